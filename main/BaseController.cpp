@@ -3,7 +3,8 @@
 namespace controller {
 
   BaseController::BaseController(uint32_t dt_ms, float min_output, float max_output, bool debug)
-      : setpoint(0.0f), output(0.0f), min_output(min_output), max_output(max_output), debug_enabled(debug) {
+      : setpoint(0.0f), output(0.0f), min_output(min_output), max_output(max_output), feed_forward(0.0f),
+        debug_enabled(debug), last_time_us(0), last_elapsed_us(0), max_gap_us(DEFAULT_MAX_GAP_US), has_last_time(false) {
 
     // Convert milliseconds to seconds for internal calculations
     // This is crucial for proper integral and derivative calculations
@@ -11,18 +12,25 @@ namespace controller {
 
     // Validate constructor parameters to prevent common setup mistakes
     if (dt_ms == 0) {
-      Serial.println(F("WARNING: BaseController - dt_ms cannot be zero, setting to 1ms"));
+      LOG_WARNING(F("WARNING: BaseController - dt_ms cannot be zero, setting to 1ms"));
       dt = 0.001f; // 1ms default
     }
 
+    // Precompute the reciprocal once so derivative terms never divide
+    inv_dt = 1.0f / dt;
+    nominal_dt = dt;
+    nominal_inv_dt = inv_dt;
+    nominal_us = (dt_ms == 0 ? 1 : dt_ms) * 1000UL;
+    jitter_tolerance_us = 0; // Every period measured unless snapping is opted into
+
     if (min_output >= max_output) {
-      Serial.println(F("WARNING: BaseController - min_output >= max_output, swapping values"));
+      LOG_WARNING(F("WARNING: BaseController - min_output >= max_output, swapping values"));
       float temp = min_output;
       this->min_output = max_output;
       this->max_output = temp;
     }
 
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("BaseController: Created with dt="));
       Serial.print(dt * 1000.0f);
       Serial.print(F("ms, limits=["));
@@ -36,18 +44,19 @@ namespace controller {
   bool BaseController::init() {
     // Basic initialization - validate parameters and reset state
     if (dt <= 0.0f) {
-      Serial.println(F("ERROR: BaseController::init() - Invalid sample time"));
+      LOG_ERROR(F("ERROR: BaseController::init() - Invalid sample time"));
       return false;
     }
 
     if (min_output >= max_output) {
-      Serial.println(F("ERROR: BaseController::init() - Invalid output limits"));
+      LOG_ERROR(F("ERROR: BaseController::init() - Invalid output limits"));
       return false;
     }
 
     // Initialize output to safe value (zero)
     output = 0.0f;
     setpoint = 0.0f;
+    feed_forward = 0.0f;
 
     debugLog(F("BaseController initialized successfully"));
     return true;
@@ -64,14 +73,11 @@ namespace controller {
     return value;
   }
 
-  void BaseController::debugLog(const String &message) const {
-    // Centralized debug logging with timestamp for better debugging
-    if (debug_enabled) {
-      Serial.print(F("["));
-      Serial.print(millis());
-      Serial.print(F("ms] "));
-      Serial.println(message);
-    }
+  void BaseController::debugPrefix() const {
+    // Timestamp prefix shared by every debugLog() overload
+    Serial.print(F("["));
+    Serial.print(millis());
+    Serial.print(F("ms] "));
   }
 
   float BaseController::computeWithSetpoint(float measured_value) {
@@ -79,7 +85,7 @@ namespace controller {
     // Error = desired - actual (positive error means we need to increase output)
     float error = setpoint - measured_value;
 
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("ComputeWithSetpoint: setpoint="));
       Serial.print(setpoint);
       Serial.print(F(", measured="));
@@ -91,6 +97,44 @@ namespace controller {
     return compute(error);
   }
 
+  float BaseController::computeWithSetpoint(float measured_value, uint32_t now_us) {
+    updateTimestep(now_us);
+    return computeWithSetpoint(measured_value);
+  }
+
+  float BaseController::compute(float error, uint32_t now_us) {
+    updateTimestep(now_us);
+    return compute(error);
+  }
+
+  void BaseController::updateTimestep(uint32_t now_us) {
+    // Unsigned subtraction stays correct across the micros() rollover
+    uint32_t elapsed_us = now_us - last_time_us;
+
+    bool first_call = !has_last_time;
+    last_time_us = now_us;
+    has_last_time = true;
+
+    // Jitter within the (opt-in) tolerance keeps the cached nominal values
+    uint32_t deviation_us = elapsed_us > nominal_us ? elapsed_us - nominal_us : nominal_us - elapsed_us;
+
+    if (first_call || elapsed_us == 0 || elapsed_us > max_gap_us || deviation_us <= jitter_tolerance_us) {
+      // Nominal period, or no trustworthy interval: first call, duplicate
+      // timestamp or resume after a pause
+      dt = nominal_dt;
+      inv_dt = nominal_inv_dt;
+      last_elapsed_us = 0;
+      return;
+    }
+
+    // Only pay for the reciprocal when the period actually changed
+    if (elapsed_us != last_elapsed_us) {
+      dt = elapsed_us * 1.0e-6f;
+      inv_dt = 1.0f / dt;
+      last_elapsed_us = elapsed_us;
+    }
+  }
+
   void BaseController::setSampleTime(uint32_t dt_ms) {
     // Validate and update sample time
     if (dt_ms == 0) {
@@ -98,15 +142,101 @@ namespace controller {
       return;
     }
 
-    dt = dt_ms / 1000.0f;
+    setSampleTimeUs(dt_ms * 1000UL);
+  }
+
+  void BaseController::setSampleTimeUs(uint32_t dt_us) {
+    if (dt_us == 0) {
+      debugLog(F("WARNING: setSampleTimeUs() - dt_us cannot be zero, ignoring"));
+      return;
+    }
 
-    if (debug_enabled) {
+    nominal_dt = dt_us * 1.0e-6f;
+    nominal_inv_dt = 1.0f / nominal_dt;
+    nominal_us = dt_us;
+    dt = nominal_dt;
+    inv_dt = nominal_inv_dt;
+    last_elapsed_us = 0;
+
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("Sample time set to "));
-      Serial.print(dt_ms);
-      Serial.println(F("ms"));
+      Serial.print(dt_us);
+      Serial.println(F("us"));
+    }
+  }
+
+  void BaseController::setMaxTimeGap(uint32_t max_gap_us) {
+    this->max_gap_us = max_gap_us;
+  }
+
+  void BaseController::setJitterTolerance(uint32_t tolerance_us) {
+    jitter_tolerance_us = tolerance_us;
+  }
+
+  void BaseController::bumplessTransfer(float output, float error) {
+    (void)error; // Only stateful controllers need it
+    this->output = applyLimits(output, min_output, max_output);
+    resetTimestamp();
+
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      Serial.print(F("Bumpless transfer at output="));
+      Serial.println(this->output, 2);
     }
   }
 
+  void BaseController::takeOverFrom(const BaseController &previous, float error) {
+    bumplessTransfer(previous.getOutput(), error);
+  }
+
+  ControllerKind BaseController::getKind() const {
+    return ControllerKind::GENERIC;
+  }
+
+  ControllerState BaseController::snapshot() const {
+    ControllerState state = {};
+    state.timestamp_us = micros();
+    state.setpoint = setpoint;
+    state.output = output;
+    state.feed_forward = feed_forward;
+    state.kind = getKind();
+    saveState(state);
+    return state;
+  }
+
+  bool BaseController::restore(const ControllerState &state) {
+    if (state.kind != getKind()) {
+      debugLog(F("WARNING: restore() - Snapshot belongs to another controller type"));
+      return false;
+    }
+
+    setpoint = state.setpoint;
+    output = applyLimits(state.output, min_output, max_output);
+    feed_forward = state.feed_forward;
+    resetTimestamp();
+    loadState(state);
+
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      Serial.print(F("State restored at output="));
+      Serial.println(output, 2);
+    }
+    return true;
+  }
+
+  void BaseController::saveState(ControllerState &state) const {
+    (void)state; // No state beyond the common fields
+  }
+
+  void BaseController::loadState(const ControllerState &state) {
+    (void)state;
+  }
+
+  void BaseController::resetTimestamp() {
+    has_last_time = false;
+    last_elapsed_us = 0;
+    dt = nominal_dt;
+    inv_dt = nominal_inv_dt;
+  }
+
   void BaseController::setOutputLimits(float min_output, float max_output) {
     // Validate and update output limits
     if (min_output >= max_output) {
@@ -122,7 +252,7 @@ namespace controller {
     // Clamp current output to new limits to prevent sudden jumps
     output = applyLimits(output, min_output, max_output);
 
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("Output limits set to ["));
       Serial.print(min_output);
       Serial.print(F(", "));
@@ -134,12 +264,17 @@ namespace controller {
   void BaseController::setSetpoint(float setpoint) {
     this->setpoint = setpoint;
 
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("Setpoint set to "));
       Serial.println(setpoint);
     }
   }
 
+  void BaseController::setFeedForward(float value) {
+    // Called every control cycle, so no debug output here
+    feed_forward = value;
+  }
+
   void BaseController::setDebugEnabled(bool enable) {
     debug_enabled = enable;
     if (enable) {
@@ -159,4 +294,8 @@ namespace controller {
     return output;
   }
 
+  float BaseController::getFeedForward() const {
+    return feed_forward;
+  }
+
 } // namespace controller
\ No newline at end of file
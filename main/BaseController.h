@@ -1,9 +1,53 @@
 #pragma once
 
+#include "LogConfig.h"
 #include <Arduino.h>
 #include <stdint.h>
 
 namespace controller {
+  /**
+   * @brief Controller type a ControllerState was taken from
+   */
+  enum class ControllerKind : uint8_t {
+    GENERIC = 0,
+    P,
+    PI,
+    PD,
+    PID,
+    INCREMENTAL_PID,
+    LQR,
+    MPC,
+    RELAY_AUTOTUNER
+  };
+
+  /**
+   * @brief Compact, trivially copyable snapshot of a controller's dynamic state
+   *
+   * Holds what a controller needs to continue exactly where it stopped:
+   * the common setpoint, output and feed-forward plus up to four
+   * controller-specific values (integral, derivative history, observer
+   * state, ...; the layout is documented by each controller's saveState()).
+   * Gains, limits and filters are configuration, not state, and are not
+   * included. At 36 bytes it can be copied between tasks, kept across a
+   * pause or appended to a FlightRecorder at the control rate.
+   *
+   * @var timestamp_us: micros() when the snapshot was taken
+   * @var setpoint, output, feed_forward: Common controller values
+   * @var internal: Controller-specific state
+   * @var kind: Controller type, checked by restore()
+   */
+  struct ControllerState {
+    uint32_t timestamp_us;
+    float setpoint;
+    float output;
+    float feed_forward;
+    float internal[4];
+    ControllerKind kind;
+    uint8_t reserved[3];
+  };
+
+  static_assert(sizeof(ControllerState) == 36, "ControllerState must stay compact");
+
   /**
    * @brief Base Controller class for different control strategies
    *
@@ -20,18 +64,43 @@ namespace controller {
      *
      * @var setpoint: Desired target value (e.g., desired position, speed, etc.)
      * @var output: Controller output (e.g., motor PWM value, servo position)
-     * @var dt: Time step in seconds (converted from milliseconds for calculations)
+     * @var dt: Time step in seconds used by the current compute() call
+     * @var inv_dt: Cached 1/dt so derivative terms multiply instead of divide
      * @var min_output: Minimum output value (prevents actuator damage)
      * @var max_output: Maximum output value (prevents actuator damage)
+     * @var feed_forward: Term added to the feedback output before limiting
      * @var debug_enabled: Flag to enable/disable debug output
      */
     float setpoint;
     float output;
     float dt;
+    float inv_dt;
     float min_output;
     float max_output;
+    float feed_forward;
     bool debug_enabled;
 
+    /**
+     * @brief Measured time step state
+     *
+     * @var nominal_dt: Configured sample time in seconds (fallback for the measured path)
+     * @var nominal_inv_dt: Cached 1/nominal_dt
+     * @var nominal_us: Configured sample time in microseconds
+     * @var jitter_tolerance_us: Deviation from nominal_us still treated as the nominal period
+     * @var last_time_us: Timestamp of the previous timestamped compute() call
+     * @var last_elapsed_us: Elapsed time that dt/inv_dt currently hold (0 = nominal)
+     * @var max_gap_us: Longest elapsed time still treated as a regular control period
+     * @var has_last_time: Whether last_time_us holds a valid timestamp
+     */
+    float nominal_dt;
+    float nominal_inv_dt;
+    uint32_t nominal_us;
+    uint32_t jitter_tolerance_us;
+    uint32_t last_time_us;
+    uint32_t last_elapsed_us;
+    uint32_t max_gap_us;
+    bool has_last_time;
+
     /**
      * @brief Apply limits to a value
      *
@@ -48,13 +117,74 @@ namespace controller {
     /**
      * @brief Debug logging function
      *
-     * Provides consistent debug output formatting across all controller types
+     * Provides consistent debug output formatting across all controller types.
+     * Takes the message as a pointer (F() or a literal) so no String is
+     * built, and compiles to nothing below LOG_LEVEL_DEBUG.
      *
      * @param message: Debug message to print
      */
-    void debugLog(const String &message) const;
+    inline void debugLog(const __FlashStringHelper *message) const {
+      if (LOG_DEBUG_ENABLED && debug_enabled) {
+        debugPrefix();
+        Serial.println(message);
+      }
+    }
+
+    inline void debugLog(const char *message) const {
+      if (LOG_DEBUG_ENABLED && debug_enabled) {
+        debugPrefix();
+        Serial.println(message);
+      }
+    }
+
+    /**
+     * @brief Print the timestamp prefix of a debug line
+     */
+    void debugPrefix() const;
+
+    /**
+     * @brief Update dt and inv_dt from a timestamp
+     *
+     * Uses the real elapsed time since the previous call. Falls back to the
+     * nominal sample time on the first call, on a repeated timestamp, and
+     * after a gap longer than max_gap_us (e.g. resuming after a stop).
+     *
+     * The reciprocal is only recomputed when the elapsed time differs from
+     * the previous one, so a loop with a steady period divides once. An
+     * elapsed time within jitter_tolerance_us of the nominal period snaps
+     * to the nominal dt and 1/dt; the tolerance is 0 unless set with
+     * setJitterTolerance(), so by default every period is measured.
+     *
+     * @param now_us: Current time in microseconds (e.g. micros())
+     */
+    void updateTimestep(uint32_t now_us);
+
+    /**
+     * @brief Write the controller-specific part of a snapshot
+     *
+     * The base implementation has no extra state; derived classes fill
+     * state.internal and document its layout.
+     *
+     * @param state: Snapshot with the common fields already filled
+     */
+    virtual void saveState(ControllerState &state) const;
+
+    /**
+     * @brief Restore the controller-specific part of a snapshot
+     *
+     * Called by restore() after the common fields were applied and the
+     * kind was checked.
+     *
+     * @param state: Snapshot taken from a controller of the same kind
+     */
+    virtual void loadState(const ControllerState &state);
 
   public:
+    /**
+     * @brief Default largest elapsed time accepted by the measured-dt path (100 ms)
+     */
+    static const uint32_t DEFAULT_MAX_GAP_US = 100000;
+
     /**
      * @brief Construct a new Base Controller
      *
@@ -90,6 +220,61 @@ namespace controller {
      */
     virtual void reset() = 0;
 
+    /**
+     * @brief Prepare to take over from another controller without an output jump
+     *
+     * Initializes the controller state so that, for an unchanged error, the
+     * next compute() continues from the given output. Controllers with an
+     * integral or incremental state can match any output within their
+     * limits; the stateless P and PD controllers only avoid the derivative
+     * kick and otherwise start from their own control law.
+     *
+     * The base implementation adopts the output (limited) and forgets the
+     * previous timestamp; derived classes extend it with their own state.
+     *
+     * @param output: Last output of the controller being replaced
+     * @param error: Current error (setpoint - measured_value)
+     */
+    virtual void bumplessTransfer(float output, float error);
+
+    /**
+     * @brief Take over from another controller without an output jump
+     *
+     * @param previous: Controller that has been driving the actuators so far
+     * @param error: Current error (setpoint - measured_value)
+     */
+    void takeOverFrom(const BaseController &previous, float error);
+
+    /**
+     * @brief Get the controller type recorded in snapshots
+     *
+     * @return ControllerKind Type of this controller
+     */
+    virtual ControllerKind getKind() const;
+
+    /**
+     * @brief Capture the dynamic state, e.g. before stopping the robot
+     *
+     * Cheap enough to call from the control task every cycle.
+     *
+     * @return ControllerState Snapshot of this controller
+     */
+    ControllerState snapshot() const;
+
+    /**
+     * @brief Continue from a snapshot, e.g. to resume mid-track after a pause
+     *
+     * Restores the setpoint, output, feed-forward and the internal state
+     * (integral, derivative history, ...) and forgets the previous
+     * timestamp, so the first timestamped compute() after the pause uses
+     * the nominal sample time instead of the length of the pause. The
+     * output is clamped to the current limits.
+     *
+     * @param state: Snapshot taken from a controller of the same kind
+     * @return bool true on success, false if the snapshot is of another kind
+     */
+    bool restore(const ControllerState &state);
+
     /**
      * @brief Calculate controller output based on error
      *
@@ -101,6 +286,22 @@ namespace controller {
      */
     virtual float compute(float error) = 0;
 
+    /**
+     * @brief Calculate controller output using the measured time step
+     *
+     * Timestamped variant of compute(): the integral and derivative terms use
+     * the actual time elapsed since the previous call instead of the fixed
+     * sample time, so gains stay valid when the loop period shifts.
+     *
+     * Derived classes must add `using BaseController::compute;` so this
+     * overload is not hidden by their compute(float) override.
+     *
+     * @param error: Current error (setpoint - measured_value)
+     * @param now_us: Current time in microseconds (e.g. micros())
+     * @return float Controller output between min_output and max_output
+     */
+    float compute(float error, uint32_t now_us);
+
     /**
      * @brief Calculate controller output based on setpoint and measured value
      *
@@ -111,6 +312,15 @@ namespace controller {
      */
     float computeWithSetpoint(float measured_value);
 
+    /**
+     * @brief Calculate controller output from a measurement using the measured time step
+     *
+     * @param measured_value: Current measured value from sensor
+     * @param now_us: Current time in microseconds (e.g. micros())
+     * @return float Controller output between min_output and max_output
+     */
+    float computeWithSetpoint(float measured_value, uint32_t now_us);
+
     /**
      * @brief Set the sample time
      *
@@ -120,6 +330,47 @@ namespace controller {
      */
     void setSampleTime(uint32_t dt_ms);
 
+    /**
+     * @brief Set the sample time with microsecond resolution
+     *
+     * Needed for loop rates above 1 kHz, where whole milliseconds cannot
+     * express the period.
+     *
+     * @param dt_us: Time step in microseconds
+     */
+    void setSampleTimeUs(uint32_t dt_us);
+
+    /**
+     * @brief Set the largest gap accepted by the measured-dt path
+     *
+     * Timestamped calls arriving later than this fall back to the nominal
+     * sample time, preventing a single huge integral step after a pause.
+     *
+     * @param max_gap_us: Gap limit in microseconds
+     */
+    void setMaxTimeGap(uint32_t max_gap_us);
+
+    /**
+     * @brief Set how far a measured period may stray and still count as nominal
+     *
+     * Periods within the tolerance use the nominal sample time, which saves
+     * the reciprocal when the period wobbles from cycle to cycle. The I and
+     * D terms then use the nominal dt instead of the elapsed time: only
+     * zero-mean jitter averages out, a biased or drifting period is off by
+     * up to the tolerance with no sign of it. Off (0) by default.
+     *
+     * @param tolerance_us: Largest |elapsed - nominal| in microseconds (0 = exact match only)
+     */
+    void setJitterTolerance(uint32_t tolerance_us);
+
+    /**
+     * @brief Forget the previous timestamp
+     *
+     * The next timestamped compute() call uses the nominal sample time.
+     * Called by every controller's reset().
+     */
+    void resetTimestamp();
+
     /**
      * @brief Set the output limits
      *
@@ -139,6 +390,20 @@ namespace controller {
      */
     void setSetpoint(float setpoint);
 
+    /**
+     * @brief Set the feed-forward term
+     *
+     * The term is added to the feedback output before the output limits, so
+     * a known disturbance (e.g. the steering a bend needs at the current
+     * speed) is applied before any error builds up. The feedback part is
+     * limited to the room the feed-forward leaves, which keeps integral
+     * anti-windup and bumpless transfer consistent with the total output.
+     * The value holds until it is changed; init() clears it.
+     *
+     * @param value: Feed-forward term in output units
+     */
+    void setFeedForward(float value);
+
     /**
      * @brief Enable or disable debug output
      *
@@ -149,7 +414,7 @@ namespace controller {
     /**
      * @brief Get the sample time
      *
-     * @return float Time step in seconds
+     * @return float Time step in seconds used by the most recent compute()
      */
     float getSampleTime() const;
 
@@ -166,5 +431,12 @@ namespace controller {
      * @return float Last computed output
      */
     float getOutput() const;
+
+    /**
+     * @brief Get the feed-forward term
+     *
+     * @return float Term added to the feedback output
+     */
+    float getFeedForward() const;
   };
 } // namespace controller
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "CascadeController.h"
+
+namespace controller {
+
+  CascadeController::CascadeController(BaseController &outer, PIController &left, PIController &right,
+                                       uint32_t inner_rate_hz, uint8_t outer_divider)
+      : outer(outer), left(left), right(right), inner_rate_hz(inner_rate_hz), outer_divider(outer_divider),
+        tick(0), base_speed(0.0f), differential(0.0f) {
+
+    if (inner_rate_hz == 0) {
+      LOG_WARNING(F("WARNING: CascadeController - inner_rate_hz cannot be zero, setting to 1000Hz"));
+      this->inner_rate_hz = 1000;
+    }
+    if (outer_divider == 0) {
+      LOG_WARNING(F("WARNING: CascadeController - outer_divider cannot be zero, setting to 1"));
+      this->outer_divider = 1;
+    }
+  }
+
+  bool CascadeController::init() {
+    // Sample times first, so init() validates the periods the controllers will run at
+    applySampleTimes();
+    if (!outer.init() || !left.init() || !right.init()) {
+      LOG_ERROR(F("ERROR: CascadeController::init() - Controller initialization failed"));
+      return false;
+    }
+
+    reset();
+    return true;
+  }
+
+  void CascadeController::reset() {
+    outer.reset();
+    left.reset();
+    right.reset();
+    differential = 0.0f;
+    tick = 0;
+  }
+
+  CascadeController::WheelCommand CascadeController::step(float line_error, float left_speed, float right_speed) {
+    if (tick == 0) {
+      differential = outer.compute(line_error);
+    }
+    return stepInner(left_speed, right_speed);
+  }
+
+  CascadeController::WheelCommand CascadeController::stepInner(float left_speed, float right_speed) {
+    // Hand-off: the held differential becomes the wheel targets of this tick
+    left.setSetpoint(base_speed + differential);
+    right.setSetpoint(base_speed - differential);
+
+    WheelCommand command;
+    command.left = left.computeWithSetpoint(left_speed);
+    command.right = right.computeWithSetpoint(right_speed);
+
+    if (++tick >= outer_divider) {
+      tick = 0;
+    }
+    return command;
+  }
+
+  bool CascadeController::setRates(uint32_t inner_rate_hz, uint8_t outer_divider) {
+    if (inner_rate_hz == 0 || outer_divider == 0) {
+      LOG_WARNING(F("WARNING: CascadeController::setRates() - Rate and divider must be non-zero"));
+      return false;
+    }
+
+    this->inner_rate_hz = inner_rate_hz;
+    this->outer_divider = outer_divider;
+    if (tick >= outer_divider) {
+      tick = 0;
+    }
+    applySampleTimes();
+    return true;
+  }
+
+  void CascadeController::applySampleTimes() {
+    uint32_t inner_period_us = 1000000UL / inner_rate_hz;
+    left.setSampleTimeUs(inner_period_us);
+    right.setSampleTimeUs(inner_period_us);
+    outer.setSampleTimeUs(inner_period_us * outer_divider);
+  }
+
+  void CascadeController::setBaseSpeed(float speed) {
+    base_speed = speed;
+  }
+
+  bool CascadeController::isOuterDue() const {
+    return tick == 0;
+  }
+
+  float CascadeController::getBaseSpeed() const {
+    return base_speed;
+  }
+
+  float CascadeController::getDifferential() const {
+    return differential;
+  }
+
+  float CascadeController::getLeftTarget() const {
+    return base_speed + differential;
+  }
+
+  float CascadeController::getRightTarget() const {
+    return base_speed - differential;
+  }
+
+  uint32_t CascadeController::getInnerRateHz() const {
+    return inner_rate_hz;
+  }
+
+  uint8_t CascadeController::getOuterDivider() const {
+    return outer_divider;
+  }
+
+} // namespace controller
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "BaseController.h"
+#include "PIController.h"
+
+namespace controller {
+
+  /**
+   * @brief Two-rate cascade: line-position loop feeding two wheel-speed loops
+   *
+   * The outer controller turns the line error into a differential speed
+   * command; two inner PI controllers track the resulting wheel speeds from
+   * encoder feedback and produce the motor commands:
+   *
+   *   differential = outer.compute(line_error)           every divider ticks
+   *   left_target  = base_speed + differential           (held in between)
+   *   right_target = base_speed - differential
+   *   left_pwm     = left.computeWithSetpoint(left_speed)    every tick
+   *   right_pwm    = right.computeWithSetpoint(right_speed)  every tick
+   *
+   * step() is meant to be called at the inner rate R2, e.g. from a
+   * ControlScheduler; the cascade counts the ticks and runs the outer loop
+   * at R1 = R2 / divider. The sample times of all three controllers are set
+   * from the rate and divider, so their integral and derivative terms see
+   * the period they actually run at. Between outer updates the wheel
+   * targets are held (zero-order hold).
+   *
+   * The controllers are owned by the caller and only referenced here, so
+   * any BaseController works as the outer loop and its gains, limits and
+   * filters stay configurable through its own interface. The outer output
+   * limits bound the differential command.
+   *
+   * Sign convention: a positive differential speeds up the left wheel, so
+   * the outer error should be positive when the robot must turn right.
+   */
+  class CascadeController {
+  public:
+    /**
+     * @brief Motor commands of one tick
+     *
+     * @var left, right: Inner controller outputs (PWM counts)
+     */
+    struct WheelCommand {
+      float left;
+      float right;
+    };
+
+    /**
+     * @brief Construct a new cascade
+     *
+     * @param outer: Line-position controller (output = differential speed)
+     * @param left: Left wheel speed controller
+     * @param right: Right wheel speed controller
+     * @param inner_rate_hz: Rate at which step() is called (R2)
+     * @param outer_divider: Inner ticks per outer update (R1 = R2 / divider)
+     */
+    CascadeController(BaseController &outer, PIController &left, PIController &right,
+                      uint32_t inner_rate_hz = 1000, uint8_t outer_divider = 4);
+
+    /**
+     * @brief Set the sample times, initialize and reset all three controllers
+     *
+     * @return bool true on success, false if a controller failed to initialize
+     */
+    bool init();
+
+    /**
+     * @brief Reset all controllers and restart the outer loop on the next tick
+     */
+    void reset();
+
+    /**
+     * @brief Run one inner tick, and the outer loop when it is due
+     *
+     * @param line_error: Line position error (only read on outer ticks)
+     * @param left_speed: Measured left wheel speed
+     * @param right_speed: Measured right wheel speed
+     * @return WheelCommand Motor commands for this tick
+     */
+    WheelCommand step(float line_error, float left_speed, float right_speed);
+
+    /**
+     * @brief Run one inner tick with the outer loop held
+     *
+     * Keeps the last differential, e.g. while the line is lost; the tick
+     * still counts towards the next outer update.
+     *
+     * @param left_speed: Measured left wheel speed
+     * @param right_speed: Measured right wheel speed
+     * @return WheelCommand Motor commands for this tick
+     */
+    WheelCommand stepInner(float left_speed, float right_speed);
+
+    /**
+     * @brief Change the rates
+     *
+     * Updates the controller sample times; the controller state is kept.
+     *
+     * @param inner_rate_hz: Rate at which step() is called (R2)
+     * @param outer_divider: Inner ticks per outer update (>= 1)
+     * @return bool true on success, false if a parameter is zero
+     */
+    bool setRates(uint32_t inner_rate_hz, uint8_t outer_divider);
+
+    /**
+     * @brief Set the common forward speed both wheel targets are built around
+     *
+     * @param speed: Base wheel speed (encoder units)
+     */
+    void setBaseSpeed(float speed);
+
+    /**
+     * @brief Check whether the next step() runs the outer loop
+     *
+     * @return bool true if the next tick is an outer tick
+     */
+    bool isOuterDue() const;
+
+    float getBaseSpeed() const;
+    float getDifferential() const;
+    float getLeftTarget() const;
+    float getRightTarget() const;
+    uint32_t getInnerRateHz() const;
+    uint8_t getOuterDivider() const;
+
+  private:
+    /**
+     * @brief Push the rate configuration into the controllers' sample times
+     */
+    void applySampleTimes();
+
+    /**
+     * @brief Cascade configuration and hand-off state
+     *
+     * @var outer, left, right: Controllers (owned by the caller)
+     * @var inner_rate_hz: Inner loop rate R2
+     * @var outer_divider: Inner ticks per outer update
+     * @var tick: Inner ticks since the last outer update
+     * @var base_speed: Common forward wheel speed
+     * @var differential: Last outer output, held between outer updates
+     */
+    BaseController &outer;
+    PIController &left;
+    PIController &right;
+    uint32_t inner_rate_hz;
+    uint8_t outer_divider;
+    uint8_t tick;
+    float base_speed;
+    float differential;
+  };
+
+} // namespace controller
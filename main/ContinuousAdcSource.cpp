@@ -0,0 +1,200 @@
+#include "ContinuousAdcSource.h"
+#include "LogConfig.h"
+
+namespace sensing {
+
+  ContinuousAdcSource *ContinuousAdcSource::active = nullptr;
+
+  ContinuousAdcSource::ContinuousAdcSource(const uint8_t *pins, uint8_t count)
+      : pins(pins), count(count), adc1_count(0), task(nullptr),
+        running(false), sequence(0), read_errors(0) {
+    // Checks that print wait for begin(): a global instance is constructed before Serial.begin()
+  }
+
+  bool ContinuousAdcSource::begin(BaseType_t core_id, UBaseType_t priority, uint32_t stack_size) {
+#if SENSING_HAS_CONTINUOUS_ADC
+    if (task != nullptr) {
+      return true; // Already initialized
+    }
+    if (count > SensorFrame::MAX_SENSORS) {
+      LOG_WARNING(F("WARNING: ContinuousAdcSource - Too many sensors, extra sensors ignored"));
+      count = SensorFrame::MAX_SENSORS;
+    }
+
+    // Split the array into scanned ADC1 channels and ADC2 fallback pins
+    adc1_count = 0;
+    for (uint8_t i = 0; i < count; i++) {
+      if (isAdc1Pin(pins[i])) {
+        adc1_pins[adc1_count] = pins[i];
+        adc1_sensor[adc1_count] = i;
+        adc1_count++;
+      }
+    }
+
+    if (adc1_count == 0) {
+      LOG_ERROR(F("ERROR: ContinuousAdcSource::begin() - No ADC1 pins to scan"));
+      return false;
+    }
+
+    if (xTaskCreatePinnedToCore(taskEntry, "acquire", stack_size, this, priority, &task, core_id) != pdPASS) {
+      LOG_ERROR(F("ERROR: ContinuousAdcSource::begin() - Failed to create acquisition task"));
+      task = nullptr;
+      return false;
+    }
+
+    if (LOG_WARNINGS_ENABLED && adc1_count < count) {
+      Serial.print(F("WARNING: ContinuousAdcSource - "));
+      Serial.print(count - adc1_count);
+      Serial.println(F(" ADC2 sensor(s) use the slower analogRead() fallback"));
+    }
+    return true;
+#else
+    (void)core_id;
+    (void)priority;
+    (void)stack_size;
+    LOG_WARNING(F("WARNING: ContinuousAdcSource - Continuous ADC needs Arduino-ESP32 3.x"));
+    return false;
+#endif
+  }
+
+  bool ContinuousAdcSource::start(uint32_t frame_rate_hz) {
+#if SENSING_HAS_CONTINUOUS_ADC
+    if (task == nullptr) {
+      LOG_ERROR(F("ERROR: ContinuousAdcSource::start() - begin() has not been called"));
+      return false;
+    }
+    if (running) {
+      return true;
+    }
+    if (active != nullptr) {
+      LOG_ERROR(F("ERROR: ContinuousAdcSource::start() - Continuous ADC already in use"));
+      return false;
+    }
+
+    uint32_t sample_rate = frame_rate_hz * adc1_count * CONVERSIONS_PER_PIN;
+    if (sample_rate < MIN_SAMPLE_RATE_HZ) {
+      sample_rate = MIN_SAMPLE_RATE_HZ;
+    } else if (sample_rate > MAX_SAMPLE_RATE_HZ) {
+      sample_rate = MAX_SAMPLE_RATE_HZ;
+    }
+
+    active = this;
+    sequence = 0;
+    read_errors = 0;
+
+    if (!analogContinuous(adc1_pins, adc1_count, CONVERSIONS_PER_PIN, sample_rate, onConversionDone)) {
+      LOG_ERROR(F("ERROR: ContinuousAdcSource::start() - Failed to configure continuous ADC"));
+      active = nullptr;
+      return false;
+    }
+    if (!analogContinuousStart()) {
+      LOG_ERROR(F("ERROR: ContinuousAdcSource::start() - Failed to start continuous ADC"));
+      analogContinuousDeinit();
+      active = nullptr;
+      return false;
+    }
+
+    running = true;
+    return true;
+#else
+    (void)frame_rate_hz;
+    return false;
+#endif
+  }
+
+  void ContinuousAdcSource::stop() {
+#if SENSING_HAS_CONTINUOUS_ADC
+    if (!running) {
+      return;
+    }
+    running = false;
+    vTaskDelay(pdMS_TO_TICKS(2)); // Let a frame already being assembled finish
+    analogContinuousStop();
+    analogContinuousDeinit(); // Hands the pins back to analogRead()
+    active = nullptr;
+#endif
+  }
+
+  bool ContinuousAdcSource::isRunning() const {
+    return running;
+  }
+
+  uint8_t ContinuousAdcSource::getAdc1Count() const {
+    return adc1_count;
+  }
+
+  uint32_t ContinuousAdcSource::getFrameCount() const {
+    return sequence;
+  }
+
+  uint32_t ContinuousAdcSource::getReadErrors() const {
+    return read_errors;
+  }
+
+  bool ContinuousAdcSource::isAdc1Pin(uint8_t pin) {
+    return pin >= 32 && pin <= 39;
+  }
+
+  void ARDUINO_ISR_ATTR ContinuousAdcSource::onConversionDone() {
+    ContinuousAdcSource *self = active;
+    if (self == nullptr || self->task == nullptr) {
+      return;
+    }
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(self->task, &woken);
+    portYIELD_FROM_ISR(woken);
+  }
+
+  bool ContinuousAdcSource::assembleFrame() {
+#if SENSING_HAS_CONTINUOUS_ADC
+    adc_continuous_result_t *results = nullptr;
+    if (!analogContinuousRead(&results, 0) || results == nullptr) {
+      read_errors = read_errors + 1;
+      return false;
+    }
+
+    SensorFrame &frame = frames.writeSlot();
+
+    // The driver reports one averaged result per scanned pin
+    for (uint8_t i = 0; i < adc1_count; i++) {
+      for (uint8_t j = 0; j < adc1_count; j++) {
+        if (results[i].pin == adc1_pins[j]) {
+          frame.raw[adc1_sensor[j]] = (uint16_t)results[i].avg_read_raw;
+          break;
+        }
+      }
+    }
+
+    // ADC2 sensors are converted here, off the control task
+    for (uint8_t i = 0; i < count; i++) {
+      if (!isAdc1Pin(pins[i])) {
+        frame.raw[i] = (uint16_t)analogRead(pins[i]);
+      }
+    }
+
+    frame.timestamp_us = micros();
+    frame.sequence = sequence + 1;
+    frames.publish();
+    sequence = frame.sequence;
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  void ContinuousAdcSource::taskEntry(void *arg) {
+    ContinuousAdcSource *self = static_cast<ContinuousAdcSource *>(arg);
+
+    for (;;) {
+      // Conversions that complete while we are busy collapse into one
+      // wake-up; only the newest set matters
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+      if (self->running) {
+        self->assembleFrame();
+      }
+    }
+  }
+
+} // namespace sensing
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "TripleBuffer.h"
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// analogContinuous() (the ADC DMA driver wrapper) arrived in Arduino-ESP32 3.0
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+#define SENSING_HAS_CONTINUOUS_ADC 1
+#else
+#define SENSING_HAS_CONTINUOUS_ADC 0
+#endif
+
+namespace sensing {
+
+  /**
+   * @brief One complete scan of the sensor array
+   *
+   * @var MAX_SENSORS: Largest array a frame can hold
+   * @var timestamp_us: micros() when the frame was completed
+   * @var sequence: Frame counter, increments by one per published frame
+   * @var raw: Uncalibrated 12-bit readings in sensor order
+   */
+  struct SensorFrame {
+    static const uint8_t MAX_SENSORS = 16;
+
+    uint32_t timestamp_us;
+    uint32_t sequence;
+    uint16_t raw[MAX_SENSORS];
+  };
+
+  /**
+   * @brief Background sensor acquisition using the ESP32 continuous (DMA) ADC
+   *
+   * The ADC1 channels of the array are put in continuous scan mode, so the
+   * conversions run in hardware while the CPU does other work. When the DMA
+   * driver has a new set of conversions it wakes an acquisition task, which
+   * assembles a SensorFrame and publishes it through a TripleBuffer. The
+   * control loop only calls fetch(), an atomic index swap, and never waits
+   * for a conversion.
+   *
+   * ADC2 pins (GPIO 0, 2, 4, 12-15, 25-27 on the ESP32) cannot join the
+   * continuous scan. They are read with analogRead() by the acquisition
+   * task as a fallback, which keeps them off the control task but is slower;
+   * wiring those sensors to spare ADC1 pins (GPIO 37/38 where the module
+   * exposes them) puts the whole array in the scan.
+   *
+   * Only one instance may run at a time, because there is only one
+   * continuous ADC driver. While it runs, the ADC1 pins are owned by the
+   * driver and analogRead() on them (e.g. QTR calibration) will fail: call
+   * stop() first.
+   */
+  class ContinuousAdcSource {
+  public:
+    /**
+     * @brief Acquisition limits
+     *
+     * @var CONVERSIONS_PER_PIN: Conversions averaged into each reading
+     * @var MIN_SAMPLE_RATE_HZ: Lowest total sample rate the ESP32 DMA driver accepts
+     * @var MAX_SAMPLE_RATE_HZ: Highest total sample rate the ESP32 DMA driver accepts
+     */
+    static const uint32_t CONVERSIONS_PER_PIN = 4;
+    static const uint32_t MIN_SAMPLE_RATE_HZ = 20000;
+    static const uint32_t MAX_SAMPLE_RATE_HZ = 2000000;
+
+    /**
+     * @brief Construct a new acquisition source
+     *
+     * @param pins: GPIO of each sensor, in sensor order (must outlive the object)
+     * @param count: Number of sensors (1 - SensorFrame::MAX_SENSORS)
+     */
+    ContinuousAdcSource(const uint8_t *pins, uint8_t count);
+
+    /**
+     * @brief Check the pins and create the acquisition task
+     *
+     * Sensors beyond SensorFrame::MAX_SENSORS are dropped with a warning.
+     *
+     * @param core_id: CPU core the acquisition task is pinned to (default 0)
+     * @param priority: FreeRTOS priority of the acquisition task
+     * @param stack_size: Acquisition task stack size in bytes
+     * @return bool true on success, false if continuous ADC is unavailable or the task failed
+     */
+    bool begin(BaseType_t core_id = 0, UBaseType_t priority = configMAX_PRIORITIES - 3,
+               uint32_t stack_size = 3072);
+
+    /**
+     * @brief Configure the continuous scan and start producing frames
+     *
+     * @param frame_rate_hz: Target frames per second; the sample rate is
+     *                       raised to the driver minimum if necessary
+     * @return bool true on success, false if begin() was not called or the driver failed
+     */
+    bool start(uint32_t frame_rate_hz);
+
+    /**
+     * @brief Stop the scan and release the ADC1 pins for analogRead()
+     */
+    void stop();
+
+    /**
+     * @brief Take the newest frame if one arrived (control side only)
+     *
+     * @return bool true if frame() now holds a frame not seen before
+     */
+    inline bool fetch() {
+      return frames.fetch();
+    }
+
+    /**
+     * @brief Latest fetched frame (control side only)
+     *
+     * @return const SensorFrame& Stable until the next fetch()
+     */
+    inline const SensorFrame &frame() const {
+      return frames.front();
+    }
+
+    /**
+     * @brief Check whether at least one frame has been fetched
+     *
+     * @return bool true once frame() holds real readings
+     */
+    inline bool hasFrame() const {
+      return frames.hasValue();
+    }
+
+    bool isRunning() const;
+
+    /**
+     * @brief Number of sensors in the continuous scan
+     *
+     * @return uint8_t ADC1 sensors, 0 before begin()
+     */
+    uint8_t getAdc1Count() const;
+    uint32_t getFrameCount() const;
+    uint32_t getReadErrors() const;
+
+    /**
+     * @brief Check whether a GPIO belongs to ADC1 on the ESP32
+     *
+     * @param pin: GPIO number
+     * @return bool true for GPIO 32-39
+     */
+    static bool isAdc1Pin(uint8_t pin);
+
+  private:
+    /**
+     * @brief DMA driver callback (ISR) - wakes the acquisition task
+     */
+    static void onConversionDone();
+
+    /**
+     * @brief Acquisition task body - assembles and publishes frames
+     *
+     * @param arg: Pointer to the owning ContinuousAdcSource
+     */
+    static void taskEntry(void *arg);
+
+    /**
+     * @brief Read the available conversions and fallback pins into one frame
+     *
+     * @return bool true if a frame was published
+     */
+    bool assembleFrame();
+
+    /**
+     * @var active: The running instance, for the argument-less driver callback
+     */
+    static ContinuousAdcSource *active;
+
+    /**
+     * @brief Acquisition state
+     *
+     * @var pins: Sensor GPIO in sensor order
+     * @var count: Number of sensors
+     * @var adc1_pins: GPIO of the sensors in the continuous scan
+     * @var adc1_sensor: Sensor index of each entry of adc1_pins
+     * @var adc1_count: Number of sensors in the continuous scan
+     * @var frames: Latest-frame handoff to the control task
+     * @var task: Acquisition task handle
+     * @var running: Whether the scan is active
+     * @var sequence: Number of frames published since start()
+     * @var read_errors: Wake-ups where the driver returned no data
+     */
+    const uint8_t *pins;
+    uint8_t count;
+    uint8_t adc1_pins[SensorFrame::MAX_SENSORS];
+    uint8_t adc1_sensor[SensorFrame::MAX_SENSORS];
+    uint8_t adc1_count;
+    rt::TripleBuffer<SensorFrame> frames;
+    TaskHandle_t task;
+    volatile bool running;
+    volatile uint32_t sequence;
+    volatile uint32_t read_errors;
+  };
+
+} // namespace sensing
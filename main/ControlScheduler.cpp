@@ -0,0 +1,155 @@
+#include "ControlScheduler.h"
+#include "LogConfig.h"
+
+namespace rt {
+
+  ControlScheduler::ControlScheduler(CycleCallback callback, void *context, uint32_t rate_hz)
+      : core(rate_hz), callback(callback), context(context),
+        timer(nullptr), task(nullptr), running(false) {
+    portMUX_INITIALIZE(&stats_lock);
+
+    if (callback == nullptr) {
+      LOG_WARNING(F("WARNING: ControlScheduler - No callback, control loop will idle"));
+    }
+  }
+
+  ControlScheduler::~ControlScheduler() {
+    stop();
+    if (timer != nullptr) {
+      esp_timer_delete(timer);
+    }
+    if (task != nullptr) {
+      vTaskDelete(task);
+    }
+  }
+
+  bool ControlScheduler::begin(BaseType_t core_id, UBaseType_t priority, uint32_t stack_size) {
+    if (task != nullptr) {
+      return true; // Already initialized
+    }
+
+    // Create the control task first so the timer always has someone to notify
+    if (xTaskCreatePinnedToCore(taskEntry, "control", stack_size, this, priority, &task, core_id) != pdPASS) {
+      LOG_ERROR(F("ERROR: ControlScheduler::begin() - Failed to create control task"));
+      task = nullptr;
+      return false;
+    }
+
+    // The timer callback only notifies the task; it runs in the esp_timer
+    // task, which is short and high priority, so dispatch latency stays low
+    esp_timer_create_args_t args = {};
+    args.callback = onTimer;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "control_tick";
+    args.skip_unhandled_events = true;
+
+    if (esp_timer_create(&args, &timer) != ESP_OK) {
+      LOG_ERROR(F("ERROR: ControlScheduler::begin() - Failed to create esp_timer"));
+      vTaskDelete(task);
+      task = nullptr;
+      timer = nullptr;
+      return false;
+    }
+
+    return true;
+  }
+
+  bool ControlScheduler::start() {
+    if (timer == nullptr) {
+      LOG_ERROR(F("ERROR: ControlScheduler::start() - begin() has not been called"));
+      return false;
+    }
+    if (running) {
+      return true;
+    }
+
+    portENTER_CRITICAL(&stats_lock);
+    core.start((uint32_t)esp_timer_get_time());
+    portEXIT_CRITICAL(&stats_lock);
+
+    if (esp_timer_start_periodic(timer, core.getPeriodUs()) != ESP_OK) {
+      LOG_ERROR(F("ERROR: ControlScheduler::start() - Failed to start timer"));
+      return false;
+    }
+
+    running = true;
+    return true;
+  }
+
+  void ControlScheduler::stop() {
+    if (!running) {
+      return;
+    }
+    running = false;
+    esp_timer_stop(timer);
+  }
+
+  bool ControlScheduler::setRate(uint32_t rate_hz) {
+    bool was_running = running;
+    stop();
+
+    portENTER_CRITICAL(&stats_lock);
+    bool accepted = core.setRate(rate_hz);
+    portEXIT_CRITICAL(&stats_lock);
+
+    if (LOG_WARNINGS_ENABLED && !accepted) {
+      Serial.print(F("WARNING: ControlScheduler - Rate clamped to "));
+      Serial.print(core.getRateHz());
+      Serial.println(F(" Hz"));
+    }
+
+    if (was_running) {
+      start();
+    }
+    return accepted;
+  }
+
+  bool ControlScheduler::isRunning() const {
+    return running;
+  }
+
+  uint32_t ControlScheduler::getRateHz() const {
+    return core.getRateHz();
+  }
+
+  SchedulerStats ControlScheduler::getStats() const {
+    portENTER_CRITICAL(&stats_lock);
+    SchedulerStats copy = core.getStats();
+    portEXIT_CRITICAL(&stats_lock);
+    return copy;
+  }
+
+  void ControlScheduler::onTimer(void *arg) {
+    ControlScheduler *self = static_cast<ControlScheduler *>(arg);
+    xTaskNotifyGive(self->task);
+  }
+
+  void ControlScheduler::taskEntry(void *arg) {
+    ControlScheduler *self = static_cast<ControlScheduler *>(arg);
+
+    for (;;) {
+      // Block until the timer releases the next period. Ticks that arrive
+      // while we are still busy collapse into one wake-up; FixedRateCore
+      // accounts for them as missed periods from the timestamps.
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+      if (!self->running) {
+        continue;
+      }
+
+      portENTER_CRITICAL(&self->stats_lock);
+      self->core.beginCycle((uint32_t)esp_timer_get_time());
+      portEXIT_CRITICAL(&self->stats_lock);
+
+      if (self->callback != nullptr) {
+        self->callback(self->context);
+      }
+
+      portENTER_CRITICAL(&self->stats_lock);
+      self->core.endCycle((uint32_t)esp_timer_get_time());
+      portEXIT_CRITICAL(&self->stats_lock);
+    }
+  }
+
+} // namespace rt
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "FixedRateCore.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace rt {
+
+  /**
+   * @brief Hardware-timer driven fixed-rate control loop for the ESP32
+   *
+   * A periodic esp_timer notifies a dedicated FreeRTOS task once per period.
+   * The task wakes up, runs the user callback (acquire -> estimate -> control)
+   * and goes back to sleep, so the loop rate is set by the hardware timer
+   * instead of by delay() calls in loop().
+   *
+   * All rate and overrun bookkeeping is delegated to FixedRateCore, which is
+   * platform independent and can be exercised on a host with a simulated clock.
+   *
+   * The callback runs in task context: it may use FreeRTOS APIs but must not
+   * block, and anything it shares with loop() needs the usual volatile/critical
+   * section care.
+   */
+  class ControlScheduler {
+  public:
+    /**
+     * @brief Signature of the per-period control callback
+     *
+     * @param context: User pointer passed to the constructor
+     */
+    typedef void (*CycleCallback)(void *context);
+
+    /**
+     * @brief Construct a new Control Scheduler
+     *
+     * @param callback: Function executed once per control period
+     * @param context: User pointer forwarded to the callback (may be nullptr)
+     * @param rate_hz: Control rate in Hz (clamped to 1-5 kHz)
+     */
+    ControlScheduler(CycleCallback callback, void *context = nullptr,
+                     uint32_t rate_hz = FixedRateCore::DEFAULT_RATE_HZ);
+
+    /**
+     * @brief Stop the timer and release the task
+     */
+    ~ControlScheduler();
+
+    /**
+     * @brief Create the control task and the periodic timer
+     *
+     * The timer is created stopped; call start() to begin running the loop.
+     *
+     * @param core_id: CPU core the control task is pinned to (default 1)
+     * @param priority: FreeRTOS priority of the control task
+     * @param stack_size: Control task stack size in bytes
+     * @return bool true on success, false if the task or timer could not be created
+     */
+    bool begin(BaseType_t core_id = 1, UBaseType_t priority = configMAX_PRIORITIES - 2,
+               uint32_t stack_size = 4096);
+
+    /**
+     * @brief Start the periodic timer and clear statistics
+     *
+     * @return bool true on success, false if begin() was not called or the timer failed
+     */
+    bool start();
+
+    /**
+     * @brief Stop the periodic timer
+     *
+     * Because the control task outranks loop(), a caller running on the same
+     * core can rely on no iteration being in progress once stop() returns.
+     */
+    void stop();
+
+    /**
+     * @brief Change the control rate
+     *
+     * If the scheduler is running, the timer is restarted with the new period.
+     *
+     * @param rate_hz: Control rate in Hz (clamped to 1-5 kHz)
+     * @return bool true if the rate was accepted without clamping
+     */
+    bool setRate(uint32_t rate_hz);
+
+    /**
+     * @brief Check whether the periodic timer is running
+     *
+     * @return bool true if control iterations are being scheduled
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Get the configured control rate
+     *
+     * @return uint32_t Control rate in Hz
+     */
+    uint32_t getRateHz() const;
+
+    /**
+     * @brief Get a consistent copy of the timing statistics
+     *
+     * @return SchedulerStats Statistics since the last start()
+     */
+    SchedulerStats getStats() const;
+
+  private:
+    /**
+     * @brief esp_timer callback - wakes the control task
+     *
+     * @param arg: Pointer to the owning ControlScheduler
+     */
+    static void onTimer(void *arg);
+
+    /**
+     * @brief Control task body - waits for timer ticks and runs the callback
+     *
+     * @param arg: Pointer to the owning ControlScheduler
+     */
+    static void taskEntry(void *arg);
+
+    /**
+     * @brief Scheduler state
+     *
+     * @var core: Platform-independent rate and overrun bookkeeping
+     * @var callback: User function run once per period
+     * @var context: User pointer forwarded to the callback
+     * @var timer: Periodic esp_timer handle
+     * @var task: Control task handle
+     * @var running: Whether the timer is currently armed
+     * @var stats_lock: Protects core between the control task and readers on other cores
+     */
+    FixedRateCore core;
+    CycleCallback callback;
+    void *context;
+    esp_timer_handle_t timer;
+    TaskHandle_t task;
+    volatile bool running;
+    mutable portMUX_TYPE stats_lock;
+  };
+
+} // namespace rt
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+
+// Generated by tools/gen_control_tables.py - do not edit by hand
+// python3 tools/gen_control_tables.py
+//
+// Model: y'' = b u, b = 1.05263 pitches/s^2 per count (v = 1 m/s, yaw 0.01 rad/s/count,
+// pitch 0.0095 m); Q = diag(1, 0.0001), R = 1.6e-05
+// MPC: N = 10 moves of 5 periods, condition number 3.1, unconstrained first move
+// u = 235.978 e + 21.3056 e' (LQR: 247.13 e + 21.8095 e')
+
+namespace controller {
+  namespace control_tables {
+
+    /**
+     * @brief Model, observer and LQR constants
+     *
+     * @var DT: Control period the tables are computed for (seconds)
+     * @var MODEL_B: Input column of the discrete model, x[k+1] = A x[k] + B u[k]
+     * @var OBSERVER_L: Steady-state observer gain on the position residual
+     * @var LQR_K: State feedback u = K[0] e + K[1] e'
+     */
+    static constexpr float DT = 0.001f;
+    static constexpr float MODEL_B[2] = {-5.26315789e-07f, -0.00105263158f};
+    static constexpr float OBSERVER_L[2] = {0.0682651456f, 2.41316034f};
+    static constexpr float LQR_K[2] = {247.130114f, 21.8095059f};
+
+    /**
+     * @brief Condensed MPC problem and solver constants
+     *
+     * @var MPC_HORIZON: Moves in the plan
+     * @var MPC_BLOCK: Control periods each move is held
+     * @var MPC_ITERATIONS: Default fast gradient iterations per step
+     * @var MPC_STEP: Gradient step 1 / lambda_max(H)
+     * @var MPC_MOMENTUM: (sqrt(kappa) - 1) / (sqrt(kappa) + 1)
+     * @var MPC_H: Hessian of the plan cost
+     * @var MPC_F: Linear term per state, gradient = H U + F x
+     */
+    static constexpr uint8_t MPC_HORIZON = 10;
+    static constexpr uint8_t MPC_BLOCK = 5;
+    static constexpr uint8_t MPC_ITERATIONS = 20;
+    static constexpr float MPC_STEP = 4057.05892f;
+    static constexpr float MPC_MOMENTUM = 0.274079821f;
+    static constexpr float MPC_H[MPC_HORIZON][MPC_HORIZON] = {
+        {0.000105854349f, 2.45808135e-05f, 2.33107406e-05f, 2.20475929e-05f, 2.07948331e-05f, 1.95559237e-05f, 1.83343273e-05f, 1.71335065e-05f, 1.59569239e-05f, 1.48080422e-05f},
+        {2.45808135e-05f, 0.00010341222f, 2.22306417e-05f, 2.1052526e-05f, 1.98813355e-05f, 1.87205329e-05f, 1.75735807e-05f, 1.64439414e-05f, 1.53350778e-05f, 1.42504525e-05f},
+        {2.33107406e-05f, 2.22306417e-05f, 0.000101150543f, 2.00574591e-05f, 1.8967838e-05f, 1.78851421e-05f, 1.6812834e-05f, 1.57543764e-05f, 1.47132318e-05f, 1.36928628e-05f},
+        {2.20475929e-05f, 2.1052526e-05f, 2.00574591e-05f, 9.90623921e-05f, 1.80543404e-05f, 1.70497513e-05f, 1.60520874e-05f, 1.50648114e-05f, 1.40913857e-05f, 1.31352731e-05f},
+        {2.07948331e-05f, 1.98813355e-05f, 1.8967838e-05f, 1.80543404e-05f, 9.71408429e-05f, 1.62143605e-05f, 1.52913408e-05f, 1.43752463e-05f, 1.34695396e-05f, 1.25776833e-05f},
+        {1.95559237e-05f, 1.87205329e-05f, 1.78851421e-05f, 1.70497513e-05f, 1.62143605e-05f, 9.53789698e-05f, 1.45305942e-05f, 1.36856813e-05f, 1.28476936e-05f, 1.20200936e-05f},
+        {1.83343273e-05f, 1.75735807e-05f, 1.6812834e-05f, 1.60520874e-05f, 1.52913408e-05f, 1.45305942e-05f, 9.37698476e-05f, 1.29961163e-05f, 1.22258475e-05f, 1.14625039e-05f},
+        {1.71335065e-05f, 1.64439414e-05f, 1.57543764e-05f, 1.50648114e-05f, 1.43752463e-05f, 1.36856813e-05f, 1.29961163e-05f, 9.23065512e-05f, 1.16040014e-05f, 1.09049142e-05f},
+        {1.59569239e-05f, 1.53350778e-05f, 1.47132318e-05f, 1.40913857e-05f, 1.34695396e-05f, 1.28476936e-05f, 1.22258475e-05f, 1.16040014e-05f, 9.09821553e-05f, 1.03473245e-05f},
+        {1.48080422e-05f, 1.42504525e-05f, 1.36928628e-05f, 1.31352731e-05f, 1.25776833e-05f, 1.20200936e-05f, 1.14625039e-05f, 1.09049142e-05f, 1.03473245e-05f, 8.97897348e-05f},
+    };
+    static constexpr float MPC_F[MPC_HORIZON][2] = {
+        {-0.0479009267f, -0.00503207861f},
+        {-0.0444065534f, -0.00478137094f},
+        {-0.041043759f, -0.00453165011f},
+        {-0.0378125436f, -0.00428357402f},
+        {-0.0347129071f, -0.00403780056f},
+        {-0.0317448496f, -0.00379498762f},
+        {-0.028908371f, -0.00355579311f},
+        {-0.0262034714f, -0.00332087491f},
+        {-0.0236301507f, -0.00309089092f},
+        {-0.021188409f, -0.00286649904f},
+    };
+
+  } // namespace control_tables
+} // namespace controller
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace sensing {
+
+  /**
+   * @brief Line curvature estimate from the recent position history
+   *
+   * Keeps the last WINDOW line positions in a fixed-size ring and fits a
+   * quadratic through them (Savitzky–Golay). The second derivative of the
+   * fit is a weighted sum with the constant weights
+   *
+   *   c_k = k² - m(m+1)/3,   k = -m..m,  m = (WINDOW - 1) / 2
+   *   y'' = 2 × Σ c_k × y_k / (Σ c_k² × h²)
+   *
+   * and dividing by the squared forward speed turns the time derivative
+   * into a curvature along the track (y'' over distance, in position units
+   * per distance²).
+   *
+   * A second difference of raw 1 kHz samples is dominated by sensor noise,
+   * so update() averages `decimation` consecutive positions into one ring
+   * sample; the window then spans WINDOW × decimation control cycles. The
+   * estimate is refreshed once per ring sample and costs WINDOW
+   * multiply-adds there, nothing in the cycles in between.
+   *
+   * The position is measured relative to the robot, so while the
+   * controller is already turning, the estimate only holds the part of the
+   * bend the robot is not yet following. That residual is exactly what a
+   * feed-forward term has to add to stop the lag into corners.
+   *
+   * @tparam WINDOW: Ring size (odd, 3-31)
+   */
+  template <uint8_t WINDOW>
+  class CurvatureEstimator {
+    static_assert(WINDOW >= 3 && WINDOW <= 31 && (WINDOW & 1), "CurvatureEstimator needs an odd window of 3-31");
+
+  public:
+    /**
+     * @brief Construct an estimator
+     *
+     * @param dt_s: Interval between update() calls in seconds
+     * @param decimation: update() calls averaged into one ring sample (>= 1)
+     */
+    explicit CurvatureEstimator(float dt_s = 0.001f, uint8_t decimation = 1)
+        : scale(0.0f), decimation(1), block_sum(0.0f), block_count(0), head(0), filled(0),
+          second_derivative(0.0f) {
+      const int8_t m = WINDOW / 2;
+      const float offset = m * (m + 1) / 3.0f;
+      for (uint8_t i = 0; i < WINDOW; i++) {
+        int8_t k = (int8_t)i - m;
+        weights[i] = k * k - offset;
+      }
+      if (!setSampleTime(dt_s, decimation)) {
+        setSampleTime(0.001f, 1);
+      }
+    }
+
+    /**
+     * @brief Forget the history, e.g. after the line was lost
+     */
+    inline void reset() {
+      block_sum = 0.0f;
+      block_count = 0;
+      head = 0;
+      filled = 0;
+      second_derivative = 0.0f;
+    }
+
+    /**
+     * @brief Set the update interval and the decimation
+     *
+     * Clears the history, as the stored samples no longer match the spacing.
+     *
+     * @param dt_s: Interval between update() calls in seconds (> 0)
+     * @param decimation: update() calls averaged into one ring sample (>= 1)
+     * @return bool true on success, false if a parameter is invalid
+     */
+    inline bool setSampleTime(float dt_s, uint8_t decimation) {
+      if (dt_s <= 0.0f || decimation == 0) {
+        return false;
+      }
+
+      float sum_squares = 0.0f;
+      for (uint8_t i = 0; i < WINDOW; i++) {
+        sum_squares += weights[i] * weights[i];
+      }
+
+      float h = dt_s * decimation;
+      this->decimation = decimation;
+      scale = 2.0f / (sum_squares * h * h);
+      reset();
+      return true;
+    }
+
+    /**
+     * @brief Add one position sample
+     *
+     * @param position: Line position (any unit, e.g. sensor pitches)
+     * @return bool true if the estimate was refreshed by this sample
+     */
+    inline bool update(float position) {
+      block_sum += position;
+      if (++block_count < decimation) {
+        return false;
+      }
+
+      ring[head] = block_sum / decimation;
+      block_sum = 0.0f;
+      block_count = 0;
+      if (++head >= WINDOW) {
+        head = 0;
+      }
+      if (filled < WINDOW) {
+        filled++;
+      }
+      if (filled < WINDOW) {
+        return false;
+      }
+
+      // head now points at the oldest sample, which pairs with weight k = -m
+      float sum = 0.0f;
+      uint8_t index = head;
+      for (uint8_t i = 0; i < WINDOW; i++) {
+        sum += weights[i] * ring[index];
+        if (++index >= WINDOW) {
+          index = 0;
+        }
+      }
+      second_derivative = sum * scale;
+      return true;
+    }
+
+    /**
+     * @brief Check whether the ring is full and the estimate valid
+     *
+     * @return bool true once WINDOW samples have been collected
+     */
+    inline bool isReady() const {
+      return filled >= WINDOW;
+    }
+
+    /**
+     * @brief Get the second time derivative of the position
+     *
+     * @return float Position units per s² (0 until the ring is full)
+     */
+    inline float getSecondDerivative() const {
+      return second_derivative;
+    }
+
+    /**
+     * @brief Get the curvature along the track
+     *
+     * @param speed: Forward speed in distance units per second
+     * @return float Position units per distance² (0 when not moving)
+     */
+    inline float getCurvature(float speed) const {
+      if (speed <= 0.0f) {
+        return 0.0f;
+      }
+      return second_derivative / (speed * speed);
+    }
+
+  private:
+    /**
+     * @brief Estimator state
+     *
+     * @var weights: Savitzky–Golay second-derivative weights, oldest sample first
+     * @var ring: Decimated positions
+     * @var scale: 2 / (Σc² × h²), folds the normalisation and spacing together
+     * @var decimation: update() calls per ring sample
+     * @var block_sum, block_count: Running average of the current ring sample
+     * @var head: Next ring slot (the oldest sample once the ring is full)
+     * @var filled: Valid ring samples
+     * @var second_derivative: Last estimate
+     */
+    float weights[WINDOW];
+    float ring[WINDOW];
+    float scale;
+    uint8_t decimation;
+    float block_sum;
+    uint8_t block_count;
+    uint8_t head;
+    uint8_t filled;
+    float second_derivative;
+  };
+
+} // namespace sensing
@@ -22,6 +22,8 @@
  */
 
 #include "EEPROMCalibrationManager.h"
+#include <stddef.h>
+#include <string.h>
 
 EEPROMCalibrationManager::EEPROMCalibrationManager(uint8_t sensorCount,
                                                    bool debugEnabled,
@@ -34,7 +36,7 @@ EEPROMCalibrationManager::EEPROMCalibrationManager(uint8_t sensorCount,
       initialized_(false),
       lastError_(ErrorCode::SUCCESS) {
 
-  if (debugEnabled_) {
+  if (LOG_DEBUG_ENABLED && debugEnabled_) {
     Serial.println(F("=== CALIBRATION MANAGER INITIALIZATION ==="));
     Serial.print(F("Configuring for "));
     Serial.print(sensorCount);
@@ -48,7 +50,7 @@ EEPROMCalibrationManager::EEPROMCalibrationManager(uint8_t sensorCount,
   if (sensorCount == 0 || sensorCount > MAX_SENSORS) {
     lastError_ = ErrorCode::INVALID_SENSOR_COUNT;
 
-    if (debugEnabled_) {
+    if (LOG_DEBUG_ENABLED && debugEnabled_) {
       Serial.print(F("ERROR: Invalid sensor count "));
       Serial.print(sensorCount);
       Serial.print(F(". Must be 1-"));
@@ -63,7 +65,7 @@ EEPROMCalibrationManager::EEPROMCalibrationManager(uint8_t sensorCount,
   // Calculate and Validate Storage Requirements
   uint16_t requiredSize = calculateStorageSize(sensorCount);
 
-  if (debugEnabled_) {
+  if (LOG_DEBUG_ENABLED && debugEnabled_) {
     Serial.print(F("Required storage space: "));
     Serial.print(requiredSize);
     Serial.println(F(" bytes"));
@@ -76,7 +78,7 @@ EEPROMCalibrationManager::EEPROMCalibrationManager(uint8_t sensorCount,
   if (startAddress + requiredSize > eepromSize) {
     lastError_ = ErrorCode::INSUFFICIENT_SPACE;
 
-    if (debugEnabled_) {
+    if (LOG_DEBUG_ENABLED && debugEnabled_) {
       Serial.print(F("ERROR: Insufficient EEPROM space"));
       Serial.print(F("Need "));
       Serial.print(requiredSize);
@@ -114,7 +116,7 @@ EEPROMCalibrationManager::EEPROMCalibrationManager(uint8_t sensorCount,
     initialized_ = true;
     lastError_ = ErrorCode::SUCCESS;
 
-    if (debugEnabled_) {
+    if (LOG_DEBUG_ENABLED && debugEnabled_) {
       Serial.println(F("✓ EEPROM accessibility test passed"));
       Serial.print(F("✓ Calibration manager ready with "));
       Serial.print(eepromSize_);
@@ -133,7 +135,7 @@ EEPROMCalibrationManager::EEPROMCalibrationManager(uint8_t sensorCount,
     // EEPROM is not accessible - likely not initialized at system level
     lastError_ = ErrorCode::EEPROM_NOT_READY;
 
-    if (debugEnabled_) {
+    if (LOG_DEBUG_ENABLED && debugEnabled_) {
       Serial.println(F("✗ EEPROM accessibility test failed"));
       Serial.println(F("This usually means:"));
       Serial.println(F("  1. EEPROM.begin() was not called at system level"));
@@ -142,10 +144,30 @@ EEPROMCalibrationManager::EEPROMCalibrationManager(uint8_t sensorCount,
       Serial.println(F("Solution: Ensure EEPROM.begin() succeeds before creating calibration manager"));
     }
   }
+
+  /**
+   * Format Migration:
+   *
+   * A robot updated from the fixed 8-sensor firmware still holds a version 2
+   * record. Rewriting it once here keeps the calibration across the update,
+   * and every other method only ever sees the current layout.
+   */
+  if (initialized_ && EEPROM.read(startAddress_ + 2) == LEGACY_CALIBRATION_VERSION) {
+    ErrorCode migration = migrateLegacyCalibration();
+
+    if (LOG_DEBUG_ENABLED && debugEnabled_) {
+      if (migration == ErrorCode::SUCCESS) {
+        Serial.println(F("✓ Version 2 calibration migrated to the variable-length format"));
+      } else if (migration != ErrorCode::MAGIC_NUMBER_MISMATCH) {
+        Serial.print(F("⚠ Version 2 calibration could not be migrated: "));
+        Serial.println(getErrorDescription(migration));
+      }
+    }
+  }
 }
 
 EEPROMCalibrationManager::~EEPROMCalibrationManager() {
-  if (debugEnabled_ && initialized_) {
+  if (LOG_DEBUG_ENABLED && debugEnabled_ && initialized_) {
     debugPrint(F("Calibration manager destructor - clean shutdown"));
   }
 }
@@ -164,7 +186,7 @@ bool EEPROMCalibrationManager::saveCalibration(const QTRSensors &qtr) {
   // Input Validation
   bool hasValidData = false;
   uint8_t validSensorCount = 0;
-  uint16_t totalCalibrationRange = 0;
+  uint32_t totalCalibrationRange = 0; // 31 sensors × 4095 overflows 16 bits
 
   for (uint8_t i = 0; i < sensorCount_; i++) {
     uint16_t minVal = qtr.calibrationOn.minimum[i];
@@ -175,7 +197,7 @@ bool EEPROMCalibrationManager::saveCalibration(const QTRSensors &qtr) {
       hasValidData = true;
       validSensorCount++;
       totalCalibrationRange += (maxVal - minVal);
-    } else if (debugEnabled_) {
+    } else if (LOG_DEBUG_ENABLED && debugEnabled_) {
       Serial.print(F("WARNING: Sensor "));
       Serial.print(i);
       Serial.print(F(" has invalid range: min="));
@@ -192,14 +214,14 @@ bool EEPROMCalibrationManager::saveCalibration(const QTRSensors &qtr) {
     return false;
   }
 
-  if (debugEnabled_) {
+  if (LOG_DEBUG_ENABLED && debugEnabled_) {
     Serial.print(F("Validated calibration data for "));
     Serial.print(validSensorCount);
     Serial.print(F("/"));
     Serial.print(sensorCount_);
     Serial.println(F(" sensors"));
 
-    uint16_t avgRange = totalCalibrationRange / validSensorCount;
+    uint16_t avgRange = (uint16_t)(totalCalibrationRange / validSensorCount);
     Serial.print(F("Average calibration range: "));
     Serial.print(avgRange);
 
@@ -227,39 +249,28 @@ bool EEPROMCalibrationManager::saveCalibration(const QTRSensors &qtr) {
     calData.maximum[i] = qtr.calibrationOn.maximum[i];
   }
 
-  // Zero unused sensor slots for consistent checksum calculation
-  // This ensures that future sensor count changes don't invalidate checksums
-  for (uint8_t i = sensorCount_; i < MAX_SENSORS; i++) {
-    calData.minimum[i] = 0;
-    calData.maximum[i] = 0;
-  }
-
   // Calculate Data Integrity Checksum
   // Checksum must be calculated AFTER all other fields are set
-  calData.checksum = calculateChecksum(&calData);
+  calData.checksum = calculateChecksum(&calData, sensorCount_);
 
-  if (debugEnabled_) {
-    Serial.print(F("Data structure prepared ("));
-    Serial.print(sizeof(CalibrationData));
+  size_t dataSize = calculateStorageSize(sensorCount_);
+
+  if (LOG_DEBUG_ENABLED && debugEnabled_) {
+    Serial.print(F("Data record prepared ("));
+    Serial.print(dataSize);
     Serial.print(F(" bytes). Checksum: 0x"));
     Serial.println(calData.checksum, HEX);
   }
 
   // Atomic Write Operation
-  const uint8_t *dataBytes = reinterpret_cast<const uint8_t *>(&calData);
-  size_t dataSize = sizeof(CalibrationData);
-
-  // Write all bytes of the structure sequentially
-  for (size_t i = 0; i < dataSize; i++) {
-    EEPROM.write(startAddress_ + i, dataBytes[i]);
-  }
+  writeCalibrationData(&calData);
 
   // Commit to Persistent Storage
   if (!EEPROM.commit()) {
     lastError_ = ErrorCode::EEPROM_COMMIT_FAILED;
     debugPrint(F("ERROR: Failed to commit EEPROM changes to flash memory"));
 
-    if (debugEnabled_) {
+    if (LOG_DEBUG_ENABLED && debugEnabled_) {
       Serial.println(F("This may indicate:"));
       Serial.println(F("  1. Flash memory wear-out or hardware issues"));
       Serial.println(F("  2. Power supply instability"));
@@ -277,7 +288,7 @@ bool EEPROMCalibrationManager::saveCalibration(const QTRSensors &qtr) {
   if (loadResult != ErrorCode::SUCCESS) {
     lastError_ = ErrorCode::VERIFICATION_FAILED;
 
-    if (debugEnabled_) {
+    if (LOG_DEBUG_ENABLED && debugEnabled_) {
       Serial.print(F("ERROR: Verification read failed: "));
       Serial.println(getErrorDescription(loadResult));
     }
@@ -292,7 +303,7 @@ bool EEPROMCalibrationManager::saveCalibration(const QTRSensors &qtr) {
 
     lastError_ = ErrorCode::VERIFICATION_FAILED;
 
-    if (debugEnabled_) {
+    if (LOG_DEBUG_ENABLED && debugEnabled_) {
       Serial.println(F("ERROR: Verification failed - data mismatch detected"));
       Serial.print(F("Expected checksum: 0x"));
       Serial.print(calData.checksum, HEX);
@@ -305,7 +316,7 @@ bool EEPROMCalibrationManager::saveCalibration(const QTRSensors &qtr) {
   // Success! Update status and provide comprehensive feedback
   lastError_ = ErrorCode::SUCCESS;
 
-  if (debugEnabled_) {
+  if (LOG_DEBUG_ENABLED && debugEnabled_) {
     Serial.println(F("✓ Calibration saved successfully to EEPROM"));
     Serial.print(F("  Storage used: "));
     Serial.print(dataSize);
@@ -336,7 +347,7 @@ bool EEPROMCalibrationManager::loadCalibration(QTRSensors &qtr) {
   if (result != ErrorCode::SUCCESS) {
     lastError_ = result;
 
-    if (debugEnabled_) {
+    if (LOG_DEBUG_ENABLED && debugEnabled_) {
       Serial.print(F("Data validation failed: "));
       Serial.println(getErrorDescription(result));
     }
@@ -353,7 +364,7 @@ bool EEPROMCalibrationManager::loadCalibration(QTRSensors &qtr) {
 
   lastError_ = ErrorCode::SUCCESS;
 
-  if (debugEnabled_) {
+  if (LOG_DEBUG_ENABLED && debugEnabled_) {
     Serial.println(F("✓ Calibration loaded and applied to QTR sensors"));
     Serial.print(F("  Data format version: "));
     Serial.println(calData.version);
@@ -365,11 +376,11 @@ bool EEPROMCalibrationManager::loadCalibration(QTRSensors &qtr) {
     Serial.println(F(")"));
 
     // Calculate and display calibration quality metrics
-    uint16_t totalRange = 0;
+    uint32_t totalRange = 0;
     for (uint8_t i = 0; i < sensorCount_; i++) {
       totalRange += (calData.maximum[i] - calData.minimum[i]);
     }
-    uint16_t avgRange = totalRange / sensorCount_;
+    uint16_t avgRange = (uint16_t)(totalRange / sensorCount_);
     Serial.print(F("  Calibration quality: Average range "));
     Serial.print(avgRange);
     Serial.println(avgRange > 1000 ? F(" (Excellent)") : avgRange > 500 ? F(" (Good)")
@@ -400,7 +411,7 @@ bool EEPROMCalibrationManager::clearCalibration() {
   debugPrint(F("=== CALIBRATION CLEAR OPERATION STARTED ==="));
 
   // Overwrite entire calibration data area with zeros
-  size_t clearSize = sizeof(CalibrationData);
+  size_t clearSize = calculateStorageSize(sensorCount_);
   for (size_t i = 0; i < clearSize; i++) {
     EEPROM.write(startAddress_ + i, 0);
   }
@@ -414,7 +425,7 @@ bool EEPROMCalibrationManager::clearCalibration() {
 
   lastError_ = ErrorCode::SUCCESS;
 
-  if (debugEnabled_) {
+  if (LOG_DEBUG_ENABLED && debugEnabled_) {
     Serial.println(F("✓ Calibration data securely cleared from EEPROM"));
     Serial.print(F("  Erased: "));
     Serial.print(clearSize);
@@ -509,15 +520,18 @@ void EEPROMCalibrationManager::reportSystemStatus() {
   Serial.print(sensorCount_);
   Serial.println(F(" sensors"));
 
-  Serial.print(F("Structure Size: "));
-  Serial.print(sizeof(CalibrationData));
-  Serial.println(F(" bytes"));
+  uint16_t recordSize = calculateStorageSize(sensorCount_);
+  Serial.print(F("Record Size: "));
+  Serial.print(recordSize);
+  Serial.print(F(" bytes (format v"));
+  Serial.print(CALIBRATION_VERSION);
+  Serial.println(F(")"));
 
   // Analyze storage efficiency and capacity
   Serial.print(F("Storage Analysis: "));
-  if (sizeof(CalibrationData) <= eepromSize_) {
-    uint16_t freeSpace = eepromSize_ - sizeof(CalibrationData);
-    float efficiency = (float)sizeof(CalibrationData) / eepromSize_ * 100.0f;
+  if (recordSize <= eepromSize_) {
+    uint16_t freeSpace = eepromSize_ - recordSize;
+    float efficiency = (float)recordSize / eepromSize_ * 100.0f;
 
     Serial.print(F("✓ ADEQUATE ("));
     Serial.print(efficiency, 1);
@@ -526,7 +540,7 @@ void EEPROMCalibrationManager::reportSystemStatus() {
     Serial.println(F(" bytes free)"));
   } else {
     Serial.print(F("✗ INSUFFICIENT (need "));
-    Serial.print(sizeof(CalibrationData) - eepromSize_);
+    Serial.print(recordSize - eepromSize_);
     Serial.println(F(" more bytes)"));
   }
 
@@ -573,18 +587,41 @@ EEPROMCalibrationManager::ErrorCode EEPROMCalibrationManager::loadCalibrationDat
     return ErrorCode::NULL_POINTER_ERROR;
   }
 
-  // Read raw binary data from EEPROM
+  // Read the fixed header first: the sensor count gives the record length
   uint8_t *dataBytes = reinterpret_cast<uint8_t *>(data);
-  size_t dataSize = sizeof(CalibrationData);
+  memset(dataBytes, 0, sizeof(CalibrationData));
 
-  for (size_t i = 0; i < dataSize; i++) {
+  for (uint16_t i = 0; i < CALIBRATION_HEADER_SIZE; i++) {
     dataBytes[i] = EEPROM.read(startAddress_ + i);
   }
 
+  // Only a current-format record of a plausible length has a body to read;
+  // anything else is rejected by the header layers of the validation
+  uint8_t storedCount = data->sensorCount;
+  if (data->magic == CALIBRATION_MAGIC && data->version == CALIBRATION_VERSION &&
+      storedCount >= 1 && storedCount <= MAX_SENSORS &&
+      startAddress_ + calculateStorageSize(storedCount) <= eepromSize_) {
+
+    uint16_t address = startAddress_ + CALIBRATION_HEADER_SIZE;
+    uint8_t *minimumBytes = dataBytes + offsetof(CalibrationData, minimum);
+    uint8_t *maximumBytes = dataBytes + offsetof(CalibrationData, maximum);
+    uint8_t *checksumBytes = dataBytes + offsetof(CalibrationData, checksum);
+
+    for (uint16_t i = 0; i < storedCount * sizeof(uint16_t); i++) {
+      minimumBytes[i] = EEPROM.read(address++);
+    }
+    for (uint16_t i = 0; i < storedCount * sizeof(uint16_t); i++) {
+      maximumBytes[i] = EEPROM.read(address++);
+    }
+    for (uint16_t i = 0; i < sizeof(uint32_t); i++) {
+      checksumBytes[i] = EEPROM.read(address++);
+    }
+  }
+
   // Validate the loaded data using comprehensive validation
   ErrorCode validationResult = validateCalibrationData(data);
 
-  if (validationResult != ErrorCode::SUCCESS && debugEnabled_) {
+  if (validationResult != ErrorCode::SUCCESS && LOG_DEBUG_ENABLED && debugEnabled_) {
     Serial.print(F("Data validation failed during load: "));
     Serial.println(getErrorDescription(validationResult));
   }
@@ -592,6 +629,110 @@ EEPROMCalibrationManager::ErrorCode EEPROMCalibrationManager::loadCalibrationDat
   return validationResult;
 }
 
+void EEPROMCalibrationManager::writeCalibrationData(const CalibrationData *data) {
+  /**
+   * Variable-Length Serialization:
+   *
+   * The mirror image of loadCalibrationData(): header, the used part of
+   * each array, checksum. Nothing beyond the record is touched, so the
+   * gain schedule block behind it survives a calibration save.
+   */
+
+  const uint8_t *dataBytes = reinterpret_cast<const uint8_t *>(data);
+  const uint8_t *minimumBytes = dataBytes + offsetof(CalibrationData, minimum);
+  const uint8_t *maximumBytes = dataBytes + offsetof(CalibrationData, maximum);
+  const uint8_t *checksumBytes = dataBytes + offsetof(CalibrationData, checksum);
+  uint16_t address = startAddress_;
+
+  for (uint16_t i = 0; i < CALIBRATION_HEADER_SIZE; i++) {
+    EEPROM.write(address++, dataBytes[i]);
+  }
+  for (uint16_t i = 0; i < data->sensorCount * sizeof(uint16_t); i++) {
+    EEPROM.write(address++, minimumBytes[i]);
+  }
+  for (uint16_t i = 0; i < data->sensorCount * sizeof(uint16_t); i++) {
+    EEPROM.write(address++, maximumBytes[i]);
+  }
+  for (uint16_t i = 0; i < sizeof(uint32_t); i++) {
+    EEPROM.write(address++, checksumBytes[i]);
+  }
+}
+
+EEPROMCalibrationManager::ErrorCode EEPROMCalibrationManager::migrateLegacyCalibration() {
+  /**
+   * Version 2 to Version 3 Migration:
+   *
+   * The legacy record is validated with the rules it was written under
+   * (fixed 8 slots, checksum over all of them) before anything is
+   * rewritten, so a corrupt record is never promoted to a valid one.
+   */
+
+  if (startAddress_ + sizeof(LegacyCalibrationData) > eepromSize_) {
+    return ErrorCode::INSUFFICIENT_SPACE;
+  }
+
+  LegacyCalibrationData legacy;
+  uint8_t *legacyBytes = reinterpret_cast<uint8_t *>(&legacy);
+  for (size_t i = 0; i < sizeof(LegacyCalibrationData); i++) {
+    legacyBytes[i] = EEPROM.read(startAddress_ + i);
+  }
+
+  if (legacy.magic != CALIBRATION_MAGIC) {
+    return ErrorCode::MAGIC_NUMBER_MISMATCH;
+  }
+  if (legacy.version != LEGACY_CALIBRATION_VERSION) {
+    return ErrorCode::VERSION_MISMATCH;
+  }
+  if (legacy.sensorCount != sensorCount_ || legacy.sensorCount > LEGACY_MAX_SENSORS) {
+    return ErrorCode::SENSOR_COUNT_MISMATCH;
+  }
+
+  // Same checksum routine, over the 8 slots the old format always summed
+  CalibrationData calData = {};
+  calData.magic = legacy.magic;
+  calData.version = legacy.version;
+  calData.sensorCount = legacy.sensorCount;
+  for (uint8_t i = 0; i < LEGACY_MAX_SENSORS; i++) {
+    calData.minimum[i] = legacy.minimum[i];
+    calData.maximum[i] = legacy.maximum[i];
+  }
+
+  if (calculateChecksum(&calData, LEGACY_MAX_SENSORS) != legacy.checksum) {
+    return ErrorCode::CHECKSUM_FAILED;
+  }
+
+  // The gain schedule sat behind the fixed 40 bytes; with fewer than 8
+  // sensors the new record is shorter and the block moves up
+  uint16_t legacyScheduleAddress = startAddress_ + sizeof(LegacyCalibrationData);
+  GainScheduleData schedule;
+  bool moveSchedule = legacyScheduleAddress != gainScheduleAddress() &&
+                      readGainScheduleData(&schedule, legacyScheduleAddress) == ErrorCode::SUCCESS;
+
+  calData.version = CALIBRATION_VERSION;
+  calData.checksum = calculateChecksum(&calData, calData.sensorCount);
+
+  ErrorCode semantic = validateCalibrationData(&calData);
+  if (semantic != ErrorCode::SUCCESS) {
+    return semantic;
+  }
+
+  writeCalibrationData(&calData);
+
+  if (moveSchedule) {
+    const uint8_t *scheduleBytes = reinterpret_cast<const uint8_t *>(&schedule);
+    uint16_t address = gainScheduleAddress();
+    for (size_t i = 0; i < sizeof(GainScheduleData); i++) {
+      EEPROM.write(address + i, scheduleBytes[i]);
+    }
+  }
+
+  if (!EEPROM.commit()) {
+    return ErrorCode::EEPROM_COMMIT_FAILED;
+  }
+
+  return ErrorCode::SUCCESS;
+}
+
 EEPROMCalibrationManager::ErrorCode EEPROMCalibrationManager::validateCalibrationData(const CalibrationData *data) const {
   /**
    * Multi-Layer Validation:
@@ -607,7 +748,7 @@ EEPROMCalibrationManager::ErrorCode EEPROMCalibrationManager::validateCalibratio
   // Layer 1: Magic Number Validation
   // Quick check to determine if this looks like calibration data at all
   if (data->magic != CALIBRATION_MAGIC) {
-    if (debugEnabled_) {
+    if (LOG_DEBUG_ENABLED && debugEnabled_) {
       Serial.print(F("Magic number validation failed: found 0x"));
       Serial.print(data->magic, HEX);
       Serial.print(F(", expected 0x"));
@@ -619,7 +760,7 @@ EEPROMCalibrationManager::ErrorCode EEPROMCalibrationManager::validateCalibratio
   // Layer 2: Version Compatibility Check
   // Ensures data format is compatible with current code
   if (data->version != CALIBRATION_VERSION) {
-    if (debugEnabled_) {
+    if (LOG_DEBUG_ENABLED && debugEnabled_) {
       Serial.print(F("Version compatibility failed: stored v"));
       Serial.print(data->version);
       Serial.print(F(", current v"));
@@ -631,7 +772,7 @@ EEPROMCalibrationManager::ErrorCode EEPROMCalibrationManager::validateCalibratio
   // Layer 3: Hardware Compatibility Check
   // Ensures stored data matches current sensor configuration
   if (data->sensorCount != sensorCount_) {
-    if (debugEnabled_) {
+    if (LOG_DEBUG_ENABLED && debugEnabled_) {
       Serial.print(F("Sensor count mismatch: stored "));
       Serial.print(data->sensorCount);
       Serial.print(F(" sensors, hardware configured for "));
@@ -643,14 +784,10 @@ EEPROMCalibrationManager::ErrorCode EEPROMCalibrationManager::validateCalibratio
   // Layer 4: Data Integrity Verification
   // Checksum validation to detect any corruption
   uint32_t storedChecksum = data->checksum;
-
-  // Create temporary copy to calculate checksum (checksum field must be zero)
-  CalibrationData tempData = *data;
-  tempData.checksum = 0;
-  uint32_t calculatedChecksum = calculateChecksum(&tempData);
+  uint32_t calculatedChecksum = calculateChecksum(data, data->sensorCount);
 
   if (storedChecksum != calculatedChecksum) {
-    if (debugEnabled_) {
+    if (LOG_DEBUG_ENABLED && debugEnabled_) {
       Serial.print(F("Checksum validation failed: stored 0x"));
       Serial.print(storedChecksum, HEX);
       Serial.print(F(", calculated 0x"));
@@ -664,7 +801,7 @@ EEPROMCalibrationManager::ErrorCode EEPROMCalibrationManager::validateCalibratio
   for (uint8_t i = 0; i < sensorCount_; i++) {
     // Validate calibration range makes sense
     if (data->minimum[i] >= data->maximum[i]) {
-      if (debugEnabled_) {
+      if (LOG_DEBUG_ENABLED && debugEnabled_) {
         Serial.print(F("Invalid calibration range for sensor "));
         Serial.print(i);
         Serial.print(F(": min="));
@@ -677,7 +814,7 @@ EEPROMCalibrationManager::ErrorCode EEPROMCalibrationManager::validateCalibratio
 
     // Validate values are within ESP32 ADC range (12-bit: 0-4095)
     if (data->maximum[i] > 4095) {
-      if (debugEnabled_) {
+      if (LOG_DEBUG_ENABLED && debugEnabled_) {
         Serial.print(F("Sensor "));
         Serial.print(i);
         Serial.print(F(" max value ("));
@@ -692,7 +829,7 @@ EEPROMCalibrationManager::ErrorCode EEPROMCalibrationManager::validateCalibratio
   return ErrorCode::SUCCESS;
 }
 
-uint32_t EEPROMCalibrationManager::calculateChecksum(const CalibrationData *data) const {
+uint32_t EEPROMCalibrationManager::calculateChecksum(const CalibrationData *data, uint8_t slots) const {
   /**
    * Checksum Algorithm:
    *
@@ -717,9 +854,11 @@ uint32_t EEPROMCalibrationManager::calculateChecksum(const CalibrationData *data
   checksum += data->sensorCount;
   checksum = (checksum << 1) | (checksum >> 31);
 
-  // Include all sensor calibration data
-  // Process the entire arrays to ensure consistent behavior
-  for (uint8_t i = 0; i < MAX_SENSORS; i++) {
+  // Include the stored sensor calibration data
+  if (slots > MAX_SENSORS) {
+    slots = MAX_SENSORS;
+  }
+  for (uint8_t i = 0; i < slots; i++) {
     checksum += data->minimum[i];
     checksum = (checksum << 1) | (checksum >> 31);
 
@@ -730,19 +869,15 @@ uint32_t EEPROMCalibrationManager::calculateChecksum(const CalibrationData *data
   return checksum;
 }
 
-void EEPROMCalibrationManager::debugPrint(const String &message) const {
+void EEPROMCalibrationManager::debugPrefix() const {
   /**
    * Centralized Debug Output:
    *
-   * This method provides consistent debug message formatting and uses
-   * the F() macro to store format strings in flash memory rather than
-   * RAM. This memory efficiency is crucial in embedded systems.
+   * Every debug line starts with the same tag so the calibration manager's
+   * output is easy to pick out of the combined serial log.
    */
 
-  if (debugEnabled_) {
-    Serial.print(F("[EEPROMCalibMgr] "));
-    Serial.println(message);
-  }
+  Serial.print(F("[EEPROMCalibMgr] "));
 }
 
 void EEPROMCalibrationManager::displayCalibrationData(const CalibrationData *data) const {
@@ -755,7 +890,7 @@ void EEPROMCalibrationManager::displayCalibrationData(const CalibrationData *dat
    */
 
   if (data == nullptr) {
-    Serial.println(F("ERROR: Cannot display null calibration data"));
+    LOG_ERROR(F("ERROR: Cannot display null calibration data"));
     return;
   }
 
@@ -812,7 +947,7 @@ void EEPROMCalibrationManager::displayCalibrationData(const CalibrationData *dat
 
   // Calculate and display calibration quality metrics
   Serial.print(F("    Range:   "));
-  uint16_t totalRange = 0;
+  uint32_t totalRange = 0;
   for (uint8_t i = 0; i < sensorCount_; i++) {
     uint16_t range = data->maximum[i] - data->minimum[i];
     totalRange += range;
@@ -828,7 +963,7 @@ void EEPROMCalibrationManager::displayCalibrationData(const CalibrationData *dat
   Serial.println();
 
   // Provide calibration quality assessment
-  uint16_t avgRange = totalRange / sensorCount_;
+  uint16_t avgRange = (uint16_t)(totalRange / sensorCount_);
   Serial.print(F("  Quality Assessment: Average range = "));
   Serial.print(avgRange);
 
@@ -863,7 +998,7 @@ String EEPROMCalibrationManager::getErrorDescription(ErrorCode error) const {
     return F("EEPROM system not initialized - call EEPROM.begin() at system level first");
 
   case ErrorCode::INVALID_SENSOR_COUNT:
-    return F("Invalid sensor count (must be 1-16) - check constructor parameters");
+    return F("Invalid sensor count (must be 1-32) - check constructor parameters");
 
   case ErrorCode::INSUFFICIENT_SPACE:
     return F("Insufficient EEPROM space for calibration data - increase EEPROM allocation");
@@ -914,15 +1049,221 @@ uint16_t EEPROMCalibrationManager::calculateStorageSize(uint8_t sensorCount) {
    * Storage Size Calculation:
    *
    * This method calculates the exact EEPROM space needed for calibration data.
-   * The calculation is based on optimized structure design that uses
-   * exactly 40 bytes regardless of sensor count (up to 8 sensors).
-   *
-   * This fixed-size approach simplifies memory management and provides
-   * consistent performance characteristics across different configurations.
+   * The record stores a minimum and a maximum per sensor between the
+   * 4-byte header and the 4-byte checksum, so 8 sensors still take the
+   * 40 bytes of the old fixed format and 32 sensors take 136.
    */
 
-  // Optimized structure always uses exactly 40 bytes
-  // This design choice simplifies memory management and provides
-  // room for future expansion within the same footprint
-  return sizeof(CalibrationData);
-}
\ No newline at end of file
+  return CALIBRATION_HEADER_SIZE + (uint16_t)sensorCount * 2 * sizeof(uint16_t) + sizeof(uint32_t);
+}
+
+uint16_t EEPROMCalibrationManager::calculateGainScheduleSize() {
+  return sizeof(GainScheduleData);
+}
+
+uint16_t EEPROMCalibrationManager::gainScheduleAddress() const {
+  // Directly behind the calibration record, whose length follows the sensor count
+  return startAddress_ + calculateStorageSize(sensorCount_);
+}
+
+bool EEPROMCalibrationManager::saveGainSchedule(const controller::GainSchedule &schedule) {
+  if (!initialized_) {
+    lastError_ = ErrorCode::EEPROM_NOT_READY;
+    debugPrint(F("Gain schedule save failed: Manager not properly initialized"));
+    return false;
+  }
+
+  uint16_t address = gainScheduleAddress();
+  if (address + sizeof(GainScheduleData) > eepromSize_) {
+    lastError_ = ErrorCode::INSUFFICIENT_SPACE;
+    debugPrint(F("Gain schedule save failed: EEPROM allocation too small"));
+    return false;
+  }
+
+  debugPrint(F("=== GAIN SCHEDULE SAVE OPERATION STARTED ==="));
+
+  // Prepare the block from the schedule's raw Q16.16 words
+  GainScheduleData data;
+  data.magic = GAIN_SCHEDULE_MAGIC;
+  data.version = GAIN_SCHEDULE_VERSION;
+  data.speedPoints = controller::GainSchedule::SPEED_POINTS;
+  data.curvaturePoints = controller::GainSchedule::CURVATURE_POINTS;
+
+  for (uint8_t s = 0; s < controller::GainSchedule::SPEED_POINTS; s++) {
+    data.speedAxis[s] = schedule.getSpeedAxis()[s].raw;
+  }
+  for (uint8_t c = 0; c < controller::GainSchedule::CURVATURE_POINTS; c++) {
+    data.curvatureAxis[c] = schedule.getCurvatureAxis()[c].raw;
+  }
+
+  uint16_t word = 0;
+  for (uint8_t s = 0; s < controller::GainSchedule::SPEED_POINTS; s++) {
+    for (uint8_t c = 0; c < controller::GainSchedule::CURVATURE_POINTS; c++) {
+      const controller::GainSchedule::Gains &entry = schedule.getEntry(s, c);
+      data.gains[word++] = entry.Kp.raw;
+      data.gains[word++] = entry.Ki.raw;
+      data.gains[word++] = entry.Kd.raw;
+    }
+  }
+
+  data.checksum = calculateGainScheduleChecksum(&data);
+
+  const uint8_t *dataBytes = reinterpret_cast<const uint8_t *>(&data);
+  for (size_t i = 0; i < sizeof(GainScheduleData); i++) {
+    EEPROM.write(address + i, dataBytes[i]);
+  }
+
+  if (!EEPROM.commit()) {
+    lastError_ = ErrorCode::EEPROM_COMMIT_FAILED;
+    debugPrint(F("ERROR: Failed to commit gain schedule to flash memory"));
+    return false;
+  }
+
+  // Verification by read-back
+  GainScheduleData verifyData;
+  ErrorCode loadResult = loadGainScheduleData(&verifyData);
+  if (loadResult != ErrorCode::SUCCESS || verifyData.checksum != data.checksum) {
+    lastError_ = ErrorCode::VERIFICATION_FAILED;
+    debugPrint(F("ERROR: Gain schedule verification failed"));
+    return false;
+  }
+
+  lastError_ = ErrorCode::SUCCESS;
+
+  if (LOG_DEBUG_ENABLED && debugEnabled_) {
+    Serial.println(F("✓ Gain schedule saved successfully to EEPROM"));
+    Serial.print(F("  Storage used: "));
+    Serial.print(sizeof(GainScheduleData));
+    Serial.print(F(" bytes at address "));
+    Serial.println(address);
+  }
+
+  return true;
+}
+
+bool EEPROMCalibrationManager::loadGainSchedule(controller::GainSchedule &schedule) {
+  if (!initialized_) {
+    lastError_ = ErrorCode::EEPROM_NOT_READY;
+    debugPrint(F("Gain schedule load failed: Manager not properly initialized"));
+    return false;
+  }
+
+  GainScheduleData data;
+  ErrorCode result = loadGainScheduleData(&data);
+  if (result != ErrorCode::SUCCESS) {
+    lastError_ = result;
+    return false;
+  }
+
+  controller::GainSchedule::Value speedAxis[controller::GainSchedule::SPEED_POINTS];
+  controller::GainSchedule::Value curvatureAxis[controller::GainSchedule::CURVATURE_POINTS];
+  controller::GainSchedule::Gains entries[controller::GainSchedule::SPEED_POINTS *
+                                          controller::GainSchedule::CURVATURE_POINTS];
+
+  for (uint8_t s = 0; s < controller::GainSchedule::SPEED_POINTS; s++) {
+    speedAxis[s].raw = data.speedAxis[s];
+  }
+  for (uint8_t c = 0; c < controller::GainSchedule::CURVATURE_POINTS; c++) {
+    curvatureAxis[c].raw = data.curvatureAxis[c];
+  }
+
+  uint16_t word = 0;
+  for (uint16_t i = 0; i < controller::GainSchedule::SPEED_POINTS * controller::GainSchedule::CURVATURE_POINTS; i++) {
+    entries[i].Kp.raw = data.gains[word++];
+    entries[i].Ki.raw = data.gains[word++];
+    entries[i].Kd.raw = data.gains[word++];
+  }
+
+  // A checksummed block with a non-increasing axis is still unusable
+  if (!schedule.restore(speedAxis, curvatureAxis, entries)) {
+    lastError_ = ErrorCode::INVALID_CALIBRATION_RANGE;
+    debugPrint(F("Gain schedule load failed: Stored axes are not increasing"));
+    return false;
+  }
+
+  lastError_ = ErrorCode::SUCCESS;
+  debugPrint(F("✓ Gain schedule loaded successfully"));
+  return true;
+}
+
+bool EEPROMCalibrationManager::hasValidGainSchedule() {
+  if (!initialized_) {
+    return false;
+  }
+
+  GainScheduleData data;
+  return loadGainScheduleData(&data) == ErrorCode::SUCCESS;
+}
+
+EEPROMCalibrationManager::ErrorCode EEPROMCalibrationManager::loadGainScheduleData(GainScheduleData *data) {
+  return readGainScheduleData(data, gainScheduleAddress());
+}
+
+EEPROMCalibrationManager::ErrorCode EEPROMCalibrationManager::readGainScheduleData(GainScheduleData *data,
+                                                                                  uint16_t address) {
+  if (data == nullptr) {
+    debugPrint(F("INTERNAL ERROR: readGainScheduleData called with null pointer"));
+    return ErrorCode::NULL_POINTER_ERROR;
+  }
+
+  if (address + sizeof(GainScheduleData) > eepromSize_) {
+    return ErrorCode::INSUFFICIENT_SPACE;
+  }
+
+  uint8_t *dataBytes = reinterpret_cast<uint8_t *>(data);
+  for (size_t i = 0; i < sizeof(GainScheduleData); i++) {
+    dataBytes[i] = EEPROM.read(address + i);
+  }
+
+  // Same layers as the calibration data: signature, format, integrity
+  if (data->magic != GAIN_SCHEDULE_MAGIC) {
+    return ErrorCode::MAGIC_NUMBER_MISMATCH;
+  }
+
+  if (data->version != GAIN_SCHEDULE_VERSION ||
+      data->speedPoints != controller::GainSchedule::SPEED_POINTS ||
+      data->curvaturePoints != controller::GainSchedule::CURVATURE_POINTS) {
+    return ErrorCode::VERSION_MISMATCH;
+  }
+
+  if (calculateGainScheduleChecksum(data) != data->checksum) {
+    debugPrint(F("Gain schedule checksum mismatch - data corruption detected"));
+    return ErrorCode::CHECKSUM_FAILED;
+  }
+
+  return ErrorCode::SUCCESS;
+}
+
+uint32_t EEPROMCalibrationManager::calculateGainScheduleChecksum(const GainScheduleData *data) const {
+  // Same add-and-rotate scheme as calculateChecksum()
+  uint32_t checksum = 0;
+
+  checksum += data->magic;
+  checksum = (checksum << 1) | (checksum >> 31);
+
+  checksum += data->version;
+  checksum = (checksum << 1) | (checksum >> 31);
+
+  checksum += data->speedPoints;
+  checksum = (checksum << 1) | (checksum >> 31);
+
+  checksum += data->curvaturePoints;
+  checksum = (checksum << 1) | (checksum >> 31);
+
+  for (uint8_t i = 0; i < controller::GainSchedule::SPEED_POINTS; i++) {
+    checksum += (uint32_t)data->speedAxis[i];
+    checksum = (checksum << 1) | (checksum >> 31);
+  }
+
+  for (uint8_t i = 0; i < controller::GainSchedule::CURVATURE_POINTS; i++) {
+    checksum += (uint32_t)data->curvatureAxis[i];
+    checksum = (checksum << 1) | (checksum >> 31);
+  }
+
+  for (size_t i = 0; i < sizeof(data->gains) / sizeof(data->gains[0]); i++) {
+    checksum += (uint32_t)data->gains[i];
+    checksum = (checksum << 1) | (checksum >> 31);
+  }
+
+  return checksum;
+}
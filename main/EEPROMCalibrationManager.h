@@ -7,7 +7,7 @@
  * It demonstrates professional approaches to:
  *
  * - Cooperative resource management (works with system-level EEPROM initialization)
- * - Memory-efficient data structures (40-byte structure fits in 64-byte EEPROM)
+ * - Memory-efficient data structures (4 bytes per sensor plus an 8-byte frame)
  * - Comprehensive error handling with specific diagnostic information
  * - Robust data integrity protection through checksums and validation
  * - Graceful degradation when resources are constrained
@@ -19,9 +19,10 @@
  *    initialization internally, this class works with system-level EEPROM
  *    initialization. This prevents resource conflicts
  *
- * 2. Memory-Optimized Data Structure: The CalibrationData structure is
- *    carefully designed to use exactly 40 bytes, fitting comfortably
- *    within typical ESP32 EEPROM allocations while leaving room for growth.
+ * 2. Memory-Optimized Data Structure: The calibration record stores only
+ *    the sensors that exist, from 40 bytes for 8 sensors up to 136 bytes
+ *    for 32 multiplexed sensors. Records written by the fixed 8-sensor
+ *    format (version 2) are migrated in place on construction.
  *
  * 3. Comprehensive Error Taxonomy: Each possible failure mode has a specific
  *    error code that guides appropriate recovery strategies, enabling
@@ -39,6 +40,8 @@
 
 #pragma once
 
+#include "GainSchedule.h"
+#include "LogConfig.h"
 #include <Arduino.h>
 #include <EEPROM.h>
 #include <QTRSensors.h>
@@ -53,13 +56,21 @@ public:
    * @var CALIBRATION_VERSION Format version (incremented for new structure)
    * @var DEFAULT_EEPROM_SIZE Realistic default based on ESP32 capabilities
    * @var DEFAULT_START_ADDRESS Standard start address for calibration data
-   * @var MAX_SENSORS Optimized for typical line following robots
+   * @var MAX_SENSORS Largest array a record can hold (two 16-channel multiplexers)
+   * @var LEGACY_CALIBRATION_VERSION Fixed 8-sensor format, migrated on construction
+   * @var LEGACY_MAX_SENSORS Sensor slots of the legacy format
+   * @var GAIN_SCHEDULE_MAGIC Magic number of the gain schedule block
+   * @var GAIN_SCHEDULE_VERSION Gain schedule block format version
    */
   static const uint16_t CALIBRATION_MAGIC = 0xCAFE;
-  static const uint8_t CALIBRATION_VERSION = 2;
+  static const uint8_t CALIBRATION_VERSION = 3;
   static const uint16_t DEFAULT_EEPROM_SIZE = 64;
   static const uint16_t DEFAULT_START_ADDRESS = 0;
-  static const uint8_t MAX_SENSORS = 8;
+  static const uint8_t MAX_SENSORS = 32;
+  static const uint8_t LEGACY_CALIBRATION_VERSION = 2;
+  static const uint8_t LEGACY_MAX_SENSORS = 8;
+  static const uint16_t GAIN_SCHEDULE_MAGIC = 0x6A15;
+  static const uint8_t GAIN_SCHEDULE_VERSION = 1;
 
   /**
    * @brief Comprehensive Error Code System
@@ -74,7 +85,7 @@ public:
    * @enum ErrorCode
    * @var SUCCESS Operation completed successfully
    * @var EEPROM_NOT_READY EEPROM system not initialized at system level
-   * @var INVALID_SENSOR_COUNT Sensor count outside valid range (1-8)
+   * @var INVALID_SENSOR_COUNT Sensor count outside valid range (1-32)
    * @var INSUFFICIENT_SPACE Not enough EEPROM space for calibration data
    * @var NO_VALID_DATA No meaningful calibration data to save
    * @var MAGIC_NUMBER_MISMATCH Stored data doesn't have valid signature
@@ -116,24 +127,27 @@ public:
 
 private:
 /**
- * @brief Memory-Optimized Calibration Data Structure
+ * @brief Variable-Length Calibration Record (Version 3)
  *
- * At exactly 40 bytes, it fits comfortably within 64-byte EEPROM allocations
- * while providing all necessary functionality for 8-sensor line following robots.
+ * Only the sensors that exist are stored, so an 8-sensor robot uses the
+ * same 40 bytes as before while a 32-sensor multiplexed array fits in 136.
+ * CalibrationData is the in-memory image with room for MAX_SENSORS; the
+ * record on EEPROM packs the two arrays back to back:
  *
- * Memory Layout Analysis (40 bytes total):
- * - Offset 0-1:   Magic number (2 bytes) - quick validation
- * - Offset 2:     Version (1 byte) - format compatibility
- * - Offset 3:     Sensor count (1 byte) - hardware validation
- * - Offset 4-19:  Minimum values (16 bytes: 8 sensors × 2 bytes)
- * - Offset 20-35: Maximum values (16 bytes: 8 sensors × 2 bytes)
- * - Offset 36-39: Checksum (4 bytes) - data integrity
+ * Memory Layout Analysis (8 + 4 × n bytes for n sensors):
+ * - Offset 0-1:       Magic number (2 bytes) - quick validation
+ * - Offset 2:         Version (1 byte) - format compatibility
+ * - Offset 3:         Sensor count n (1 byte) - hardware validation and record length
+ * - Offset 4:         Minimum values (n × 2 bytes)
+ * - Offset 4 + 2n:    Maximum values (n × 2 bytes)
+ * - Offset 4 + 4n:    Checksum (4 bytes) - data integrity over the first n sensors
+ *
+ * The header is read first: it carries the sensor count, and with it the
+ * position of every following field.
  *
- * The #pragma pack directives ensure this exact layout across all
- * compilers and platforms, preventing the structure padding issues
  * @var magic Data validation magic number (0xCAFE)
  * @var version Data format version for compatibility
- * @var sensorCount Number of sensors (must be 8 for this version)
+ * @var sensorCount Number of sensors stored (1 - MAX_SENSORS)
  * @var minimum Minimum calibration values per sensor
  * @var maximum Maximum calibration values per sensor
  * @var checksum Data integrity verification checksum
@@ -149,8 +163,64 @@ private:
     uint32_t checksum;              
   } __attribute__((packed));       // Additional packing enforcement for GCC
 
+/**
+ * @brief Fixed 40-Byte Record of Version 2
+ *
+ * Always 8 sensor slots, unused slots zeroed, checksum over all slots.
+ * Only read, to migrate an existing calibration to the version 3 layout
+ * without asking for a recalibration after a firmware update.
+ */
+  struct LegacyCalibrationData {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t sensorCount;
+    uint16_t minimum[LEGACY_MAX_SENSORS];
+    uint16_t maximum[LEGACY_MAX_SENSORS];
+    uint32_t checksum;
+  } __attribute__((packed));
+
+  static_assert(sizeof(LegacyCalibrationData) == 40, "Version 2 records are exactly 40 bytes");
+
 #pragma pack(pop) // Restore default packing
 
+  /**
+   * @brief Size of the record header (magic, version, sensor count)
+   */
+  static const uint16_t CALIBRATION_HEADER_SIZE = 4;
+
+/**
+ * @brief Gain Schedule Block Stored After the Calibration Data
+ *
+ * The gain schedule lives directly behind CalibrationData so both can be
+ * read and cleared independently. It has its own magic, version and
+ * checksum; the table dimensions are stored so a firmware with a different
+ * table size rejects the block instead of misreading it. All values are
+ * the raw Q16.16 words of controller::GainSchedule.
+ *
+ * Memory Layout (233 bytes for the 4x4 table):
+ * - Offset 0-1:   Magic number (0x6A15)
+ * - Offset 2:     Version
+ * - Offset 3-4:   Speed and curvature breakpoint counts
+ * - Offset 5-20:  Speed axis (4 × int32)
+ * - Offset 21-36: Curvature axis (4 × int32)
+ * - Offset 37-228: Gains (16 × Kp/Ki/Kd × int32, speed-major)
+ * - Offset 229-232: Checksum
+ */
+#pragma pack(push, 1)
+
+  struct GainScheduleData {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t speedPoints;
+    uint8_t curvaturePoints;
+    int32_t speedAxis[controller::GainSchedule::SPEED_POINTS];
+    int32_t curvatureAxis[controller::GainSchedule::CURVATURE_POINTS];
+    int32_t gains[controller::GainSchedule::SPEED_POINTS * controller::GainSchedule::CURVATURE_POINTS * 3];
+    uint32_t checksum;
+  } __attribute__((packed));
+
+#pragma pack(pop)
+
   // Instance State Variables - The Manager's Internal Configuration
   uint8_t sensorCount_;   ///< Number of sensors this instance manages
   uint16_t eepromSize_;   ///< Available EEPROM space (set by system level)
@@ -171,10 +241,15 @@ private:
    * dramatically different checksum values, providing reliable corruption
    * detection while being fast enough for real-time embedded use.
    *
+   * Only the first `slots` sensors are included, so the checksum of a
+   * version 3 record covers exactly the sensors it stores. Version 2
+   * records were summed over all 8 slots, zeros included.
+   *
    * @param data Pointer to calibration data structure
+   * @param slots Sensor slots to include (sensorCount, or 8 for version 2)
    * @return uint32_t Calculated checksum value
    */
-  uint32_t calculateChecksum(const CalibrationData *data) const;
+  uint32_t calculateChecksum(const CalibrationData *data, uint8_t slots) const;
 
   /**
    * @brief Multi-Layer Data Validation System
@@ -199,16 +274,34 @@ private:
    */
   ErrorCode validateCalibrationData(const CalibrationData *data) const;
 
+  /**
+   * @brief Gain Schedule Block Helpers
+   *
+   * Same checksum scheme and validation layers as the calibration data,
+   * applied to the gain schedule block.
+   */
+  uint32_t calculateGainScheduleChecksum(const GainScheduleData *data) const;
+  ErrorCode loadGainScheduleData(GainScheduleData *data);
+  ErrorCode readGainScheduleData(GainScheduleData *data, uint16_t address);
+  uint16_t gainScheduleAddress() const;
+
   /**
    * @brief Centralized Debug Output with Memory Efficiency
    *
    * This method provides consistent debug output while using the F() macro
    * to store format strings in flash memory rather than precious RAM.
-   * This memory efficiency consideration is crucial in embedded systems.
+   * The message is taken as a pointer, so no heap String is built, and the
+   * whole call compiles away below LOG_LEVEL_DEBUG.
    *
    * @param message Debug message to output (only if debugging enabled)
    */
-  void debugPrint(const String &message) const;
+  void debugPrint(const __FlashStringHelper *message) const;
+  void debugPrint(const char *message) const;
+
+  /**
+   * @brief Print the tag that starts every debug line
+   */
+  void debugPrefix() const;
 
   /**
    * @brief Internal Data Loading with Comprehensive Validation
@@ -226,6 +319,28 @@ private:
    */
   ErrorCode loadCalibrationData(CalibrationData *data);
 
+  /**
+   * @brief Serialize a Calibration Record to EEPROM
+   *
+   * Writes the variable-length layout for data->sensorCount sensors at
+   * startAddress_. The caller commits.
+   *
+   * @param data Pointer to a complete record, checksum included
+   */
+  void writeCalibrationData(const CalibrationData *data);
+
+  /**
+   * @brief Upgrade a Version 2 Record in Place
+   *
+   * Validates the fixed 40-byte record with its own checksum, rewrites it
+   * in the version 3 layout and, when the shorter record moves the gain
+   * schedule block, moves a valid block along with it. Anything that does
+   * not validate is left untouched and reported by the normal load path.
+   *
+   * @return ErrorCode SUCCESS if the record was migrated
+   */
+  ErrorCode migrateLegacyCalibration();
+
   /**
    * @brief Formatted Data Display for Debugging and Verification
    *
@@ -361,6 +476,36 @@ public:
    */
   bool clearCalibration();
 
+  /**
+   * @brief Save a Gain Schedule Next to the Calibration Data
+   *
+   * Writes the schedule's axes and gain table into its own checksummed
+   * block directly after the calibration data, then verifies it by
+   * read-back like saveCalibration(). The calibration data is untouched.
+   *
+   * @param schedule Gain schedule to store
+   * @return bool true if the block was written and verified
+   */
+  bool saveGainSchedule(const controller::GainSchedule &schedule);
+
+  /**
+   * @brief Load a Stored Gain Schedule
+   *
+   * The schedule is only modified when the stored block passes every
+   * validation layer.
+   *
+   * @param schedule Gain schedule to receive the stored table
+   * @return bool true if a valid block was found and applied
+   */
+  bool loadGainSchedule(controller::GainSchedule &schedule);
+
+  /**
+   * @brief Non-Destructive Gain Schedule Check
+   *
+   * @return bool true if a valid, compatible gain schedule block exists
+   */
+  bool hasValidGainSchedule();
+
   /**
    * @brief Comprehensive Diagnostic Data Display
    *
@@ -415,13 +560,24 @@ public:
    * @brief Calculate Storage Requirements for Planning
    *
    * This static utility method calculates the exact EEPROM space needed
-   * for different sensor configurations. It's useful for system-level
-   * EEPROM layout planning and capacity verification.
+   * for different sensor configurations: 8 bytes of header and checksum
+   * plus 4 bytes per sensor. It's useful for system-level EEPROM layout
+   * planning and capacity verification.
    *
    * @param sensorCount Number of sensors to calculate storage for
    * @return uint16_t Required EEPROM bytes for the specified configuration
    */
   static uint16_t calculateStorageSize(uint8_t sensorCount);
+
+  /**
+   * @brief Storage Needed for the Gain Schedule Block
+   *
+   * The block starts at startAddress + calculateStorageSize(), so the total
+   * EEPROM allocation must cover the sum of both sizes.
+   *
+   * @return uint16_t Bytes used by the gain schedule block
+   */
+  static uint16_t calculateGainScheduleSize();
 };
 
 // ============================
@@ -452,6 +608,20 @@ inline uint8_t EEPROMCalibrationManager::getSensorCount() const {
   return sensorCount_;
 }
 
+inline void EEPROMCalibrationManager::debugPrint(const __FlashStringHelper *message) const {
+  if (LOG_DEBUG_ENABLED && debugEnabled_) {
+    debugPrefix();
+    Serial.println(message);
+  }
+}
+
+inline void EEPROMCalibrationManager::debugPrint(const char *message) const {
+  if (LOG_DEBUG_ENABLED && debugEnabled_) {
+    debugPrefix();
+    Serial.println(message);
+  }
+}
+
 inline void EEPROMCalibrationManager::setDebugEnabled(bool enabled) {
   debugEnabled_ = enabled;
   if (enabled) {
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace numeric {
+
+  /**
+   * @brief Saturating signed fixed-point number in a 32-bit word
+   *
+   * The ESP32 has a single-precision FPU but no double-precision hardware;
+   * integer multiply and shift are single-cycle. Fixed<FRAC_BITS> gives the
+   * controllers and the position estimator a numeric type that never touches
+   * the emulated double path and has deterministic rounding.
+   *
+   * All arithmetic saturates at the representable range instead of wrapping,
+   * so an overflowing intermediate behaves like an actuator hitting its
+   * limit rather than flipping sign. Products and quotients are computed in
+   * 64 bits and rounded to nearest.
+   *
+   * The operators make the type a drop-in Scalar for Pid<Traits> and for
+   * policy::Saturate, which clamps with exactly the semantics of
+   * BaseController::applyLimits.
+   *
+   * @tparam FRAC_BITS: Number of fractional bits (1-30)
+   */
+  template <uint8_t FRAC_BITS>
+  struct Fixed {
+    static_assert(FRAC_BITS >= 1 && FRAC_BITS <= 30, "Fixed supports 1-30 fractional bits");
+
+    static const int32_t ONE = (int32_t)1 << FRAC_BITS;
+    static const int32_t RAW_MAX = INT32_MAX;
+    static const int32_t RAW_MIN = INT32_MIN;
+
+    /**
+     * @var raw: Underlying two's complement value, scaled by 2^FRAC_BITS
+     */
+    int32_t raw;
+
+    Fixed() : raw(0) {}
+
+    /**
+     * @brief Convert from float with rounding and saturation
+     *
+     * @param value: Real value to represent
+     */
+    explicit Fixed(float value) : raw(fromFloatRaw(value)) {}
+
+    /**
+     * @brief Build a value from its raw representation
+     *
+     * @param raw: Scaled integer value
+     * @return Fixed Value with the given raw bits
+     */
+    static Fixed fromRaw(int32_t raw) {
+      Fixed f;
+      f.raw = raw;
+      return f;
+    }
+
+    /**
+     * @brief Convert from an integer with saturation
+     *
+     * @param value: Whole number to represent
+     * @return Fixed Converted value
+     */
+    static Fixed fromInt(int32_t value) {
+      return fromRaw(saturate((int64_t)value * ONE));
+    }
+
+    /**
+     * @brief Build the ratio num/den with a single integer divide
+     *
+     * @param num: Numerator
+     * @param den: Denominator (0 saturates towards the sign of num)
+     * @return Fixed num/den
+     */
+    static Fixed ratio(int32_t num, int32_t den) {
+      return fromInt(num) / fromInt(den);
+    }
+
+    explicit operator float() const {
+      return (float)raw * (1.0f / (float)ONE);
+    }
+
+    /**
+     * @brief Convert to float
+     *
+     * @return float Real value
+     */
+    float toFloat() const {
+      return (float)*this;
+    }
+
+    /**
+     * @brief Convert to integer, rounding to nearest
+     *
+     * @return int32_t Rounded whole value
+     */
+    int32_t toInt() const {
+      return (int32_t)(((int64_t)raw + (ONE >> 1)) >> FRAC_BITS);
+    }
+
+    /**
+     * @brief Convert a float to raw bits with rounding and saturation
+     *
+     * The range is checked in float first because casting an out-of-range
+     * float to an integer is undefined behavior. Halves round away from
+     * zero, so the result is within half an LSB of the float value.
+     */
+    static int32_t fromFloatRaw(float value) {
+      float scaled = value * (float)ONE;
+      if (scaled >= 2147483647.0f) {
+        return RAW_MAX;
+      }
+      if (scaled <= -2147483648.0f) {
+        return RAW_MIN;
+      }
+      // Round the fraction separately: adding 0.5f to a scaled value of
+      // 2^23 or more is itself rounded and can land one LSB off
+      int32_t whole = (int32_t)scaled;
+      float fraction = scaled - (float)whole;
+      if (fraction >= 0.5f) {
+        whole++;
+      } else if (fraction <= -0.5f) {
+        whole--;
+      }
+      return whole;
+    }
+
+    /**
+     * @brief Clamp a 64-bit intermediate into the 32-bit raw range
+     */
+    static int32_t saturate(int64_t value) {
+      if (value > RAW_MAX) {
+        return RAW_MAX;
+      }
+      if (value < RAW_MIN) {
+        return RAW_MIN;
+      }
+      return (int32_t)value;
+    }
+
+    Fixed operator+(Fixed other) const {
+      return fromRaw(saturate((int64_t)raw + other.raw));
+    }
+
+    Fixed operator-(Fixed other) const {
+      return fromRaw(saturate((int64_t)raw - other.raw));
+    }
+
+    Fixed operator-() const {
+      return fromRaw(saturate(-(int64_t)raw));
+    }
+
+    Fixed operator*(Fixed other) const {
+      // Round to nearest (half up) before dropping the extra fractional bits
+      int64_t product = (int64_t)raw * other.raw;
+      return fromRaw(saturate((product + ((int64_t)1 << (FRAC_BITS - 1))) >> FRAC_BITS));
+    }
+
+    Fixed operator/(Fixed other) const {
+      if (other.raw == 0) {
+        return fromRaw(raw >= 0 ? RAW_MAX : RAW_MIN);
+      }
+
+      int64_t num = (int64_t)raw * ONE;
+      int64_t quotient = num / other.raw;
+      int64_t remainder = num % other.raw;
+
+      // Round half away from zero
+      int64_t twice_rem = remainder < 0 ? -2 * remainder : 2 * remainder;
+      int64_t abs_den = other.raw < 0 ? -(int64_t)other.raw : (int64_t)other.raw;
+      if (twice_rem >= abs_den) {
+        quotient += ((num < 0) != (other.raw < 0)) ? -1 : 1;
+      }
+      return fromRaw(saturate(quotient));
+    }
+
+    Fixed &operator+=(Fixed other) {
+      *this = *this + other;
+      return *this;
+    }
+
+    Fixed &operator-=(Fixed other) {
+      *this = *this - other;
+      return *this;
+    }
+
+    Fixed &operator*=(Fixed other) {
+      *this = *this * other;
+      return *this;
+    }
+
+    bool operator<(Fixed other) const { return raw < other.raw; }
+    bool operator>(Fixed other) const { return raw > other.raw; }
+    bool operator<=(Fixed other) const { return raw <= other.raw; }
+    bool operator>=(Fixed other) const { return raw >= other.raw; }
+    bool operator==(Fixed other) const { return raw == other.raw; }
+    bool operator!=(Fixed other) const { return raw != other.raw; }
+  };
+
+  /**
+   * @brief Q16.16: range ±32768 with 1.5e-5 resolution - gains, outputs, positions
+   */
+  typedef Fixed<16> Q16_16;
+
+  /**
+   * @brief Q17.15: range ±65536 with 3.1e-5 resolution - not the 16-bit Q1.15
+   *        of DSP code; for values that need more integer headroom than Q16.16
+   */
+  typedef Fixed<15> Q17_15;
+
+} // namespace numeric
@@ -0,0 +1,106 @@
+#include "FixedRateCore.h"
+
+namespace rt {
+
+  FixedRateCore::FixedRateCore(uint32_t rate_hz)
+      : rate_hz(DEFAULT_RATE_HZ), period_us(1000000UL / DEFAULT_RATE_HZ),
+        release_us(0), next_release_us(0), cycle_start_us(0) {
+    setRate(rate_hz);
+    resetStats();
+  }
+
+  bool FixedRateCore::setRate(uint32_t rate_hz) {
+    bool accepted = true;
+
+    // Clamp into the supported band rather than rejecting the request
+    if (rate_hz < MIN_RATE_HZ) {
+      rate_hz = MIN_RATE_HZ;
+      accepted = false;
+    } else if (rate_hz > MAX_RATE_HZ) {
+      rate_hz = MAX_RATE_HZ;
+      accepted = false;
+    }
+
+    this->rate_hz = rate_hz;
+    period_us = 1000000UL / rate_hz;
+    return accepted;
+  }
+
+  void FixedRateCore::start(uint32_t now_us) {
+    release_us = now_us;
+    next_release_us = now_us + period_us;
+    cycle_start_us = now_us;
+    resetStats();
+  }
+
+  bool FixedRateCore::isDue(uint32_t now_us) const {
+    // Signed difference handles counter wrap-around
+    return (int32_t)(now_us - next_release_us) >= 0;
+  }
+
+  uint32_t FixedRateCore::beginCycle(uint32_t now_us) {
+    int32_t lateness = (int32_t)(now_us - next_release_us);
+    uint32_t missed = 0;
+
+    // A wake-up slightly ahead of the release (timer jitter) counts as on time
+    if (lateness < 0) {
+      lateness = 0;
+    }
+
+    // Skip whole periods we were too late for instead of bursting to catch up
+    if ((uint32_t)lateness >= period_us) {
+      missed = (uint32_t)lateness / period_us;
+      next_release_us += missed * period_us;
+      lateness -= (int32_t)(missed * period_us);
+      stats.missed_periods += missed;
+    }
+
+    if ((uint32_t)lateness > stats.max_latency_us) {
+      stats.max_latency_us = (uint32_t)lateness;
+    }
+
+    release_us = next_release_us;
+    next_release_us += period_us;
+    cycle_start_us = now_us;
+    stats.cycles++;
+
+    return missed;
+  }
+
+  bool FixedRateCore::endCycle(uint32_t now_us) {
+    uint32_t exec_us = now_us - cycle_start_us;
+    stats.last_exec_us = exec_us;
+    if (exec_us > stats.max_exec_us) {
+      stats.max_exec_us = exec_us;
+    }
+
+    // Deadline is the release of the following period
+    bool overrun = (int32_t)(now_us - release_us) > (int32_t)period_us;
+    if (overrun) {
+      stats.overruns++;
+    }
+    return overrun;
+  }
+
+  void FixedRateCore::resetStats() {
+    stats.cycles = 0;
+    stats.overruns = 0;
+    stats.missed_periods = 0;
+    stats.last_exec_us = 0;
+    stats.max_exec_us = 0;
+    stats.max_latency_us = 0;
+  }
+
+  uint32_t FixedRateCore::getRateHz() const {
+    return rate_hz;
+  }
+
+  uint32_t FixedRateCore::getPeriodUs() const {
+    return period_us;
+  }
+
+  const SchedulerStats &FixedRateCore::getStats() const {
+    return stats;
+  }
+
+} // namespace rt
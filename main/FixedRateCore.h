@@ -0,0 +1,165 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rt {
+
+  /**
+   * @brief Timing statistics collected by the fixed-rate scheduler
+   *
+   * @var cycles: Number of control iterations executed since the last reset
+   * @var overruns: Iterations that finished after their deadline (release time + one period)
+   * @var missed_periods: Whole periods skipped because an iteration started too late
+   * @var last_exec_us: Execution time of the most recent iteration in microseconds
+   * @var max_exec_us: Longest execution time observed since the last reset
+   * @var max_latency_us: Largest delay between a scheduled release and the iteration start
+   */
+  struct SchedulerStats {
+    uint32_t cycles;
+    uint32_t overruns;
+    uint32_t missed_periods;
+    uint32_t last_exec_us;
+    uint32_t max_exec_us;
+    uint32_t max_latency_us;
+  };
+
+  /**
+   * @brief Platform-independent timing core for a fixed-rate control loop
+   *
+   * Tracks the release time of every control period and classifies each
+   * iteration as on time, late (missed periods) or overrunning. The core never
+   * reads a clock itself: every method receives the current time in
+   * microseconds, so the same logic runs against esp_timer on the ESP32 and
+   * against a simulated clock on a Linux host.
+   *
+   * All time arithmetic is done in wrapping uint32_t microseconds, which keeps
+   * it correct across the ~71 minute rollover of a 32-bit micros() counter.
+   *
+   * Typical use (polled or timer-driven):
+   *   core.start(now);
+   *   ...
+   *   if (core.isDue(now)) {
+   *     core.beginCycle(now);
+   *     acquire(); estimate(); control();
+   *     core.endCycle(later);
+   *   }
+   */
+  class FixedRateCore {
+  public:
+    /**
+     * @brief Supported control rates
+     *
+     * @var MIN_RATE_HZ: Lowest accepted control rate (1 kHz)
+     * @var MAX_RATE_HZ: Highest accepted control rate (5 kHz)
+     * @var DEFAULT_RATE_HZ: Rate used when none is specified
+     */
+    static const uint32_t MIN_RATE_HZ = 1000;
+    static const uint32_t MAX_RATE_HZ = 5000;
+    static const uint32_t DEFAULT_RATE_HZ = 1000;
+
+    /**
+     * @brief Construct a new timing core
+     *
+     * @param rate_hz: Control rate in Hz, clamped to [MIN_RATE_HZ, MAX_RATE_HZ]
+     */
+    explicit FixedRateCore(uint32_t rate_hz = DEFAULT_RATE_HZ);
+
+    /**
+     * @brief Change the control rate
+     *
+     * The period is computed as an integer number of microseconds, so rates
+     * that do not divide 1 MHz evenly run marginally fast (3 kHz -> 333 us).
+     * Takes effect from the next call to start().
+     *
+     * @param rate_hz: Requested control rate in Hz
+     * @return bool true if the rate was accepted as-is, false if it was clamped
+     */
+    bool setRate(uint32_t rate_hz);
+
+    /**
+     * @brief Anchor the release schedule and clear statistics
+     *
+     * The first period is released one full period after now_us, matching a
+     * periodic hardware timer started at the same instant.
+     *
+     * @param now_us: Current time in microseconds
+     */
+    void start(uint32_t now_us);
+
+    /**
+     * @brief Check whether the next period has been released
+     *
+     * @param now_us: Current time in microseconds
+     * @return bool true if an iteration should run now
+     */
+    bool isDue(uint32_t now_us) const;
+
+    /**
+     * @brief Mark the start of a control iteration
+     *
+     * If the iteration starts one or more whole periods after its release
+     * time, those periods are counted as missed and the schedule skips ahead
+     * so the loop does not try to "catch up" with a burst of iterations.
+     *
+     * @param now_us: Current time in microseconds
+     * @return uint32_t Number of periods skipped before this iteration
+     */
+    uint32_t beginCycle(uint32_t now_us);
+
+    /**
+     * @brief Mark the end of a control iteration
+     *
+     * Records the execution time and counts an overrun if the iteration
+     * finished after its deadline (release time + one period).
+     *
+     * @param now_us: Current time in microseconds
+     * @return bool true if this iteration overran its deadline
+     */
+    bool endCycle(uint32_t now_us);
+
+    /**
+     * @brief Clear all statistics without touching the release schedule
+     */
+    void resetStats();
+
+    /**
+     * @brief Get the configured control rate
+     *
+     * @return uint32_t Control rate in Hz
+     */
+    uint32_t getRateHz() const;
+
+    /**
+     * @brief Get the control period
+     *
+     * @return uint32_t Period in microseconds
+     */
+    uint32_t getPeriodUs() const;
+
+    /**
+     * @brief Get the collected timing statistics
+     *
+     * @return const SchedulerStats& Statistics since the last reset
+     */
+    const SchedulerStats &getStats() const;
+
+  private:
+    /**
+     * @brief Scheduler state
+     *
+     * @var rate_hz: Configured control rate
+     * @var period_us: Control period derived from rate_hz
+     * @var release_us: Release time of the iteration currently running
+     * @var next_release_us: Release time of the next period
+     * @var cycle_start_us: Start time of the iteration currently running
+     * @var stats: Accumulated timing statistics
+     */
+    uint32_t rate_hz;
+    uint32_t period_us;
+    uint32_t release_us;
+    uint32_t next_release_us;
+    uint32_t cycle_start_us;
+    SchedulerStats stats;
+  };
+
+} // namespace rt
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "BaseController.h"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rt {
+
+  /**
+   * @brief Fixed-size ring of controller snapshots for post-run analysis
+   *
+   * The control task appends a ControllerState every few cycles; once the
+   * ring is full the oldest entries are overwritten, so after a run (or a
+   * crash into the wall) it holds the last CAPACITY snapshots leading up
+   * to the stop. Appending is a 36-byte copy and an index update, no
+   * allocation or locking.
+   *
+   * The recorder has a single writer and is read without synchronisation:
+   * call dump(), get() and clear() only while the control task is stopped.
+   *
+   * @tparam CAPACITY: Number of snapshots kept (>= 1)
+   */
+  template <size_t CAPACITY>
+  class FlightRecorder {
+    static_assert(CAPACITY >= 1, "FlightRecorder needs at least one slot");
+
+  public:
+    FlightRecorder() : next(0), count(0) {}
+
+    /**
+     * @brief Append a snapshot, overwriting the oldest when full
+     *
+     * @param state: Snapshot to store (e.g. controller.snapshot())
+     */
+    inline void record(const controller::ControllerState &state) {
+      entries[next] = state;
+      if (++next >= CAPACITY) {
+        next = 0;
+      }
+      if (count < CAPACITY) {
+        count++;
+      }
+    }
+
+    /**
+     * @brief Discard all snapshots
+     */
+    inline void clear() {
+      next = 0;
+      count = 0;
+    }
+
+    /**
+     * @brief Get a stored snapshot
+     *
+     * @param index: 0 = oldest, size() - 1 = newest
+     * @return const ControllerState& Snapshot (index is not range-checked)
+     */
+    inline const controller::ControllerState &get(size_t index) const {
+      size_t first = count < CAPACITY ? 0 : next;
+      size_t slot = first + index;
+      if (slot >= CAPACITY) {
+        slot -= CAPACITY;
+      }
+      return entries[slot];
+    }
+
+    inline size_t size() const { return count; }
+    inline size_t capacity() const { return CAPACITY; }
+
+#if defined(ARDUINO)
+    /**
+     * @brief Print all snapshots as CSV, oldest first
+     *
+     * Columns: t_us, kind, setpoint, output, feed_forward, s0..s3, where
+     * s0..s3 follow the layout of the recorded controller's saveState().
+     *
+     * @param out: Destination, e.g. Serial
+     */
+    void dump(Print &out) const {
+      out.println(F("t_us,kind,setpoint,output,feed_forward,s0,s1,s2,s3"));
+      for (size_t i = 0; i < count; i++) {
+        const controller::ControllerState &state = get(i);
+        out.print(state.timestamp_us);
+        out.print(',');
+        out.print((uint8_t)state.kind);
+        out.print(',');
+        out.print(state.setpoint, 4);
+        out.print(',');
+        out.print(state.output, 3);
+        out.print(',');
+        out.print(state.feed_forward, 3);
+        for (uint8_t k = 0; k < 4; k++) {
+          out.print(',');
+          out.print(state.internal[k], 5);
+        }
+        out.println();
+      }
+    }
+#endif
+
+  private:
+    /**
+     * @brief Ring storage
+     *
+     * @var entries: Snapshots
+     * @var next: Slot written by the next record()
+     * @var count: Valid snapshots (<= CAPACITY)
+     */
+    controller::ControllerState entries[CAPACITY];
+    size_t next;
+    size_t count;
+  };
+
+} // namespace rt
@@ -0,0 +1,177 @@
+#include "GainSchedule.h"
+
+namespace controller {
+
+  GainSchedule::GainSchedule() : has_last(false) {
+    float speeds[SPEED_POINTS];
+    for (uint8_t i = 0; i < SPEED_POINTS; i++) {
+      speeds[i] = 1023.0f * i / (SPEED_POINTS - 1);
+    }
+    float curvatures[CURVATURE_POINTS];
+    for (uint8_t i = 0; i < CURVATURE_POINTS; i++) {
+      curvatures[i] = (float)i;
+    }
+
+    setSpeedAxis(speeds);
+    setCurvatureAxis(curvatures);
+    fill(0.0f, 0.0f, 0.0f);
+  }
+
+  bool GainSchedule::prepareAxis(const Value *points, uint8_t count, Value *axis, int64_t *inv_span) {
+    for (uint8_t i = 1; i < count; i++) {
+      if (points[i].raw <= points[i - 1].raw) {
+        return false;
+      }
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+      axis[i] = points[i];
+    }
+    // The reciprocal is scaled by 2^40 so that (offset * inv_span) >> 24 is
+    // the Q16 fraction with no loss even for segments spanning most of the range
+    for (uint8_t i = 0; i + 1 < count; i++) {
+      int64_t span = (int64_t)axis[i + 1].raw - axis[i].raw;
+      inv_span[i] = ((int64_t)1 << 40) / span;
+    }
+    return true;
+  }
+
+  bool GainSchedule::setSpeedAxis(const float *points) {
+    Value values[SPEED_POINTS];
+    for (uint8_t i = 0; i < SPEED_POINTS; i++) {
+      values[i] = Value(points[i]);
+    }
+
+    if (!prepareAxis(values, SPEED_POINTS, speed_axis, speed_inv_span)) {
+      LOG_WARNING(F("WARNING: GainSchedule - Speed axis must be strictly increasing"));
+      return false;
+    }
+    has_last = false;
+    return true;
+  }
+
+  bool GainSchedule::setCurvatureAxis(const float *points) {
+    Value values[CURVATURE_POINTS];
+    for (uint8_t i = 0; i < CURVATURE_POINTS; i++) {
+      values[i] = Value(points[i]);
+    }
+
+    if (!prepareAxis(values, CURVATURE_POINTS, curvature_axis, curvature_inv_span)) {
+      LOG_WARNING(F("WARNING: GainSchedule - Curvature axis must be strictly increasing"));
+      return false;
+    }
+    has_last = false;
+    return true;
+  }
+
+  bool GainSchedule::setEntry(uint8_t speed_index, uint8_t curvature_index, float Kp, float Ki, float Kd) {
+    if (speed_index >= SPEED_POINTS || curvature_index >= CURVATURE_POINTS) {
+      LOG_WARNING(F("WARNING: GainSchedule - Entry index out of range"));
+      return false;
+    }
+
+    Gains &entry = table[speed_index][curvature_index];
+    entry.Kp = Value(Kp);
+    entry.Ki = Value(Ki);
+    entry.Kd = Value(Kd);
+    has_last = false;
+    return true;
+  }
+
+  void GainSchedule::fill(float Kp, float Ki, float Kd) {
+    for (uint8_t s = 0; s < SPEED_POINTS; s++) {
+      for (uint8_t c = 0; c < CURVATURE_POINTS; c++) {
+        setEntry(s, c, Kp, Ki, Kd);
+      }
+    }
+  }
+
+  bool GainSchedule::restore(const Value *speed_axis, const Value *curvature_axis, const Gains *entries) {
+    if (!prepareAxis(speed_axis, SPEED_POINTS, this->speed_axis, speed_inv_span) ||
+        !prepareAxis(curvature_axis, CURVATURE_POINTS, this->curvature_axis, curvature_inv_span)) {
+      return false;
+    }
+
+    for (uint8_t s = 0; s < SPEED_POINTS; s++) {
+      for (uint8_t c = 0; c < CURVATURE_POINTS; c++) {
+        table[s][c] = entries[s * CURVATURE_POINTS + c];
+      }
+    }
+    has_last = false;
+    return true;
+  }
+
+  int32_t GainSchedule::locate(const Value *axis, const int64_t *inv_span, uint8_t count, Value value,
+                               uint8_t &index) {
+    if (value.raw <= axis[0].raw) {
+      index = 0;
+      return 0;
+    }
+    if (value.raw >= axis[count - 1].raw) {
+      index = count - 2;
+      return 1 << 16;
+    }
+
+    uint8_t i = 0;
+    while (value.raw >= axis[i + 1].raw) {
+      i++;
+    }
+    index = i;
+
+    int64_t offset = (int64_t)value.raw - axis[i].raw;
+    return (int32_t)((offset * inv_span[i]) >> 24);
+  }
+
+  GainSchedule::Gains GainSchedule::lookup(float speed, float curvature) const {
+    uint8_t s;
+    uint8_t c;
+    int32_t fs = locate(speed_axis, speed_inv_span, SPEED_POINTS, Value(speed), s);
+    int32_t fc = locate(curvature_axis, curvature_inv_span, CURVATURE_POINTS, Value(curvature), c);
+
+    const Gains &g00 = table[s][c];
+    const Gains &g01 = table[s][c + 1];
+    const Gains &g10 = table[s + 1][c];
+    const Gains &g11 = table[s + 1][c + 1];
+
+    // Blend along curvature at both speed breakpoints, then along speed
+    Gains result;
+    result.Kp.raw = blend(blend(g00.Kp.raw, g01.Kp.raw, fc), blend(g10.Kp.raw, g11.Kp.raw, fc), fs);
+    result.Ki.raw = blend(blend(g00.Ki.raw, g01.Ki.raw, fc), blend(g10.Ki.raw, g11.Ki.raw, fc), fs);
+    result.Kd.raw = blend(blend(g00.Kd.raw, g01.Kd.raw, fc), blend(g10.Kd.raw, g11.Kd.raw, fc), fs);
+    return result;
+  }
+
+  bool GainSchedule::update(float speed, float curvature, Gains &gains) {
+    gains = lookup(speed, curvature);
+
+    if (has_last && gains.Kp == last.Kp && gains.Ki == last.Ki && gains.Kd == last.Kd) {
+      return false;
+    }
+    last = gains;
+    has_last = true;
+    return true;
+  }
+
+  bool GainSchedule::apply(PIDController &pid, float speed, float curvature) {
+    Gains gains;
+    if (!update(speed, curvature, gains)) {
+      return false;
+    }
+    pid.setGains(gains.Kp.toFloat(), gains.Ki.toFloat(), gains.Kd.toFloat());
+    return true;
+  }
+
+  bool GainSchedule::apply(PDController &pd, float speed, float curvature) {
+    Gains gains;
+    if (!update(speed, curvature, gains)) {
+      return false;
+    }
+    pd.setGains(gains.Kp.toFloat(), gains.Kd.toFloat());
+    return true;
+  }
+
+  void GainSchedule::invalidate() {
+    has_last = false;
+  }
+
+} // namespace controller
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "FixedPoint.h"
+#include "PDController.h"
+#include "PIDController.h"
+#include <stdint.h>
+
+namespace controller {
+
+  /**
+   * @brief Gain schedule keyed on base speed and curvature
+   *
+   * A small 2-D table of Kp/Ki/Kd gain sets, one per (speed, curvature)
+   * breakpoint, bilinearly interpolated in Q16.16 fixed point. Straights
+   * want low gains at high speed, hairpins the opposite; a single gain set
+   * for the whole track is a compromise for both.
+   *
+   * The interpolation is integer only: the breakpoint reciprocals are
+   * precomputed when an axis is set, so a lookup is two short searches,
+   * two multiplies for the fractions and three bilinear blends.
+   *
+   * apply() layers the result over the controller's setGains(), which
+   * retunes without resetting state, and skips the call entirely while the
+   * interpolated gains are unchanged. A PID absorbs a Kp change in its
+   * integral, so its output does not step; a PD has no integral to absorb
+   * it, so each retune steps its output by ΔKp·error (see the PD overload).
+   *
+   * Inputs outside an axis are clamped to its first or last breakpoint.
+   *
+   * For line following robots:
+   * - Speed axis: base motor command (PWM counts)
+   * - Curvature axis: |CurvatureEstimator::getCurvature()| at the base
+   *   speed, i.e. position units per distance² with the speed axis as the
+   *   distance rate; the sign only gives the direction of the bend, so pass
+   *   the magnitude. Q16.16 resolves 1.5e-5, so breakpoints of small
+   *   curvatures should span a few hundred LSBs at least
+   * - Persist a tuned table with EEPROMCalibrationManager::saveGainSchedule()
+   */
+  class GainSchedule {
+  public:
+    /**
+     * @brief Table dimensions
+     *
+     * @var SPEED_POINTS: Breakpoints on the speed axis
+     * @var CURVATURE_POINTS: Breakpoints on the curvature axis
+     */
+    static const uint8_t SPEED_POINTS = 4;
+    static const uint8_t CURVATURE_POINTS = 4;
+
+    typedef numeric::Q16_16 Value;
+
+    /**
+     * @brief One gain set, stored in Q16.16
+     */
+    struct Gains {
+      Value Kp;
+      Value Ki;
+      Value Kd;
+    };
+
+    /**
+     * @brief Construct a schedule with evenly spaced axes and zero gains
+     *
+     * Speed breakpoints default to 0, 341, 682 and 1023 PWM counts and
+     * curvature breakpoints to 0, 1, 2 and 3; a tuned table brings its own.
+     */
+    GainSchedule();
+
+    /**
+     * @brief Set the speed breakpoints
+     *
+     * @param points: SPEED_POINTS strictly increasing values
+     * @return bool true on success, false if the axis is not increasing
+     */
+    bool setSpeedAxis(const float *points);
+
+    /**
+     * @brief Set the curvature breakpoints
+     *
+     * @param points: CURVATURE_POINTS strictly increasing values
+     * @return bool true on success, false if the axis is not increasing
+     */
+    bool setCurvatureAxis(const float *points);
+
+    /**
+     * @brief Set the gains at one breakpoint
+     *
+     * @param speed_index: Index on the speed axis (< SPEED_POINTS)
+     * @param curvature_index: Index on the curvature axis (< CURVATURE_POINTS)
+     * @param Kp: Proportional gain
+     * @param Ki: Integral gain
+     * @param Kd: Derivative gain
+     * @return bool true on success, false if an index is out of range
+     */
+    bool setEntry(uint8_t speed_index, uint8_t curvature_index, float Kp, float Ki, float Kd);
+
+    /**
+     * @brief Set every breakpoint to the same gains
+     *
+     * @param Kp: Proportional gain
+     * @param Ki: Integral gain
+     * @param Kd: Derivative gain
+     */
+    void fill(float Kp, float Ki, float Kd);
+
+    /**
+     * @brief Interpolate the gains at an operating point
+     *
+     * @param speed: Current base speed
+     * @param curvature: Current curvature magnitude
+     * @return Gains Bilinearly interpolated gain set
+     */
+    Gains lookup(float speed, float curvature) const;
+
+    /**
+     * @brief Interpolate and retune a controller if the gains changed
+     *
+     * @param pid: Controller to retune (state is kept)
+     * @param speed: Current base speed
+     * @param curvature: Current curvature magnitude
+     * @return bool true if new gains were applied
+     */
+    bool apply(PIDController &pid, float speed, float curvature);
+
+    /**
+     * @brief Interpolate and retune a PD controller (Ki is ignored)
+     *
+     * Not bumpless: with no integral to absorb it, a Kp change steps the
+     * next output by ΔKp·error. Between neighbouring lookups ΔKp is a small
+     * slice of one table cell, so the step stays small while the curvature
+     * moves smoothly; space breakpoints closer where that matters, or
+     * schedule a PID if it does not.
+     *
+     * @param pd: Controller to retune (state is kept)
+     * @param speed: Current base speed
+     * @param curvature: Current curvature magnitude
+     * @return bool true if new gains were applied
+     */
+    bool apply(PDController &pd, float speed, float curvature);
+
+    /**
+     * @brief Forget the last applied gains so the next apply() always retunes
+     */
+    void invalidate();
+
+    /**
+     * @brief Raw table access for persistence
+     */
+    const Value *getSpeedAxis() const { return speed_axis; }
+    const Value *getCurvatureAxis() const { return curvature_axis; }
+    const Gains &getEntry(uint8_t speed_index, uint8_t curvature_index) const {
+      return table[speed_index][curvature_index];
+    }
+
+    /**
+     * @brief Restore a table read back from storage
+     *
+     * @param speed_axis: SPEED_POINTS breakpoints
+     * @param curvature_axis: CURVATURE_POINTS breakpoints
+     * @param entries: SPEED_POINTS x CURVATURE_POINTS gain sets, speed-major
+     * @return bool true on success, false if an axis is not increasing
+     */
+    bool restore(const Value *speed_axis, const Value *curvature_axis, const Gains *entries);
+
+  private:
+    /**
+     * @brief Locate a value on an axis
+     *
+     * @param axis: Breakpoints
+     * @param inv_span: Precomputed 2^40 / (axis[i+1] - axis[i]) per segment
+     * @param count: Number of breakpoints
+     * @param value: Value to locate
+     * @param index: Receives the segment index (0..count-2)
+     * @return int32_t Position inside the segment in Q16 (0..65536)
+     */
+    static int32_t locate(const Value *axis, const int64_t *inv_span, uint8_t count, Value value,
+                          uint8_t &index);
+
+    /**
+     * @brief Validate an axis and precompute its segment reciprocals
+     */
+    static bool prepareAxis(const Value *points, uint8_t count, Value *axis, int64_t *inv_span);
+
+    /**
+     * @brief Blend two raw values: a + (b - a) * fraction
+     */
+    static inline int32_t blend(int32_t a, int32_t b, int32_t fraction) {
+      return a + (int32_t)((((int64_t)b - a) * fraction) >> 16);
+    }
+
+    /**
+     * @brief Table, axes and change detection
+     *
+     * @var speed_axis, curvature_axis: Breakpoints in Q16.16
+     * @var speed_inv_span, curvature_inv_span: 2^40 / segment width (raw)
+     * @var table: Gain sets, indexed [speed][curvature]
+     * @var last: Gains passed to the controller by the last apply()
+     * @var has_last: Whether last is valid
+     */
+    Value speed_axis[SPEED_POINTS];
+    Value curvature_axis[CURVATURE_POINTS];
+    int64_t speed_inv_span[SPEED_POINTS - 1];
+    int64_t curvature_inv_span[CURVATURE_POINTS - 1];
+    Gains table[SPEED_POINTS][CURVATURE_POINTS];
+    Gains last;
+    bool has_last;
+
+    /**
+     * @brief Interpolate and report whether the result differs from last
+     */
+    bool update(float speed, float curvature, Gains &gains);
+  };
+
+} // namespace controller
@@ -0,0 +1,193 @@
+#include "IncrementalPIDController.h"
+
+namespace controller {
+
+  IncrementalPIDController::IncrementalPIDController(float Kp, float Ki, float Kd, uint32_t dt_ms,
+                                                     float min_output, float max_output, bool debug)
+      : BaseController(dt_ms, min_output, max_output, debug),
+        Kp(Kp), Ki(Ki), Kd(Kd), q0(0.0f), q1(0.0f), q2(0.0f), coeff_dt(0.0f),
+        e1(0.0f), e2(0.0f), delta(0.0f), applied_feed_forward(0.0f) {
+
+    if (Kp < 0.0f || Ki < 0.0f || Kd < 0.0f) {
+      LOG_WARNING(F("WARNING: IncrementalPIDController - Negative gains can cause instability"));
+    }
+
+    updateCoefficients();
+
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      Serial.print(F("IncrementalPIDController: Created with Kp="));
+      Serial.print(Kp, 3);
+      Serial.print(F(", Ki="));
+      Serial.print(Ki, 3);
+      Serial.print(F(", Kd="));
+      Serial.print(Kd, 3);
+      Serial.print(F(", dt="));
+      Serial.print(dt * 1000.0f);
+      Serial.println(F("ms"));
+    }
+  }
+
+  bool IncrementalPIDController::init() {
+    if (!BaseController::init()) {
+      LOG_ERROR(F("ERROR: IncrementalPIDController::init() - Base initialization failed"));
+      return false;
+    }
+
+    if (Kp < 0.0f || Ki < 0.0f || Kd < 0.0f) {
+      LOG_ERROR(F("ERROR: IncrementalPIDController::init() - Gains cannot be negative"));
+      return false;
+    }
+
+    if (Kp == 0.0f && Ki == 0.0f && Kd == 0.0f) {
+      LOG_ERROR(F("ERROR: IncrementalPIDController::init() - All gains are zero"));
+      return false;
+    }
+
+    reset();
+
+    debugLog(F("IncrementalPIDController initialized successfully"));
+    return true;
+  }
+
+  void IncrementalPIDController::reset() {
+    output = 0.0f;
+    e1 = 0.0f;
+    e2 = 0.0f;
+    delta = 0.0f;
+    applied_feed_forward = 0.0f;
+    resetTimestamp();
+
+    debugLog(F("IncrementalPIDController state reset - output and error history cleared"));
+  }
+
+  void IncrementalPIDController::bumplessTransfer(float output, float error) {
+    BaseController::bumplessTransfer(output, error);
+
+    // The output is the integrator state, so adopting it is the whole
+    // transfer; a flat error history keeps the P and D increments at zero
+    e1 = error;
+    e2 = error;
+    delta = 0.0f;
+    applied_feed_forward = feed_forward;
+  }
+
+  ControllerKind IncrementalPIDController::getKind() const {
+    return ControllerKind::INCREMENTAL_PID;
+  }
+
+  void IncrementalPIDController::saveState(ControllerState &state) const {
+    state.internal[0] = e1;
+    state.internal[1] = e2;
+    state.internal[2] = delta;
+    state.internal[3] = applied_feed_forward;
+  }
+
+  void IncrementalPIDController::loadState(const ControllerState &state) {
+    e1 = state.internal[0];
+    e2 = state.internal[1];
+    delta = state.internal[2];
+    applied_feed_forward = state.internal[3];
+  }
+
+  float IncrementalPIDController::compute(float error) {
+    // Δu = Kp*(e - e1) + Ki*dt*e + Kd/dt*(e - 2*e1 + e2)
+    //    = q0*e + q1*e1 + q2*e2
+    //
+    // The timestamped compute() may have changed dt since the last step
+    if (dt != coeff_dt) {
+      updateCoefficients();
+    }
+
+    delta = q0 * error + q1 * e1 + q2 * e2;
+    e2 = e1;
+    e1 = error;
+
+    // Clamping the accumulated output is the anti-windup: the integrator
+    // cannot run past the actuator limits. The feed-forward is not a change
+    // of the error, so it is swapped rather than accumulated and only
+    // narrows the room left for the feedback
+    float feedback = output - applied_feed_forward;
+    feedback = applyLimits(feedback + delta, min_output - feed_forward, max_output - feed_forward);
+    applied_feed_forward = feed_forward;
+    output = feedback + feed_forward;
+
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      Serial.print(F("IPID: error="));
+      Serial.print(error, 3);
+      Serial.print(F(", delta="));
+      Serial.print(delta, 2);
+      Serial.print(F(", output="));
+      Serial.println(output, 2);
+    }
+
+    return output;
+  }
+
+  void IncrementalPIDController::updateCoefficients() {
+    float kd_inv_dt = Kd * inv_dt;
+    q0 = Kp + Ki * dt + kd_inv_dt;
+    q1 = -Kp - 2.0f * kd_inv_dt;
+    q2 = kd_inv_dt;
+    coeff_dt = dt;
+  }
+
+  void IncrementalPIDController::setKp(float Kp) {
+    if (Kp < 0.0f) {
+      debugLog(F("WARNING: setKp() - Negative Kp can cause instability"));
+    }
+    this->Kp = Kp;
+    updateCoefficients();
+  }
+
+  void IncrementalPIDController::setKi(float Ki) {
+    if (Ki < 0.0f) {
+      debugLog(F("WARNING: setKi() - Negative Ki can cause instability"));
+    }
+    this->Ki = Ki;
+    updateCoefficients();
+  }
+
+  void IncrementalPIDController::setKd(float Kd) {
+    if (Kd < 0.0f) {
+      debugLog(F("WARNING: setKd() - Negative Kd can cause instability"));
+    }
+    this->Kd = Kd;
+    updateCoefficients();
+  }
+
+  void IncrementalPIDController::setGains(float Kp, float Ki, float Kd) {
+    if (Kp < 0.0f || Ki < 0.0f || Kd < 0.0f) {
+      debugLog(F("WARNING: setGains() - Negative gains can cause instability"));
+    }
+    this->Kp = Kp;
+    this->Ki = Ki;
+    this->Kd = Kd;
+    updateCoefficients();
+
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      Serial.print(F("Incremental PID gains updated: Kp="));
+      Serial.print(Kp, 3);
+      Serial.print(F(", Ki="));
+      Serial.print(Ki, 3);
+      Serial.print(F(", Kd="));
+      Serial.println(Kd, 3);
+    }
+  }
+
+  float IncrementalPIDController::getKp() const {
+    return Kp;
+  }
+
+  float IncrementalPIDController::getKi() const {
+    return Ki;
+  }
+
+  float IncrementalPIDController::getKd() const {
+    return Kd;
+  }
+
+  float IncrementalPIDController::getLastDelta() const {
+    return delta;
+  }
+
+} // namespace controller
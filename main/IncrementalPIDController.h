@@ -0,0 +1,160 @@
+#pragma once
+
+#include "BaseController.h"
+
+namespace controller {
+
+  /**
+   * @brief Velocity-form (incremental) PID controller
+   *
+   * Instead of summing three terms every step, the velocity form computes
+   * the change of the output and adds it to the previous output:
+   *
+   *   Δu = Kp × (e - e1) + Ki × dt × e + (Kd / dt) × (e - 2×e1 + e2)
+   *   u  = clamp(u_prev + Δu)
+   *
+   * with e1, e2 the errors of the previous two steps. The three factors
+   * are folded into q0, q1, q2 whenever a gain or dt changes, so a step is
+   * three multiply-adds and a clamp with O(1) state.
+   *
+   * Characteristics:
+   * - Bumpless by construction: changing gains or limits never makes the
+   *   output jump, because the output is the integrator state
+   * - Built-in anti-windup: the accumulated output is clamped, so there is
+   *   no separate integral that can wind up while saturated
+   * - Bumpless mode transfer: bumplessTransfer() seeds the output and error
+   *   history, so switching from a P/PD/PID controller at run time is smooth
+   * - Same steady-state behavior as a positional PID with the same gains
+   *
+   * For line following robots:
+   * - Lets you retune live at full speed without a twitch off the line
+   * - Switch in from a PD controller used for the launch without a transient
+   */
+  class IncrementalPIDController : public BaseController {
+  private:
+    /**
+     * @brief Gains, folded coefficients and state
+     *
+     * @var Kp, Ki, Kd: Controller gains (same meaning as in PIDController)
+     * @var q0, q1, q2: Δu = q0 × e + q1 × e1 + q2 × e2
+     * @var coeff_dt: Time step q0, q1, q2 were computed for
+     * @var e1, e2: Errors of the previous two steps
+     * @var delta: Output change requested by the last step (before limiting)
+     * @var applied_feed_forward: Feed-forward contained in output, kept out of the accumulator
+     */
+    float Kp;
+    float Ki;
+    float Kd;
+    float q0;
+    float q1;
+    float q2;
+    float coeff_dt;
+    float e1;
+    float e2;
+    float delta;
+    float applied_feed_forward;
+
+    /**
+     * @brief Fold the gains and the current dt into q0, q1, q2
+     */
+    void updateCoefficients();
+
+  protected:
+    /**
+     * @brief Snapshot layout: internal[0] = e1, internal[1] = e2, internal[2] = last
+     * delta, internal[3] = feed-forward contained in the output
+     */
+    void saveState(ControllerState &state) const override;
+    void loadState(const ControllerState &state) override;
+
+  public:
+    /**
+     * @brief Construct a new incremental PID controller
+     *
+     * @param Kp: Proportional gain
+     * @param Ki: Integral gain
+     * @param Kd: Derivative gain
+     * @param dt_ms: Time step in milliseconds
+     * @param min_output: Minimum output value (default -1023 for 10-bit PWM)
+     * @param max_output: Maximum output value (default 1023 for 10-bit PWM)
+     * @param debug: Enable debug output for tuning (default false)
+     */
+    IncrementalPIDController(float Kp, float Ki, float Kd, uint32_t dt_ms = 1, float min_output = -1023.0f,
+                             float max_output = 1023.0f, bool debug = false);
+
+    /**
+     * @brief Initialize the controller
+     *
+     * @return bool true on success, false if parameters are invalid
+     */
+    bool init() override;
+
+    /**
+     * @brief Reset the output and error history to zero
+     */
+    void reset() override;
+
+    ControllerKind getKind() const override;
+
+    /**
+     * @brief Continue from another controller's output without a jump
+     *
+     * @param output: Last output of the controller being replaced
+     * @param error: Current error (setpoint - measured_value)
+     */
+    void bumplessTransfer(float output, float error) override;
+
+    /**
+     * @brief Calculate the next output by adding the increment
+     *
+     * @param error: Current error (setpoint - measured_value)
+     * @return float Controller output between min_output and max_output
+     */
+    float compute(float error) override;
+    using BaseController::compute;
+
+    /**
+     * @brief Set the proportional gain (bumpless)
+     *
+     * @param Kp: Proportional gain
+     */
+    void setKp(float Kp);
+
+    /**
+     * @brief Set the integral gain (bumpless)
+     *
+     * @param Ki: Integral gain
+     */
+    void setKi(float Ki);
+
+    /**
+     * @brief Set the derivative gain (bumpless)
+     *
+     * @param Kd: Derivative gain
+     */
+    void setKd(float Kd);
+
+    /**
+     * @brief Set all gains at once (bumpless)
+     *
+     * @param Kp: Proportional gain
+     * @param Ki: Integral gain
+     * @param Kd: Derivative gain
+     */
+    void setGains(float Kp, float Ki, float Kd);
+
+    float getKp() const;
+    float getKi() const;
+    float getKd() const;
+
+    /**
+     * @brief Get the output change requested by the last step
+     *
+     * Useful to see how hard the controller is pushing against a limit.
+     *
+     * @return float Δu of the last compute(), before limiting
+     */
+    float getLastDelta() const;
+  };
+
+} // namespace controller
@@ -0,0 +1,79 @@
+#include "LQRController.h"
+
+namespace controller {
+
+  LQRController::LQRController(uint32_t dt_ms, float min_output, float max_output, bool debug)
+      : StateSpaceController(dt_ms, min_output, max_output, debug) {
+    K[0] = control_tables::LQR_K[0];
+    K[1] = control_tables::LQR_K[1];
+
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      Serial.print(F("LQRController: Created with K=["));
+      Serial.print(K[0], 3);
+      Serial.print(F(", "));
+      Serial.print(K[1], 4);
+      Serial.println(F("]"));
+    }
+  }
+
+  bool LQRController::init() {
+    if (!StateSpaceController::init()) {
+      LOG_ERROR(F("ERROR: LQRController::init() - Base initialization failed"));
+      return false;
+    }
+
+    debugLog(F("LQRController initialized successfully"));
+    return true;
+  }
+
+  ControllerKind LQRController::getKind() const {
+    return ControllerKind::LQR;
+  }
+
+  float LQRController::compute(float error) {
+    estimate(error);
+
+    // Feed-forward is added before the limits, like in the PID family
+    float u = K[0] * x_hat[0] + K[1] * x_hat[1];
+    output = applyLimits(u + feed_forward, min_output, max_output);
+    applied_input = output;
+
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      Serial.print(F("LQR: error="));
+      Serial.print(error, 3);
+      Serial.print(F(", e_hat="));
+      Serial.print(x_hat[0], 3);
+      Serial.print(F(", rate_hat="));
+      Serial.print(x_hat[1], 3);
+      Serial.print(F(", output="));
+      Serial.println(output, 3);
+    }
+
+    return output;
+  }
+
+  void LQRController::setGains(float k_error, float k_rate) {
+    if (k_error < 0.0f || k_rate < 0.0f) {
+      debugLog(F("WARNING: setGains() - Negative gains can cause instability"));
+    }
+
+    K[0] = k_error;
+    K[1] = k_rate;
+
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      Serial.print(F("LQR gains updated - K_error="));
+      Serial.print(k_error, 3);
+      Serial.print(F(", K_rate="));
+      Serial.println(k_rate, 4);
+    }
+  }
+
+  float LQRController::getErrorGain() const {
+    return K[0];
+  }
+
+  float LQRController::getRateGain() const {
+    return K[1];
+  }
+
+} // namespace controller
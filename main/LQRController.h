@@ -0,0 +1,78 @@
+#pragma once
+
+#include "StateSpaceController.h"
+
+namespace controller {
+
+  /**
+   * @brief Linear-quadratic regulator on the observed line state
+   *
+   * Output = K[0] × ê + K[1] × ê'
+   *
+   * The gains minimise Σ (xᵀQx + R u²) for the kinematic lateral model in
+   * ControlTables.h and are computed offline by tools/gen_control_tables.py
+   * from the robot's speed, steering authority and the chosen weights, so
+   * tuning means regenerating the tables rather than adjusting Kp and Kd by
+   * hand. Compared with a PD on a differentiated error, the rate comes from
+   * the observer (see StateSpaceController), which uses the steering command
+   * and therefore reacts without the filter lag.
+   *
+   * Cost per step: the observer and the law are 8 multiply-adds, well inside
+   * any control period.
+   *
+   * For line following robots:
+   * - The tables are valid for the speed they were generated for; regenerate
+   *   them when BASE_SPEED changes noticeably
+   * - Raise --q-position for a tighter line, raise --r for smoother steering
+   */
+  class LQRController : public StateSpaceController {
+  private:
+    /**
+     * @brief State feedback gains
+     *
+     * @var K: u = K[0] × error + K[1] × error rate (from control_tables::LQR_K)
+     */
+    float K[2];
+
+  public:
+    /**
+     * @brief Construct a new LQR controller with the generated gains
+     *
+     * @param dt_ms: Time step in milliseconds (must match control_tables::DT)
+     * @param min_output: Minimum output value (default -1023 for 10-bit PWM)
+     * @param max_output: Maximum output value (default 1023 for 10-bit PWM)
+     * @param debug: Enable debug output (default false)
+     */
+    LQRController(uint32_t dt_ms = 1, float min_output = -1023.0f, float max_output = 1023.0f, bool debug = false);
+
+    /**
+     * @brief Initialize the LQR controller
+     *
+     * @return bool true on success, false if the tables do not fit the sample time
+     */
+    bool init() override;
+
+    ControllerKind getKind() const override;
+
+    /**
+     * @brief Update the observer and apply the state feedback
+     *
+     * @param error: Current error (setpoint - measured_value)
+     * @return float Controller output between min_output and max_output
+     */
+    float compute(float error) override;
+    using BaseController::compute;
+
+    /**
+     * @brief Override the generated gains, e.g. for experiments on the track
+     *
+     * @param k_error: Gain on the estimated error (should be > 0)
+     * @param k_rate: Gain on the estimated error rate (should be > 0)
+     */
+    void setGains(float k_error, float k_rate);
+
+    float getErrorGain() const;
+    float getRateGain() const;
+  };
+
+} // namespace controller
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <stdint.h>
+
+// Ask GCC to fully unroll the per-sensor loop; other compilers unroll a
+// small constant trip count on their own
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 8
+#define LINE_ESTIMATOR_UNROLL _Pragma("GCC unroll 32")
+#else
+#define LINE_ESTIMATOR_UNROLL
+#endif
+
+namespace sensing {
+
+  /**
+   * @brief Integer-only weighted-centroid line position estimator
+   *
+   * Computes position = sum(w[i] * v[i]) / sum(v[i]) with integer weights,
+   * 32-bit accumulators and a single integer divide per estimate. The sensor
+   * count is a template parameter, so the per-sensor loop has a constant trip
+   * count and is unrolled by the compiler.
+   *
+   * Each reading is conditioned before it is accumulated:
+   * - values above the saturation threshold are clipped to it, so a single
+   *   sensor over a glossy patch cannot dominate the centroid
+   * - the noise floor is subtracted (clipping at zero), so the background
+   *   reflectance of the track does not pull the centroid towards the middle
+   *
+   * If nothing remains above the noise floor the result is NO_LINE, an
+   * integer sentinel that lies outside the weight range (no NaN involved).
+   *
+   * The default weights are WEIGHT_STEP apart and centred on zero, i.e.
+   * -3500, -2500, ..., 3500 for 8 sensors, so the position is in thousandths
+   * of the sensor pitch.
+   *
+   * @tparam SENSOR_COUNT: Number of sensors in the array (2-32)
+   */
+  template <uint8_t SENSOR_COUNT>
+  class LineEstimator {
+    static_assert(SENSOR_COUNT >= 2 && SENSOR_COUNT <= 32, "LineEstimator supports 2-32 sensors");
+
+  public:
+    /**
+     * @brief Estimator constants
+     *
+     * @var NO_LINE: Returned when no sensor reads above the noise floor
+     * @var WEIGHT_STEP: Spacing of the default weights (position units per sensor)
+     * @var DEFAULT_NOISE_FLOOR: Default noise floor, matching QTR's readLine() threshold
+     * @var DEFAULT_SATURATION: Default saturation threshold, the top of QTR's calibrated range
+     */
+    static const int32_t NO_LINE = INT32_MIN;
+    static const int32_t WEIGHT_STEP = 1000;
+    static const uint16_t DEFAULT_NOISE_FLOOR = 50;
+    static const uint16_t DEFAULT_SATURATION = 1000;
+
+    /**
+     * @brief Construct an estimator with evenly spaced, centred weights
+     *
+     * @param noise_floor: Readings at or below this value are ignored
+     * @param saturation: Readings are clipped to this value
+     */
+    explicit LineEstimator(uint16_t noise_floor = DEFAULT_NOISE_FLOOR,
+                           uint16_t saturation = DEFAULT_SATURATION)
+        : noise_floor(0), saturation(0), signal(0) {
+      for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        weights[i] = (int16_t)(WEIGHT_STEP * i - (WEIGHT_STEP / 2) * (SENSOR_COUNT - 1));
+      }
+      if (!setThresholds(noise_floor, saturation)) {
+        setThresholds(DEFAULT_NOISE_FLOOR, DEFAULT_SATURATION);
+      }
+    }
+
+    /**
+     * @brief Estimate the line position from one frame of readings
+     *
+     * @param values: SENSOR_COUNT readings, typically calibrated 0-1000
+     * @return int32_t Weighted position in weight units, or NO_LINE
+     */
+    inline int32_t estimate(const uint16_t *values) {
+      int32_t numerator = 0;
+      int32_t denominator = 0;
+
+      LINE_ESTIMATOR_UNROLL
+      for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        int32_t v = values[i];
+        v = (v > saturation) ? saturation : v;
+        v = (v > noise_floor) ? v - noise_floor : 0;
+        numerator += weights[i] * v;
+        denominator += v;
+      }
+
+      signal = denominator;
+      if (denominator == 0) {
+        return NO_LINE;
+      }
+
+      // Round to nearest rather than truncating towards zero, so the
+      // estimate is symmetric about the centre of the array
+      int32_t half = denominator >> 1;
+      return (numerator >= 0 ? numerator + half : numerator - half) / denominator;
+    }
+
+    /**
+     * @brief Check whether an estimate found the line
+     *
+     * @param position: Value returned by estimate()
+     * @return bool true unless position is NO_LINE
+     */
+    static inline bool hasLine(int32_t position) {
+      return position != NO_LINE;
+    }
+
+    /**
+     * @brief Set the noise floor and saturation threshold
+     *
+     * Rejected (state unchanged) if the saturation is not above the noise
+     * floor or if the weights could overflow the 32-bit accumulator.
+     *
+     * @param noise_floor: Readings at or below this value are ignored
+     * @param saturation: Readings are clipped to this value
+     * @return bool true if the thresholds were accepted
+     */
+    bool setThresholds(uint16_t noise_floor, uint16_t saturation) {
+      if (saturation <= noise_floor || !fitsAccumulator(weights, saturation - noise_floor)) {
+        return false;
+      }
+      this->noise_floor = noise_floor;
+      this->saturation = saturation;
+      return true;
+    }
+
+    /**
+     * @brief Replace the per-sensor weights
+     *
+     * Use this for arrays with uneven sensor spacing. Rejected (weights
+     * unchanged) if they could overflow the 32-bit accumulator at the
+     * current saturation threshold.
+     *
+     * @param new_weights: SENSOR_COUNT weights, left to right
+     * @return bool true if the weights were accepted
+     */
+    bool setWeights(const int16_t *new_weights) {
+      if (!fitsAccumulator(new_weights, saturation - noise_floor)) {
+        return false;
+      }
+      for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        weights[i] = new_weights[i];
+      }
+      return true;
+    }
+
+    inline uint16_t getNoiseFloor() const { return noise_floor; }
+    inline uint16_t getSaturation() const { return saturation; }
+    inline int16_t getWeight(uint8_t index) const { return weights[index]; }
+
+    /**
+     * @brief Get the total conditioned signal of the last estimate
+     *
+     * A low value means the line is only faintly visible; 0 means NO_LINE.
+     *
+     * @return int32_t Sum of the conditioned readings
+     */
+    inline int32_t getSignal() const { return signal; }
+
+  private:
+    /**
+     * @brief Check that sum(|w[i]|) * max_value fits in an int32_t
+     */
+    static bool fitsAccumulator(const int16_t *w, int32_t max_value) {
+      int64_t bound = 0;
+      for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        bound += (w[i] < 0 ? -(int64_t)w[i] : (int64_t)w[i]) * max_value;
+      }
+      return bound <= INT32_MAX;
+    }
+
+    /**
+     * @brief Estimator configuration and last result
+     *
+     * @var weights: Position weight of each sensor
+     * @var noise_floor: Subtracted from every reading, clipping at zero
+     * @var saturation: Upper clip applied before the noise floor
+     * @var signal: Denominator of the last estimate
+     */
+    int16_t weights[SENSOR_COUNT];
+    int32_t noise_floor;
+    int32_t saturation;
+    int32_t signal;
+  };
+
+} // namespace sensing
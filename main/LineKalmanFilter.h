@@ -0,0 +1,214 @@
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+namespace sensing {
+
+  /**
+   * @brief Constant-velocity Kalman filter on the line position
+   *
+   * Tracks the line position p and its velocity v under the array with the
+   * model
+   *
+   *   p(k+1) = p(k) + dt × v(k) + dt²/2 × a(k)
+   *   v(k+1) = v(k) + dt × a(k)
+   *   z(k)   = p(k) + w(k)
+   *
+   * where a is a white acceleration (RMS accel_noise) and w the estimator
+   * noise (RMS position_noise). At a fixed rate the covariance converges to
+   * a constant, and so does the gain; configure() computes that gain once
+   * from the closed form for this model (Kalata's tracking index)
+   *
+   *   λ = accel_noise × dt² / position_noise
+   *   α = -(λ² + 8λ - (λ + 4) × √(λ² + 8λ)) / 8
+   *   β = (λ² + 4λ - λ × √(λ² + 8λ)) / 4
+   *   K = [α, β / dt]
+   *
+   * so a cycle costs five multiply-adds and no covariance update. The
+   * transient gains of the first few cycles are skipped; the first
+   * measurement seeds the position with zero velocity instead.
+   *
+   * The velocity is a cleaner D-term input than a difference of two noisy
+   * positions, and during a short NO_LINE gap (a crossing, a gap in the
+   * tape, a glare spot) predict() coasts on it for up to max_gap cycles
+   * before the filter gives up.
+   *
+   * @note The gain assumes update()/predict() are called every dt; a jittery
+   *       loop only shifts the effective noise ratio slightly.
+   */
+  class LineKalmanFilter {
+  public:
+    /**
+     * @brief Construct a filter
+     *
+     * @param dt_s: Interval between update()/predict() calls in seconds
+     * @param accel_noise: RMS acceleration of the line under the array (units/s²)
+     * @param position_noise: RMS noise of the measured position (units)
+     * @param max_gap: Cycles predict() may bridge without a measurement
+     * @param position_limit: |position| clamp during prediction (0 = none)
+     */
+    explicit LineKalmanFilter(float dt_s = 0.001f, float accel_noise = 500.0f, float position_noise = 0.02f,
+                              uint16_t max_gap = 30, float position_limit = 0.0f)
+        : dt(0.001f), alpha(1.0f), beta_dt(0.0f), max_gap(max_gap),
+          position_limit(position_limit > 0.0f ? position_limit : 0.0f), position(0.0f), velocity(0.0f),
+          gap(0), tracking(false) {
+      if (!configure(dt_s, accel_noise, position_noise)) {
+        configure(0.001f, 500.0f, 0.02f);
+      }
+    }
+
+    /**
+     * @brief Set the model and compute the steady-state gain
+     *
+     * Resets the filter.
+     *
+     * @param dt_s: Interval between calls in seconds (> 0)
+     * @param accel_noise: RMS acceleration of the line (> 0)
+     * @param position_noise: RMS measurement noise (> 0)
+     * @return bool true on success, false if a parameter is invalid
+     */
+    inline bool configure(float dt_s, float accel_noise, float position_noise) {
+      if (dt_s <= 0.0f || accel_noise <= 0.0f || position_noise <= 0.0f) {
+        return false;
+      }
+
+      float lambda = accel_noise * dt_s * dt_s / position_noise;
+      float root = sqrtf(lambda * lambda + 8.0f * lambda);
+      dt = dt_s;
+      alpha = -(lambda * lambda + 8.0f * lambda - (lambda + 4.0f) * root) / 8.0f;
+      beta_dt = (lambda * lambda + 4.0f * lambda - lambda * root) / 4.0f / dt_s;
+      reset();
+      return true;
+    }
+
+    /**
+     * @brief Forget the track; the next update() seeds it again
+     */
+    inline void reset() {
+      position = 0.0f;
+      velocity = 0.0f;
+      gap = 0;
+      tracking = false;
+    }
+
+    /**
+     * @brief Predict one cycle ahead and correct with a measurement
+     *
+     * @param measured: Measured line position
+     */
+    inline void update(float measured) {
+      if (!tracking) {
+        position = measured;
+        velocity = 0.0f;
+        gap = 0;
+        tracking = true;
+        return;
+      }
+
+      float predicted = position + dt * velocity;
+      float residual = measured - predicted;
+      position = predicted + alpha * residual;
+      velocity += beta_dt * residual;
+      gap = 0;
+    }
+
+    /**
+     * @brief Predict one cycle ahead without a measurement (line not seen)
+     *
+     * The position is clamped to the position limit, where the velocity is
+     * zeroed: the line has left the array and its speed is unknown.
+     *
+     * @return bool true while the prediction is usable, false once the gap
+     *              exceeds max_gap cycles (the track is then dropped)
+     */
+    inline bool predict() {
+      if (!tracking) {
+        return false;
+      }
+      if (gap >= max_gap) {
+        tracking = false;
+        return false;
+      }
+
+      gap++;
+      position += dt * velocity;
+      if (position_limit > 0.0f) {
+        if (position > position_limit) {
+          position = position_limit;
+          velocity = 0.0f;
+        } else if (position < -position_limit) {
+          position = -position_limit;
+          velocity = 0.0f;
+        }
+      }
+      return true;
+    }
+
+    /**
+     * @brief Set how long predict() may bridge a gap
+     *
+     * @param max_gap: Cycles without a measurement (0 = no prediction)
+     */
+    inline void setMaxGap(uint16_t max_gap) {
+      this->max_gap = max_gap;
+    }
+
+    /**
+     * @brief Set the clamp applied to predicted positions
+     *
+     * @param limit: Largest |position|, e.g. the edge of the array (0 = none)
+     */
+    inline void setPositionLimit(float limit) {
+      position_limit = limit > 0.0f ? limit : 0.0f;
+    }
+
+    inline float getPosition() const { return position; }
+    inline float getVelocity() const { return velocity; }
+
+    /**
+     * @brief Check whether the filter holds a track
+     *
+     * @return bool true after an update() until reset() or a gap too long
+     */
+    inline bool isTracking() const { return tracking; }
+
+    /**
+     * @brief Cycles since the last measurement
+     */
+    inline uint16_t getGap() const { return gap; }
+    inline uint16_t getMaxGap() const { return max_gap; }
+
+    /**
+     * @brief Steady-state gain
+     *
+     * @return float Position gain α, or velocity gain β/dt (1/s)
+     */
+    inline float getPositionGain() const { return alpha; }
+    inline float getVelocityGain() const { return beta_dt; }
+
+  private:
+    /**
+     * @brief Filter configuration and state
+     *
+     * @var dt: Interval between calls in seconds
+     * @var alpha: Steady-state position gain
+     * @var beta_dt: Steady-state velocity gain β/dt
+     * @var max_gap: Cycles predict() may bridge
+     * @var position_limit: |position| clamp during prediction (0 = none)
+     * @var position, velocity: State estimate
+     * @var gap: Cycles since the last measurement
+     * @var tracking: A measurement seeded the state
+     */
+    float dt;
+    float alpha;
+    float beta_dt;
+    uint16_t max_gap;
+    float position_limit;
+    float position;
+    float velocity;
+    uint16_t gap;
+    bool tracking;
+  };
+
+} // namespace sensing
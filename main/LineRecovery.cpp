@@ -0,0 +1,75 @@
+#include "LineRecovery.h"
+
+namespace controller {
+
+  LineRecovery::LineRecovery(float search_steering, uint32_t search_timeout_us, float search_speed_scale,
+                             float centre_band)
+      : search_steering(0.0f), search_timeout_us(0), search_speed_scale(search_speed_scale),
+        centre_band(centre_band < 0.0f ? -centre_band : centre_band) {
+    if (this->search_speed_scale < 0.0f) {
+      this->search_speed_scale = 0.0f;
+    } else if (this->search_speed_scale > 1.0f) {
+      this->search_speed_scale = 1.0f;
+    }
+    setSearch(search_steering, search_timeout_us);
+    reset();
+  }
+
+  void LineRecovery::reset() {
+    state = State::TRACKING;
+    side = 0;
+    search_start_us = 0;
+    recoveries = 0;
+  }
+
+  void LineRecovery::track(float position, float velocity) {
+    if (state == State::STOPPED) {
+      return;
+    }
+    if (state == State::SEARCHING) {
+      state = State::TRACKING;
+      recoveries++;
+    }
+
+    // Near the centre the position sign is noise; the velocity tells where the line went
+    float cue = (position > centre_band || position < -centre_band) ? position : velocity;
+    side = cue > 0.0f ? 1 : (cue < 0.0f ? -1 : 0);
+  }
+
+  float LineRecovery::search(uint32_t now_us) {
+    if (state == State::TRACKING) {
+      state = State::SEARCHING;
+      search_start_us = now_us;
+    }
+    if (state == State::SEARCHING && (uint32_t)(now_us - search_start_us) >= search_timeout_us) {
+      state = State::STOPPED;
+    }
+    if (state == State::STOPPED) {
+      return 0.0f;
+    }
+
+    // Turn towards the line: positive side needs negative steering
+    return -side * search_steering;
+  }
+
+  void LineRecovery::setSearch(float search_steering, uint32_t search_timeout_us) {
+    this->search_steering = search_steering < 0.0f ? -search_steering : search_steering;
+    this->search_timeout_us = search_timeout_us;
+  }
+
+  float LineRecovery::getSpeedScale() const {
+    switch (state) {
+    case State::TRACKING:
+      return 1.0f;
+    case State::SEARCHING:
+      return search_speed_scale;
+    default:
+      return 0.0f;
+    }
+  }
+
+  uint32_t LineRecovery::getSearchTime(uint32_t now_us) const {
+    return state == State::SEARCHING ? (uint32_t)(now_us - search_start_us) : 0;
+  }
+
+} // namespace controller
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace controller {
+
+  /**
+   * @brief Line-loss recovery: search towards the last known side, then stop
+   *
+   * Losing the line in a sharp turn usually means it left the array on the
+   * outside of the bend: the last positions were already at one edge. The
+   * recovery remembers the side and velocity of the line from the cycles
+   * where it was seen, and when it is lost commands a fixed, bounded turn
+   * towards that side instead of holding whatever (often saturated)
+   * command the line controller produced last.
+   *
+   * States:
+   * - TRACKING: the line is seen; track() records its position and velocity
+   * - SEARCHING: search() returns the search turn until the line is seen
+   *   again or search_timeout_us has passed
+   * - STOPPED: the search timed out; steering and speed are zero until
+   *   reset(), the line reappearing does not restart the run
+   *
+   * The side is the sign of the last position when it is outside the
+   * centre band, otherwise the sign of the last velocity (the line was
+   * moving off that way); a line lost near the centre while standing
+   * still, e.g. at the end of the tape, is searched straight ahead.
+   *
+   * Every call is a few comparisons on a caller-supplied timestamp, with
+   * no waiting, so the control loop keeps its rate during the search.
+   * Short gaps are better bridged before the search starts, e.g. by
+   * LineKalmanFilter::predict(), with track() fed the predicted values.
+   *
+   * Sign convention: positive position is the side that needs negative
+   * steering (error = -position), as for the line controller.
+   */
+  class LineRecovery {
+  public:
+    /**
+     * @brief Recovery states
+     */
+    enum class State : uint8_t {
+      TRACKING,
+      SEARCHING,
+      STOPPED,
+    };
+
+    /**
+     * @brief Construct a recovery
+     *
+     * @param search_steering: Magnitude of the search turn (steering units)
+     * @param search_timeout_us: Search time before stopping in µs
+     * @param search_speed_scale: Fraction of the base speed while searching (0-1)
+     * @param centre_band: |position| below which the velocity picks the side
+     */
+    LineRecovery(float search_steering, uint32_t search_timeout_us, float search_speed_scale = 0.5f,
+                 float centre_band = 0.5f);
+
+    /**
+     * @brief Back to TRACKING with no side remembered, e.g. at START
+     */
+    void reset();
+
+    /**
+     * @brief Record a cycle with the line seen
+     *
+     * Leaves SEARCHING; has no effect once STOPPED.
+     *
+     * @param position: Line position, 0 = centre
+     * @param velocity: Line velocity in position units per second
+     */
+    void track(float position, float velocity);
+
+    /**
+     * @brief Steering for a cycle without the line
+     *
+     * The first call after track() starts the search budget.
+     *
+     * @param now_us: Current time in microseconds (e.g. micros())
+     * @return float Search turn while SEARCHING, 0 once STOPPED
+     */
+    float search(uint32_t now_us);
+
+    /**
+     * @brief Set the search turn and time budget
+     *
+     * @param search_steering: Magnitude of the search turn (negative values use their magnitude)
+     * @param search_timeout_us: Search time before stopping in µs
+     */
+    void setSearch(float search_steering, uint32_t search_timeout_us);
+
+    inline State getState() const { return state; }
+    inline bool isSearching() const { return state == State::SEARCHING; }
+    inline bool isStopped() const { return state == State::STOPPED; }
+
+    /**
+     * @brief Side the line was last seen on
+     *
+     * @return int8_t +1 positive side, -1 negative side, 0 centre / unknown
+     */
+    inline int8_t getSide() const { return side; }
+
+    /**
+     * @brief Speed command relative to the base speed
+     *
+     * @return float 1 while tracking, search_speed_scale while searching, 0 once stopped
+     */
+    float getSpeedScale() const;
+
+    /**
+     * @brief Time spent in the current search
+     *
+     * @param now_us: Current time in microseconds
+     * @return uint32_t Search time in µs, 0 unless SEARCHING
+     */
+    uint32_t getSearchTime(uint32_t now_us) const;
+
+    /**
+     * @brief Number of searches that found the line again since reset()
+     */
+    inline uint16_t getRecoveries() const { return recoveries; }
+
+  private:
+    /**
+     * @brief Recovery configuration and state
+     *
+     * @var search_steering: Magnitude of the search turn
+     * @var search_timeout_us: Search time budget
+     * @var search_speed_scale: Speed fraction while searching
+     * @var centre_band: |position| below which the velocity picks the side
+     * @var state: Current state
+     * @var side: Last known side of the line (-1, 0, +1)
+     * @var search_start_us: micros() of the first cycle without the line
+     * @var recoveries: Searches that found the line again
+     */
+    float search_steering;
+    uint32_t search_timeout_us;
+    float search_speed_scale;
+    float centre_band;
+    State state;
+    int8_t side;
+    uint32_t search_start_us;
+    uint16_t recoveries;
+  };
+
+} // namespace controller
@@ -0,0 +1,55 @@
+#pragma once
+
+/**
+ * @file LogConfig.h
+ * @brief Compile-time log levels for the controllers and the calibration manager
+ *
+ * Every log statement in BaseController, the P/PI/PD/PID controllers,
+ * EEPROMCalibrationManager, ControlScheduler, ContinuousAdcSource and
+ * MuxScanner is guarded by one of the constants below. They are
+ * preprocessor constants, so a disabled level leaves no code, no flash
+ * strings and no run-time check behind: the per-call debug_enabled test in
+ * compute() and the setters disappears together with the output.
+ *
+ * Levels (each includes the ones above it):
+ * - LOG_LEVEL_NONE:    no output at all
+ * - LOG_LEVEL_ERROR:   failed initialization and data errors
+ * - LOG_LEVEL_WARNING: suspicious parameters that were accepted or corrected
+ * - LOG_LEVEL_DEBUG:   per-object debug output, still switched at run time by
+ *                      the debug flag of each object (the previous behavior)
+ *
+ * Select a level by defining LOG_LEVEL before this header is included, e.g.
+ * with -DLOG_LEVEL=LOG_LEVEL_WARNING in build_opt.h or the build flags.
+ * Release builds should use LOG_LEVEL_WARNING or lower.
+ */
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARNING 2
+#define LOG_LEVEL_DEBUG 3
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+#define LOG_ERRORS_ENABLED (LOG_LEVEL >= LOG_LEVEL_ERROR)
+#define LOG_WARNINGS_ENABLED (LOG_LEVEL >= LOG_LEVEL_WARNING)
+#define LOG_DEBUG_ENABLED (LOG_LEVEL >= LOG_LEVEL_DEBUG)
+
+/**
+ * @brief Single-line error and warning output
+ *
+ * The argument is not evaluated when the level is disabled, so F() strings
+ * passed here are stripped from the image as well.
+ */
+#if LOG_ERRORS_ENABLED
+#define LOG_ERROR(message) Serial.println(message)
+#else
+#define LOG_ERROR(message) ((void)0)
+#endif
+
+#if LOG_WARNINGS_ENABLED
+#define LOG_WARNING(message) Serial.println(message)
+#else
+#define LOG_WARNING(message) ((void)0)
+#endif
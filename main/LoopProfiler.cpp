@@ -0,0 +1,102 @@
+#include "LoopProfiler.h"
+
+namespace rt {
+
+  StageStats LoopProfiler::table[(uint8_t)Stage::COUNT];
+
+  void LoopProfiler::record(Stage stage, uint32_t ticks) {
+    StageStats &entry = table[(uint8_t)stage];
+
+    if (entry.count == 0 || ticks < entry.min_ticks) {
+      entry.min_ticks = ticks;
+    }
+    if (ticks > entry.max_ticks) {
+      entry.max_ticks = ticks;
+    }
+    entry.count++;
+    entry.total_ticks += ticks;
+
+    // Bucket index is floor(log2(ticks)); zero-length samples land in bucket 0
+    uint8_t bucket = (ticks == 0) ? 0 : (uint8_t)(31 - __builtin_clz(ticks));
+    entry.histogram[bucket]++;
+  }
+
+  void LoopProfiler::reset() {
+    for (uint8_t s = 0; s < (uint8_t)Stage::COUNT; s++) {
+      StageStats &entry = table[s];
+      entry.count = 0;
+      entry.min_ticks = 0;
+      entry.max_ticks = 0;
+      entry.total_ticks = 0;
+      for (uint8_t b = 0; b < StageStats::HISTOGRAM_BUCKETS; b++) {
+        entry.histogram[b] = 0;
+      }
+    }
+  }
+
+  const StageStats &LoopProfiler::getStats(Stage stage) {
+    return table[(uint8_t)stage];
+  }
+
+  const char *LoopProfiler::getStageName(Stage stage) {
+    switch (stage) {
+    case Stage::ACQUIRE:
+      return "acquire";
+    case Stage::ESTIMATE:
+      return "estimate";
+    case Stage::ESTIMATE_SHADOW:
+      return "estimate (shadow)";
+    case Stage::CONTROL:
+      return "control";
+    case Stage::TELEMETRY:
+      return "telemetry";
+    default:
+      return "unknown";
+    }
+  }
+
+#if defined(ARDUINO)
+  void LoopProfiler::dump(Print &out) {
+    // Ticks are converted to microseconds for the summary columns
+    float ticks_per_us = ticksPerMicrosecond();
+
+#if defined(ESP_PLATFORM)
+    out.println(F("=== CONTROL LOOP PROFILE (us; histogram buckets in CPU cycles) ==="));
+#else
+    out.println(F("=== CONTROL LOOP PROFILE (us; histogram buckets in ns) ==="));
+#endif
+
+    for (uint8_t s = 0; s < (uint8_t)Stage::COUNT; s++) {
+      const StageStats &entry = table[s];
+
+      out.print(getStageName((Stage)s));
+      out.print(F(": n="));
+      out.print(entry.count);
+
+      if (entry.count == 0) {
+        out.println();
+        continue;
+      }
+
+      out.print(F(" min="));
+      out.print(entry.min_ticks / ticks_per_us, 2);
+      out.print(F(" mean="));
+      out.print((float)(entry.total_ticks / entry.count) / ticks_per_us, 2);
+      out.print(F(" max="));
+      out.println(entry.max_ticks / ticks_per_us, 2);
+
+      // Only print populated buckets to keep the dump short
+      for (uint8_t b = 0; b < StageStats::HISTOGRAM_BUCKETS; b++) {
+        if (entry.histogram[b] == 0) {
+          continue;
+        }
+        out.print(F("  [2^"));
+        out.print(b);
+        out.print(F("] "));
+        out.println(entry.histogram[b]);
+      }
+    }
+  }
+#endif
+
+} // namespace rt
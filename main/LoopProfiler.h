@@ -0,0 +1,169 @@
+#pragma once
+
+#include <stdint.h>
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#endif
+#if !defined(ESP_PLATFORM)
+#include <chrono>
+#endif
+
+/**
+ * @brief Compile-time switch for loop profiling
+ *
+ * Define LOOP_PROFILING as 0 to compile every ProfileScope down to nothing.
+ */
+#ifndef LOOP_PROFILING
+#define LOOP_PROFILING 1
+#endif
+
+namespace rt {
+
+  /**
+   * @brief Stages of one control iteration that can be timed
+   */
+  enum class Stage : uint8_t {
+    ACQUIRE,         ///< Sensor conversion (qtr.readLineBlack or equivalent)
+    ESTIMATE,        ///< Line position estimation
+    ESTIMATE_SHADOW, ///< The estimator not in use, on the same frame (PROFILE_SHADOW_ESTIMATOR)
+    CONTROL,         ///< Controller compute()
+    TELEMETRY,       ///< Formatting and printing one telemetry sample
+    COUNT
+  };
+
+  /**
+   * @brief Accumulated timing statistics for one stage
+   *
+   * All durations are in profiler ticks: CPU cycles on the ESP32,
+   * nanoseconds on a host build.
+   *
+   * @var count: Number of recorded samples
+   * @var min_ticks: Shortest recorded duration
+   * @var max_ticks: Longest recorded duration
+   * @var total_ticks: Sum of all durations (for the mean)
+   * @var histogram: Sample counts per power-of-two bucket; bucket b holds durations in [2^b, 2^(b+1))
+   */
+  struct StageStats {
+    static const uint8_t HISTOGRAM_BUCKETS = 32;
+
+    uint32_t count;
+    uint32_t min_ticks;
+    uint32_t max_ticks;
+    uint64_t total_ticks;
+    uint32_t histogram[HISTOGRAM_BUCKETS];
+  };
+
+  /**
+   * @brief Static, allocation-free per-stage latency profiler
+   *
+   * Every stage owns one StageStats entry in a static table. Recording a
+   * sample is a handful of integer operations and never touches the heap, so
+   * it is safe to call from the control task at full rate.
+   *
+   * Each stage should be recorded from a single task. dump() and reset() may
+   * be called from any task; a concurrently updated entry can appear torn,
+   * which is acceptable for diagnostics.
+   */
+  class LoopProfiler {
+  public:
+    /**
+     * @brief Read the profiler clock
+     *
+     * Keyed on ESP_PLATFORM, not ARDUINO: a host build with the Arduino
+     * stubs times real code, so it needs the real steady_clock. Tests feed
+     * simulated durations through record() instead.
+     *
+     * @return uint32_t CPU cycle counter on the ESP32, steady_clock nanoseconds on a host
+     */
+    static inline uint32_t now() {
+#if defined(ESP_PLATFORM)
+      return ESP.getCycleCount();
+#else
+      return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now().time_since_epoch())
+          .count();
+#endif
+    }
+
+    /**
+     * @brief Profiler ticks per microsecond
+     *
+     * @return float CPU clock in MHz on the ESP32, 1000 on a host
+     */
+    static inline float ticksPerMicrosecond() {
+#if defined(ESP_PLATFORM)
+      return (float)ESP.getCpuFreqMHz();
+#else
+      return 1000.0f;
+#endif
+    }
+
+    /**
+     * @brief Record one duration for a stage
+     *
+     * @param stage: Stage the duration belongs to
+     * @param ticks: Elapsed profiler ticks
+     */
+    static void record(Stage stage, uint32_t ticks);
+
+    /**
+     * @brief Clear all statistics
+     */
+    static void reset();
+
+    /**
+     * @brief Get the statistics of one stage
+     *
+     * @param stage: Stage to query
+     * @return const StageStats& Accumulated statistics
+     */
+    static const StageStats &getStats(Stage stage);
+
+    /**
+     * @brief Get a printable stage name
+     *
+     * @param stage: Stage to name
+     * @return const char* Static stage name
+     */
+    static const char *getStageName(Stage stage);
+
+#if defined(ARDUINO)
+    /**
+     * @brief Print min/mean/max (in microseconds) and the histogram of every stage
+     *
+     * @param out: Destination stream, typically Serial
+     */
+    static void dump(Print &out);
+#endif
+
+  private:
+    static StageStats table[(uint8_t)Stage::COUNT];
+  };
+
+  /**
+   * @brief RAII helper that times the enclosing scope
+   *
+   * Usage:
+   *   {
+   *     rt::ProfileScope scope(rt::Stage::ACQUIRE);
+   *     qtr.readLineBlack(sensorValues);
+   *   }
+   */
+  class ProfileScope {
+  public:
+#if LOOP_PROFILING
+    explicit ProfileScope(Stage stage) : stage(stage), start(LoopProfiler::now()) {}
+    ~ProfileScope() {
+      LoopProfiler::record(stage, LoopProfiler::now() - start);
+    }
+
+  private:
+    Stage stage;
+    uint32_t start;
+#else
+    explicit ProfileScope(Stage) {}
+#endif
+  };
+
+} // namespace rt
@@ -0,0 +1,130 @@
+#include "MPCController.h"
+
+namespace controller {
+
+  MPCController::MPCController(uint32_t dt_ms, float min_output, float max_output, bool debug)
+      : StateSpaceController(dt_ms, min_output, max_output, debug), iterations(control_tables::MPC_ITERATIONS) {
+    for (uint8_t i = 0; i < HORIZON; i++) {
+      plan[i] = 0.0f;
+      extrapolated[i] = 0.0f;
+      linear[i] = 0.0f;
+    }
+
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      Serial.print(F("MPCController: Created with horizon="));
+      Serial.print(HORIZON);
+      Serial.print(F("x"));
+      Serial.print(control_tables::MPC_BLOCK);
+      Serial.print(F(" periods, iterations="));
+      Serial.println(iterations);
+    }
+  }
+
+  bool MPCController::init() {
+    if (!StateSpaceController::init()) {
+      LOG_ERROR(F("ERROR: MPCController::init() - Base initialization failed"));
+      return false;
+    }
+
+    debugLog(F("MPCController initialized successfully"));
+    return true;
+  }
+
+  void MPCController::reset() {
+    StateSpaceController::reset();
+    for (uint8_t i = 0; i < HORIZON; i++) {
+      plan[i] = 0.0f;
+    }
+    debugLog(F("MPCController plan cleared"));
+  }
+
+  void MPCController::bumplessTransfer(float output, float error) {
+    StateSpaceController::bumplessTransfer(output, error);
+
+    float feedback = this->output - feed_forward;
+    for (uint8_t i = 0; i < HORIZON; i++) {
+      plan[i] = feedback;
+    }
+  }
+
+  ControllerKind MPCController::getKind() const {
+    return ControllerKind::MPC;
+  }
+
+  void MPCController::loadState(const ControllerState &state) {
+    StateSpaceController::loadState(state);
+
+    float feedback = output - feed_forward;
+    for (uint8_t i = 0; i < HORIZON; i++) {
+      plan[i] = feedback;
+    }
+  }
+
+  float MPCController::compute(float error) {
+    using namespace control_tables;
+
+    estimate(error);
+
+    // The feed-forward is applied on top, so the plan gets the remaining room
+    const float low = min_output - feed_forward;
+    const float high = max_output - feed_forward;
+
+    for (uint8_t i = 0; i < HORIZON; i++) {
+      linear[i] = MPC_F[i][0] * x_hat[0] + MPC_F[i][1] * x_hat[1];
+      plan[i] = applyLimits(plan[i], low, high);
+      extrapolated[i] = plan[i];
+    }
+
+    // Fast projected gradient: a fixed number of steps keeps the time fixed
+    float next[HORIZON];
+    for (uint8_t k = 0; k < iterations; k++) {
+      for (uint8_t i = 0; i < HORIZON; i++) {
+        float gradient = linear[i];
+        for (uint8_t j = 0; j < HORIZON; j++) {
+          gradient += MPC_H[i][j] * extrapolated[j];
+        }
+        next[i] = applyLimits(extrapolated[i] - MPC_STEP * gradient, low, high);
+      }
+      for (uint8_t i = 0; i < HORIZON; i++) {
+        extrapolated[i] = next[i] + MPC_MOMENTUM * (next[i] - plan[i]);
+        plan[i] = next[i];
+      }
+    }
+
+    output = applyLimits(plan[0] + feed_forward, min_output, max_output);
+    applied_input = output;
+
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      Serial.print(F("MPC: error="));
+      Serial.print(error, 3);
+      Serial.print(F(", e_hat="));
+      Serial.print(x_hat[0], 3);
+      Serial.print(F(", rate_hat="));
+      Serial.print(x_hat[1], 3);
+      Serial.print(F(", output="));
+      Serial.println(output, 3);
+    }
+
+    return output;
+  }
+
+  void MPCController::setIterations(uint8_t iterations) {
+    if (iterations == 0) {
+      debugLog(F("WARNING: setIterations() - At least one iteration is needed, using 1"));
+      iterations = 1;
+    }
+    this->iterations = iterations;
+  }
+
+  uint8_t MPCController::getIterations() const {
+    return iterations;
+  }
+
+  float MPCController::getPlannedMove(uint8_t index) const {
+    if (index >= HORIZON) {
+      return 0.0f;
+    }
+    return plan[index];
+  }
+
+} // namespace controller
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "StateSpaceController.h"
+
+namespace controller {
+
+  /**
+   * @brief Short-horizon model predictive controller with input constraints
+   *
+   * Plans N steering moves U (each held for MPC_BLOCK control periods)
+   * that minimise the predicted cost of the lateral model in
+   * ControlTables.h, subject to the output limits, and applies the first:
+   *
+   *   min_U  ½ Uᵀ H U + Uᵀ F x̂    s.t.  min_output ≤ U ≤ max_output
+   *
+   * The problem is condensed offline (tools/gen_control_tables.py), so only
+   * the N×N Hessian H and the N×2 matrix F are stored; the state x̂ comes
+   * from the observer in StateSpaceController. Unlike clamping an LQR
+   * output, the plan knows the steering is bounded and brakes the approach
+   * to the line earlier when a large correction saturates.
+   *
+   * The box-constrained QP is solved by a fixed number of fast projected
+   * gradient steps (Nesterov), warm-started from the previous plan:
+   *
+   *   U⁺ = clamp(Y - step × (H Y + F x̂)),   Y = U⁺ + momentum × (U⁺ - U)
+   *
+   * A fixed iteration count gives a fixed execution time: with N = 10 and
+   * 20 iterations one step is about 2400 multiply-adds, which should be a
+   * few tens of µs on the ESP32 FPU at 240 MHz. That figure is estimated
+   * from the operation count, not measured on the target; check it against
+   * the 200 µs budget with LoopProfiler's CONTROL stage (the host timing is
+   * in tests/bench_state_space_controller.cpp). Step and momentum come from
+   * the extreme eigenvalues of H, so convergence does not depend on hand
+   * tuning.
+   *
+   * For line following robots:
+   * - Worth it on tracks with hairpins, where the steering saturates
+   * - The tables are valid for the speed they were generated for
+   */
+  class MPCController : public StateSpaceController {
+  public:
+    /**
+     * @brief Moves in the plan
+     */
+    static constexpr uint8_t HORIZON = control_tables::MPC_HORIZON;
+
+  private:
+    /**
+     * @brief Solver state
+     *
+     * @var plan: Planned moves, kept as the warm start of the next step
+     * @var extrapolated: Momentum point Y of the fast gradient method
+     * @var linear: F x̂ of the current step
+     * @var iterations: Gradient steps per compute()
+     */
+    float plan[HORIZON];
+    float extrapolated[HORIZON];
+    float linear[HORIZON];
+    uint8_t iterations;
+
+  protected:
+    /**
+     * @brief Restore the observer; the plan is not part of the snapshot and
+     * restarts from the restored output (see bumplessTransfer())
+     */
+    void loadState(const ControllerState &state) override;
+
+  public:
+    /**
+     * @brief Construct a new MPC controller with the generated tables
+     *
+     * @param dt_ms: Time step in milliseconds (must match control_tables::DT)
+     * @param min_output: Minimum output value (default -1023 for 10-bit PWM)
+     * @param max_output: Maximum output value (default 1023 for 10-bit PWM)
+     * @param debug: Enable debug output (default false)
+     */
+    MPCController(uint32_t dt_ms = 1, float min_output = -1023.0f, float max_output = 1023.0f, bool debug = false);
+
+    /**
+     * @brief Initialize the MPC controller
+     *
+     * @return bool true on success, false if the tables do not fit the sample time
+     */
+    bool init() override;
+
+    /**
+     * @brief Clear the observer and the plan
+     */
+    void reset() override;
+
+    ControllerKind getKind() const override;
+
+    /**
+     * @brief Continue from another controller's output without a jump
+     *
+     * Also fills the plan with the adopted output as the warm start.
+     *
+     * @param output: Last output of the controller being replaced
+     * @param error: Current error (setpoint - measured_value)
+     */
+    void bumplessTransfer(float output, float error) override;
+
+    /**
+     * @brief Update the observer, re-plan and apply the first move
+     *
+     * @param error: Current error (setpoint - measured_value)
+     * @return float Controller output between min_output and max_output
+     */
+    float compute(float error) override;
+    using BaseController::compute;
+
+    /**
+     * @brief Set the gradient steps per compute()
+     *
+     * More iterations approach the exact optimum, fewer bound the time.
+     *
+     * @param iterations: Steps per control period (>= 1)
+     */
+    void setIterations(uint8_t iterations);
+
+    uint8_t getIterations() const;
+
+    /**
+     * @brief Get a planned move of the last step
+     *
+     * @param index: Move index (0 = the applied move)
+     * @return float Planned feedback command, or 0 for an invalid index
+     */
+    float getPlannedMove(uint8_t index) const;
+  };
+
+} // namespace controller
@@ -0,0 +1,123 @@
+#include "MuxScanner.h"
+#include "LogConfig.h"
+
+namespace sensing {
+
+  MuxScanner::MuxScanner(const MuxPins *muxes, uint8_t mux_count, uint8_t sensor_count, uint8_t samples,
+                         uint16_t settle_us)
+      : muxes(muxes), mux_count(mux_count), sensor_count(sensor_count), samples(samples),
+        settle_us(settle_us), settle_waits(0) {
+    // Checks that print wait for begin(): a global instance is constructed before Serial.begin()
+    if (this->samples == 0) {
+      this->samples = 1;
+    }
+
+    for (uint8_t m = 0; m < MAX_MUXES; m++) {
+      selected[m] = 0xFF;
+      selected_at[m] = 0;
+    }
+  }
+
+  void MuxScanner::begin() {
+    if (mux_count == 0 || mux_count > MAX_MUXES) {
+      LOG_WARNING(F("WARNING: MuxScanner - Mux count must be 1-2, using 1"));
+      mux_count = 1;
+    }
+    if (sensor_count == 0 || sensor_count > mux_count * CHANNELS_PER_MUX) {
+      LOG_WARNING(F("WARNING: MuxScanner - Too many sensors for the muxes, extra sensors ignored"));
+      sensor_count = sensor_count == 0 ? 1 : mux_count * CHANNELS_PER_MUX;
+    }
+
+    for (uint8_t m = 0; m < mux_count; m++) {
+      for (uint8_t line = 0; line < SELECT_LINES; line++) {
+        pinMode(muxes[m].select[line], OUTPUT);
+      }
+      selected[m] = 0xFF; // Line levels unknown until the first select()
+      select(m, 0);
+    }
+  }
+
+  void MuxScanner::read(uint16_t *raw, uint8_t first, uint8_t count) {
+    if (first >= sensor_count || count == 0) {
+      return;
+    }
+    uint8_t end = first + count;
+    if (end > sensor_count || end < first) {
+      end = sensor_count;
+    }
+
+    select(muxOf(first), channelOf(first));
+
+    for (uint8_t i = first; i < end; i++) {
+      uint8_t mux = muxOf(i);
+
+      // After the last sensor the start of the next scan settles while the
+      // rest of the control cycle runs
+      uint8_t next = i + 1 < end ? i + 1 : first;
+
+      // Pipeline: the next sensor settles on the other mux during this conversion
+      bool next_on_other = muxOf(next) != mux;
+      if (next_on_other) {
+        select(muxOf(next), channelOf(next));
+      }
+
+      waitSettled(mux);
+      uint32_t sum = 0;
+      for (uint8_t s = 0; s < samples; s++) {
+        sum += analogRead(muxes[mux].signal);
+      }
+      raw[i] = (uint16_t)(sum / samples);
+
+      if (!next_on_other) {
+        select(mux, channelOf(next));
+      }
+    }
+  }
+
+  void MuxScanner::setSettleTime(uint16_t settle_us) {
+    this->settle_us = settle_us;
+  }
+
+  uint16_t MuxScanner::getSettleTime() const {
+    return settle_us;
+  }
+
+  uint8_t MuxScanner::getSensorCount() const {
+    return sensor_count;
+  }
+
+  uint8_t MuxScanner::getMuxCount() const {
+    return mux_count;
+  }
+
+  uint32_t MuxScanner::getSettleWaits() const {
+    return settle_waits;
+  }
+
+  void MuxScanner::select(uint8_t mux, uint8_t channel) {
+    uint8_t previous = selected[mux];
+    if (previous == channel) {
+      return; // Already settled or settling
+    }
+
+    // Only the lines that change are written; 0xFF forces all four
+    for (uint8_t line = 0; line < SELECT_LINES; line++) {
+      uint8_t bit = 1 << line;
+      if (previous == 0xFF || ((previous ^ channel) & bit)) {
+        digitalWrite(muxes[mux].select[line], (channel & bit) ? HIGH : LOW);
+      }
+    }
+    selected[mux] = channel;
+    selected_at[mux] = micros();
+  }
+
+  void MuxScanner::waitSettled(uint8_t mux) {
+    if ((uint32_t)(micros() - selected_at[mux]) >= settle_us) {
+      return;
+    }
+    settle_waits++;
+    while ((uint32_t)(micros() - selected_at[mux]) < settle_us) {
+    }
+  }
+
+} // namespace sensing
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace sensing {
+
+  /**
+   * @brief Synchronous scan of a sensor array behind CD74HC4067 multiplexers
+   *
+   * One 16:1 analog multiplexer puts 16 sensors on a single ADC pin, two of
+   * them take a 32-sensor array on two pins. The price is settling time:
+   * after the select lines change, the common pin needs a few µs to reach
+   * the new sensor's voltage (on-resistance and pin capacitance of the mux
+   * against the sensor's output impedance) before it may be sampled.
+   *
+   * With two multiplexers the scan hides that time in a pipeline. Sensors
+   * alternate between the two (even sensors on mux 0, odd sensors on mux 1),
+   * each mux has its own select lines, and the next sensor's channel is
+   * selected on the other mux before the current sensor is converted:
+   *
+   *   mux 0:  [convert s0] [select s2 ] [convert s2] [select s4 ] ...
+   *   mux 1:  [select s1 ] [convert s1] [select s3 ] [convert s3] ...
+   *
+   * so each channel settles while the previous one converts, and the scan
+   * only waits when a conversion is shorter than the settling time. A single
+   * multiplexer cannot overlap (its one output is being sampled), so it
+   * waits the full settling time per sensor; after the last sensor the
+   * first channel of the range is selected again, to settle between cycles.
+   *
+   * The mux signal pins should be ADC1 pins (GPIO 32-39): ADC2 is shared
+   * with Wi-Fi.
+   */
+  class MuxScanner {
+  public:
+    /**
+     * @brief Scanner limits
+     *
+     * @var CHANNELS_PER_MUX: Inputs of one CD74HC4067
+     * @var MAX_MUXES: Multiplexers a scanner can drive
+     * @var MAX_SENSORS: Largest array a scanner can read
+     * @var SELECT_LINES: Select pins per multiplexer (S0-S3)
+     */
+    static const uint8_t CHANNELS_PER_MUX = 16;
+    static const uint8_t MAX_MUXES = 2;
+    static const uint8_t MAX_SENSORS = CHANNELS_PER_MUX * MAX_MUXES;
+    static const uint8_t SELECT_LINES = 4;
+
+    /**
+     * @brief Wiring of one multiplexer
+     *
+     * @var signal: ADC pin on the common (SIG) pin
+     * @var select: GPIO on S0..S3
+     */
+    struct MuxPins {
+      uint8_t signal;
+      uint8_t select[SELECT_LINES];
+    };
+
+    /**
+     * @brief Construct a new scanner
+     *
+     * @param muxes: Wiring of each multiplexer (must outlive the object)
+     * @param mux_count: Number of multiplexers (1 - MAX_MUXES)
+     * @param sensor_count: Number of sensors (1 - mux_count × 16)
+     * @param samples: Conversions averaged per reading (default 4, as qtr.read())
+     * @param settle_us: Settling time after a channel change in µs (default 5)
+     */
+    MuxScanner(const MuxPins *muxes, uint8_t mux_count, uint8_t sensor_count, uint8_t samples = 4,
+               uint16_t settle_us = 5);
+
+    /**
+     * @brief Check the mux and sensor counts, configure the select lines as
+     *        outputs and select the first sensor
+     *
+     * Must be called before read(); an invalid count is corrected here.
+     */
+    void begin();
+
+    /**
+     * @brief Convert a run of sensors
+     *
+     * Sensors outside the run are not touched, so the scan can serve an
+     * adaptive window as well as a full sweep.
+     *
+     * @param raw: Readings in sensor order, the run is overwritten
+     * @param first: First sensor to convert
+     * @param count: Number of sensors to convert
+     */
+    void read(uint16_t *raw, uint8_t first, uint8_t count);
+
+    /**
+     * @brief Set the settling time after a channel change
+     *
+     * @param settle_us: Time in µs; about 9 RC time constants of the
+     *                   sensor output impedance and the mux pin capacitance
+     */
+    void setSettleTime(uint16_t settle_us);
+
+    /**
+     * @brief Sensor to mux mapping (sensors alternate between the muxes)
+     */
+    inline uint8_t muxOf(uint8_t sensor) const { return sensor % mux_count; }
+    inline uint8_t channelOf(uint8_t sensor) const { return sensor / mux_count; }
+
+    uint16_t getSettleTime() const;
+    uint8_t getSensorCount() const;
+    uint8_t getMuxCount() const;
+
+    /**
+     * @brief Conversions that had to wait for the mux to settle
+     *
+     * @return uint32_t Count since construction; stays near zero when the
+     *                  pipeline hides the settling time
+     */
+    uint32_t getSettleWaits() const;
+
+  private:
+    /**
+     * @brief Switch a multiplexer to a channel, skipping unchanged lines
+     *
+     * @param mux: Multiplexer index
+     * @param channel: Channel 0-15
+     */
+    void select(uint8_t mux, uint8_t channel);
+
+    /**
+     * @brief Busy-wait until the selected channel of a mux has settled
+     *
+     * @param mux: Multiplexer index
+     */
+    void waitSettled(uint8_t mux);
+
+    /**
+     * @brief Scanner state
+     *
+     * @var muxes: Wiring of each multiplexer
+     * @var mux_count: Number of multiplexers
+     * @var sensor_count: Number of sensors
+     * @var samples: Conversions averaged per reading
+     * @var settle_us: Settling time after a channel change
+     * @var selected: Channel each mux is switched to (0xFF = unknown)
+     * @var selected_at: micros() of each mux's last channel change
+     * @var settle_waits: Conversions that waited for settling
+     */
+    const MuxPins *muxes;
+    uint8_t mux_count;
+    uint8_t sensor_count;
+    uint8_t samples;
+    uint16_t settle_us;
+    uint8_t selected[MAX_MUXES];
+    uint32_t selected_at[MAX_MUXES];
+    uint32_t settle_waits;
+  };
+
+} // namespace sensing
@@ -3,17 +3,17 @@
 namespace controller {
 
   PController::PController(float Kp, uint32_t dt_ms, float min_output, float max_output, bool debug)
-      : BaseController(dt_ms, min_output, max_output, debug), Kp(Kp) {
+      : BaseController(dt_ms, min_output, max_output, debug), core(Kp) {
 
     // Validate proportional gain to prevent common mistakes
     if (Kp < 0.0f) {
-      Serial.println(F("WARNING: PController - Negative Kp can cause instability"));
+      LOG_WARNING(F("WARNING: PController - Negative Kp can cause instability"));
     }
     if (Kp == 0.0f) {
-      Serial.println(F("WARNING: PController - Zero Kp means no control action"));
+      LOG_WARNING(F("WARNING: PController - Zero Kp means no control action"));
     }
 
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("PController: Created with Kp="));
       Serial.print(Kp);
       Serial.print(F(", dt="));
@@ -25,13 +25,13 @@ namespace controller {
   bool PController::init() {
     // Call base class initialization first
     if (!BaseController::init()) {
-      Serial.println(F("ERROR: PController::init() - Base initialization failed"));
+      LOG_ERROR(F("ERROR: PController::init() - Base initialization failed"));
       return false;
     }
 
     // Validate P controller specific parameters
-    if (Kp < 0.0f) {
-      Serial.println(F("ERROR: PController::init() - Kp cannot be negative"));
+    if (core.getKp() < 0.0f) {
+      LOG_ERROR(F("ERROR: PController::init() - Kp cannot be negative"));
       return false;
     }
 
@@ -44,23 +44,29 @@ namespace controller {
 
   void PController::reset() {
     // P controller has no internal state to reset, just clear output
+    core.reset();
     output = 0.0f;
+    resetTimestamp();
     debugLog(F("PController state reset"));
   }
 
+  ControllerKind PController::getKind() const {
+    return ControllerKind::P;
+  }
+
   float PController::compute(float error) {
     // Implement the core P control algorithm: Output = Kp × Error
     // This is the fundamental equation of proportional control
 
-    // Calculate proportional term
-    float p_term = Kp * error;
-
-    // Apply output limits to prevent actuator damage
+    // The devirtualized core computes Kp * error and applies the output limits
     // This is critical in embedded systems to protect hardware
-    output = applyLimits(p_term, min_output, max_output);
+    // The feed-forward term shifts the limits so the total output stays bounded
+    output = core.step(error, dt, inv_dt, min_output - feed_forward,
+                       max_output - feed_forward) + feed_forward;
 
     // Debug output shows the control action for tuning purposes
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      float p_term = core.getKp() * error;
       Serial.print(F("P: error="));
       Serial.print(error, 3); // 3 decimal places for precision
       Serial.print(F(", P_term="));
@@ -78,16 +84,16 @@ namespace controller {
       debugLog(F("WARNING: setKp() - Negative Kp can cause instability"));
     }
 
-    this->Kp = Kp;
+    core.setKp(Kp);
 
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("Kp updated to "));
       Serial.println(Kp, 3);
     }
   }
 
   float PController::getKp() const {
-    return Kp;
+    return core.getKp();
   }
 
 } // namespace controller
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BaseController.h"
+#include "PidCore.h"
 
 namespace controller {
 
@@ -32,9 +33,12 @@ namespace controller {
   class PController : public BaseController {
   private:
     /**
-     * @brief Proportional gain
+     * @brief Proportional gain, held in the devirtualized Pid<PTraits> core
      *
-     * @var Kp: Proportional gain - determines how aggressively the controller responds to error
+     * @var core: Header-only P core that performs the arithmetic
+     *
+     * Gain stored in the core:
+     * - Kp: Proportional gain - determines how aggressively the controller responds to error
      *          Higher values = faster response but potential instability
      *          Lower values = slower response but more stable
      *
@@ -43,7 +47,7 @@ namespace controller {
      * - Medium robots (0.5-2 m/s): Kp = 2.0 to 10.0
      * - Fast robots (> 2 m/s): Kp = 10.0 to 50.0
      */
-    float Kp;
+    Pid<PTraits> core;
 
   public:
     /**
@@ -74,6 +78,8 @@ namespace controller {
      */
     void reset() override;
 
+    ControllerKind getKind() const override;
+
     /**
      * @brief Calculate P output based on error
      *
@@ -84,6 +90,7 @@ namespace controller {
      * @return float Controller output between min_output and max_output
      */
     float compute(float error) override;
+    using BaseController::compute;
 
     /**
      * @brief Set the proportional gain
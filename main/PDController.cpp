@@ -5,28 +5,29 @@ namespace controller {
 
   PDController::PDController(float Kp, float Kd, uint32_t dt_ms, float min_output, float max_output, bool debug)
       : BaseController(dt_ms, min_output, max_output, debug),
-        Kp(Kp), Kd(Kd), prev_error(0.0f) {
+        core(Kp, 0.0f, Kd, 0.001f, min_output, max_output),
+        derivative_on_measurement(false) {
 
     // Validate PD parameters and provide guidance for common mistakes
     if (Kp < 0.0f) {
-      Serial.println(F("WARNING: PDController - Negative Kp can cause instability"));
+      LOG_WARNING(F("WARNING: PDController - Negative Kp can cause instability"));
     }
     if (Kd < 0.0f) {
-      Serial.println(F("WARNING: PDController - Negative Kd reduces damping effect"));
+      LOG_WARNING(F("WARNING: PDController - Negative Kd reduces damping effect"));
     }
     if (Kp == 0.0f && Kd == 0.0f) {
-      Serial.println(F("WARNING: PDController - Both gains are zero, no control action"));
+      LOG_WARNING(F("WARNING: PDController - Both gains are zero, no control action"));
     }
 
     // Check for unusual gain relationships that might indicate tuning issues
     if (Kd > Kp * 2.0f) {
-      Serial.println(F("WARNING: PDController - Very high Kd relative to Kp may cause sluggish response"));
+      LOG_WARNING(F("WARNING: PDController - Very high Kd relative to Kp may cause sluggish response"));
     }
     if (Kd > 0.0f && dt > 0.1f) { // dt > 100ms
-      Serial.println(F("WARNING: PDController - Large sample time may cause derivative noise"));
+      LOG_WARNING(F("WARNING: PDController - Large sample time may cause derivative noise"));
     }
 
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("PDController: Created with Kp="));
       Serial.print(Kp, 3);
       Serial.print(F(", Kd="));
@@ -40,25 +41,28 @@ namespace controller {
   bool PDController::init() {
     // Call base class initialization first
     if (!BaseController::init()) {
-      Serial.println(F("ERROR: PDController::init() - Base initialization failed"));
+      LOG_ERROR(F("ERROR: PDController::init() - Base initialization failed"));
       return false;
     }
 
+    const float Kp = core.getKp();
+    const float Kd = core.getKd();
+
     // Validate PD-specific parameters
     if (Kp < 0.0f || Kd < 0.0f) {
-      Serial.println(F("ERROR: PDController::init() - Gains cannot be negative"));
+      LOG_ERROR(F("ERROR: PDController::init() - Gains cannot be negative"));
       return false;
     }
 
     // Ensure at least one gain is non-zero for meaningful control
     if (Kp == 0.0f && Kd == 0.0f) {
-      Serial.println(F("ERROR: PDController::init() - At least one gain must be non-zero"));
+      LOG_ERROR(F("ERROR: PDController::init() - At least one gain must be non-zero"));
       return false;
     }
 
     // Warn about derivative term with large sample times
     // Large dt makes derivative calculation less accurate and more noisy
-    if (Kd > 0.0f && dt > 0.05f) { // Warning if dt > 50ms and using derivative
+    if (LOG_WARNINGS_ENABLED && Kd > 0.0f && dt > 0.05f) { // Warning if dt > 50ms and using derivative
       Serial.print(F("WARNING: PDController::init() - Large sample time ("));
       Serial.print(dt * 1000.0f);
       Serial.println(F("ms) may cause derivative noise"));
@@ -74,56 +78,62 @@ namespace controller {
   void PDController::reset() {
     // Clear derivative calculation history
     // This prevents startup transients from old error values
-    prev_error = 0.0f;
+    core.reset();
     output = 0.0f;
+    resetTimestamp();
 
     debugLog(F("PDController state reset - derivative history cleared"));
   }
 
+  void PDController::bumplessTransfer(float output, float error) {
+    BaseController::bumplessTransfer(output, error);
+
+    // No integral to absorb the difference: only the derivative history is
+    // aligned with the current error so the first step has no derivative kick
+    core.track(this->output - feed_forward, error, derivativeInput(error));
+  }
+
+  ControllerKind PDController::getKind() const {
+    return ControllerKind::PD;
+  }
+
+  void PDController::saveState(ControllerState &state) const {
+    state.internal[0] = core.getPrevError();
+    state.internal[1] = core.getPrevDerivativeInput();
+    state.internal[2] = core.getDerivativeTerm();
+  }
+
+  void PDController::loadState(const ControllerState &state) {
+    core.restoreState(0.0f, state.internal[0], state.internal[1], state.internal[2]);
+  }
+
   float PDController::compute(float error) {
     // Implement the PD control algorithm
     // Output = Kp*error + Kd*(error - prev_error)/dt
     //
     // This algorithm provides both immediate response to errors (P term)
     // and predictive damping based on error trends (D term)
-
-    // 1. PROPORTIONAL TERM: Immediate response to current error
-    //    This term provides the primary driving force to correct errors
-    //    Larger errors produce proportionally larger corrections
-    float p_term = Kp * error;
-
-    // 2. DERIVATIVE TERM: Predictive response based on error rate of change
-    //    This term acts like a "brake" when approaching the setpoint
-    //    It helps prevent overshoot and reduces oscillations
     //
-    //    Key insight: We calculate derivative of ERROR, not just setpoint change
-    //    This approach avoids "derivative kick" - a sudden spike in output
-    //    when the setpoint changes rapidly (like in step inputs)
-    float error_rate = (error - prev_error) / dt;
-    float d_term = Kd * error_rate;
-
-    // Store current error for next iteration's derivative calculation
-    // This is critical - the derivative term depends on the history of errors
-    prev_error = error;
-
-    // 3. COMBINE PROPORTIONAL AND DERIVATIVE TERMS
-    //    The P term provides the "muscle" - the main corrective force
-    //    The D term provides the "intelligence" - it moderates the response
-    //    based on how quickly things are changing
-    float pd_output = p_term + d_term;
-
-    // 4. APPLY OUTPUT LIMITS
-    //    Essential for protecting actuators and ensuring system stability
-    //    Without limits, the controller could command impossible actuator values
-    output = applyLimits(pd_output, min_output, max_output);
+    // The arithmetic itself lives in the header-only Pid<PDTraits> core:
+    // 1. P term: Kp * error - the "muscle", the main corrective force
+    // 2. D term: (Kd / dt) * (error - prev_error) - the "brake" that damps
+    //    the response based on how quickly the error is changing. With
+    //    derivative on measurement the difference is taken of -measured_value
+    //    instead, so setpoint steps cause no "derivative kick"; the optional
+    //    low-pass filter then smooths the difference
+    // 3. Output limits: protect actuators from impossible commands, applied
+    //    to the feed-forward term plus the feedback
+    output = core.step(error, derivativeInput(error), dt, inv_dt, min_output - feed_forward,
+                       max_output - feed_forward) + feed_forward;
 
     // Debug output shows how each term contributes to the final result
     // This is invaluable for understanding controller behavior during tuning
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      float p_term = core.getKp() * error;
+      float d_term = core.getDerivativeTerm();
+
       Serial.print(F("PD: error="));
       Serial.print(error, 3);
-      Serial.print(F(", error_rate="));
-      Serial.print(error_rate, 3);
       Serial.print(F(", P="));
       Serial.print(p_term, 2);
       Serial.print(F(", D="));
@@ -135,15 +145,40 @@ namespace controller {
     return output;
   }
 
+  float PDController::computeWithDerivative(float error, float error_rate) {
+    // Same terms as compute(), with the backward difference replaced by the
+    // supplied rate; the derivative input is still recorded for compute()
+    output = core.stepWithRate(error, derivativeInput(error), error_rate, dt, inv_dt, min_output - feed_forward,
+                               max_output - feed_forward) + feed_forward;
+
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      Serial.print(F("PD: error="));
+      Serial.print(error, 3);
+      Serial.print(F(", rate="));
+      Serial.print(error_rate, 3);
+      Serial.print(F(", D="));
+      Serial.print(core.getDerivativeTerm(), 2);
+      Serial.print(F(", output="));
+      Serial.println(output, 2);
+    }
+
+    return output;
+  }
+
+  float PDController::computeWithDerivative(float error, float error_rate, uint32_t now_us) {
+    updateTimestep(now_us);
+    return computeWithDerivative(error, error_rate);
+  }
+
   void PDController::setKp(float Kp) {
     // Validate proportional gain
     if (Kp < 0.0f) {
       debugLog(F("WARNING: setKp() - Negative Kp can cause instability"));
     }
 
-    this->Kp = Kp;
+    core.setKp(Kp);
 
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("Kp updated to "));
       Serial.println(Kp, 3);
     }
@@ -155,9 +190,9 @@ namespace controller {
       debugLog(F("WARNING: setKd() - Negative Kd reduces damping effect"));
     }
 
-    this->Kd = Kd;
+    core.setKd(Kd);
 
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("Kd updated to "));
       Serial.println(Kd, 3);
     }
@@ -171,14 +206,13 @@ namespace controller {
 
     // Update both gains simultaneously
     // This is more efficient than individual updates and ensures consistency
-    this->Kp = Kp;
-    this->Kd = Kd;
+    core.setGains(Kp, 0.0f, Kd);
 
     // Note: Unlike PI or PID controllers, we don't need to reset any
     // accumulated state when changing PD gains. The only state is prev_error,
     // which should maintain continuity for proper derivative calculation.
 
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("PD gains updated: Kp="));
       Serial.print(Kp, 3);
       Serial.print(F(", Kd="));
@@ -187,11 +221,47 @@ namespace controller {
   }
 
   float PDController::getKp() const {
-    return Kp;
+    return core.getKp();
   }
 
   float PDController::getKd() const {
-    return Kd;
+    return core.getKd();
+  }
+
+  void PDController::setDerivativeFilter(float cutoff_hz) {
+    if (cutoff_hz < 0.0f) {
+      debugLog(F("WARNING: setDerivativeFilter() - Negative cutoff, filter disabled"));
+      cutoff_hz = 0.0f;
+    }
+    if (cutoff_hz > 0.0f && cutoff_hz * dt > 0.25f) {
+      debugLog(F("WARNING: setDerivativeFilter() - Cutoff close to the sample rate has little effect"));
+    }
+
+    core.setDerivativeFilter(cutoff_hz);
+
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      Serial.print(F("Derivative filter cutoff set to "));
+      Serial.print(cutoff_hz, 1);
+      Serial.println(F("Hz"));
+    }
+  }
+
+  void PDController::setDerivativeOnMeasurement(bool enable) {
+    if (enable != derivative_on_measurement) {
+      // Re-seed the history so switching sources does not differentiate a jump
+      derivative_on_measurement = enable;
+      core.seedDerivative(derivativeInput(core.getPrevError()));
+    }
+
+    debugLog(enable ? F("Derivative on measurement") : F("Derivative on error"));
+  }
+
+  float PDController::getDerivativeFilter() const {
+    return core.getDerivativeCutoff();
+  }
+
+  bool PDController::isDerivativeOnMeasurement() const {
+    return derivative_on_measurement;
   }
 
 } // namespace controller
\ No newline at end of file
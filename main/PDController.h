@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BaseController.h"
+#include "PidCore.h"
 
 namespace controller {
 
@@ -61,10 +62,36 @@ namespace controller {
      *
      * Note: No integral term means no anti-windup protection needed
      *       This simplifies the controller but may allow steady-state error
+     *
+     * All of the above live in core, the header-only Pid<PDTraits> that
+     * performs the arithmetic; this class adds validation, logging and the
+     * BaseController interface around it.
+     */
+    Pid<PDTraits> core;
+
+    /**
+     * @brief Derivative source
+     *
+     * @var derivative_on_measurement: Differentiate -measured_value instead
+     *      of the error. Identical while the setpoint is constant, but a
+     *      setpoint step no longer produces a derivative spike.
+     */
+    bool derivative_on_measurement;
+
+    /**
+     * @brief Signal the D term differentiates (error or -measured_value)
+     */
+    inline float derivativeInput(float error) const {
+      return derivative_on_measurement ? error - setpoint : error;
+    }
+
+  protected:
+    /**
+     * @brief Snapshot layout: internal[0] = previous error, internal[1] = previous
+     * derivative input, internal[2] = (filtered) derivative term
      */
-    float Kp;
-    float Kd;
-    float prev_error;
+    void saveState(ControllerState &state) const override;
+    void loadState(const ControllerState &state) override;
 
   public:
     /**
@@ -98,18 +125,57 @@ namespace controller {
      */
     void reset() override;
 
+    ControllerKind getKind() const override;
+
+    /**
+     * @brief Continue from another controller's output without a jump
+     *
+     * @param output: Last output of the controller being replaced
+     * @param error: Current error (setpoint - measured_value)
+     */
+    void bumplessTransfer(float output, float error) override;
+
     /**
      * @brief Calculate PD output based on error
      *
      * Implements the core PD algorithm with proper derivative calculation.
-     * The derivative term is calculated on the error signal to avoid
-     * "derivative kick" when the setpoint changes suddenly.
+     * The derivative term is calculated on the error signal, or on the
+     * measurement (setDerivativeOnMeasurement()) to avoid "derivative kick"
+     * when the setpoint changes suddenly, and can be low-pass filtered
+     * (setDerivativeFilter()).
      *
      * @param error: Current error (setpoint - measured_value)
      *               For line following: 0 = centered, +/- = off to sides
      * @return float Controller output between min_output and max_output
      */
     float compute(float error) override;
+    using BaseController::compute;
+
+    /**
+     * @brief Calculate the output with a derivative supplied by an estimator
+     *
+     * The D term becomes Kd × error_rate instead of a difference of
+     * consecutive errors, e.g. with the velocity of a Kalman filter that
+     * tracks the measurement. While the setpoint is constant the error rate
+     * is also the rate of the derivative-on-measurement input, so both
+     * derivative modes accept the same value. compute() can take over again
+     * at any time without a derivative kick.
+     *
+     * @param error: Current error (setpoint - measured_value)
+     * @param error_rate: Rate of change of the error per second
+     * @return float Controller output between min_output and max_output
+     */
+    float computeWithDerivative(float error, float error_rate);
+
+    /**
+     * @brief computeWithDerivative() using the measured time step
+     *
+     * @param error: Current error (setpoint - measured_value)
+     * @param error_rate: Rate of change of the error per second
+     * @param now_us: Current time in microseconds (e.g. micros())
+     * @return float Controller output between min_output and max_output
+     */
+    float computeWithDerivative(float error, float error_rate, uint32_t now_us);
 
     /**
      * @brief Set the proportional gain
@@ -149,6 +215,41 @@ namespace controller {
      * @return float Current Kd value
      */
     float getKd() const;
+
+    /**
+     * @brief Low-pass filter the derivative term
+     *
+     * A first-order filter whose coefficient is recomputed only when dt
+     * changes, so it costs one multiply-add per step. At kHz loop rates the
+     * raw backward difference is dominated by ADC noise; a cutoff of 5-10x
+     * the fastest line dynamics (e.g. 50-150 Hz) removes most of it while
+     * adding little phase lag.
+     *
+     * @param cutoff_hz: -3 dB frequency in Hz, 0 to disable (default)
+     */
+    void setDerivativeFilter(float cutoff_hz);
+
+    /**
+     * @brief Choose what the derivative term differentiates
+     *
+     * @param enable: true for the measurement (no kick on setpoint steps),
+     *                false for the error (default)
+     */
+    void setDerivativeOnMeasurement(bool enable);
+
+    /**
+     * @brief Get the derivative filter cutoff
+     *
+     * @return float Cutoff in Hz (0 when unfiltered)
+     */
+    float getDerivativeFilter() const;
+
+    /**
+     * @brief Check whether the derivative is taken on the measurement
+     *
+     * @return bool true when differentiating the measurement
+     */
+    bool isDerivativeOnMeasurement() const;
   };
 
 } // namespace controller
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BaseController.h"
+#include "PidCore.h"
 
 namespace controller {
   /**
@@ -67,7 +68,8 @@ namespace controller {
      * @var integral: Accumulated error over time (the "memory" of the controller)
      *                This value grows when there's consistent error in one direction
      *                and shrinks when error is in the opposite direction
-     *                Reset to zero when controller is reset or gains change
+     *                Reset to zero when the controller is reset; kept across gain
+     *                changes so retuning mid-run does not make the output jump
      *
      *                Physical meaning: Represents the total "error debt" that
      *                needs to be corrected to achieve perfect tracking
@@ -79,11 +81,19 @@ namespace controller {
      *                   the system comes out of saturation
      *
      *                   Should typically be set to 50-100% of max_output
+     *
+     * All of the above live in core, the header-only Pid<PITraits> that
+     * performs the arithmetic; this class adds validation, logging and the
+     * BaseController interface around it.
+     */
+    Pid<PITraits> core;
+
+  protected:
+    /**
+     * @brief Snapshot layout: internal[0] = integral, internal[1] = previous error
      */
-    float Kp;
-    float Ki;
-    float integral;
-    float anti_windup;
+    void saveState(ControllerState &state) const override;
+    void loadState(const ControllerState &state) override;
 
   public:
     /**
@@ -119,6 +129,16 @@ namespace controller {
      */
     void reset() override;
 
+    ControllerKind getKind() const override;
+
+    /**
+     * @brief Continue from another controller's output without a jump
+     *
+     * @param output: Last output of the controller being replaced
+     * @param error: Current error (setpoint - measured_value)
+     */
+    void bumplessTransfer(float output, float error) override;
+
     /**
      * @brief Calculate PI output based on error
      *
@@ -132,10 +152,14 @@ namespace controller {
      * @return float Controller output between min_output and max_output
      */
     float compute(float error) override;
+    using BaseController::compute;
 
     /**
      * @brief Set the proportional gain
      *
+     * Bumpless: the integral absorbs the change of Kp * error, so the
+     * output continues from its current value.
+     *
      * @param Kp: Proportional gain (affects response speed)
      */
     void setKp(float Kp);
@@ -143,9 +167,8 @@ namespace controller {
     /**
      * @brief Set the integral gain
      *
-     * Resets integral accumulation to prevent sudden output jumps.
-     * This is necessary because changing Ki changes the "weight" of
-     * the accumulated error, which could cause discontinuous output.
+     * Bumpless: the integral stores Ki-weighted error, so the accumulated
+     * correction is kept as is and only future error uses the new Ki.
      *
      * @param Ki: Integral gain (affects steady-state accuracy)
      */
@@ -155,7 +178,7 @@ namespace controller {
      * @brief Set both PI gains simultaneously
      *
      * More efficient than setting gains individually.
-     * Resets integral accumulation to ensure smooth operation.
+     * Bumpless, like setKp() and setKi().
      *
      * @param Kp: Proportional gain
      * @param Ki: Integral gain
@@ -6,30 +6,29 @@ namespace controller {
   PIDController::PIDController(float Kp, float Ki, float Kd, uint32_t dt_ms,
                                float min_output, float max_output, bool debug)
       : BaseController(dt_ms, min_output, max_output, debug),
-        Kp(Kp), Ki(Ki), Kd(Kd),
-        integral(0.0f), prev_error(0.0f),
-        anti_windup(fabs(max_output)) { // Default anti-windup limit = max output
+        core(Kp, Ki, Kd, 0.001f, min_output, max_output),
+        derivative_on_measurement(false) { // Default anti-windup limit = max output
 
     // Validate PID parameters and warn about common mistakes
     if (Kp < 0.0f) {
-      Serial.println(F("WARNING: PIDController - Negative Kp can cause instability"));
+      LOG_WARNING(F("WARNING: PIDController - Negative Kp can cause instability"));
     }
     if (Ki < 0.0f) {
-      Serial.println(F("WARNING: PIDController - Negative Ki can cause instability"));
+      LOG_WARNING(F("WARNING: PIDController - Negative Ki can cause instability"));
     }
     if (Kd < 0.0f) {
-      Serial.println(F("WARNING: PIDController - Negative Kd can cause instability"));
+      LOG_WARNING(F("WARNING: PIDController - Negative Kd can cause instability"));
     }
 
     // Check for unrealistic gain combinations
     if (Ki > 0.0f && Kp == 0.0f) {
-      Serial.println(F("WARNING: PIDController - Ki without Kp may cause oscillation"));
+      LOG_WARNING(F("WARNING: PIDController - Ki without Kp may cause oscillation"));
     }
     if (Kd > Kp * 10.0f) {
-      Serial.println(F("WARNING: PIDController - Very high Kd relative to Kp may cause noise sensitivity"));
+      LOG_WARNING(F("WARNING: PIDController - Very high Kd relative to Kp may cause noise sensitivity"));
     }
 
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("PIDController: Created with Kp="));
       Serial.print(Kp, 3);
       Serial.print(F(", Ki="));
@@ -45,19 +44,23 @@ namespace controller {
   bool PIDController::init() {
     // Call base class initialization first
     if (!BaseController::init()) {
-      Serial.println(F("ERROR: PIDController::init() - Base initialization failed"));
+      LOG_ERROR(F("ERROR: PIDController::init() - Base initialization failed"));
       return false;
     }
 
+    const float Kp = core.getKp();
+    const float Ki = core.getKi();
+    const float Kd = core.getKd();
+
     // Validate PID-specific parameters
     if (Kp < 0.0f || Ki < 0.0f || Kd < 0.0f) {
-      Serial.println(F("ERROR: PIDController::init() - Gains cannot be negative"));
+      LOG_ERROR(F("ERROR: PIDController::init() - Gains cannot be negative"));
       return false;
     }
 
     // Ensure we have at least one non-zero gain
     if (Kp == 0.0f && Ki == 0.0f && Kd == 0.0f) {
-      Serial.println(F("ERROR: PIDController::init() - All gains are zero"));
+      LOG_ERROR(F("ERROR: PIDController::init() - All gains are zero"));
       return false;
     }
 
@@ -71,50 +74,58 @@ namespace controller {
   void PIDController::reset() {
     // Clear all state variables for a fresh start
     // This is critical when starting control or changing setpoints significantly
-    integral = 0.0f;
-    prev_error = 0.0f;
+    core.reset();
     output = 0.0f;
+    resetTimestamp();
 
     debugLog(F("PIDController state reset - integral and derivative history cleared"));
   }
 
-  float PIDController::compute(float error) {
-    // Implement the complete PID algorithm
-    // Output = Kp*error + Ki*∫error*dt + Kd*derror/dt
-
-    // 1. PROPORTIONAL TERM: Responds to current error magnitude
-    //    Higher error = higher proportional response
-    float p_term = Kp * error;
-
-    // 2. INTEGRAL TERM: Responds to accumulated error over time
-    //    Eliminates steady-state error by building up correction over time
-    integral += Ki * error * dt; // Accumulate error × time × gain
+  void PIDController::bumplessTransfer(float output, float error) {
+    BaseController::bumplessTransfer(output, error);
 
-    // Apply anti-windup protection to prevent integral term from growing too large
-    // This prevents overshoot when the system is saturated (output at limits)
-    integral = applyLimits(integral, -anti_windup, anti_windup);
-    float i_term = integral;
+    // Preload the integral so that Kp * error + integral equals the adopted output,
+    // and align the derivative history with the current error (no derivative kick)
+    core.track(this->output - feed_forward, error, derivativeInput(error));
+  }
 
-    // 3. DERIVATIVE TERM: Responds to rate of error change
-    //    Provides predictive action and damping to reduce overshoot
-    //    Note: We calculate derivative of ERROR, not just setpoint change
-    //    This avoids "derivative kick" when setpoint changes suddenly
-    float error_rate = (error - prev_error) / dt;
-    float d_term = Kd * error_rate;
+  ControllerKind PIDController::getKind() const {
+    return ControllerKind::PID;
+  }
 
-    // Store current error for next iteration's derivative calculation
-    prev_error = error;
+  void PIDController::saveState(ControllerState &state) const {
+    state.internal[0] = core.getIntegral();
+    state.internal[1] = core.getPrevError();
+    state.internal[2] = core.getPrevDerivativeInput();
+    state.internal[3] = core.getDerivativeTerm();
+  }
 
-    // 4. COMBINE ALL THREE TERMS
-    //    Each term contributes to the final control output
-    float pid_output = p_term + i_term + d_term;
+  void PIDController::loadState(const ControllerState &state) {
+    core.restoreState(state.internal[0], state.internal[1], state.internal[2], state.internal[3]);
+  }
 
-    // 5. APPLY OUTPUT LIMITS
-    //    Protect actuators and ensure output stays within safe bounds
-    output = applyLimits(pid_output, min_output, max_output);
+  float PIDController::compute(float error) {
+    // Implement the complete PID algorithm
+    // Output = Kp*error + Ki*∫error*dt + Kd*derror/dt
+    //
+    // The arithmetic itself lives in the header-only Pid<PIDTraits> core:
+    // 1. P term: Kp * error - responds to current error magnitude
+    // 2. I term: integral += (Ki * dt) * error, clamped to ±anti_windup so the
+    //    integral cannot grow too large while the output is saturated
+    // 3. D term: (Kd / dt) * (error - prev_error) - damping and predictive
+    //    action; optionally taken of -measured_value (no kick on setpoint
+    //    steps) and low-pass filtered against sensor noise
+    // 4. Output limits: protect actuators and keep output within safe bounds,
+    //    applied to the feed-forward term plus the feedback
+    output = core.step(error, derivativeInput(error), dt, inv_dt, min_output - feed_forward,
+                       max_output - feed_forward) + feed_forward;
 
     // Debug output shows each term's contribution for tuning purposes
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      float p_term = core.getKp() * error;
+      float i_term = core.getIntegral();
+      float d_term = core.getDerivativeTerm();
+
       Serial.print(F("PID: error="));
       Serial.print(error, 3);
       Serial.print(F(", P="));
@@ -130,14 +141,40 @@ namespace controller {
     return output;
   }
 
+  float PIDController::computeWithDerivative(float error, float error_rate) {
+    // Same terms as compute(), with the backward difference replaced by the
+    // supplied rate; the derivative input is still recorded for compute()
+    output = core.stepWithRate(error, derivativeInput(error), error_rate, dt, inv_dt, min_output - feed_forward,
+                               max_output - feed_forward) + feed_forward;
+
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      Serial.print(F("PID: error="));
+      Serial.print(error, 3);
+      Serial.print(F(", rate="));
+      Serial.print(error_rate, 3);
+      Serial.print(F(", D="));
+      Serial.print(core.getDerivativeTerm(), 2);
+      Serial.print(F(", output="));
+      Serial.println(output, 2);
+    }
+
+    return output;
+  }
+
+  float PIDController::computeWithDerivative(float error, float error_rate, uint32_t now_us) {
+    updateTimestep(now_us);
+    return computeWithDerivative(error, error_rate);
+  }
+
   void PIDController::setKp(float Kp) {
     if (Kp < 0.0f) {
       debugLog(F("WARNING: setKp() - Negative Kp can cause instability"));
     }
 
-    this->Kp = Kp;
+    // Bumpless: the integral absorbs the change of Kp * error
+    core.retune(Kp, core.getKi(), core.getKd());
 
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("Kp updated to "));
       Serial.println(Kp, 3);
     }
@@ -148,17 +185,13 @@ namespace controller {
       debugLog(F("WARNING: setKi() - Negative Ki can cause instability"));
     }
 
-    this->Ki = Ki;
+    // No reset needed: the integral already stores Ki-weighted error, so
+    // only future error is weighted by the new Ki and the output does not jump
+    core.setKi(Ki);
 
-    // Reset integral when changing Ki to prevent sudden jumps in output
-    // This is important because the integral term represents accumulated error
-    // and changing Ki changes the "weight" of that accumulation
-    integral = 0.0f;
-
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("Ki updated to "));
-      Serial.print(Ki, 3);
-      Serial.println(F(" (integral reset)"));
+      Serial.println(Ki, 3);
     }
   }
 
@@ -167,9 +200,9 @@ namespace controller {
       debugLog(F("WARNING: setKd() - Negative Kd can cause instability"));
     }
 
-    this->Kd = Kd;
+    core.setKd(Kd);
 
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("Kd updated to "));
       Serial.println(Kd, 3);
     }
@@ -181,22 +214,17 @@ namespace controller {
       debugLog(F("WARNING: setGains() - Negative gains can cause instability"));
     }
 
-    // Update all gains simultaneously
-    this->Kp = Kp;
-    this->Ki = Ki;
-    this->Kd = Kd;
-
-    // Reset integral accumulation when changing gains to prevent sudden jumps
-    integral = 0.0f;
+    // Update all gains simultaneously; the integral absorbs the change of
+    // the proportional term so the output does not jump
+    core.retune(Kp, Ki, Kd);
 
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("PID gains updated: Kp="));
       Serial.print(Kp, 3);
       Serial.print(F(", Ki="));
       Serial.print(Ki, 3);
       Serial.print(F(", Kd="));
-      Serial.print(Kd, 3);
-      Serial.println(F(" (integral reset)"));
+      Serial.println(Kd, 3);
     }
   }
 
@@ -212,32 +240,66 @@ namespace controller {
       debugLog(F("Anti-windup limit capped to max_output"));
     }
 
-    this->anti_windup = limit;
-
-    // Re-clamp existing integral term to new limit
+    // Store the limit and re-clamp the existing integral term to it
     // This ensures immediate compliance with the new limit
-    integral = applyLimits(integral, -anti_windup, anti_windup);
+    core.setAntiWindupLimit(limit);
 
-    if (debug_enabled) {
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
       Serial.print(F("Anti-windup limit set to "));
       Serial.println(limit, 2);
     }
   }
 
   float PIDController::getKp() const {
-    return Kp;
+    return core.getKp();
   }
 
   float PIDController::getKi() const {
-    return Ki;
+    return core.getKi();
   }
 
   float PIDController::getKd() const {
-    return Kd;
+    return core.getKd();
+  }
+
+  void PIDController::setDerivativeFilter(float cutoff_hz) {
+    if (cutoff_hz < 0.0f) {
+      debugLog(F("WARNING: setDerivativeFilter() - Negative cutoff, filter disabled"));
+      cutoff_hz = 0.0f;
+    }
+    if (cutoff_hz > 0.0f && cutoff_hz * dt > 0.25f) {
+      debugLog(F("WARNING: setDerivativeFilter() - Cutoff close to the sample rate has little effect"));
+    }
+
+    core.setDerivativeFilter(cutoff_hz);
+
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      Serial.print(F("Derivative filter cutoff set to "));
+      Serial.print(cutoff_hz, 1);
+      Serial.println(F("Hz"));
+    }
+  }
+
+  void PIDController::setDerivativeOnMeasurement(bool enable) {
+    if (enable != derivative_on_measurement) {
+      // Re-seed the history so switching sources does not differentiate a jump
+      derivative_on_measurement = enable;
+      core.seedDerivative(derivativeInput(core.getPrevError()));
+    }
+
+    debugLog(enable ? F("Derivative on measurement") : F("Derivative on error"));
+  }
+
+  float PIDController::getDerivativeFilter() const {
+    return core.getDerivativeCutoff();
+  }
+
+  bool PIDController::isDerivativeOnMeasurement() const {
+    return derivative_on_measurement;
   }
 
   float PIDController::getIntegral() const {
-    return integral;
+    return core.getIntegral();
   }
 
 } // namespace controller
\ No newline at end of file
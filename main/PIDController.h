@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BaseController.h"
+#include "PidCore.h"
 
 namespace controller {
 
@@ -53,7 +54,8 @@ namespace controller {
      *          Typical range: 0.0 to 5.0 (often 1/4 to 1/10 of Kp)
      *
      * @var integral: Accumulated error over time (I term state)
-     *                Reset to zero when controller is reset or gains change
+     *                Reset to zero when the controller is reset; kept across gain
+     *                changes so retuning mid-run does not make the output jump
      *
      * @var prev_error: Previous error value (needed for D term calculation)
      *                  Stored to calculate error rate: (current_error - prev_error) / dt
@@ -61,13 +63,36 @@ namespace controller {
      * @var anti_windup: Maximum allowed value for integral term
      *                   Prevents integral windup which can cause large overshoots
      *                   Should be set to a reasonable fraction of max_output
+     *
+     * All of the above live in core, the header-only Pid<PIDTraits> that
+     * performs the arithmetic; this class adds validation, logging and the
+     * BaseController interface around it.
+     */
+    Pid<PIDTraits> core;
+
+    /**
+     * @brief Derivative source
+     *
+     * @var derivative_on_measurement: Differentiate -measured_value instead
+     *      of the error. Identical while the setpoint is constant, but a
+     *      setpoint step no longer produces a derivative spike.
+     */
+    bool derivative_on_measurement;
+
+    /**
+     * @brief Signal the D term differentiates (error or -measured_value)
+     */
+    inline float derivativeInput(float error) const {
+      return derivative_on_measurement ? error - setpoint : error;
+    }
+
+  protected:
+    /**
+     * @brief Snapshot layout: internal[0] = integral, internal[1] = previous error,
+     * internal[2] = previous derivative input, internal[3] = (filtered) derivative term
      */
-    float Kp;
-    float Ki;
-    float Kd;
-    float integral;
-    float prev_error;
-    float anti_windup;
+    void saveState(ControllerState &state) const override;
+    void loadState(const ControllerState &state) override;
 
   public:
     /**
@@ -101,6 +126,16 @@ namespace controller {
      */
     void reset() override;
 
+    ControllerKind getKind() const override;
+
+    /**
+     * @brief Continue from another controller's output without a jump
+     *
+     * @param output: Last output of the controller being replaced
+     * @param error: Current error (setpoint - measured_value)
+     */
+    void bumplessTransfer(float output, float error) override;
+
     /**
      * @brief Calculate PID output based on error
      *
@@ -112,10 +147,39 @@ namespace controller {
      * @return float Controller output between min_output and max_output
      */
     float compute(float error) override;
+    using BaseController::compute;
+
+    /**
+     * @brief Calculate the output with a derivative supplied by an estimator
+     *
+     * The D term becomes Kd × error_rate instead of a difference of
+     * consecutive errors, e.g. with the velocity of a Kalman filter that
+     * tracks the measurement. While the setpoint is constant the error rate
+     * is also the rate of the derivative-on-measurement input, so both
+     * derivative modes accept the same value. compute() can take over again
+     * at any time without a derivative kick.
+     *
+     * @param error: Current error (setpoint - measured_value)
+     * @param error_rate: Rate of change of the error per second
+     * @return float Controller output between min_output and max_output
+     */
+    float computeWithDerivative(float error, float error_rate);
+
+    /**
+     * @brief computeWithDerivative() using the measured time step
+     *
+     * @param error: Current error (setpoint - measured_value)
+     * @param error_rate: Rate of change of the error per second
+     * @param now_us: Current time in microseconds (e.g. micros())
+     * @return float Controller output between min_output and max_output
+     */
+    float computeWithDerivative(float error, float error_rate, uint32_t now_us);
 
     /**
      * @brief Set the proportional gain
      *
+     * Bumpless: the integral absorbs the change of Kp * error.
+     *
      * @param Kp: Proportional gain (affects responsiveness)
      */
     void setKp(float Kp);
@@ -123,7 +187,7 @@ namespace controller {
     /**
      * @brief Set the integral gain
      *
-     * Resets integral accumulation to prevent sudden jumps.
+     * Bumpless: the accumulated (Ki-weighted) integral is kept as is.
      *
      * @param Ki: Integral gain (affects steady-state accuracy)
      */
@@ -140,7 +204,7 @@ namespace controller {
      * @brief Set all PID gains simultaneously
      *
      * More efficient than setting gains individually.
-     * Resets integral accumulation to prevent sudden jumps.
+     * Bumpless for Kp and Ki; a Kd change rescales the derivative term.
      *
      * @param Kp: Proportional gain
      * @param Ki: Integral gain
@@ -180,6 +244,41 @@ namespace controller {
      */
     float getKd() const;
 
+    /**
+     * @brief Low-pass filter the derivative term
+     *
+     * A first-order filter whose coefficient is recomputed only when dt
+     * changes, so it costs one multiply-add per step. At kHz loop rates the
+     * raw backward difference is dominated by ADC noise; a cutoff of 5-10x
+     * the fastest line dynamics (e.g. 50-150 Hz) removes most of it while
+     * adding little phase lag.
+     *
+     * @param cutoff_hz: -3 dB frequency in Hz, 0 to disable (default)
+     */
+    void setDerivativeFilter(float cutoff_hz);
+
+    /**
+     * @brief Choose what the derivative term differentiates
+     *
+     * @param enable: true for the measurement (no kick on setpoint steps),
+     *                false for the error (default)
+     */
+    void setDerivativeOnMeasurement(bool enable);
+
+    /**
+     * @brief Get the derivative filter cutoff
+     *
+     * @return float Cutoff in Hz (0 when unfiltered)
+     */
+    float getDerivativeFilter() const;
+
+    /**
+     * @brief Check whether the derivative is taken on the measurement
+     *
+     * @return bool true when differentiating the measurement
+     */
+    bool isDerivativeOnMeasurement() const;
+
     /**
      * @brief Get the current integral term value
      *
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "LineEstimator.h"
+#include <stdint.h>
+
+namespace sensing {
+
+  /**
+   * @brief Integer-only line position from a parabola through the peak sensor
+   *
+   * The weighted centroid averages every sensor, so it is pulled towards
+   * the middle when the line nears an end of the array (the sensors past
+   * the edge are missing from the average), and two sensors clipped at
+   * saturation look the same wherever the line sits between them. This
+   * estimator only looks at the strongest sensor and its two neighbours and
+   * places the line at the vertex of the parabola through them:
+   *
+   *   offset = WEIGHT_STEP × (R - L) / (2 × (2P - L - R))
+   *
+   * where P is the conditioned peak and L, R its neighbours; the offset is
+   * always within half a sensor pitch of the peak. A run of equal readings
+   * (a plateau of saturated sensors) is treated as one wide peak centred on
+   * the run, with the readings just outside it as neighbours.
+   *
+   * At an end of the array one neighbour is missing. Taking it as zero
+   * pulls the estimate inwards whenever the line is on or past the edge
+   * sensor, by about a tenth of a pitch for a line seen by three sensors.
+   * Mirroring it (L = R, the line centred on the edge sensor) is right
+   * there but jumps by half a pitch when the peak moves onto the edge
+   * sensor, where the line is really halfway to its neighbour (P = R).
+   * The missing reading is therefore extrapolated as
+   *
+   *   L = R × ((P - R) / P)²
+   *
+   * which is R for a line centred on the edge sensor (R << P) and fades
+   * to zero as R approaches P, so the estimate stays continuous.
+   *
+   * Readings are conditioned as in LineEstimator (clipped to the saturation
+   * threshold, noise floor subtracted). The scan is a compare per sensor
+   * and the fit one integer divide, with no per-sensor multiply-accumulate.
+   * Positions use the same units and NO_LINE sentinel as LineEstimator, so
+   * the two are interchangeable; the sensors must be evenly spaced.
+   *
+   * A parabola is exact for a quadratic peak and has an S-shaped bias on a
+   * bell-shaped profile that grows as the profile narrows. It suits a line
+   * seen by about three sensors at once; when only one sensor responds the
+   * centroid is the better choice.
+   *
+   * @tparam SENSOR_COUNT: Number of sensors in the array (2-32)
+   */
+  template <uint8_t SENSOR_COUNT>
+  class PeakEstimator {
+    static_assert(SENSOR_COUNT >= 2 && SENSOR_COUNT <= 32, "PeakEstimator supports 2-32 sensors");
+
+  public:
+    /**
+     * @brief Estimator constants, shared with LineEstimator
+     */
+    static const int32_t NO_LINE = LineEstimator<SENSOR_COUNT>::NO_LINE;
+    static const int32_t WEIGHT_STEP = LineEstimator<SENSOR_COUNT>::WEIGHT_STEP;
+    static const uint16_t DEFAULT_NOISE_FLOOR = LineEstimator<SENSOR_COUNT>::DEFAULT_NOISE_FLOOR;
+    static const uint16_t DEFAULT_SATURATION = LineEstimator<SENSOR_COUNT>::DEFAULT_SATURATION;
+
+    /**
+     * @brief Construct an estimator
+     *
+     * @param noise_floor: Readings at or below this value are ignored
+     * @param saturation: Readings are clipped to this value
+     */
+    explicit PeakEstimator(uint16_t noise_floor = DEFAULT_NOISE_FLOOR,
+                           uint16_t saturation = DEFAULT_SATURATION)
+        : noise_floor(0), saturation(0), signal(0) {
+      if (!setThresholds(noise_floor, saturation)) {
+        setThresholds(DEFAULT_NOISE_FLOOR, DEFAULT_SATURATION);
+      }
+    }
+
+    /**
+     * @brief Estimate the line position from one frame of readings
+     *
+     * @param values: SENSOR_COUNT readings, typically calibrated 0-1000
+     * @return int32_t Position in weight units (0 = centre), or NO_LINE
+     */
+    inline int32_t estimate(const uint16_t *values) {
+      // Strongest sensor: a plain arg-max the compiler can make branch-free
+      int32_t peak = 0;
+      uint8_t first = 0;
+
+      LINE_ESTIMATOR_UNROLL
+      for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        int32_t v = condition(values[i]);
+        bool higher = v > peak;
+        peak = higher ? v : peak;
+        first = higher ? i : first;
+      }
+
+      signal = peak;
+      if (peak == 0) {
+        return NO_LINE;
+      }
+
+      // Extend over a run of equal (saturated) readings
+      uint8_t last = first;
+      while (last < SENSOR_COUNT - 1 && condition(values[last + 1]) == peak) {
+        last++;
+      }
+
+      int32_t left = first > 0 ? condition(values[first - 1]) : 0;
+      int32_t right = last < SENSOR_COUNT - 1 ? condition(values[last + 1]) : 0;
+      if (first == 0 && last < SENSOR_COUNT - 1) {
+        left = extrapolate(peak, right);
+      } else if (last == SENSOR_COUNT - 1 && first > 0) {
+        right = extrapolate(peak, left);
+      }
+
+      // Both neighbours are below the peak, so the denominator is positive
+      int32_t numerator = WEIGHT_STEP * (right - left);
+      int32_t denominator = 2 * (2 * peak - left - right);
+      int32_t half = denominator >> 1;
+      int32_t offset = (numerator >= 0 ? numerator + half : numerator - half) / denominator;
+
+      // Centre of the run, in half pitches so a plateau of even length works
+      int32_t centre = (WEIGHT_STEP / 2) * (int32_t)(first + last) - (WEIGHT_STEP / 2) * (SENSOR_COUNT - 1);
+      return centre + offset;
+    }
+
+    /**
+     * @brief Check whether an estimate found the line
+     *
+     * @param position: Value returned by estimate()
+     * @return bool true unless position is NO_LINE
+     */
+    static inline bool hasLine(int32_t position) {
+      return position != NO_LINE;
+    }
+
+    /**
+     * @brief Set the noise floor and saturation threshold
+     *
+     * @param noise_floor: Readings at or below this value are ignored
+     * @param saturation: Readings are clipped to this value
+     * @return bool true if accepted (saturation above the noise floor)
+     */
+    bool setThresholds(uint16_t noise_floor, uint16_t saturation) {
+      if (saturation <= noise_floor) {
+        return false;
+      }
+      this->noise_floor = noise_floor;
+      this->saturation = saturation;
+      return true;
+    }
+
+    inline uint16_t getNoiseFloor() const { return noise_floor; }
+    inline uint16_t getSaturation() const { return saturation; }
+
+    /**
+     * @brief Get the conditioned peak reading of the last estimate
+     *
+     * A low value means the line is only faintly visible; 0 means NO_LINE.
+     *
+     * @return int32_t Peak reading above the noise floor
+     */
+    inline int32_t getSignal() const { return signal; }
+
+  private:
+    /**
+     * @brief Clip to saturation, then subtract the noise floor (clipping at zero)
+     */
+    inline int32_t condition(uint16_t value) const {
+      int32_t v = value;
+      v = (v > saturation) ? saturation : v;
+      return (v > noise_floor) ? v - noise_floor : 0;
+    }
+
+    /**
+     * @brief Reading past an end of the array, from the peak and its inner neighbour
+     *
+     * @param peak: Conditioned peak reading (> 0)
+     * @param inner: Conditioned reading of the inner neighbour (< peak)
+     * @return int32_t inner × ((peak - inner) / peak)²
+     */
+    static inline int32_t extrapolate(int32_t peak, int32_t inner) {
+      // Two steps keep the products within 32 bits for 16-bit readings
+      int32_t falloff = peak - inner;
+      return inner * falloff / peak * falloff / peak;
+    }
+
+    /**
+     * @brief Estimator configuration and last result
+     *
+     * @var noise_floor: Subtracted from every reading, clipping at zero
+     * @var saturation: Upper clip applied before the noise floor
+     * @var signal: Conditioned peak of the last estimate
+     */
+    int32_t noise_floor;
+    int32_t saturation;
+    int32_t signal;
+  };
+
+} // namespace sensing
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "PidCore.h"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace controller {
+
+  /**
+   * @brief N independent PID controllers in structure-of-arrays form
+   *
+   * Intended for offline tuning sweeps: each lane holds one candidate gain
+   * set, and step() advances every lane by one sample with a single loop
+   * that has no calls, no virtual dispatch and no data-dependent branches.
+   * GCC and Clang auto-vectorize it (SSE/AVX/NEON on a host at -O3 or
+   * -O2 -ftree-vectorize); on the ESP32 it compiles to the equivalent scalar
+   * loop.
+   *
+   * Each lane follows the same arithmetic as Pid<PIDTraits>, in the same
+   * order, so a lane matches PIDController::compute() with the same gains,
+   * sample time and limits. Disable a term in a lane by setting its gain to
+   * zero. All lanes share the sample time and output limits.
+   *
+   * @tparam LANES: Number of controllers evaluated side by side
+   */
+  template <size_t LANES>
+  class PidBank {
+  public:
+    /**
+     * @brief Construct a bank with all gains zero
+     *
+     * @param dt: Sample time in seconds shared by all lanes
+     * @param min_output: Minimum output shared by all lanes
+     * @param max_output: Maximum output shared by all lanes
+     */
+    explicit PidBank(float dt = 0.001f, float min_output = -1023.0f, float max_output = 1023.0f)
+        : dt(dt), inv_dt(1.0f / dt), min_output(min_output), max_output(max_output) {
+      float default_limit = max_output < 0.0f ? -max_output : max_output;
+      for (size_t i = 0; i < LANES; i++) {
+        Kp[i] = 0.0f;
+        Ki[i] = 0.0f;
+        Kd[i] = 0.0f;
+        ki_dt[i] = 0.0f;
+        kd_inv_dt[i] = 0.0f;
+        anti_windup[i] = default_limit;
+      }
+      reset();
+    }
+
+    /**
+     * @brief Set the gains of one lane
+     *
+     * @param lane: Lane index (< LANES)
+     * @param Kp: Proportional gain
+     * @param Ki: Integral gain
+     * @param Kd: Derivative gain
+     */
+    void setGains(size_t lane, float Kp, float Ki, float Kd) {
+      this->Kp[lane] = Kp;
+      this->Ki[lane] = Ki;
+      this->Kd[lane] = Kd;
+      ki_dt[lane] = Ki * dt;
+      kd_inv_dt[lane] = Kd * inv_dt;
+    }
+
+    /**
+     * @brief Set the anti-windup limit of one lane
+     *
+     * @param lane: Lane index (< LANES)
+     * @param limit: Maximum absolute value of the integral term
+     */
+    void setAntiWindupLimit(size_t lane, float limit) {
+      anti_windup[lane] = limit;
+    }
+
+    /**
+     * @brief Clear the integral, derivative history and output of every lane
+     */
+    void reset() {
+      for (size_t i = 0; i < LANES; i++) {
+        integral[i] = 0.0f;
+        prev_error[i] = 0.0f;
+        output[i] = 0.0f;
+      }
+    }
+
+    /**
+     * @brief Advance every lane by one sample
+     *
+     * @param error: LANES error values, one per lane
+     * @param out: Receives LANES outputs (may be nullptr; see getOutput())
+     */
+    inline void step(const float *__restrict error, float *__restrict out) {
+      for (size_t i = 0; i < LANES; i++) {
+        float e = error[i];
+        float sum = Kp[i] * e;
+
+        float acc = integral[i] + ki_dt[i] * e;
+        acc = policy::Saturate::apply(acc, -anti_windup[i], anti_windup[i]);
+        integral[i] = acc;
+        sum = sum + acc;
+
+        sum = sum + kd_inv_dt[i] * (e - prev_error[i]);
+        prev_error[i] = e;
+
+        output[i] = policy::Saturate::apply(sum, min_output, max_output);
+      }
+
+      if (out != nullptr) {
+        for (size_t i = 0; i < LANES; i++) {
+          out[i] = output[i];
+        }
+      }
+    }
+
+    /**
+     * @brief Advance every lane by one sample with the same error
+     *
+     * The usual case in a gain sweep: every candidate sees the same
+     * recorded error sample.
+     *
+     * @param error: Error applied to all lanes
+     */
+    inline void stepAll(float error) {
+      for (size_t i = 0; i < LANES; i++) {
+        float sum = Kp[i] * error;
+
+        float acc = integral[i] + ki_dt[i] * error;
+        acc = policy::Saturate::apply(acc, -anti_windup[i], anti_windup[i]);
+        integral[i] = acc;
+        sum = sum + acc;
+
+        sum = sum + kd_inv_dt[i] * (error - prev_error[i]);
+        prev_error[i] = error;
+
+        output[i] = policy::Saturate::apply(sum, min_output, max_output);
+      }
+    }
+
+    inline float getOutput(size_t lane) const { return output[lane]; }
+    inline float getIntegral(size_t lane) const { return integral[lane]; }
+    inline const float *getOutputs() const { return output; }
+    inline size_t getLaneCount() const { return LANES; }
+
+  private:
+    /**
+     * @brief Per-lane gains and state, one contiguous array per field
+     *
+     * @var Kp, Ki, Kd: Gains as set by the user
+     * @var ki_dt, kd_inv_dt: Ki * dt and Kd / dt used by step()
+     * @var anti_windup: Maximum absolute value of each integral
+     * @var integral, prev_error, output: Controller state
+     * @var dt, inv_dt: Shared sample time and its reciprocal
+     * @var min_output, max_output: Shared output limits
+     */
+    alignas(32) float Kp[LANES];
+    alignas(32) float Ki[LANES];
+    alignas(32) float Kd[LANES];
+    alignas(32) float ki_dt[LANES];
+    alignas(32) float kd_inv_dt[LANES];
+    alignas(32) float anti_windup[LANES];
+    alignas(32) float integral[LANES];
+    alignas(32) float prev_error[LANES];
+    alignas(32) float output[LANES];
+    float dt;
+    float inv_dt;
+    float min_output;
+    float max_output;
+  };
+
+} // namespace controller
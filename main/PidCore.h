@@ -0,0 +1,621 @@
+#pragma once
+
+#include "FixedPoint.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#endif
+
+namespace controller {
+
+  /**
+   * @brief Compile-time policies for the Pid<Traits> template
+   *
+   * Policies are stateless structs with static inline functions, so selecting
+   * one costs nothing at run time: the compiler inlines the chosen behavior
+   * and drops the alternatives entirely.
+   */
+  namespace policy {
+
+    /**
+     * @brief Saturating clamp - same semantics as BaseController::applyLimits
+     */
+    struct Saturate {
+      template <typename T>
+      static inline T apply(T value, T min, T max) {
+        if (value > max) {
+          return max;
+        }
+        if (value < min) {
+          return min;
+        }
+        return value;
+      }
+    };
+
+    /**
+     * @brief No clamping - neither anti-windup nor output limits are applied
+     *
+     * Useful inside cascades where an outer stage applies the limits.
+     */
+    struct Unclamped {
+      template <typename T>
+      static inline T apply(T value, T, T) {
+        return value;
+      }
+    };
+
+    /**
+     * @brief No tracing - the release configuration
+     */
+    struct NoTrace {
+      template <typename T>
+      static inline void trace(T, T, T, T, T) {}
+    };
+
+#if defined(ARDUINO)
+    /**
+     * @brief Print every step to Serial in the same format as the controller classes
+     *
+     * Only for bench tuning: printing at kHz rates will overrun the loop.
+     */
+    struct SerialTrace {
+      template <typename T>
+      static inline void trace(T error, T p_term, T i_term, T d_term, T output) {
+        Serial.print(F("Pid: error="));
+        Serial.print((float)error, 3);
+        Serial.print(F(", P="));
+        Serial.print((float)p_term, 2);
+        Serial.print(F(", I="));
+        Serial.print((float)i_term, 2);
+        Serial.print(F(", D="));
+        Serial.print((float)d_term, 2);
+        Serial.print(F(", output="));
+        Serial.println((float)output, 2);
+      }
+    };
+#endif
+
+  } // namespace policy
+
+  /**
+   * @brief Compile-time configuration of a Pid instantiation
+   *
+   * @tparam P: Enable the proportional term
+   * @tparam I: Enable the integral term (with anti-windup)
+   * @tparam D: Enable the derivative term (backward difference of the error
+   *            or the measurement, optionally low-pass filtered)
+   * @tparam ClampPolicy: How anti-windup and output limits are applied
+   * @tparam TracePolicy: What happens to the per-step terms (nothing by default)
+   * @tparam ScalarType: Numeric type of gains, state and signals - float or a
+   *                     numeric::Fixed instantiation such as numeric::Q16_16
+   */
+  template <bool P, bool I, bool D,
+            typename ClampPolicy = policy::Saturate,
+            typename TracePolicy = policy::NoTrace,
+            typename ScalarType = float>
+  struct PidTraits {
+    static const bool HAS_P = P;
+    static const bool HAS_I = I;
+    static const bool HAS_D = D;
+    typedef ClampPolicy Clamp;
+    typedef TracePolicy Trace;
+    typedef ScalarType Scalar;
+  };
+
+  typedef PidTraits<true, false, false> PTraits;
+  typedef PidTraits<true, true, false> PITraits;
+  typedef PidTraits<true, false, true> PDTraits;
+  typedef PidTraits<true, true, true> PIDTraits;
+
+  /**
+   * @brief Fixed-point (Q16.16) variants for FPU-free or bit-exact builds
+   *
+   * Saturating arithmetic keeps every intermediate inside ±32768, and
+   * policy::Saturate clamps with the same semantics as the float path.
+   * Note that 1 ms is only 66 LSBs in Q16.16, so dt and 1/dt carry about 1%
+   * quantization error at 1 kHz; pass an exact inv_dt through step() when the
+   * derivative gain matters, and prefer larger Ki over tiny per-step dt.
+   */
+  typedef PidTraits<true, false, false, policy::Saturate, policy::NoTrace, numeric::Q16_16> PTraitsQ16;
+  typedef PidTraits<true, true, false, policy::Saturate, policy::NoTrace, numeric::Q16_16> PITraitsQ16;
+  typedef PidTraits<true, false, true, policy::Saturate, policy::NoTrace, numeric::Q16_16> PDTraitsQ16;
+  typedef PidTraits<true, true, true, policy::Saturate, policy::NoTrace, numeric::Q16_16> PIDTraitsQ16;
+
+  /**
+   * @brief Header-only, devirtualized PID core
+   *
+   * The term selection, clamping and tracing are fixed at compile time by the
+   * Traits parameter, so there is no vtable and no run-time branching on
+   * configuration: a PDTraits instantiation reduces to two multiply-adds and
+   * a clamp, a PTraits instantiation to one multiply and a clamp.
+   *
+   * The PController/PIController/PDController/PIDController classes are
+   * thin wrappers around this template.
+   *
+   * The products Ki * dt and Kd / dt are kept as coefficients and only
+   * recomputed when a gain changes or when step() sees a different dt than
+   * the previous call, so the per-step work is a compare, three multiplies
+   * and the clamps - no divide and no multiply by dt. Grouping the factors
+   * this way changes float rounding in the last bit compared with
+   * (Ki * error) * dt.
+   *
+   * The derivative term can be low-pass filtered with a first-order IIR
+   * (setDerivativeFilter()): D[k] = alpha * D_raw[k] + (1 - alpha) * D[k-1]
+   * with alpha = w / (1 + w), w = 2*pi*fc*dt. Both coefficients are
+   * refreshed together with the other dt-dependent ones; unfiltered they
+   * are 1 and 0, so the same multiply and multiply-add run every step with
+   * no branch on the cutoff and give the raw derivative exactly, at the
+   * price of each step waiting on the previous derivative. Its -3 dB
+   * point is fc as long as fc is well below the sample rate (backward-Euler
+   * discretization): the gain at fc is -3.3 dB at fs/50 and -3.6 dB at fs/20.
+   *
+   * Three ways to run it:
+   * - compute(error): uses the sample time and limits stored in the core
+   * - step(error, dt, inv_dt, min, max): uses caller-supplied timing and
+   *   limits; this is how the BaseController wrappers share their settings
+   *   (stepWithRate() takes the derivative from an estimator instead)
+   * - computeTrace(errors, outputs, count): a whole recorded error trace
+   *   with the core's own settings, for offline tuning (see also PidBank)
+   *
+   * @tparam Traits: A PidTraits instantiation
+   */
+  template <typename Traits>
+  class Pid {
+  public:
+    typedef typename Traits::Clamp Clamp;
+    typedef typename Traits::Trace Trace;
+    typedef typename Traits::Scalar Scalar;
+
+    /**
+     * @brief Construct a new Pid core
+     *
+     * Gains for disabled terms are stored but never used.
+     *
+     * @param Kp: Proportional gain
+     * @param Ki: Integral gain (per second)
+     * @param Kd: Derivative gain (seconds)
+     * @param dt: Sample time in seconds for compute()
+     * @param min_output: Minimum output for compute()
+     * @param max_output: Maximum output for compute()
+     */
+    Pid(Scalar Kp = Scalar(0.0f), Scalar Ki = Scalar(0.0f), Scalar Kd = Scalar(0.0f),
+        Scalar dt = Scalar(0.001f), Scalar min_output = Scalar(-1023.0f), Scalar max_output = Scalar(1023.0f))
+        : Kp(Kp), Ki(Ki), Kd(Kd), anti_windup(max_output < Scalar(0.0f) ? -max_output : max_output),
+          integral(0.0f), prev_error(0.0f), prev_d_input(0.0f), derivative(0.0f), output(0.0f),
+          dt(dt), inv_dt(Scalar(1.0f) / dt), min_output(min_output), max_output(max_output),
+          d_cutoff(0.0f), d_alpha(1.0f), d_beta(0.0f) {
+      refreshCoefficients(this->dt, inv_dt);
+    }
+
+    /**
+     * @brief Run one control step with the core's own sample time and limits
+     *
+     * @param error: Current error (setpoint - measured_value)
+     * @return Scalar Controller output
+     */
+    inline Scalar compute(Scalar error) {
+      return step(error, dt, inv_dt, min_output, max_output);
+    }
+
+    /**
+     * @brief Run the controller over a recorded error trace
+     *
+     * Equivalent to calling compute() once per element, split into a pass
+     * that only depends on the input (the P term, auto-vectorized by
+     * GCC/Clang at -O2 -ftree-vectorize or -O3) and a serial pass for the
+     * integral and derivative-filter recursions and the clamp. The terms
+     * are summed in compute()'s order, (P + I) + D, so the outputs match it
+     * bit for bit. Tracing is not applied, and the derivative is always
+     * taken of the error (equal to derivative on measurement while the
+     * setpoint is constant).
+     *
+     * @param errors: count error samples (must not overlap outputs)
+     * @param outputs: Receives count controller outputs
+     * @param count: Number of samples
+     */
+    inline void computeTrace(const Scalar *__restrict errors, Scalar *__restrict outputs, size_t count) {
+      if (count == 0) {
+        return;
+      }
+      if (dt != coeff_dt) {
+        refreshCoefficients(dt, inv_dt);
+      }
+
+      // Pass 1: input-only term, no loop-carried dependency
+      const Scalar kp = Kp;
+      for (size_t k = 0; k < count; k++) {
+        outputs[k] = proportionalTerm(kp, errors[k]);
+      }
+
+      // Pass 2: integral and derivative-filter recursions, output limits
+      if (Traits::HAS_I || Traits::HAS_D) {
+        const Scalar ki = ki_dt;
+        const Scalar kd = kd_inv_dt;
+        const Scalar alpha = d_alpha;
+        const Scalar beta = d_beta;
+        Scalar acc = integral;
+        Scalar d = derivative;
+        Scalar previous = prev_d_input;
+        for (size_t k = 0; k < count; k++) {
+          Scalar sum = outputs[k];
+          if (Traits::HAS_I) {
+            acc += ki * errors[k];
+            acc = Clamp::apply(acc, -anti_windup, anti_windup);
+            sum = sum + acc;
+          }
+          if (Traits::HAS_D) {
+            d = alpha * (kd * (errors[k] - previous)) + beta * d;
+            previous = errors[k];
+            sum = sum + d;
+          }
+          outputs[k] = Clamp::apply(sum, min_output, max_output);
+        }
+        integral = acc;
+        derivative = d;
+      } else {
+        for (size_t k = 0; k < count; k++) {
+          outputs[k] = Clamp::apply(outputs[k], min_output, max_output);
+        }
+      }
+
+      prev_error = errors[count - 1];
+      prev_d_input = errors[count - 1];
+      output = outputs[count - 1];
+    }
+
+    /**
+     * @brief Run one control step with caller-supplied timing and limits
+     *
+     * @param error: Current error (setpoint - measured_value)
+     * @param dt: Time step in seconds (integral term)
+     * @param inv_dt: 1/dt (derivative term)
+     * @param min_output: Minimum output value
+     * @param max_output: Maximum output value
+     * @return Scalar Controller output
+     */
+    inline Scalar step(Scalar error, Scalar dt, Scalar inv_dt, Scalar min_output, Scalar max_output) {
+      return step(error, error, dt, inv_dt, min_output, max_output);
+    }
+
+    /**
+     * @brief Run one control step with a separate derivative input
+     *
+     * The derivative term differentiates d_input instead of the error. Pass
+     * -measurement (i.e. error - setpoint) for derivative on measurement:
+     * it has the same sign and value as the error derivative while the
+     * setpoint is constant, but no kick when the setpoint steps.
+     *
+     * @param error: Current error (setpoint - measured_value)
+     * @param d_input: Signal differentiated by the D term
+     * @param dt: Time step in seconds (integral term)
+     * @param inv_dt: 1/dt (derivative term)
+     * @param min_output: Minimum output value
+     * @param max_output: Maximum output value
+     * @return Scalar Controller output
+     */
+    inline Scalar step(Scalar error, Scalar d_input, Scalar dt, Scalar inv_dt, Scalar min_output,
+                       Scalar max_output) {
+      if (dt != coeff_dt) {
+        refreshCoefficients(dt, inv_dt);
+      }
+
+      Scalar d_raw = Traits::HAS_D ? kd_inv_dt * (d_input - prev_d_input) : Scalar(0.0f);
+      return combine(error, d_input, d_raw, min_output, max_output);
+    }
+
+    /**
+     * @brief Run one control step with a supplied derivative
+     *
+     * The D term is Kd * d_rate instead of a backward difference, for a
+     * rate that comes from an estimator (e.g. the velocity of a Kalman
+     * filter) rather than from differencing noisy samples. The derivative
+     * filter still applies, and d_input is recorded so that step() can
+     * take over again without a kick.
+     *
+     * @param error: Current error (setpoint - measured_value)
+     * @param d_input: Current derivative input (see step())
+     * @param d_rate: Rate of change of d_input per second
+     * @param dt: Time step in seconds (integral term)
+     * @param inv_dt: 1/dt
+     * @param min_output: Minimum output value
+     * @param max_output: Maximum output value
+     * @return Scalar Controller output
+     */
+    inline Scalar stepWithRate(Scalar error, Scalar d_input, Scalar d_rate, Scalar dt, Scalar inv_dt,
+                               Scalar min_output, Scalar max_output) {
+      if (dt != coeff_dt) {
+        refreshCoefficients(dt, inv_dt);
+      }
+
+      Scalar d_raw = Traits::HAS_D ? Kd * d_rate : Scalar(0.0f);
+      return combine(error, d_input, d_raw, min_output, max_output);
+    }
+
+    /**
+     * @brief Clear integral, derivative history and output
+     */
+    inline void reset() {
+      integral = Scalar(0.0f);
+      prev_error = Scalar(0.0f);
+      prev_d_input = Scalar(0.0f);
+      derivative = Scalar(0.0f);
+      output = Scalar(0.0f);
+    }
+
+    /**
+     * @brief Clear only the integral accumulation
+     */
+    inline void resetIntegral() {
+      integral = Scalar(0.0f);
+    }
+
+    inline void setKp(Scalar Kp) { this->Kp = Kp; }
+
+    inline void setKi(Scalar Ki) {
+      this->Ki = Ki;
+      refreshCoefficients(coeff_dt, coeff_inv_dt);
+    }
+
+    inline void setKd(Scalar Kd) {
+      this->Kd = Kd;
+      refreshCoefficients(coeff_dt, coeff_inv_dt);
+    }
+
+    inline void setGains(Scalar Kp, Scalar Ki, Scalar Kd) {
+      this->Kp = Kp;
+      this->Ki = Ki;
+      this->Kd = Kd;
+      refreshCoefficients(coeff_dt, coeff_inv_dt);
+    }
+
+    /**
+     * @brief Change the gains without a step in the output
+     *
+     * The integral absorbs the change of the proportional term at the last
+     * error, so the next output continues from the current one instead of
+     * jumping by (Kp_new - Kp_old) * error. Ki needs no compensation because
+     * the integral already stores Ki-weighted error. A Kd change still
+     * scales the (transient) derivative term. Without an integral term the
+     * gains are simply replaced.
+     *
+     * @param Kp: Proportional gain
+     * @param Ki: Integral gain
+     * @param Kd: Derivative gain
+     */
+    inline void retune(Scalar Kp, Scalar Ki, Scalar Kd) {
+      if (Traits::HAS_I && Traits::HAS_P) {
+        integral += (this->Kp - Kp) * prev_error;
+        integral = Clamp::apply(integral, -anti_windup, anti_windup);
+      }
+      setGains(Kp, Ki, Kd);
+    }
+
+    /**
+     * @brief Initialize the state to continue from another controller's output
+     *
+     * Sets the integral so that P + I reproduces output at the current
+     * error (as far as the anti-windup limit allows) and the derivative
+     * history to the current derivative input, so the first step has no
+     * derivative kick.
+     *
+     * @param output: Output to continue from
+     * @param error: Current error
+     * @param d_input: Current derivative input (see step())
+     */
+    inline void track(Scalar output, Scalar error, Scalar d_input) {
+      if (Traits::HAS_I) {
+        Scalar p_term = Traits::HAS_P ? Kp * error : Scalar(0.0f);
+        integral = Clamp::apply(output - p_term, -anti_windup, anti_windup);
+      }
+      prev_error = error;
+      prev_d_input = d_input;
+      derivative = Scalar(0.0f);
+      this->output = output;
+    }
+
+    inline void track(Scalar output, Scalar error) {
+      track(output, error, error);
+    }
+
+    /**
+     * @brief Restart the derivative history from the given input
+     *
+     * Use when the derivative source changes so that the first difference
+     * does not see the jump between the two signals.
+     *
+     * @param d_input: Current derivative input (see step())
+     */
+    inline void seedDerivative(Scalar d_input) {
+      prev_d_input = d_input;
+      derivative = Scalar(0.0f);
+    }
+
+    /**
+     * @brief Overwrite the dynamic state, e.g. from a saved snapshot
+     *
+     * The integral is clamped to the current anti-windup limit; gains,
+     * filter and limits are configuration and stay as they are.
+     *
+     * @param integral: Integral accumulation
+     * @param prev_error: Error of the last step
+     * @param prev_d_input: Derivative input of the last step
+     * @param derivative: Last (filtered) derivative term
+     */
+    inline void restoreState(Scalar integral, Scalar prev_error, Scalar prev_d_input, Scalar derivative) {
+      this->integral = Traits::HAS_I ? Clamp::apply(integral, -anti_windup, anti_windup) : Scalar(0.0f);
+      this->prev_error = prev_error;
+      this->prev_d_input = prev_d_input;
+      this->derivative = Traits::HAS_D ? derivative : Scalar(0.0f);
+    }
+
+    /**
+     * @brief Low-pass filter the derivative term
+     *
+     * @param cutoff_hz: -3 dB frequency of the first-order filter in Hz,
+     *                   0 to disable (raw backward difference)
+     */
+    inline void setDerivativeFilter(Scalar cutoff_hz) {
+      d_cutoff = cutoff_hz < Scalar(0.0f) ? Scalar(0.0f) : cutoff_hz;
+      refreshCoefficients(coeff_dt, coeff_inv_dt);
+    }
+
+    /**
+     * @brief Set the anti-windup limit and re-clamp the integral to it
+     *
+     * @param limit: Maximum absolute value of the integral term (must be >= 0)
+     */
+    inline void setAntiWindupLimit(Scalar limit) {
+      anti_windup = limit;
+      integral = Clamp::apply(integral, -anti_windup, anti_windup);
+    }
+
+    /**
+     * @brief Set the sample time used by compute()
+     *
+     * @param dt: Time step in seconds (must be > 0)
+     */
+    inline void setSampleTime(Scalar dt) {
+      this->dt = dt;
+      inv_dt = Scalar(1.0f) / dt;
+      refreshCoefficients(this->dt, inv_dt);
+    }
+
+    /**
+     * @brief Set the output limits used by compute()
+     *
+     * @param min_output: Minimum output value
+     * @param max_output: Maximum output value
+     */
+    inline void setOutputLimits(Scalar min_output, Scalar max_output) {
+      this->min_output = min_output;
+      this->max_output = max_output;
+    }
+
+    inline Scalar getKp() const { return Kp; }
+    inline Scalar getKi() const { return Ki; }
+    inline Scalar getKd() const { return Kd; }
+    inline Scalar getIntegral() const { return integral; }
+    inline Scalar getPrevError() const { return prev_error; }
+    inline Scalar getPrevDerivativeInput() const { return prev_d_input; }
+    inline Scalar getDerivativeTerm() const { return derivative; }
+    inline Scalar getDerivativeCutoff() const { return d_cutoff; }
+    inline Scalar getDerivativeAlpha() const { return d_alpha; }
+    inline Scalar getAntiWindupLimit() const { return anti_windup; }
+    inline Scalar getOutput() const { return output; }
+
+  private:
+    /**
+     * @brief Sum the terms of one step, update the state and apply the limits
+     *
+     * @param error: Current error
+     * @param d_input: Derivative input recorded for the next difference
+     * @param d_raw: Unfiltered derivative term of this step
+     * @param min_output: Minimum output value
+     * @param max_output: Maximum output value
+     * @return Scalar Controller output
+     */
+    inline Scalar combine(Scalar error, Scalar d_input, Scalar d_raw, Scalar min_output, Scalar max_output) {
+      Scalar p_term = Scalar(0.0f);
+      Scalar i_term = Scalar(0.0f);
+      Scalar d_term = Scalar(0.0f);
+      Scalar sum = Scalar(0.0f);
+
+      if (Traits::HAS_P) {
+        p_term = Kp * error;
+        sum = p_term;
+      }
+
+      if (Traits::HAS_I) {
+        integral += ki_dt * error;
+        integral = Clamp::apply(integral, -anti_windup, anti_windup);
+        i_term = integral;
+        sum = sum + i_term;
+      }
+
+      if (Traits::HAS_D) {
+        // Unfiltered, alpha = 1 and beta = 0 give d_raw exactly
+        d_term = d_alpha * d_raw + d_beta * derivative;
+        derivative = d_term;
+        prev_d_input = d_input;
+        sum = sum + d_term;
+      }
+      prev_error = error; // Also kept without D, for bumpless retuning
+
+      output = Clamp::apply(sum, min_output, max_output);
+      Trace::trace(error, p_term, i_term, d_term, output);
+      return output;
+    }
+
+    /**
+     * @brief P contribution of one sample (the only term with no state)
+     */
+    static inline Scalar proportionalTerm(Scalar kp, Scalar error) {
+      return Traits::HAS_P ? kp * error : Scalar(0.0f);
+    }
+
+    /**
+     * @brief Recompute the dt-dependent coefficients
+     *
+     * @param dt: Time step the coefficients are valid for
+     * @param inv_dt: 1/dt
+     */
+    inline void refreshCoefficients(Scalar dt, Scalar inv_dt) {
+      coeff_dt = dt;
+      coeff_inv_dt = inv_dt;
+      ki_dt = Ki * dt;
+      kd_inv_dt = Kd * inv_dt;
+      if (d_cutoff > Scalar(0.0f)) {
+        Scalar w = Scalar(TWO_PI_F) * d_cutoff * dt;
+        d_alpha = w / (Scalar(1.0f) + w);
+      } else {
+        d_alpha = Scalar(1.0f);
+      }
+      d_beta = Scalar(1.0f) - d_alpha;
+    }
+
+    static constexpr float TWO_PI_F = 6.28318531f;
+
+    /**
+     * @brief Gains, state and standalone configuration
+     *
+     * @var Kp, Ki, Kd: Controller gains
+     * @var anti_windup: Maximum absolute value of the integral term
+     * @var integral: Accumulated Ki * error * dt
+     * @var prev_error: Error of the previous step (bumpless retuning)
+     * @var prev_d_input: Derivative input of the previous step
+     * @var derivative: Last (filtered) derivative term, the filter state
+     * @var output: Last computed output
+     * @var dt, inv_dt: Sample time and its reciprocal for compute()
+     * @var min_output, max_output: Output limits for compute()
+     * @var ki_dt, kd_inv_dt: Ki * dt and Kd / dt for the time step in coeff_dt
+     * @var coeff_dt, coeff_inv_dt: Time step the coefficients were computed for
+     * @var d_cutoff: Derivative filter cutoff in Hz (0 = unfiltered)
+     * @var d_alpha, d_beta: Derivative filter coefficients for the time step
+     *                       in coeff_dt (beta = 1 - alpha; 1 and 0 unfiltered)
+     */
+    Scalar Kp;
+    Scalar Ki;
+    Scalar Kd;
+    Scalar anti_windup;
+    Scalar integral;
+    Scalar prev_error;
+    Scalar prev_d_input;
+    Scalar derivative;
+    Scalar output;
+    Scalar dt;
+    Scalar inv_dt;
+    Scalar min_output;
+    Scalar max_output;
+    Scalar ki_dt;
+    Scalar kd_inv_dt;
+    Scalar coeff_dt;
+    Scalar coeff_inv_dt;
+    Scalar d_cutoff;
+    Scalar d_alpha;
+    Scalar d_beta;
+  };
+
+} // namespace controller
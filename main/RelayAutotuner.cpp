@@ -0,0 +1,301 @@
+#include "RelayAutotuner.h"
+#include <math.h> // For sqrtf()
+
+namespace controller {
+
+  RelayAutotuner::RelayAutotuner(float relay_amplitude, float hysteresis, uint32_t dt_ms,
+                                 float min_output, float max_output, bool debug)
+      : BaseController(dt_ms, min_output, max_output, debug),
+        relay_amplitude(relay_amplitude), hysteresis(hysteresis < 0.0f ? -hysteresis : hysteresis),
+        settle_cycles(2), measure_cycles(4), timeout_us(30000000UL) {
+
+    if (relay_amplitude <= 0.0f) {
+      LOG_WARNING(F("WARNING: RelayAutotuner - Relay amplitude must be positive"));
+    }
+    if (relay_amplitude > this->max_output || -relay_amplitude < this->min_output) {
+      LOG_WARNING(F("WARNING: RelayAutotuner - Relay amplitude exceeds output limits, Ku will be wrong"));
+    }
+
+    reset();
+  }
+
+  bool RelayAutotuner::init() {
+    if (!BaseController::init()) {
+      LOG_ERROR(F("ERROR: RelayAutotuner::init() - Base initialization failed"));
+      return false;
+    }
+
+    if (relay_amplitude <= 0.0f) {
+      LOG_ERROR(F("ERROR: RelayAutotuner::init() - Relay amplitude must be positive"));
+      return false;
+    }
+
+    reset();
+
+    debugLog(F("RelayAutotuner initialized successfully"));
+    return true;
+  }
+
+  void RelayAutotuner::reset() {
+    state = State::RUNNING;
+    relay_high = true;
+    cycle_started = false;
+    start_us = 0;
+    timing = false;
+    cycle_time_s = 0.0f;
+    cycle_max = 0.0f;
+    cycle_min = 0.0f;
+    cycles_seen = 0;
+    average_start = settle_cycles;
+    sum_period = 0.0f;
+    sum_amplitude = 0.0f;
+    last_period = 0.0f;
+    ultimate_gain = 0.0f;
+    ultimate_period = 0.0f;
+    amplitude = 0.0f;
+    output = 0.0f;
+    resetTimestamp();
+
+    debugLog(F("RelayAutotuner reset - starting a new experiment"));
+  }
+
+  ControllerKind RelayAutotuner::getKind() const {
+    return ControllerKind::RELAY_AUTOTUNER;
+  }
+
+  void RelayAutotuner::loadState(const ControllerState &state) {
+    (void)state;
+    reset();
+  }
+
+  float RelayAutotuner::compute(float error) {
+    if (state != State::RUNNING) {
+      output = 0.0f;
+      return output;
+    }
+
+    // Timed against the caller's clock, which also runs in cycles without compute()
+    if (has_last_time && checkTimeout(last_time_us)) {
+      return output;
+    }
+    cycle_time_s += dt;
+
+    if (error > cycle_max) {
+      cycle_max = error;
+    }
+    if (error < cycle_min) {
+      cycle_min = error;
+    }
+
+    // Relay with hysteresis: only leaving the band switches the direction
+    if (!relay_high && error > hysteresis) {
+      relay_high = true;
+
+      // A rising switch closes one full cycle
+      if (cycle_started) {
+        finishCycle();
+      }
+      cycle_started = true;
+      cycle_time_s = 0.0f;
+      cycle_max = error;
+      cycle_min = error;
+    } else if (relay_high && error < -hysteresis) {
+      relay_high = false;
+    }
+
+    if (state != State::RUNNING) {
+      output = 0.0f;
+      return output;
+    }
+
+    output = applyLimits(relay_high ? relay_amplitude : -relay_amplitude, min_output, max_output);
+    return output;
+  }
+
+  void RelayAutotuner::finishCycle() {
+    cycles_seen++;
+    if (cycles_seen <= average_start) {
+      return;
+    }
+
+    float period = cycle_time_s;
+    float half_swing = 0.5f * (cycle_max - cycle_min);
+    last_period = period;
+    sum_period += period;
+    sum_amplitude += half_swing;
+
+    uint16_t averaged = cycles_seen - average_start;
+    if (averaged < measure_cycles) {
+      return;
+    }
+
+    float mean_period = sum_period / averaged;
+    float mean_amplitude = sum_amplitude / averaged;
+    float deviation = last_period - mean_period;
+    if (deviation < 0.0f) {
+      deviation = -deviation;
+    }
+
+    if (deviation > PERIOD_TOLERANCE * mean_period || mean_amplitude <= hysteresis) {
+      // Not settled yet: treat everything so far as transient and measure again
+      average_start = cycles_seen;
+      sum_period = 0.0f;
+      sum_amplitude = 0.0f;
+      debugLog(F("RelayAutotuner: oscillation not stable yet, restarting the average"));
+      return;
+    }
+
+    // Describing function of a relay with hysteresis
+    amplitude = mean_amplitude;
+    ultimate_period = mean_period;
+    ultimate_gain = 4.0f * relay_amplitude /
+                    (3.14159265f * sqrtf(mean_amplitude * mean_amplitude - hysteresis * hysteresis));
+    state = State::CONVERGED;
+
+    if (LOG_DEBUG_ENABLED && debug_enabled) {
+      Serial.print(F("RelayAutotuner: converged, Ku="));
+      Serial.print(ultimate_gain, 3);
+      Serial.print(F(", Pu="));
+      Serial.print(ultimate_period * 1000.0f, 1);
+      Serial.print(F("ms, a="));
+      Serial.println(amplitude, 3);
+    }
+  }
+
+  bool RelayAutotuner::checkTimeout(uint32_t now_us) {
+    if (state != State::RUNNING) {
+      return true;
+    }
+    if (!timing) {
+      start_us = now_us;
+      timing = true;
+    }
+
+    // Unsigned subtraction stays correct across the micros() rollover
+    if ((uint32_t)(now_us - start_us) > timeout_us) {
+      // Reported through getState(); the control loop must not print
+      state = State::FAILED;
+      output = 0.0f;
+      return true;
+    }
+    return false;
+  }
+
+  void RelayAutotuner::abort() {
+    if (state == State::RUNNING) {
+      state = State::ABORTED;
+    }
+    output = 0.0f;
+  }
+
+  void RelayAutotuner::setCycles(uint8_t settle_cycles, uint8_t measure_cycles) {
+    if (measure_cycles == 0) {
+      debugLog(F("WARNING: setCycles() - At least one cycle must be measured, using 1"));
+      measure_cycles = 1;
+    }
+    this->settle_cycles = settle_cycles;
+    this->measure_cycles = measure_cycles;
+  }
+
+  void RelayAutotuner::setTimeout(float timeout_s) {
+    if (timeout_s < 0.0f) {
+      timeout_s = 0.0f;
+    } else if (timeout_s > 4294.0f) {
+      timeout_s = 4294.0f; // uint32_t microseconds
+    }
+    timeout_us = (uint32_t)(timeout_s * 1.0e6f);
+  }
+
+  bool RelayAutotuner::computeGains(TuningRule rule, bool use_i, bool use_d, float &Kp, float &Ki, float &Kd) const {
+    if (state != State::CONVERGED) {
+      return false;
+    }
+
+    const float Ku = ultimate_gain;
+    const float Pu = ultimate_period;
+    float Ti = 0.0f;
+    float Td = 0.0f;
+
+    if (rule == TuningRule::ZIEGLER_NICHOLS) {
+      if (use_i && use_d) {
+        Kp = 0.6f * Ku;
+        Ti = Pu / 2.0f;
+        Td = Pu / 8.0f;
+      } else if (use_i) {
+        Kp = 0.45f * Ku;
+        Ti = Pu / 1.2f;
+      } else if (use_d) {
+        Kp = 0.8f * Ku;
+        Td = Pu / 8.0f;
+      } else {
+        Kp = 0.5f * Ku;
+      }
+    } else {
+      if (use_i) {
+        Kp = (use_d ? Ku / 2.2f : Ku / 3.2f);
+        Ti = 2.2f * Pu;
+      } else {
+        Kp = Ku / 2.2f;
+      }
+      if (use_d) {
+        Td = Pu / 6.3f;
+      }
+    }
+
+    Ki = use_i ? Kp / Ti : 0.0f;
+    Kd = use_d ? Kp * Td : 0.0f;
+    return true;
+  }
+
+  bool RelayAutotuner::applyTo(PIDController &pid, TuningRule rule) const {
+    float Kp, Ki, Kd;
+    if (!computeGains(rule, true, true, Kp, Ki, Kd)) {
+      return false;
+    }
+    pid.setGains(Kp, Ki, Kd);
+    return true;
+  }
+
+  bool RelayAutotuner::applyTo(PIController &pi, TuningRule rule) const {
+    float Kp, Ki, Kd;
+    if (!computeGains(rule, true, false, Kp, Ki, Kd)) {
+      return false;
+    }
+    pi.setGains(Kp, Ki);
+    return true;
+  }
+
+  bool RelayAutotuner::applyTo(PDController &pd, TuningRule rule) const {
+    float Kp, Ki, Kd;
+    if (!computeGains(rule, false, true, Kp, Ki, Kd)) {
+      return false;
+    }
+    pd.setGains(Kp, Kd);
+    return true;
+  }
+
+  RelayAutotuner::State RelayAutotuner::getState() const {
+    return state;
+  }
+
+  bool RelayAutotuner::isDone() const {
+    return state != State::RUNNING;
+  }
+
+  float RelayAutotuner::getUltimateGain() const {
+    return ultimate_gain;
+  }
+
+  float RelayAutotuner::getUltimatePeriod() const {
+    return ultimate_period;
+  }
+
+  float RelayAutotuner::getOscillationAmplitude() const {
+    return amplitude;
+  }
+
+  uint16_t RelayAutotuner::getCycleCount() const {
+    return cycles_seen;
+  }
+
+} // namespace controller
@@ -0,0 +1,239 @@
+#pragma once
+
+#include "BaseController.h"
+#include "PDController.h"
+#include "PIController.h"
+#include "PIDController.h"
+
+namespace controller {
+
+  /**
+   * @brief Relay-feedback (Åström–Hägglund) autotuner
+   *
+   * Closes the loop with a relay instead of a PID: the output is +d while
+   * the error is above +hysteresis and -d below -hysteresis. Most plants
+   * then settle into a limit cycle at their ultimate frequency, and the
+   * error amplitude a and period Pu give the ultimate gain
+   *
+   *   Ku = 4d / (π × sqrt(a² - ε²))      (ε = hysteresis)
+   *
+   * from which Ziegler–Nichols or Tyreus–Luyben rules derive the gains.
+   *
+   * The measurement is online and O(1) in memory: each relay switch to +d
+   * closes a cycle whose length and error extrema are accumulated into
+   * running sums. The first cycles are discarded as transient; the tuner
+   * converges once enough cycles were averaged and the last period agrees
+   * with the mean, and fails if no stable cycle appears before the timeout.
+   * The timeout runs on the caller's timestamps (compute(error, now_us),
+   * computeWithSetpoint(value, now_us) or checkTimeout()), so it keeps
+   * running in cycles where compute() is skipped.
+   *
+   * The autotuner is a BaseController, so it runs in the normal control
+   * loop in place of the line controller; once isDone() reports success,
+   * applyTo() writes the gains and the tuned controller can continue with
+   * takeOverFrom() without a jump. After convergence the relay output is 0.
+   * If the experiment cannot continue (e.g. the line was lost), abort() ends
+   * it and the caller hands control back to its normal recovery path.
+   *
+   * For line following robots:
+   * - Choose d as large as the robot tolerates on the track (e.g. 20-40%
+   *   of the steering range) so the oscillation dominates sensor noise
+   * - Use a hysteresis of a few times the position noise
+   * - Tyreus–Luyben gives less overshoot than Ziegler–Nichols, usually the
+   *   better starting point for a robot that must not leave the line
+   */
+  class RelayAutotuner : public BaseController {
+  public:
+    /**
+     * @brief Tuning rule applied to Ku and Pu
+     */
+    enum class TuningRule {
+      ZIEGLER_NICHOLS,
+      TYREUS_LUYBEN
+    };
+
+    /**
+     * @brief Progress of the experiment
+     */
+    enum class State {
+      RUNNING,   ///< Relay active, collecting cycles
+      CONVERGED, ///< Ku and Pu are available
+      FAILED,    ///< No stable oscillation before the timeout
+      ABORTED    ///< Stopped by abort(), e.g. the line was lost
+    };
+
+    /**
+     * @brief Construct a new relay autotuner
+     *
+     * @param relay_amplitude: Relay output d (> 0)
+     * @param hysteresis: Error band ε around zero that does not switch the relay
+     * @param dt_ms: Time step in milliseconds
+     * @param min_output: Minimum output value (default -1023 for 10-bit PWM)
+     * @param max_output: Maximum output value (default 1023 for 10-bit PWM)
+     * @param debug: Enable debug output (default false)
+     */
+    RelayAutotuner(float relay_amplitude, float hysteresis, uint32_t dt_ms = 1,
+                   float min_output = -1023.0f, float max_output = 1023.0f, bool debug = false);
+
+    /**
+     * @brief Initialize the autotuner and start a new experiment
+     *
+     * @return bool true on success, false if parameters are invalid
+     */
+    bool init() override;
+
+    /**
+     * @brief Discard all measurements and start a new experiment
+     */
+    void reset() override;
+
+    ControllerKind getKind() const override;
+
+    /**
+     * @brief Run the relay for one step and update the cycle measurement
+     *
+     * @param error: Current error (setpoint - measured_value)
+     * @return float Relay output (±relay_amplitude, 0 once finished)
+     */
+    float compute(float error) override;
+    using BaseController::compute;
+
+    /**
+     * @brief Fail the experiment once the timeout has passed
+     *
+     * The first timestamp after reset() starts the clock. Timestamped
+     * compute() calls check the timeout themselves; call this in cycles
+     * that skip compute().
+     *
+     * @param now_us: Current time in microseconds (e.g. micros())
+     * @return bool true if the experiment is over (for any reason)
+     */
+    bool checkTimeout(uint32_t now_us);
+
+    /**
+     * @brief End the experiment without a result
+     *
+     * The relay output drops to 0 and the state becomes ABORTED.
+     */
+    void abort();
+
+    /**
+     * @brief Set how many cycles are discarded and how many are averaged
+     *
+     * @param settle_cycles: Cycles ignored while the oscillation builds up
+     * @param measure_cycles: Cycles averaged for Ku and Pu (>= 1)
+     */
+    void setCycles(uint8_t settle_cycles, uint8_t measure_cycles);
+
+    /**
+     * @brief Set the longest an experiment may run
+     *
+     * @param timeout_s: Seconds before the tuner gives up (at most 4294 s)
+     */
+    void setTimeout(float timeout_s);
+
+    /**
+     * @brief Derive gains from the measured Ku and Pu
+     *
+     * | Rule            | Type | Kp       | Ti       | Td      |
+     * |-----------------|------|----------|----------|---------|
+     * | Ziegler–Nichols | PI   | 0.45 Ku  | Pu / 1.2 | -       |
+     * | Ziegler–Nichols | PD   | 0.8 Ku   | -        | Pu / 8  |
+     * | Ziegler–Nichols | PID  | 0.6 Ku   | Pu / 2   | Pu / 8  |
+     * | Tyreus–Luyben   | PI   | Ku / 3.2 | 2.2 Pu   | -       |
+     * | Tyreus–Luyben   | PD   | Ku / 2.2 | -        | Pu / 6.3|
+     * | Tyreus–Luyben   | PID  | Ku / 2.2 | 2.2 Pu   | Pu / 6.3|
+     *
+     * with Ki = Kp / Ti and Kd = Kp × Td. The PD rows are the PID rules
+     * without the integral (Ziegler–Nichols uses the usual 0.8 Ku).
+     *
+     * @param rule: Tuning rule
+     * @param use_i: Include an integral term
+     * @param use_d: Include a derivative term
+     * @param Kp: Receives the proportional gain
+     * @param Ki: Receives the integral gain (0 without I)
+     * @param Kd: Receives the derivative gain (0 without D)
+     * @return bool true if the experiment converged
+     */
+    bool computeGains(TuningRule rule, bool use_i, bool use_d, float &Kp, float &Ki, float &Kd) const;
+
+    /**
+     * @brief Write tuned gains into a controller (bumpless)
+     *
+     * @param pid: Controller to retune
+     * @param rule: Tuning rule
+     * @return bool true if the experiment converged and the gains were applied
+     */
+    bool applyTo(PIDController &pid, TuningRule rule) const;
+    bool applyTo(PIController &pi, TuningRule rule) const;
+    bool applyTo(PDController &pd, TuningRule rule) const;
+
+    State getState() const;
+    bool isDone() const;
+    float getUltimateGain() const;
+    float getUltimatePeriod() const;
+    float getOscillationAmplitude() const;
+    uint16_t getCycleCount() const;
+
+  protected:
+    /**
+     * @brief An interrupted experiment cannot be continued: restoring a
+     * snapshot starts a new one
+     */
+    void loadState(const ControllerState &state) override;
+
+  private:
+    /**
+     * @brief Close the cycle that ended at the current relay switch
+     */
+    void finishCycle();
+
+    /**
+     * @brief Relay configuration and running measurement
+     *
+     * @var relay_amplitude: Relay output d
+     * @var hysteresis: Switching band ε
+     * @var settle_cycles, measure_cycles: Cycles discarded / averaged
+     * @var timeout_us: Experiment time limit
+     * @var state: Progress of the experiment
+     * @var relay_high: Current relay direction
+     * @var cycle_started: A rising switch has been seen (a cycle is open)
+     * @var start_us: Timestamp of the first timestamped call of the experiment
+     * @var timing: Whether start_us is set
+     * @var cycle_time_s: Time since the last rising switch
+     * @var cycle_max, cycle_min: Error extrema of the open cycle
+     * @var cycles_seen: Completed cycles including discarded ones
+     * @var average_start: Cycles discarded before the current average
+     * @var sum_period, sum_amplitude: Running sums over averaged cycles
+     * @var last_period: Period of the last completed cycle
+     * @var ultimate_gain, ultimate_period, amplitude: Results
+     */
+    float relay_amplitude;
+    float hysteresis;
+    uint8_t settle_cycles;
+    uint8_t measure_cycles;
+    uint32_t timeout_us;
+    State state;
+    bool relay_high;
+    bool cycle_started;
+    uint32_t start_us;
+    bool timing;
+    float cycle_time_s;
+    float cycle_max;
+    float cycle_min;
+    uint16_t cycles_seen;
+    uint16_t average_start;
+    float sum_period;
+    float sum_amplitude;
+    float last_period;
+    float ultimate_gain;
+    float ultimate_period;
+    float amplitude;
+
+    /**
+     * @brief Relative tolerance between the last period and the mean
+     */
+    static constexpr float PERIOD_TOLERANCE = 0.1f;
+  };
+
+} // namespace controller
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <new>
+#include <stdint.h>
+
+namespace sensing {
+
+  /**
+   * @brief Precomputed per-sensor calibration: raw ADC reading -> 0..1000
+   *
+   * QTRSensors::readCalibrated() computes (raw - min) * 1000 / (max - min)
+   * for every sensor on every sample, i.e. a divide in the hottest loop.
+   * This class moves the divide to calibration time:
+   *
+   * - Scale mode (always available): a Q16 reciprocal scale per sensor, so
+   *   normalization is a subtract, a multiply and a shift. Results match
+   *   the QTR integer arithmetic to within 1 count of 1000.
+   * - Table mode (optional, 4096 x SENSOR_COUNT x 2 bytes = 64 KB for
+   *   8 sensors): the exact QTR result for every 12-bit raw value, so
+   *   normalization is a single load per sensor.
+   *
+   * Call rebuild() whenever the calibration changes (after loading it from
+   * EEPROM and after a fresh calibration). rebuild() is not synchronized
+   * with normalize(): only call it while the control loop is stopped.
+   *
+   * @tparam SENSOR_COUNT: Number of sensors in the array
+   */
+  template <uint8_t SENSOR_COUNT>
+  class SensorNormalizer {
+  public:
+    /**
+     * @brief Normalization constants
+     *
+     * @var OUTPUT_MAX: Normalized value of a fully dark reading (QTR convention)
+     * @var RAW_LEVELS: Number of distinct raw readings (12-bit ADC)
+     * @var SCALE_BITS: Fractional bits of the per-sensor scale
+     */
+    static const uint16_t OUTPUT_MAX = 1000;
+    static const uint16_t RAW_LEVELS = 4096;
+    static const uint8_t SCALE_BITS = 16;
+
+    SensorNormalizer() : table(nullptr) {
+      for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        offset[i] = 0;
+        range[i] = 0;
+        scale[i] = 0;
+      }
+    }
+
+    ~SensorNormalizer() {
+      delete[] table;
+    }
+
+    /**
+     * @brief Allocate the lookup tables
+     *
+     * Takes effect at the next rebuild(). If the allocation fails the
+     * normalizer keeps working in scale mode.
+     *
+     * @return bool true if the tables are available
+     */
+    bool enableTable() {
+      if (table == nullptr) {
+        table = new (std::nothrow) uint16_t[(uint32_t)RAW_LEVELS * SENSOR_COUNT];
+      }
+      return table != nullptr;
+    }
+
+    /**
+     * @brief Recompute the scales (and tables) from calibration limits
+     *
+     * A sensor whose maximum equals its minimum always reads 0, as it does
+     * in QTRSensors. A maximum below the minimum keeps QTR's 16-bit
+     * (max - min), which wraps to a large range: such a sensor reads a few
+     * dozen counts at most, the same values readCalibrated() returns.
+     *
+     * @param minimum: Per-sensor minimum raw reading
+     * @param maximum: Per-sensor maximum raw reading
+     */
+    void rebuild(const uint16_t *minimum, const uint16_t *maximum) {
+      for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        offset[i] = minimum[i];
+        range[i] = (uint16_t)(maximum[i] - minimum[i]);
+
+        // Round the reciprocal up so exact multiples of the range reach
+        // OUTPUT_MAX; the result is never more than 1 count above QTR's
+        scale[i] = (range[i] == 0)
+                       ? 0
+                       : (((uint32_t)OUTPUT_MAX << SCALE_BITS) + range[i] - 1) / range[i];
+
+        if (table != nullptr) {
+          uint16_t *entries = table + (uint32_t)i * RAW_LEVELS;
+          for (uint32_t raw = 0; raw < RAW_LEVELS; raw++) {
+            entries[raw] = exact(i, (uint16_t)raw);
+          }
+        }
+      }
+    }
+
+    /**
+     * @brief Normalize one frame of raw readings
+     *
+     * @param raw: SENSOR_COUNT raw 12-bit readings
+     * @param normalized: Receives SENSOR_COUNT values in 0..OUTPUT_MAX
+     */
+    inline void normalize(const uint16_t *raw, uint16_t *normalized) const {
+      if (table != nullptr) {
+        for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+          uint16_t index = (raw[i] < RAW_LEVELS) ? raw[i] : (uint16_t)(RAW_LEVELS - 1);
+          normalized[i] = table[(uint32_t)i * RAW_LEVELS + index];
+        }
+        return;
+      }
+
+      for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        uint32_t delta = (raw[i] > offset[i]) ? (uint32_t)(raw[i] - offset[i]) : 0;
+        if (delta >= range[i]) {
+          // Also covers range == 0, where the QTR arithmetic yields 0
+          normalized[i] = (range[i] == 0) ? 0 : OUTPUT_MAX;
+        } else {
+          // delta < range, so delta * scale < OUTPUT_MAX << SCALE_BITS + range: no overflow
+          normalized[i] = (uint16_t)((delta * scale[i]) >> SCALE_BITS);
+        }
+      }
+    }
+
+    /**
+     * @brief Check whether normalization uses the lookup tables
+     *
+     * @return bool true in table mode, false in scale mode
+     */
+    inline bool usesTable() const {
+      return table != nullptr;
+    }
+
+  private:
+    /**
+     * @brief Reference QTR arithmetic, used to fill the tables
+     */
+    uint16_t exact(uint8_t i, uint16_t raw) const {
+      if (range[i] == 0) {
+        return 0;
+      }
+      int32_t value = ((int32_t)raw - offset[i]) * OUTPUT_MAX / range[i];
+      return (value < 0) ? 0 : (value > OUTPUT_MAX) ? OUTPUT_MAX : (uint16_t)value;
+    }
+
+    /**
+     * @brief Per-sensor calibration
+     *
+     * @var offset: Calibrated minimum, subtracted from every reading
+     * @var range: Calibrated maximum - minimum, modulo 2^16 as in QTR
+     * @var scale: OUTPUT_MAX / range in Q16, rounded up
+     * @var table: SENSOR_COUNT consecutive RAW_LEVELS-entry tables, or nullptr
+     */
+    uint16_t offset[SENSOR_COUNT];
+    uint16_t range[SENSOR_COUNT];
+    uint32_t scale[SENSOR_COUNT];
+    uint16_t *table;
+  };
+
+} // namespace sensing
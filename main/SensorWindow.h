@@ -0,0 +1,216 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace sensing {
+
+  /**
+   * @brief Adaptive acquisition window: convert only the sensors near the line
+   *
+   * Away from the line the sensors read white floor, and the centroid
+   * ignores them anyway (they fall below the estimator's noise floor). When
+   * each reading costs a conversion on the control task, reading only the
+   * `size` sensors centred on the last position cuts the acquisition time
+   * to roughly size / SENSOR_COUNT.
+   *
+   * A full sweep of the array is still taken
+   * - every full_sweep_period cycles, to notice a second line or a
+   *   crossing the window cannot see
+   * - whenever there is no valid last position (start, line lost)
+   * - on the cycle after the line reached an inner edge of the window,
+   *   where it may continue outside
+   *
+   * Usage per control cycle:
+   *
+   *   Window w = window.plan(last_position);      // which sensors to read
+   *   ... read raw[w.first .. w.first + w.count - 1], normalize ...
+   *   window.complete(values, noise_floor);        // mask the rest, check edges
+   *
+   * complete() zeroes the sensors outside the window, so the readings of
+   * a previous cycle cannot leak into the estimate. The class has no
+   * hardware dependency and can be replayed against recorded frames on a
+   * host.
+   *
+   * @tparam SENSOR_COUNT: Number of sensors in the array (2-32)
+   */
+  template <uint8_t SENSOR_COUNT>
+  class SensorWindow {
+    static_assert(SENSOR_COUNT >= 2 && SENSOR_COUNT <= 32, "SensorWindow supports 2-32 sensors");
+
+  public:
+    /**
+     * @brief Sensors to convert in one cycle
+     *
+     * @var first: Index of the first sensor
+     * @var count: Number of consecutive sensors
+     * @var full: true if this is a full sweep
+     */
+    struct Window {
+      uint8_t first;
+      uint8_t count;
+      bool full;
+    };
+
+    /**
+     * @brief Construct a window
+     *
+     * @param size: Sensors per windowed cycle (clamped to 2 - SENSOR_COUNT)
+     * @param full_sweep_period: Cycles between forced full sweeps (0 = only when needed)
+     * @param weight_step: Position units per sensor (LineEstimator::WEIGHT_STEP)
+     */
+    explicit SensorWindow(uint8_t size = 4, uint16_t full_sweep_period = 8, int32_t weight_step = 1000)
+        : size(SENSOR_COUNT), full_sweep_period(full_sweep_period), weight_step(weight_step > 0 ? weight_step : 1000),
+          current({0, SENSOR_COUNT, true}), since_full(0), edge_hit(true), cycles(0), conversions(0) {
+      setSize(size);
+    }
+
+    /**
+     * @brief Set the number of sensors per windowed cycle
+     *
+     * @param size: Sensors to convert (clamped to 2 - SENSOR_COUNT)
+     */
+    inline void setSize(uint8_t size) {
+      if (size < 2) {
+        size = 2;
+      }
+      if (size > SENSOR_COUNT) {
+        size = SENSOR_COUNT;
+      }
+      this->size = size;
+    }
+
+    /**
+     * @brief Set how often a full sweep is forced
+     *
+     * @param period: Cycles between full sweeps (0 = only on line loss or an edge hit)
+     */
+    inline void setFullSweepPeriod(uint16_t period) {
+      full_sweep_period = period;
+    }
+
+    /**
+     * @brief Force a full sweep on the next cycle and clear the statistics
+     */
+    inline void reset() {
+      since_full = 0;
+      edge_hit = true;
+      cycles = 0;
+      conversions = 0;
+    }
+
+    /**
+     * @brief Choose the sensors to convert this cycle
+     *
+     * @param last_position: Last estimated position in weight units
+     *                       (0 = centre), or any value outside the array
+     *                       (e.g. LineEstimator::NO_LINE) when unknown
+     * @return Window Sensors to read
+     */
+    inline Window plan(int32_t last_position) {
+      // Position -> nearest sensor; weights are centred on zero
+      const int32_t half_span = (weight_step / 2) * (SENSOR_COUNT - 1);
+      bool known = last_position >= -half_span - weight_step / 2 && last_position <= half_span + weight_step / 2;
+
+      bool full = !known || edge_hit || size >= SENSOR_COUNT ||
+                  (full_sweep_period > 0 && since_full + 1 >= full_sweep_period);
+
+      if (full) {
+        current.first = 0;
+        current.count = SENSOR_COUNT;
+        since_full = 0;
+      } else {
+        int32_t centre = (last_position + half_span + weight_step / 2) / weight_step;
+        int32_t first = centre - (size - 1) / 2;
+        if (first < 0) {
+          first = 0;
+        }
+        if (first > SENSOR_COUNT - size) {
+          first = SENSOR_COUNT - size;
+        }
+        current.first = (uint8_t)first;
+        current.count = size;
+        since_full++;
+      }
+      current.full = full;
+      edge_hit = false;
+
+      cycles++;
+      conversions += current.count;
+      return current;
+    }
+
+    /**
+     * @brief Mask the unread sensors and check whether the line left the window
+     *
+     * @param values: SENSOR_COUNT readings, valid inside the planned window
+     * @param threshold: Reading above which a sensor counts as on the line
+     */
+    inline void complete(uint16_t *values, uint16_t threshold) {
+      if (current.full) {
+        return;
+      }
+
+      const uint8_t last = current.first + current.count - 1;
+      for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        if (i < current.first || i > last) {
+          values[i] = 0;
+        }
+      }
+
+      // An inner edge on the line means the line may extend past the window
+      if ((current.first > 0 && values[current.first] > threshold) ||
+          (last < SENSOR_COUNT - 1 && values[last] > threshold)) {
+        edge_hit = true;
+      }
+    }
+
+    /**
+     * @brief Get the window of the current cycle
+     *
+     * @return const Window& Last planned window
+     */
+    inline const Window &getWindow() const { return current; }
+
+    /**
+     * @brief Conversions skipped in the current cycle
+     *
+     * @return uint8_t SENSOR_COUNT - window size
+     */
+    inline uint8_t getSavedConversions() const { return SENSOR_COUNT - current.count; }
+
+    /**
+     * @brief Average conversions per cycle since reset()
+     *
+     * @return float Conversions per cycle (SENSOR_COUNT without windowing)
+     */
+    inline float getMeanConversions() const {
+      return cycles > 0 ? (float)conversions / (float)cycles : (float)SENSOR_COUNT;
+    }
+
+    inline uint32_t getCycleCount() const { return cycles; }
+    inline uint8_t getSize() const { return size; }
+    inline uint16_t getFullSweepPeriod() const { return full_sweep_period; }
+
+  private:
+    /**
+     * @brief Window configuration and state
+     *
+     * @var size: Sensors per windowed cycle
+     * @var full_sweep_period: Cycles between forced full sweeps (0 = never forced)
+     * @var weight_step: Position units per sensor
+     * @var current: Window of the current cycle
+     * @var since_full: Cycles since the last full sweep
+     * @var edge_hit: The line touched an inner window edge last cycle
+     * @var cycles, conversions: Statistics since reset()
+     */
+    uint8_t size;
+    uint16_t full_sweep_period;
+    int32_t weight_step;
+    Window current;
+    uint16_t since_full;
+    bool edge_hit;
+    uint32_t cycles;
+    uint32_t conversions;
+  };
+
+} // namespace sensing
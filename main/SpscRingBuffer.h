@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rt {
+
+  /**
+   * @brief Lock-free single-producer / single-consumer ring buffer
+   *
+   * Fixed-capacity FIFO for handing samples from one thread to exactly one
+   * other thread without locks, allocation or blocking. On the robot the
+   * control task (core 1) is the producer and the telemetry task (core 0) is
+   * the consumer; on a host the same template works with std::thread.
+   *
+   * Implementation notes:
+   * - head and tail are free-running 32-bit counters; the slot index is the
+   *   counter masked by CAPACITY - 1, so CAPACITY must be a power of two.
+   * - The producer publishes a slot with a release store of head, and the
+   *   consumer acquires it before reading the slot (and vice versa for tail).
+   * - When the buffer is full push() fails and the sample is counted as
+   *   dropped; the producer never waits for the consumer.
+   *
+   * @tparam T: Trivially copyable sample type
+   * @tparam CAPACITY: Number of slots (power of two, >= 2)
+   */
+  template <typename T, size_t CAPACITY>
+  class SpscRingBuffer {
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0,
+                  "SpscRingBuffer capacity must be a power of two");
+
+  public:
+    SpscRingBuffer() : head(0), tail(0), dropped(0) {}
+
+    /**
+     * @brief Append a sample (producer side only)
+     *
+     * @param item: Sample to copy into the buffer
+     * @return bool true if stored, false if the buffer was full and the sample was dropped
+     */
+    bool push(const T &item) {
+      uint32_t h = head.load(std::memory_order_relaxed);
+      uint32_t t = tail.load(std::memory_order_acquire);
+
+      if (h - t >= CAPACITY) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+
+      slots[h & MASK] = item;
+      head.store(h + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * @brief Remove the oldest sample (consumer side only)
+     *
+     * @param item: Receives the sample
+     * @return bool true if a sample was returned, false if the buffer was empty
+     */
+    bool pop(T &item) {
+      uint32_t t = tail.load(std::memory_order_relaxed);
+      uint32_t h = head.load(std::memory_order_acquire);
+
+      if (h == t) {
+        return false;
+      }
+
+      item = slots[t & MASK];
+      tail.store(t + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * @brief Get the number of queued samples
+     *
+     * Exact when called from either endpoint, approximate from a third thread.
+     *
+     * @return size_t Samples waiting to be popped
+     */
+    size_t size() const {
+      return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Check whether the buffer is empty
+     *
+     * @return bool true if no samples are queued
+     */
+    bool empty() const {
+      return size() == 0;
+    }
+
+    /**
+     * @brief Get the number of samples rejected because the buffer was full
+     *
+     * @return uint32_t Dropped sample count since construction
+     */
+    uint32_t getDropped() const {
+      return dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the buffer capacity
+     *
+     * @return size_t Number of slots
+     */
+    static size_t capacity() {
+      return CAPACITY;
+    }
+
+  private:
+    static const uint32_t MASK = CAPACITY - 1;
+
+    /**
+     * @brief Buffer storage and indices
+     *
+     * head and tail sit on separate cache lines so producer and consumer do
+     * not invalidate each other's line on every update (matters on hosts;
+     * harmless on the ESP32).
+     *
+     * @var slots: Sample storage
+     * @var head: Next slot to write, owned by the producer
+     * @var tail: Next slot to read, owned by the consumer
+     * @var dropped: Samples rejected while full, written by the producer
+     */
+    T slots[CAPACITY];
+    alignas(64) std::atomic<uint32_t> head;
+    alignas(64) std::atomic<uint32_t> tail;
+    std::atomic<uint32_t> dropped;
+  };
+
+} // namespace rt
@@ -0,0 +1,74 @@
+#include "StateSpaceController.h"
+
+namespace controller {
+
+  StateSpaceController::StateSpaceController(uint32_t dt_ms, float min_output, float max_output, bool debug)
+      : BaseController(dt_ms, min_output, max_output, debug), applied_input(0.0f),
+        has_estimate(false) {
+    x_hat[0] = 0.0f;
+    x_hat[1] = 0.0f;
+  }
+
+  bool StateSpaceController::init() {
+    if (!BaseController::init()) {
+      LOG_ERROR(F("ERROR: StateSpaceController::init() - Base initialization failed"));
+      return false;
+    }
+
+    // The model, observer and gains are only valid at the period they were generated for
+    float mismatch = nominal_dt - control_tables::DT;
+    if (mismatch < 0.0f) {
+      mismatch = -mismatch;
+    }
+    if (mismatch > 0.01f * control_tables::DT) {
+      LOG_ERROR(F("ERROR: StateSpaceController::init() - Sample time does not match ControlTables.h, regenerate the tables"));
+      return false;
+    }
+
+    reset();
+    return true;
+  }
+
+  void StateSpaceController::reset() {
+    x_hat[0] = 0.0f;
+    x_hat[1] = 0.0f;
+    applied_input = 0.0f;
+    has_estimate = false;
+    output = 0.0f;
+    resetTimestamp();
+
+    debugLog(F("StateSpaceController state reset - observer cleared"));
+  }
+
+  void StateSpaceController::bumplessTransfer(float output, float error) {
+    BaseController::bumplessTransfer(output, error);
+
+    x_hat[0] = error;
+    x_hat[1] = 0.0f;
+    applied_input = this->output;
+    has_estimate = true;
+  }
+
+  void StateSpaceController::saveState(ControllerState &state) const {
+    state.internal[0] = x_hat[0];
+    state.internal[1] = x_hat[1];
+    state.internal[2] = applied_input;
+    state.internal[3] = has_estimate ? 1.0f : 0.0f;
+  }
+
+  void StateSpaceController::loadState(const ControllerState &state) {
+    x_hat[0] = state.internal[0];
+    x_hat[1] = state.internal[1];
+    applied_input = state.internal[2];
+    has_estimate = state.internal[3] != 0.0f;
+  }
+
+  float StateSpaceController::getErrorEstimate() const {
+    return x_hat[0];
+  }
+
+  float StateSpaceController::getErrorRateEstimate() const {
+    return x_hat[1];
+  }
+
+} // namespace controller
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "BaseController.h"
+#include "ControlTables.h"
+
+namespace controller {
+
+  /**
+   * @brief Common base of the model-based line controllers (LQR, MPC)
+   *
+   * Model-based controllers need the full state x = [e, e'] of the lateral
+   * model in ControlTables.h, but the sensors only measure the error e. The
+   * base class estimates the error rate with a steady-state observer:
+   *
+   *   predict:  x⁻ = A x̂ + B u          (u = output applied last step)
+   *   correct:  x̂ = x⁻ + L (e - x⁻[0])
+   *
+   * A = [[1, DT], [0, 1]], B and L come from tools/gen_control_tables.py.
+   * Because the prediction includes the steering command, the rate
+   * estimate does not lag like a filtered difference of the error.
+   *
+   * The tables are computed for one control period. init() rejects a
+   * sample time that does not match it, and the timestamped compute()
+   * overload still runs the fixed-period model: the measured dt only
+   * matters for controllers whose gains scale with it.
+   *
+   * Derived classes implement the control law on the estimate in compute().
+   */
+  class StateSpaceController : public BaseController {
+  protected:
+    /**
+     * @brief Observer state
+     *
+     * @var x_hat: Estimated [error, error rate] (error units, error units/s)
+     * @var applied_input: Output of the previous step, the model input
+     * @var has_estimate: x_hat has been started from a measurement
+     */
+    float x_hat[2];
+    float applied_input;
+    bool has_estimate;
+
+    /**
+     * @brief Advance the observer with a new error measurement
+     *
+     * The first measurement after reset() starts the estimate at the error
+     * with zero rate, so the initial residual does not kick the rate
+     * estimate (the observer equivalent of a derivative kick).
+     *
+     * @param error: Current error (setpoint - measured_value)
+     */
+    inline void estimate(float error) {
+      using namespace control_tables;
+      if (!has_estimate) {
+        x_hat[0] = error;
+        x_hat[1] = 0.0f;
+        has_estimate = true;
+        return;
+      }
+      float predicted_error = x_hat[0] + DT * x_hat[1] + MODEL_B[0] * applied_input;
+      float predicted_rate = x_hat[1] + MODEL_B[1] * applied_input;
+      float residual = error - predicted_error;
+      x_hat[0] = predicted_error + OBSERVER_L[0] * residual;
+      x_hat[1] = predicted_rate + OBSERVER_L[1] * residual;
+    }
+
+    /**
+     * @brief Construct the observer part
+     *
+     * @param dt_ms: Time step in milliseconds (must match control_tables::DT)
+     * @param min_output: Minimum output value
+     * @param max_output: Maximum output value
+     * @param debug: Enable debug output
+     */
+    StateSpaceController(uint32_t dt_ms, float min_output, float max_output, bool debug);
+
+    /**
+     * @brief Snapshot layout: internal[0..1] = x_hat, internal[2] = model
+     * input, internal[3] = 1 once the estimate was started
+     */
+    void saveState(ControllerState &state) const override;
+    void loadState(const ControllerState &state) override;
+
+  public:
+    /**
+     * @brief Initialize the controller and check the tables match the sample time
+     *
+     * @return bool true on success, false if the sample time differs from the tables
+     */
+    bool init() override;
+
+    /**
+     * @brief Clear the state estimate and the model input
+     */
+    void reset() override;
+
+    /**
+     * @brief Continue from another controller's output without a jump
+     *
+     * Starts the estimate at the current error with zero rate and records
+     * the adopted output as the last model input.
+     *
+     * @param output: Last output of the controller being replaced
+     * @param error: Current error (setpoint - measured_value)
+     */
+    void bumplessTransfer(float output, float error) override;
+
+    /**
+     * @brief Get the estimated error
+     *
+     * @return float Observer estimate of the error
+     */
+    float getErrorEstimate() const;
+
+    /**
+     * @brief Get the estimated error rate
+     *
+     * @return float Observer estimate of d(error)/dt in error units per second
+     */
+    float getErrorRateEstimate() const;
+  };
+
+} // namespace controller
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+namespace rt {
+
+  /**
+   * @brief Lock-free latest-value handoff between one writer and one reader
+   *
+   * Unlike SpscRingBuffer, which queues every sample, a TripleBuffer only
+   * ever hands over the most recent complete value: the reader never sees a
+   * half-written value and never waits, and the writer never blocks or drops
+   * anything it would need later. This is the right shape for sensor frames,
+   * where the control loop only cares about the freshest one.
+   *
+   * Three slots rotate between the roles back (being written), middle (last
+   * published) and front (being read). Publishing and fetching are each a
+   * single atomic exchange of the middle index, i.e. a pointer swap; the
+   * payload itself is never copied.
+   *
+   * Usage:
+   *   writer: T &slot = buffer.writeSlot(); fill(slot); buffer.publish();
+   *   reader: if (buffer.fetch()) use(buffer.front());
+   *
+   * @tparam T: Value type (copied only by the caller, never by the buffer)
+   */
+  template <typename T>
+  class TripleBuffer {
+  public:
+    TripleBuffer() : middle(1), back(0), front_index(2), has_value(false) {}
+
+    /**
+     * @brief Slot the writer may fill (writer side only)
+     *
+     * @return T& Slot that is invisible to the reader until publish()
+     */
+    inline T &writeSlot() {
+      return slots[back];
+    }
+
+    /**
+     * @brief Publish the write slot as the latest value (writer side only)
+     *
+     * A previously published value the reader has not fetched yet is
+     * recycled as the next write slot.
+     */
+    inline void publish() {
+      back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /**
+     * @brief Take the latest published value if there is a new one (reader side only)
+     *
+     * @return bool true if front() now refers to a value not seen before
+     */
+    inline bool fetch() {
+      if ((middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+        return false;
+      }
+      front_index = middle.exchange(front_index, std::memory_order_acq_rel) & INDEX_MASK;
+      has_value = true;
+      return true;
+    }
+
+    /**
+     * @brief Value obtained by the last successful fetch() (reader side only)
+     *
+     * Stays valid and unchanged until the next fetch().
+     *
+     * @return const T& Latest fetched value (default-constructed before the first)
+     */
+    inline const T &front() const {
+      return slots[front_index];
+    }
+
+    /**
+     * @brief Check whether the reader has fetched at least one value
+     *
+     * @return bool true once front() holds published data
+     */
+    inline bool hasValue() const {
+      return has_value;
+    }
+
+  private:
+    static const uint8_t INDEX_MASK = 0x03;
+    static const uint8_t FRESH = 0x04;
+
+    /**
+     * @brief Slots and role indices
+     *
+     * @var slots: The three value slots
+     * @var middle: Index of the last published slot, plus FRESH until the reader takes it
+     * @var back: Writer-owned slot index
+     * @var front_index: Reader-owned slot index
+     * @var has_value: Whether the reader has fetched anything yet
+     */
+    T slots[3];
+    alignas(64) std::atomic<uint8_t> middle;
+    uint8_t back;
+    alignas(64) uint8_t front_index;
+    bool has_value;
+  };
+
+} // namespace rt
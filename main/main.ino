@@ -1,34 +1,164 @@
+#include "ContinuousAdcSource.h"
+#include "ControlScheduler.h"
+#include "CurvatureEstimator.h"
 #include "EEPROMCalibrationManager.h"
+#include "FlightRecorder.h"
+#include "GainSchedule.h"
+#include "LineEstimator.h"
+#include "LineKalmanFilter.h"
+#include "LineRecovery.h"
+#include "LoopProfiler.h"
+#include "MuxScanner.h"
+#include "PDController.h"
+#include "PeakEstimator.h"
+#include "RelayAutotuner.h"
+#include "SensorNormalizer.h"
+#include "SensorWindow.h"
+#include "SpscRingBuffer.h"
 #include <Arduino.h>
 #include <EEPROM.h>
 #include <QTRSensors.h>
 
 // Hardware configuration
+#define USE_MUX 0            // 1: array behind two CD74HC4067 multiplexers, scanned by sensing::MuxScanner
+#define REMAP_ADC2_SENSORS 0 // 1: sensors 7/8 wired to GPIO 37/38 so all eight are scanned by DMA
 #define D1 36
 #define D2 39
 #define D3 34
 #define D4 35
 #define D5 32
 #define D6 33
-#define D7 25
-#define D8 26
+#if REMAP_ADC2_SENSORS
+#define D7 37 // ADC1_CH1 - only broken out on some modules
+#define D8 38 // ADC1_CH2
+#else
+#define D7 25 // ADC2 - read by the acquisition task with analogRead()
+#define D8 26 // ADC2
+#endif
 #define CALIB_BUTTON_PIN 16
 #define START_BUTTON_PIN 17
 #define LED_PIN 2
+#if USE_MUX
+#define SENSOR_COUNT 16  // Up to 32 on two muxes; the QTR calibration arrays hold at most 31
+#define MUX0_SIGNAL 36   // ADC1, even sensors
+#define MUX1_SIGNAL 39   // ADC1, odd sensors
+#define MUX_SETTLE_US 5  // Channel settling time, hidden behind the other mux's conversion
+#else
 #define SENSOR_COUNT 8
+#endif
+
+// Control loop configuration
+#define CONTROL_RATE_HZ 1000
+#define CONTROL_TASK_CORE 1
+#define TELEMETRY_TASK_CORE 0
+#define TELEMETRY_TASK_PRIORITY 1
+#define USE_CONTINUOUS_ADC (!USE_MUX) // The DMA scan cannot step a multiplexer
+#define ADC_FRAME_RATE_HZ 2000 // Faster than the control loop so every cycle sees a fresh frame
+#define ACQUISITION_TASK_CORE 0
+#define USE_NORMALIZATION_TABLE 1 // 64 KB of lookup tables instead of a multiply-shift per sensor
+#define USE_SENSOR_WINDOW 1        // Synchronous path: convert only the sensors around the line
+#define SENSOR_WINDOW_SIZE 4       // Sensors converted per windowed cycle
+#define SENSOR_FULL_SWEEP_PERIOD 8 // Cycles between forced full sweeps
+#define SENSOR_SAMPLES 4           // analogRead() conversions averaged per sensor, as qtr.read() does
+#define USE_PEAK_ESTIMATOR 0       // 1: parabolic peak fit instead of the centroid, for lines seen by ~3 sensors
+#define PROFILE_SHADOW_ESTIMATOR 0 // 1: also time the other estimator on every frame ("estimate (shadow)" in PROFILE)
+#define USE_LINE_KALMAN 1          // Kalman-filtered position and velocity for the PD; coasts over short gaps
+#define KALMAN_ACCEL_NOISE 500.0f  // RMS line acceleration under the array, sensor pitches/s²
+#define KALMAN_POSITION_NOISE 0.02f // RMS estimator noise, sensor pitches
+#define KALMAN_MAX_GAP_MS 30       // NO_LINE time bridged by prediction before holding the last command
+#define RECOVERY_SEARCH_STEERING 400.0f // Turn towards the side the line was lost on, steering units
+#define RECOVERY_TIMEOUT_MS 500          // Search time before the run is stopped
+#define LINE_KP 250.0f
+#define LINE_KD 2.0f
+#define AUTOTUNE_RELAY_AMPLITUDE 300.0f // Relay steering command during autotune
+#define AUTOTUNE_HYSTERESIS 0.05f      // Sensor pitches, a few times the position noise
+#define BASE_SPEED 600.0f // Base motor command, the speed axis of the gain schedule
+#define CURVATURE_WINDOW 9      // Ring samples in the curvature fit (odd)
+#define CURVATURE_DECIMATION 10 // Control cycles averaged per ring sample (90 ms window)
+#define CURVATURE_FF_GAIN 0.0f  // Steering per unit of curvature x speed; 0 disables, tune on the track
+#define TELEMETRY_INTERVAL_MS 100
+#define FLIGHT_RECORD_DECIMATION 20   // Control cycles per flight recorder entry (50 Hz)
+#define FLIGHT_RECORDER_CAPACITY 512  // Entries kept, about 10 s before the stop
+#define OVERRUN_REPORT_INTERVAL_MS 1000
 
 // EEPROM Configuration
-#define EEPROM_SIZE 64
+#define EEPROM_SIZE 512 // Calibration data followed by the gain schedule block
 #define CALIB_START_ADDRESS 0
 
 // Hardware arrays
+#if USE_MUX
+// Each sensor as seen by the QTR library and the pin report: its mux's signal pin
+const uint8_t sensorPins[SENSOR_COUNT] = {MUX0_SIGNAL, MUX1_SIGNAL, MUX0_SIGNAL, MUX1_SIGNAL,
+                                          MUX0_SIGNAL, MUX1_SIGNAL, MUX0_SIGNAL, MUX1_SIGNAL,
+                                          MUX0_SIGNAL, MUX1_SIGNAL, MUX0_SIGNAL, MUX1_SIGNAL,
+                                          MUX0_SIGNAL, MUX1_SIGNAL, MUX0_SIGNAL, MUX1_SIGNAL};
+const sensing::MuxScanner::MuxPins muxPins[2] = {
+    {MUX0_SIGNAL, {18, 19, 21, 22}}, // S0..S3
+    {MUX1_SIGNAL, {23, 13, 14, 27}},
+};
+#else
 const uint8_t sensorPins[SENSOR_COUNT] = {D1, D2, D3, D4, D5, D6, D7, D8};
-const double sensorWeights[SENSOR_COUNT] = {-3.5, -2.5, -1.5, -0.5, 0.5, 1.5, 2.5, 3.5};
+#endif
 uint16_t sensorValues[SENSOR_COUNT];
 
 // Global objects
 QTRSensors qtr;
+sensing::ContinuousAdcSource adcSource(sensorPins, SENSOR_COUNT);
+#if USE_MUX
+sensing::MuxScanner muxScanner(muxPins, 2, SENSOR_COUNT, SENSOR_SAMPLES, MUX_SETTLE_US);
+#endif
+sensing::SensorNormalizer<SENSOR_COUNT> sensorNormalizer;
 EEPROMCalibrationManager *calibManager = nullptr;
+#if USE_PEAK_ESTIMATOR
+sensing::PeakEstimator<SENSOR_COUNT> lineEstimator; // Same units as the centroid, less pull towards the middle
+#else
+sensing::LineEstimator<SENSOR_COUNT> lineEstimator; // Weights -3500..3500, thousandths of the sensor pitch
+#endif
+#if PROFILE_SHADOW_ESTIMATOR
+#if USE_PEAK_ESTIMATOR
+sensing::LineEstimator<SENSOR_COUNT> shadowEstimator;
+#else
+sensing::PeakEstimator<SENSOR_COUNT> shadowEstimator;
+#endif
+volatile int32_t shadowPosition; // Kept so the timed estimate is not optimized away
+#endif
+sensing::SensorWindow<SENSOR_COUNT> sensorWindow(SENSOR_WINDOW_SIZE, SENSOR_FULL_SWEEP_PERIOD,
+                                                 sensing::LineEstimator<SENSOR_COUNT>::WEIGHT_STEP);
+controller::PDController lineController(LINE_KP, LINE_KD);
+sensing::LineKalmanFilter lineKalman(1.0f / CONTROL_RATE_HZ, KALMAN_ACCEL_NOISE, KALMAN_POSITION_NOISE,
+                                     (KALMAN_MAX_GAP_MS * CONTROL_RATE_HZ) / 1000,
+                                     (SENSOR_COUNT - 1) / 2.0f); // Predictions stop at the outer sensor
+sensing::CurvatureEstimator<CURVATURE_WINDOW> curvatureEstimator(1.0f / CONTROL_RATE_HZ, CURVATURE_DECIMATION);
+controller::LineRecovery lineRecovery(RECOVERY_SEARCH_STEERING, RECOVERY_TIMEOUT_MS * 1000UL);
+volatile bool lineLostStop = false; // Set by the control task when the search times out, handled by loop()
+controller::GainSchedule gainSchedule; // Used only when a tuned table is stored in EEPROM
+bool gainScheduleLoaded = false;
+controller::RelayAutotuner autotuner(AUTOTUNE_RELAY_AMPLITUDE, AUTOTUNE_HYSTERESIS);
+volatile bool autotuneActive = false; // Set by loop(), cleared by the control task when done
+rt::FlightRecorder<FLIGHT_RECORDER_CAPACITY> flightRecorder; // Written by the control task, dumped while stopped
+controller::ControllerState pausedState; // Line controller state at the last STOP
+bool pausedStateValid = false;
+
+// The controller gains are tuned for a position in sensor pitches (-3.5..3.5)
+const float POSITION_SCALE = 1.0f / sensing::LineEstimator<SENSOR_COUNT>::WEIGHT_STEP;
+
+void readSensorRange(uint16_t *raw, uint8_t first, uint8_t count);
+void calibrateSensors();
+void controlCycle(void *context);
+rt::ControlScheduler controlScheduler(controlCycle, nullptr, CONTROL_RATE_HZ);
+
+// Telemetry handoff from the control task (core 1) to the telemetry task (core 0)
+struct TelemetrySample {
+  uint32_t timestampUs;
+  int32_t position; // Estimator units, or LineEstimator::NO_LINE
+  float steering;
+  uint8_t conversions; // Sensors converted in this cycle
+  uint16_t sensors[SENSOR_COUNT];
+};
+
+const uint32_t TELEMETRY_DECIMATION = (CONTROL_RATE_HZ * TELEMETRY_INTERVAL_MS) / 1000;
+rt::SpscRingBuffer<TelemetrySample, 16> telemetryQueue;
+void telemetryTask(void *arg);
 
 // System state tracking
 bool systemInitialized = false;
@@ -58,6 +188,15 @@ void IRAM_ATTR handleStartInterrupt() {
   }
 }
 
+/**
+ * @brief Rebuild the normalization tables from the QTR calibration arrays
+ *
+ * Must follow every change of qtr.calibrationOn, while the control loop is stopped.
+ */
+void rebuildNormalizer() {
+  sensorNormalizer.rebuild(qtr.calibrationOn.minimum, qtr.calibrationOn.maximum);
+}
+
 void initializeQTRSensors() {
   Serial.println(F("=== QTR SENSOR INITIALIZATION WITH MEMORY ALLOCATION ==="));
 
@@ -65,6 +204,14 @@ void initializeQTRSensors() {
   qtr.setTypeAnalog();
   qtr.setSensorPins(sensorPins, SENSOR_COUNT);
   Serial.println(F("✓ QTR library configured"));
+#if USE_MUX
+  muxScanner.begin();
+  Serial.print(F("✓ Multiplexer scan ready, "));
+  Serial.print(muxScanner.getSensorCount());
+  Serial.print(F(" sensors on "));
+  Serial.print(muxScanner.getMuxCount());
+  Serial.println(F(" muxes"));
+#endif
 
   // Step 2: CRITICAL - Trigger memory allocation for calibration arrays
   // This is the key insight from the forum post: we must call calibrate()
@@ -96,6 +243,13 @@ void initializeQTRSensors() {
 
     Serial.println(F("✓ Calibration arrays initialized with safe default values"));
 
+#if USE_NORMALIZATION_TABLE
+    if (!sensorNormalizer.enableTable()) {
+      Serial.println(F("⚠ Not enough memory for normalization tables, using scale mode"));
+    }
+#endif
+    rebuildNormalizer();
+
   } else {
     Serial.println(F("✗ WARNING: QTR calibration arrays still not allocated"));
     Serial.println(F("This indicates a deeper issue with QTR library initialization"));
@@ -151,6 +305,15 @@ bool initializeAllSystems() {
   }
   Serial.println(F("✓ Calibration manager ready"));
 
+  // Optional gain schedule stored behind the calibration data
+  gainScheduleLoaded = calibManager->loadGainSchedule(gainSchedule);
+  if (gainScheduleLoaded) {
+    Serial.println(F("✓ Gain schedule loaded"));
+  } else {
+    gainSchedule.fill(LINE_KP, 0.0f, LINE_KD);
+    Serial.println(F("No gain schedule stored, using fixed gains"));
+  }
+
   // Phase 4: GPIO and interrupts
   Serial.println(F("Phase 4: GPIO and Interrupts"));
   pinMode(CALIB_BUTTON_PIN, INPUT_PULLUP);
@@ -162,6 +325,48 @@ bool initializeAllSystems() {
   attachInterrupt(digitalPinToInterrupt(START_BUTTON_PIN), handleStartInterrupt, FALLING);
   Serial.println(F("✓ GPIO and interrupts configured"));
 
+  // Phase 5: Fixed-rate control loop
+  Serial.println(F("Phase 5: Control Loop"));
+  if (!lineController.init()) {
+    Serial.println(F("✗ Line controller initialization failed"));
+    return false;
+  }
+  lineController.setSetpoint(0.0f); // Keep the line centred under the array
+  lineController.setSampleTimeUs(1000000UL / CONTROL_RATE_HZ); // Nominal dt; compute() measures the real one
+  if (!autotuner.init()) {
+    Serial.println(F("✗ Autotuner initialization failed"));
+    return false;
+  }
+  autotuner.setSampleTimeUs(1000000UL / CONTROL_RATE_HZ);
+
+  if (!controlScheduler.begin(CONTROL_TASK_CORE)) {
+    Serial.println(F("✗ Control scheduler initialization failed"));
+    return false;
+  }
+  Serial.print(F("✓ Control loop ready at "));
+  Serial.print(controlScheduler.getRateHz());
+  Serial.print(F(" Hz on core "));
+  Serial.println(CONTROL_TASK_CORE);
+
+  if (xTaskCreatePinnedToCore(telemetryTask, "telemetry", 4096, nullptr,
+                              TELEMETRY_TASK_PRIORITY, nullptr, TELEMETRY_TASK_CORE) != pdPASS) {
+    Serial.println(F("✗ Telemetry task creation failed"));
+    return false;
+  }
+  Serial.print(F("✓ Telemetry task running on core "));
+  Serial.println(TELEMETRY_TASK_CORE);
+
+#if USE_CONTINUOUS_ADC
+  // Optional: without it the control loop falls back to qtr.readLineBlack()
+  if (adcSource.begin(ACQUISITION_TASK_CORE)) {
+    Serial.print(F("✓ Continuous ADC acquisition ready, "));
+    Serial.print(adcSource.getAdc1Count());
+    Serial.println(F(" sensor(s) on DMA"));
+  } else {
+    Serial.println(F("⚠ Continuous ADC unavailable, using synchronous reads"));
+  }
+#endif
+
   return true;
 }
 
@@ -216,6 +421,7 @@ bool loadSavedCalibration() {
     }
     Serial.println();
 
+    rebuildNormalizer();
     calibrationLoaded = true;
     return true;
 
@@ -271,7 +477,7 @@ void performCalibration() {
   const uint32_t calibrationDuration = 4000;
 
   while (millis() - startTime < calibrationDuration) {
-    qtr.calibrate(); // This updates the min/max arrays
+    calibrateSensors(); // This updates the min/max arrays
 
     // Visual feedback
     digitalWrite(LED_PIN, (millis() % 200) < 100);
@@ -287,6 +493,7 @@ void performCalibration() {
   digitalWrite(LED_PIN, LOW);
   Serial.println();
   Serial.println(F("Calibration data collection complete!"));
+  rebuildNormalizer();
 
   // Display calibration results
   Serial.println(F("Calibration results:"));
@@ -379,16 +586,346 @@ void setup() {
   }
 }
 
+/**
+ * @brief Convert a run of sensors synchronously
+ *
+ * Averages SENSOR_SAMPLES conversions per sensor like qtr.read(), so the
+ * readings match the calibration. Sensors outside the run are not touched.
+ *
+ * @param raw: SENSOR_COUNT raw readings, the run is overwritten
+ * @param first: First sensor to convert
+ * @param count: Number of sensors to convert
+ */
+void readSensorRange(uint16_t *raw, uint8_t first, uint8_t count) {
+#if USE_MUX
+  muxScanner.read(raw, first, count);
+#else
+  for (uint8_t i = first; i < first + count; i++) {
+    uint32_t sum = 0;
+    for (uint8_t s = 0; s < SENSOR_SAMPLES; s++) {
+      sum += analogRead(sensorPins[i]);
+    }
+    raw[i] = (uint16_t)(sum / SENSOR_SAMPLES);
+  }
+#endif
+}
+
+/**
+ * @brief One calibration pass: widen each sensor's min/max with a fresh reading
+ *
+ * qtr.calibrate() reads the pins directly and cannot step a multiplexer,
+ * so a multiplexed array is calibrated from readSensorRange() instead.
+ */
+void calibrateSensors() {
+#if USE_MUX
+  uint16_t raw[SENSOR_COUNT];
+  readSensorRange(raw, 0, SENSOR_COUNT);
+  for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+    if (raw[i] < qtr.calibrationOn.minimum[i]) {
+      qtr.calibrationOn.minimum[i] = raw[i];
+    }
+    if (raw[i] > qtr.calibrationOn.maximum[i]) {
+      qtr.calibrationOn.maximum[i] = raw[i];
+    }
+  }
+#else
+  qtr.calibrate();
+#endif
+}
+
+/**
+ * @brief One fixed-rate control iteration: acquire -> estimate -> control
+ *
+ * Runs in the control task at CONTROL_RATE_HZ, released by the hardware
+ * timer. It must never block or print; every TELEMETRY_DECIMATION cycles it
+ * pushes a sample for the telemetry task instead.
+ */
+void controlCycle(void *context) {
+  (void)context;
+  static uint32_t cyclesSinceSample = 0;
+  static int32_t lastPosition = sensing::LineEstimator<SENSOR_COUNT>::NO_LINE;
+
+  // Acquire: take the latest DMA frame, or convert synchronously without it,
+  // then normalize with the precomputed calibration tables. The DMA scan
+  // converts in hardware, so only the synchronous path is windowed.
+  uint8_t conversions = SENSOR_COUNT;
+  {
+    rt::ProfileScope scope(rt::Stage::ACQUIRE);
+    if (adcSource.isRunning()) {
+      adcSource.fetch();
+      sensorNormalizer.normalize(adcSource.frame().raw, sensorValues);
+    } else {
+      static uint16_t rawValues[SENSOR_COUNT];
+#if USE_SENSOR_WINDOW
+      sensing::SensorWindow<SENSOR_COUNT>::Window window = sensorWindow.plan(lastPosition);
+      readSensorRange(rawValues, window.first, window.count);
+      sensorNormalizer.normalize(rawValues, sensorValues);
+      sensorWindow.complete(sensorValues, lineEstimator.getNoiseFloor());
+      conversions = window.count;
+#else
+      readSensorRange(rawValues, 0, SENSOR_COUNT);
+      sensorNormalizer.normalize(rawValues, sensorValues);
+#endif
+    }
+  }
+
+  // Estimate: integer weighted centroid (or parabolic peak fit)
+  int32_t position;
+  {
+    rt::ProfileScope scope(rt::Stage::ESTIMATE);
+    position = lineEstimator.estimate(sensorValues);
+  }
+#if PROFILE_SHADOW_ESTIMATOR
+  {
+    rt::ProfileScope scope(rt::Stage::ESTIMATE_SHADOW);
+    shadowPosition = shadowEstimator.estimate(sensorValues);
+  }
+#endif
+  lastPosition = position;
+
+  // Control: steer back to the centre; bridge short gaps, then search towards the side the line was lost on
+  float steering = 0.0f; // Assigned on every path below, through conditions -Wmaybe-uninitialized cannot follow
+  static float searchSteering = 0.0f; // Last search turn, handed to the line controller when the line returns
+  {
+    rt::ProfileScope scope(rt::Stage::CONTROL);
+    bool lineControl = !autotuneActive;
+    if (autotuneActive) {
+      if (lineEstimator.hasLine(position)) {
+        // Relay experiment in place of the line controller; the recovery
+        // still learns the side in case the relay swings off the line
+        lineRecovery.track(position * POSITION_SCALE, 0.0f);
+        steering = autotuner.computeWithSetpoint(position * POSITION_SCALE, micros());
+
+        if (autotuner.isDone()) {
+          // Tuned gains replace the schedule for this session; hand over without a jump
+          if (autotuner.applyTo(lineController, controller::RelayAutotuner::TuningRule::TYREUS_LUYBEN)) {
+            gainScheduleLoaded = false;
+          }
+          lineController.takeOverFrom(autotuner, -(position * POSITION_SCALE));
+          autotuneActive = false;
+        }
+      } else {
+        // Holding the relay output off the line would keep turning away from
+        // it: end the experiment and let the recovery search below take over
+        autotuner.abort();
+        autotuneActive = false;
+        lineControl = true;
+      }
+    }
+    if (lineControl) {
+      if (lineEstimator.hasLine(position)) {
+        // Feed-forward into the bend ahead: the error is -position, so a line
+        // curving towards positive positions needs negative steering
+        if (curvatureEstimator.update(position * POSITION_SCALE)) {
+          float curvature = curvatureEstimator.getCurvature(BASE_SPEED);
+          lineController.setFeedForward(-CURVATURE_FF_GAIN * curvature * BASE_SPEED);
+
+          // Bends either way want the same gains; retuned once per curvature refresh
+          if (gainScheduleLoaded) {
+            gainSchedule.apply(lineController, BASE_SPEED, curvature < 0.0f ? -curvature : curvature);
+          }
+        }
+      } else {
+        // The history no longer describes the track once the line is lost
+        curvatureEstimator.reset();
+      }
+#if USE_LINE_KALMAN
+      // Filtered position and velocity; a short gap is bridged by prediction.
+      // With the setpoint constant the error rate is minus the line velocity.
+      bool tracked;
+      if (lineEstimator.hasLine(position)) {
+        lineKalman.update(position * POSITION_SCALE);
+        tracked = true;
+      } else {
+        tracked = lineKalman.predict();
+      }
+      if (tracked) {
+        float error = lineController.getSetpoint() - lineKalman.getPosition();
+        if (lineRecovery.isSearching()) {
+          // Line found again: continue from the search turn, not from the history before the gap
+          lineController.bumplessTransfer(searchSteering, error);
+        }
+        lineRecovery.track(lineKalman.getPosition(), lineKalman.getVelocity());
+        steering = lineController.computeWithDerivative(error, -lineKalman.getVelocity(), micros());
+      }
+#else
+      bool tracked = lineEstimator.hasLine(position);
+      if (tracked) {
+        if (lineRecovery.isSearching()) {
+          // Line found again: without the transfer the D term differentiates across the gap
+          lineController.bumplessTransfer(searchSteering,
+                                          lineController.getSetpoint() - position * POSITION_SCALE);
+        }
+        lineRecovery.track(position * POSITION_SCALE, 0.0f); // Side from the position alone
+        steering = lineController.computeWithSetpoint(position * POSITION_SCALE, micros());
+      }
+#endif
+      if (!tracked) {
+        // Line lost: bounded turn towards its last side, then a safe stop
+        steering = lineRecovery.search(micros());
+        searchSteering = steering;
+        if (lineRecovery.isStopped()) {
+          lineLostStop = true;
+        }
+      }
+    }
+  }
+
+  // Record the active controller's state for post-run analysis
+  static uint32_t cyclesSinceRecord = 0;
+  if (++cyclesSinceRecord >= FLIGHT_RECORD_DECIMATION) {
+    cyclesSinceRecord = 0;
+    flightRecorder.record(autotuneActive ? autotuner.snapshot() : lineController.snapshot());
+  }
+
+  // Publish a telemetry sample; a full queue drops it rather than stalling control
+  if (++cyclesSinceSample >= TELEMETRY_DECIMATION) {
+    cyclesSinceSample = 0;
+
+    TelemetrySample sample;
+    sample.timestampUs = micros();
+    sample.position = position;
+    sample.steering = steering;
+    sample.conversions = conversions;
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+      sample.sensors[i] = sensorValues[i];
+    }
+    telemetryQueue.push(sample);
+  }
+}
+
+/**
+ * @brief Report control loop overruns at a bounded rate
+ */
+void reportControlOverruns() {
+  static uint32_t lastReport = 0;
+  static uint32_t lastOverruns = 0;
+  static uint32_t lastDropped = 0;
+
+  if (millis() - lastReport < OVERRUN_REPORT_INTERVAL_MS) {
+    return;
+  }
+  lastReport = millis();
+
+  uint32_t dropped = telemetryQueue.getDropped();
+  if (dropped != lastDropped) {
+    Serial.print(F("⚠ Telemetry samples dropped: "));
+    Serial.println(dropped - lastDropped);
+    lastDropped = dropped;
+  }
+
+  rt::SchedulerStats stats = controlScheduler.getStats();
+  if (stats.overruns == lastOverruns) {
+    return;
+  }
+  lastOverruns = stats.overruns;
+
+  Serial.print(F("⚠ Control overruns: "));
+  Serial.print(stats.overruns);
+  Serial.print(F("/"));
+  Serial.print(stats.cycles);
+  Serial.print(F(" cycles, missed periods: "));
+  Serial.print(stats.missed_periods);
+  Serial.print(F(", max exec: "));
+  Serial.print(stats.max_exec_us);
+  Serial.print(F("us, max latency: "));
+  Serial.print(stats.max_latency_us);
+  Serial.println(F("us"));
+}
+
+/**
+ * @brief Telemetry task: drains control samples and formats them for Serial
+ *
+ * Runs at low priority on the core opposite the control task, so slow UART
+ * output never adds jitter to sensing or control.
+ */
+void telemetryTask(void *arg) {
+  (void)arg;
+  TelemetrySample sample;
+
+  for (;;) {
+    while (telemetryQueue.pop(sample)) {
+      rt::ProfileScope scope(rt::Stage::TELEMETRY);
+
+      Serial.print(F("Pos: "));
+      if (lineEstimator.hasLine(sample.position)) {
+        Serial.print(sample.position * POSITION_SCALE, 2);
+      } else {
+        Serial.print(F("NO_LINE"));
+      }
+
+      Serial.print(F(" | Steer: "));
+      Serial.print(sample.steering, 1);
+
+      Serial.print(F(" | Conv: "));
+      Serial.print(sample.conversions);
+      Serial.print(F("/"));
+      Serial.print(SENSOR_COUNT);
+
+      Serial.print(F(" | Sensors: "));
+      for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        Serial.print(sample.sensors[i]);
+        if (i < SENSOR_COUNT - 1)
+          Serial.print(F(" "));
+      }
+      Serial.println();
+    }
+
+    if (controlScheduler.isRunning()) {
+      reportControlOverruns();
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+}
+
+/**
+ * @brief Print the outcome of a finished relay autotune
+ */
+void reportAutotuneResult() {
+  if (autotuner.getState() == controller::RelayAutotuner::State::ABORTED) {
+    Serial.println(F("✗ Autotune aborted: line lost, keeping the previous gains"));
+    return;
+  }
+  if (autotuner.getState() != controller::RelayAutotuner::State::CONVERGED) {
+    Serial.println(F("✗ Autotune failed: no stable oscillation, keeping the previous gains"));
+    return;
+  }
+
+  Serial.println(F("\n=== AUTOTUNE COMPLETE ==="));
+  Serial.print(F("Ku="));
+  Serial.print(autotuner.getUltimateGain(), 3);
+  Serial.print(F(", Pu="));
+  Serial.print(autotuner.getUltimatePeriod() * 1000.0f, 1);
+  Serial.println(F("ms"));
+  Serial.print(F("Tyreus-Luyben PD gains applied: Kp="));
+  Serial.print(lineController.getKp(), 3);
+  Serial.print(F(", Kd="));
+  Serial.println(lineController.getKd(), 4);
+}
+
 void loop() {
   static bool running = false;
+  static bool autotuneArmed = false;
+  static bool autotuneReportPending = false;
 
   // Handle calibration button
   if (calibRequested) {
     calibRequested = false;
-    running = false; 
+    running = false;
+    controlScheduler.stop(); // The calibration routine needs exclusive use of the sensors
+    adcSource.stop();
+    pausedStateValid = false; // New calibration, new positions: do not resume
     performCalibration();
   }
 
+  // The control task gave up searching for the line: stop as the button would
+  if (running && lineLostStop) {
+    lineLostStop = false;
+    Serial.println(F("⚠ Line lost: search timed out"));
+    startRequested = true;
+  }
+
   // Handle start/stop button
   if (startRequested) {
     startRequested = false;
@@ -398,55 +935,99 @@ void loop() {
         Serial.println(F("⚠ Cannot start: No calibration loaded"));
         Serial.println(F("Press CALIB button first"));
       } else {
-        running = true;
-        Serial.println(F("\n=== LINE FOLLOWING STARTED ==="));
-        digitalWrite(LED_PIN, HIGH);
+        curvatureEstimator.reset();
+        lineKalman.reset(); // Seeded by the first measurement
+        lineRecovery.reset();
+        lineLostStop = false;
+        sensorWindow.reset(); // First cycle is a full sweep
+        if (pausedStateValid && !autotuneArmed) {
+          // Continue mid-track with the state the controller had at STOP
+          lineController.restore(pausedState);
+          Serial.println(F("Resuming with the saved controller state ('n' for a fresh start)"));
+        } else {
+          lineController.reset();
+          lineController.setFeedForward(0.0f);
+          flightRecorder.clear();
+        }
+        if (autotuneArmed) {
+          autotuner.reset();
+          autotuneActive = true;
+          autotuneArmed = false;
+          autotuneReportPending = true;
+        }
+#if USE_CONTINUOUS_ADC
+        adcSource.start(ADC_FRAME_RATE_HZ);
+#endif
+        if (controlScheduler.start()) {
+          running = true;
+          Serial.println(F("\n=== LINE FOLLOWING STARTED ==="));
+          digitalWrite(LED_PIN, HIGH);
+        }
       }
     } else {
       running = false;
+      controlScheduler.stop();
+      adcSource.stop();
+      // Only the line controller resumes; an interrupted autotune starts over,
+      // and so does a run that lost the line
+      pausedState = lineController.snapshot();
+      pausedStateValid = !autotuneActive && !lineRecovery.isStopped();
+      autotuneActive = false;
       Serial.println(F("\n=== LINE FOLLOWING STOPPED ==="));
+      if (lineRecovery.getRecoveries() > 0) {
+        Serial.print(F("Line recovered by searching: "));
+        Serial.print(lineRecovery.getRecoveries());
+        Serial.println(F(" times"));
+      }
+#if USE_SENSOR_WINDOW
+      if (sensorWindow.getCycleCount() > 0) { // Only the synchronous path is windowed
+        Serial.print(F("Sensor window: "));
+        Serial.print(sensorWindow.getMeanConversions(), 2);
+        Serial.print(F(" of "));
+        Serial.print(SENSOR_COUNT);
+        Serial.println(F(" sensors converted per cycle"));
+      }
+#endif
       digitalWrite(LED_PIN, LOW);
     }
   }
 
-  // Main line following logic
-  if (running) {
-    static unsigned long lastOutput = 0;
-
-    // Read calibrated sensor values
-    qtr.readLineBlack(sensorValues);
-
-    // Calculate weighted position
-    double numerator = 0;
-    double denominator = 0;
-
-    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
-      numerator += sensorWeights[i] * sensorValues[i];
-      denominator += sensorValues[i];
+  if (autotuneReportPending && !autotuneActive) {
+    autotuneReportPending = false;
+    if (autotuner.isDone()) {
+      reportAutotuneResult();
     }
+  }
 
-    double position = (denominator > 0) ? (numerator / denominator) : NAN;
-
-    // Output data every 100ms
-    if (millis() - lastOutput > 100) {
-      lastOutput = millis();
-
-      Serial.print(F("Pos: "));
-      if (isnan(position)) {
-        Serial.print(F("NO_LINE"));
+  // Serial commands: 'p' dumps the loop profile, 'r' clears it,
+  // 'a' runs a relay autotune on the next START, 'f' dumps the flight
+  // recorder, 'n' makes the next START fresh instead of resuming
+  if (Serial.available() > 0) {
+    int command = Serial.read();
+    if (command == 'p') {
+      rt::LoopProfiler::dump(Serial);
+    } else if (command == 'r') {
+      rt::LoopProfiler::reset();
+      Serial.println(F("Loop profile cleared"));
+    } else if (command == 'a') {
+      if (running) {
+        Serial.println(F("⚠ Stop line following before arming the autotune"));
       } else {
-        Serial.print(position, 2);
+        autotuneArmed = true;
+        Serial.println(F("Autotune armed: press START with the robot on the line"));
       }
-
-      Serial.print(F(" | Sensors: "));
-      for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
-        Serial.print(sensorValues[i]);
-        if (i < SENSOR_COUNT - 1)
-          Serial.print(F(" "));
+    } else if (command == 'f') {
+      if (running) {
+        Serial.println(F("⚠ Stop line following before dumping the flight recorder"));
+      } else {
+        flightRecorder.dump(Serial);
       }
-      Serial.println();
+    } else if (command == 'n') {
+      pausedStateValid = false;
+      Serial.println(F("Saved controller state discarded: next START is fresh"));
     }
   }
 
-  delay(50);
-}
\ No newline at end of file
+  // loop() only services buttons and commands; control and telemetry run in their own tasks
+  delay(10);
+}
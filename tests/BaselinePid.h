@@ -0,0 +1,97 @@
+#pragma once
+
+#include <math.h>
+
+/**
+ * @file BaselinePid.h
+ * @brief Frozen copies of the controller arithmetic before the Pid<Traits> core
+ *
+ * The compute() bodies of PController, PIController, PDController and
+ * PIDController as they were before the core took over (debug output
+ * removed), with the same constructor defaults: anti-windup = |max_output|,
+ * integral += Ki * error * dt, D = Kd * (error - prev_error) / dt. Do not
+ * "fix" these; they are the reference the current controllers are compared
+ * against.
+ */
+
+namespace baseline {
+
+  inline float applyLimits(float value, float min, float max) {
+    if (value > max) {
+      return max;
+    }
+    if (value < min) {
+      return min;
+    }
+    return value;
+  }
+
+  struct PController {
+    float Kp, dt, min_output, max_output;
+
+    PController(float Kp, float dt, float min_output, float max_output)
+        : Kp(Kp), dt(dt), min_output(min_output), max_output(max_output) {}
+
+    float compute(float error) {
+      float p_term = Kp * error;
+      return applyLimits(p_term, min_output, max_output);
+    }
+  };
+
+  struct PIController {
+    float Kp, Ki, dt, min_output, max_output;
+    float integral, anti_windup;
+
+    PIController(float Kp, float Ki, float dt, float min_output, float max_output)
+        : Kp(Kp), Ki(Ki), dt(dt), min_output(min_output), max_output(max_output), integral(0.0f),
+          anti_windup(fabsf(max_output)) {}
+
+    float compute(float error) {
+      float p_term = Kp * error;
+      integral += Ki * error * dt;
+      integral = applyLimits(integral, -anti_windup, anti_windup);
+      float i_term = integral;
+      float pi_output = p_term + i_term;
+      return applyLimits(pi_output, min_output, max_output);
+    }
+  };
+
+  struct PDController {
+    float Kp, Kd, dt, min_output, max_output;
+    float prev_error;
+
+    PDController(float Kp, float Kd, float dt, float min_output, float max_output)
+        : Kp(Kp), Kd(Kd), dt(dt), min_output(min_output), max_output(max_output), prev_error(0.0f) {}
+
+    float compute(float error) {
+      float p_term = Kp * error;
+      float error_rate = (error - prev_error) / dt;
+      float d_term = Kd * error_rate;
+      prev_error = error;
+      float pd_output = p_term + d_term;
+      return applyLimits(pd_output, min_output, max_output);
+    }
+  };
+
+  struct PIDController {
+    float Kp, Ki, Kd, dt, min_output, max_output;
+    float integral, prev_error, anti_windup;
+
+    PIDController(float Kp, float Ki, float Kd, float dt, float min_output, float max_output)
+        : Kp(Kp), Ki(Ki), Kd(Kd), dt(dt), min_output(min_output), max_output(max_output), integral(0.0f),
+          prev_error(0.0f), anti_windup(fabsf(max_output)) {}
+
+    float compute(float error) {
+      float p_term = Kp * error;
+      integral += Ki * error * dt;
+      integral = applyLimits(integral, -anti_windup, anti_windup);
+      float i_term = integral;
+      float error_rate = (error - prev_error) / dt;
+      float d_term = Kd * error_rate;
+      prev_error = error;
+      float pid_output = p_term + i_term + d_term;
+      return applyLimits(pid_output, min_output, max_output);
+    }
+  };
+
+} // namespace baseline
@@ -0,0 +1,55 @@
+#pragma once
+
+/**
+ * @file BenchHarness.h
+ * @brief Timing helpers for the host benchmarks
+ *
+ * Host numbers compare implementations against each other on the same
+ * machine; they are not ESP32 timings. Use LoopProfiler on the target for
+ * those.
+ */
+
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+
+namespace bench {
+
+  /**
+   * @brief Keep a value alive so the optimizer cannot drop its computation
+   */
+  template <typename T>
+  inline void keep(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+  /**
+   * @brief Best-of-N wall time per call of a function
+   *
+   * @param body: Callable run `calls` times per repetition
+   * @param calls: Calls per repetition
+   * @param repetitions: Repetitions, the fastest is reported
+   * @return double Nanoseconds per call
+   */
+  template <typename Body>
+  double nsPerCall(Body body, uint32_t calls, uint32_t repetitions = 5) {
+    double best = 1e300;
+    for (uint32_t r = 0; r < repetitions; r++) {
+      auto start = std::chrono::steady_clock::now();
+      for (uint32_t i = 0; i < calls; i++) {
+        body(i);
+      }
+      auto stop = std::chrono::steady_clock::now();
+      double ns = std::chrono::duration<double, std::nano>(stop - start).count() / calls;
+      if (ns < best) {
+        best = ns;
+      }
+    }
+    return best;
+  }
+
+  inline void report(const char *name, double ns_per_call) {
+    printf("  %-40s %8.2f ns/call %10.2f Mcalls/s\n", name, ns_per_call, 1e3 / ns_per_call);
+  }
+
+} // namespace bench
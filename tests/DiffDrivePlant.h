@@ -0,0 +1,73 @@
+#pragma once
+
+#include <math.h>
+
+namespace test {
+
+  /**
+   * @brief Differential-drive robot following a line, for closed-loop host tests
+   *
+   * Wheels: first-order motors, speed' = (gain × pwm - speed) / tau, with the
+   * speeds in mm/s as an encoder would report them. Body: unicycle
+   * kinematics relative to the line,
+   *
+   *   heading' = (left - right) / track_width - speed × curvature
+   *   offset'  = speed × sin(heading)
+   *
+   * with heading and offset positive to the right of the line and a line
+   * that curves right for positive curvature. The sensor array sits
+   * lookahead mm ahead of the axle, and lineError() reports the line
+   * position under it with the CascadeController convention: positive when
+   * the robot has to turn right.
+   *
+   * step() integrates with fixed sub-steps, so the plant stays accurate at
+   * whatever rate the controller under test runs.
+   */
+  struct DiffDrivePlant {
+    /**
+     * @var motor_gain: Steady-state wheel speed per PWM count (mm/s)
+     * @var motor_tau: Motor time constant (s)
+     * @var track_width: Distance between the wheels (mm)
+     * @var lookahead: Sensor array distance ahead of the axle (mm)
+     * @var curvature: Line curvature (1/mm, positive curves right)
+     */
+    double motor_gain = 1.5;
+    double motor_tau = 0.04;
+    double track_width = 120.0;
+    double lookahead = 80.0;
+    double curvature = 0.0;
+
+    /**
+     * @var left_speed, right_speed: Wheel speeds (mm/s)
+     * @var heading: Heading relative to the line (rad)
+     * @var offset: Axle distance to the right of the line (mm)
+     */
+    double left_speed = 0.0;
+    double right_speed = 0.0;
+    double heading = 0.0;
+    double offset = 0.0;
+
+    /**
+     * @brief Advance the plant with the motor commands held for dt seconds
+     */
+    void step(double left_pwm, double right_pwm, double dt) {
+      const int SUBSTEPS = 10;
+      double h = dt / SUBSTEPS;
+      for (int i = 0; i < SUBSTEPS; i++) {
+        left_speed += h * (motor_gain * left_pwm - left_speed) / motor_tau;
+        right_speed += h * (motor_gain * right_pwm - right_speed) / motor_tau;
+        double speed = 0.5 * (left_speed + right_speed);
+        heading += h * ((left_speed - right_speed) / track_width - speed * curvature);
+        offset += h * speed * sin(heading);
+      }
+    }
+
+    /**
+     * @brief Line position under the sensor array (mm, positive = turn right)
+     */
+    double lineError() const {
+      return -(offset + lookahead * sin(heading));
+    }
+  };
+
+} // namespace test
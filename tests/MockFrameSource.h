@@ -0,0 +1,110 @@
+#pragma once
+
+#include "ContinuousAdcSource.h"
+#include <atomic>
+#include <thread>
+
+namespace test {
+
+  /**
+   * @brief Host stand-in for ContinuousAdcSource
+   *
+   * A std::thread takes the place of the acquisition task and publishes
+   * SensorFrames through the same TripleBuffer, with the same
+   * writeSlot()/publish() sequence as assembleFrame(). Each reading is
+   * derived from the frame sequence, so the reader side can tell a torn
+   * frame (readings from two different publishes) from an intact one.
+   */
+  class MockFrameSource {
+  public:
+    explicit MockFrameSource(uint8_t count = sensing::SensorFrame::MAX_SENSORS)
+        : count(count), running(false), published(0) {}
+
+    ~MockFrameSource() {
+      stop();
+    }
+
+    /**
+     * @brief Start publishing frames
+     *
+     * @param frames_to_publish: Frames to publish before the thread ends
+     */
+    void start(uint32_t frames_to_publish) {
+      stop();
+      published = 0;
+      running = true;
+      producer = std::thread([this, frames_to_publish] {
+        for (uint32_t sequence = 1; sequence <= frames_to_publish && running; sequence++) {
+          sensing::SensorFrame &frame = frames.writeSlot();
+          for (uint8_t i = 0; i < count; i++) {
+            frame.raw[i] = reading(sequence, i);
+          }
+          frame.timestamp_us = sequence * 1000u;
+          frame.sequence = sequence;
+          frames.publish();
+          published.store(sequence, std::memory_order_release);
+          if ((sequence & 15) == 0) {
+            std::this_thread::yield(); // Gives a single-core host a chance to interleave
+          }
+        }
+        running = false;
+      });
+    }
+
+    /**
+     * @brief Wait until every frame has been published
+     */
+    void wait() {
+      if (producer.joinable()) {
+        producer.join();
+      }
+    }
+
+    /**
+     * @brief Stop publishing early
+     */
+    void stop() {
+      running = false;
+      if (producer.joinable()) {
+        producer.join();
+      }
+    }
+
+    inline bool fetch() { return frames.fetch(); }
+    inline const sensing::SensorFrame &frame() const { return frames.front(); }
+    inline bool hasFrame() const { return frames.hasValue(); }
+    inline bool isRunning() const { return running; }
+    inline uint32_t getFrameCount() const { return published.load(std::memory_order_acquire); }
+    inline uint8_t getCount() const { return count; }
+
+    /**
+     * @brief Reading of one sensor in the frame with this sequence
+     */
+    static uint16_t reading(uint32_t sequence, uint8_t sensor) {
+      return (uint16_t)((sequence * 31u + sensor * 257u) & 0x0FFF);
+    }
+
+    /**
+     * @brief Check that every reading of a frame comes from the same publish
+     */
+    bool isIntact(const sensing::SensorFrame &frame) const {
+      if (frame.timestamp_us != frame.sequence * 1000u) {
+        return false;
+      }
+      for (uint8_t i = 0; i < count; i++) {
+        if (frame.raw[i] != reading(frame.sequence, i)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+  private:
+    uint8_t count;
+    rt::TripleBuffer<sensing::SensorFrame> frames;
+    std::thread producer;
+    std::atomic<bool> running;
+    std::atomic<uint32_t> published;
+  };
+
+} // namespace test
@@ -0,0 +1,67 @@
+#pragma once
+
+/**
+ * @file TestHarness.h
+ * @brief Minimal assertion macros for the host tests
+ *
+ * Each test is a plain executable: functions registered with RUN_TEST()
+ * from main(), failures counted and printed with file and line, and the
+ * exit status of test::finish() tells CTest whether the suite passed.
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+namespace test {
+
+  inline int &failures() {
+    static int count = 0;
+    return count;
+  }
+
+  inline void fail(const char *file, int line, const char *expression) {
+    failures()++;
+    printf("  FAILED %s:%d: %s\n", file, line, expression);
+  }
+
+  inline int finish(const char *suite) {
+    if (failures() == 0) {
+      printf("%s: all tests passed\n", suite);
+      return 0;
+    }
+    printf("%s: %d check(s) failed\n", suite, failures());
+    return 1;
+  }
+
+} // namespace test
+
+#define CHECK(condition)                                                                                      \
+  do {                                                                                                        \
+    if (!(condition)) {                                                                                       \
+      test::fail(__FILE__, __LINE__, #condition);                                                            \
+    }                                                                                                         \
+  } while (0)
+
+#define CHECK_EQ(actual, expected)                                                                            \
+  do {                                                                                                        \
+    if (!((actual) == (expected))) {                                                                          \
+      test::fail(__FILE__, __LINE__, #actual " == " #expected);                                              \
+      printf("    actual %.9g, expected %.9g\n", (double)(actual), (double)(expected));                      \
+    }                                                                                                         \
+  } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                                               \
+  do {                                                                                                        \
+    double check_difference = fabs((double)(actual) - (double)(expected));                                   \
+    if (!(check_difference <= (double)(tolerance))) {                                                         \
+      test::fail(__FILE__, __LINE__, #actual " ~= " #expected);                                              \
+      printf("    actual %.9g, expected %.9g, difference %.3g > %.3g\n", (double)(actual), (double)(expected), \
+             check_difference, (double)(tolerance));                                                          \
+    }                                                                                                         \
+  } while (0)
+
+#define RUN_TEST(function)                                                                                    \
+  do {                                                                                                        \
+    printf("%s\n", #function);                                                                               \
+    function();                                                                                               \
+  } while (0)
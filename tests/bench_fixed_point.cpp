@@ -0,0 +1,61 @@
+#include "BenchHarness.h"
+#include "FixedPoint.h"
+#include "PidCore.h"
+#include <stdlib.h>
+
+using numeric::Q16_16;
+
+namespace {
+
+  const uint32_t OPS = 50000000;
+  const uint32_t MASK = 1023;
+  float float_values[MASK + 1];
+  Q16_16 fixed_values[MASK + 1];
+
+  template <typename T, typename Op>
+  void benchOp(const char *name, const T *values, Op op) {
+    // Independent operands: a chained accumulator drifts into denormals or saturation
+    double ns = bench::nsPerCall(
+        [&](uint32_t i) {
+          bench::keep(op(values[i & MASK], values[(i + 1) & MASK]));
+        },
+        OPS);
+    printf("  %-40s %8.1f Mops/s\n", name, 1e3 / ns);
+  }
+
+  template <typename Traits>
+  void benchPid(const char *name, const typename Traits::Scalar *errors, typename Traits::Scalar dt) {
+    typedef typename Traits::Scalar Scalar;
+    controller::Pid<Traits> core(Scalar(250.0f), Scalar(20.0f), Scalar(0.5f), dt);
+    Scalar sum = Scalar(0.0f);
+    double ns = bench::nsPerCall(
+        [&](uint32_t i) {
+          sum = core.compute(errors[i & MASK]);
+        },
+        OPS / 4);
+    bench::keep(sum);
+    printf("  %-40s %8.1f Msteps/s\n", name, 1e3 / ns);
+  }
+
+} // namespace
+
+int main() {
+  srand(1);
+  for (uint32_t i = 0; i <= MASK; i++) {
+    float_values[i] = 0.5f + (float)rand() / RAND_MAX; // Keeps products and quotients bounded
+    fixed_values[i] = Q16_16(float_values[i]);
+  }
+
+  printf("Fixed point (Q16.16) vs float\n");
+  benchOp("float add", float_values, [](float a, float b) { return a + b; });
+  benchOp("Q16.16 add (saturating)", fixed_values, [](Q16_16 a, Q16_16 b) { return a + b; });
+  benchOp("float mul", float_values, [](float a, float b) { return a * b; });
+  benchOp("Q16.16 mul (rounded, saturating)", fixed_values, [](Q16_16 a, Q16_16 b) { return a * b; });
+  benchOp("float div", float_values, [](float a, float b) { return a / b; });
+  benchOp("Q16.16 div (rounded, saturating)", fixed_values, [](Q16_16 a, Q16_16 b) { return a / b; });
+
+  const float dt = 1.0f / 1024.0f;
+  benchPid<controller::PIDTraits>("Pid<PIDTraits> step (float)", float_values, dt);
+  benchPid<controller::PIDTraitsQ16>("Pid<PIDTraitsQ16> step (Q16.16)", fixed_values, Q16_16(dt));
+  return 0;
+}
@@ -0,0 +1,58 @@
+#include "BenchHarness.h"
+#include "LineEstimator.h"
+#include "PeakEstimator.h"
+#include <math.h>
+#include <stdlib.h>
+
+namespace {
+
+  const uint8_t SENSORS = 8;
+  const uint32_t CALLS = 5000000;
+  const uint32_t FRAME_MASK = 1023;
+  uint16_t frames[FRAME_MASK + 1][SENSORS];
+  double positions[FRAME_MASK + 1];
+
+  /**
+   * @brief Gaussian line profile (sigma 0.6 pitch, about three sensors) with ±8 counts of noise
+   */
+  void profile(uint16_t *values, double x) {
+    for (uint8_t i = 0; i < SENSORS; i++) {
+      double d = (i - 3.5) - x;
+      double v = 25.0 + 950.0 * exp(-d * d / (2.0 * 0.6 * 0.6)) + (rand() % 17 - 8);
+      values[i] = (uint16_t)(v < 0.0 ? 0.0 : (v > 1000.0 ? 1000.0 : v));
+    }
+  }
+
+  template <typename Estimator>
+  void report(const char *name, Estimator &estimator) {
+    double sum_squares = 0.0;
+    double worst = 0.0;
+    for (uint32_t f = 0; f <= FRAME_MASK; f++) {
+      double truth = (positions[f] < -3.5 ? -3.5 : (positions[f] > 3.5 ? 3.5 : positions[f])) * 1000.0;
+      double error = fabs(estimator.estimate(frames[f]) - truth);
+      sum_squares += error * error;
+      worst = error > worst ? error : worst;
+    }
+    printf("  %s: error rms %.0f, max %.0f (weight units, 1000 = one pitch)\n", name,
+           sqrt(sum_squares / (FRAME_MASK + 1)), worst);
+    bench::report(name, bench::nsPerCall([&](uint32_t i) { bench::keep(estimator.estimate(frames[i & FRAME_MASK])); },
+                                         CALLS));
+  }
+
+} // namespace
+
+int main() {
+  srand(1);
+  for (uint32_t f = 0; f <= FRAME_MASK; f++) {
+    positions[f] = -3.8 + 7.6 * f / FRAME_MASK; // Across the array and a little past both edges
+    profile(frames[f], positions[f]);
+  }
+
+  sensing::LineEstimator<SENSORS> centroid;
+  sensing::PeakEstimator<SENSORS> peak;
+
+  printf("Line position estimation, %u sensors per frame\n", (unsigned)SENSORS);
+  report("LineEstimator (centroid)", centroid);
+  report("PeakEstimator (parabola)", peak);
+  return 0;
+}
@@ -0,0 +1,68 @@
+#include "BaselinePid.h"
+#include "BenchHarness.h"
+#include "PDController.h"
+#include "PIController.h"
+#include "PIDController.h"
+#include "PidCore.h"
+#include <stdlib.h>
+
+namespace {
+
+  const uint32_t CALLS = 20000000;
+  const uint32_t TRACE_MASK = 1023;
+  float errors[TRACE_MASK + 1];
+
+  template <typename Controller>
+  void benchCompute(const char *name, Controller &controller) {
+    float sum = 0.0f;
+    bench::report(name, bench::nsPerCall(
+                            [&](uint32_t i) {
+                              sum += controller.compute(errors[i & TRACE_MASK]);
+                            },
+                            CALLS));
+    bench::keep(sum);
+  }
+
+} // namespace
+
+int main() {
+  srand(1);
+  for (uint32_t i = 0; i <= TRACE_MASK; i++) {
+    errors[i] = 4.0f * (float)rand() / RAND_MAX - 2.0f;
+  }
+
+  // Loaded at run time so neither side gets its dt constant-folded
+  volatile float dt_source = 0.001f;
+  const float dt = dt_source;
+
+  // Baseline: integral += Ki * error * dt and (error - prev_error) / dt every step
+  baseline::PIController pi_before(180.0f, 60.0f, dt, -1023.0f, 1023.0f);
+  baseline::PDController pd_before(180.0f, 0.9f, dt, -1023.0f, 1023.0f);
+  baseline::PIDController pid_before(180.0f, 60.0f, 0.9f, dt, -1023.0f, 1023.0f);
+
+  // Current core: precomputed Ki * dt and Kd / dt, inlined like the baseline
+  controller::Pid<controller::PITraits> pi_core(180.0f, 60.0f, 0.0f, dt);
+  controller::Pid<controller::PDTraits> pd_core(180.0f, 0.0f, 0.9f, dt);
+  controller::Pid<controller::PIDTraits> pid_core(180.0f, 60.0f, 0.9f, dt);
+
+  // Current wrappers as the sketch calls them: out of line, with feed-forward
+  // and derivative-input selection on top of the core
+  controller::PIController pi_wrapper(180.0f, 60.0f, 1);
+  controller::PDController pd_wrapper(180.0f, 0.9f, 1);
+  controller::PIDController pid_wrapper(180.0f, 60.0f, 0.9f, 1);
+  pi_wrapper.init();
+  pd_wrapper.init();
+  pid_wrapper.init();
+
+  printf("PID compute(), before and after precomputing Ki*dt and Kd/dt\n");
+  benchCompute("PI  baseline (Ki * error * dt)", pi_before);
+  benchCompute("PI  Pid<PITraits> core", pi_core);
+  benchCompute("PI  PIController wrapper", pi_wrapper);
+  benchCompute("PD  baseline ((e - e1) / dt)", pd_before);
+  benchCompute("PD  Pid<PDTraits> core", pd_core);
+  benchCompute("PD  PDController wrapper", pd_wrapper);
+  benchCompute("PID baseline", pid_before);
+  benchCompute("PID Pid<PIDTraits> core", pid_core);
+  benchCompute("PID PIDController wrapper", pid_wrapper);
+  return 0;
+}
@@ -0,0 +1,74 @@
+#include "BenchHarness.h"
+#include "PController.h"
+#include "PDController.h"
+#include "PIController.h"
+#include "PIDController.h"
+#include "PidCore.h"
+#include <stdlib.h>
+
+using namespace controller;
+
+namespace {
+
+  const uint32_t CALLS = 20000000;
+  const uint32_t TRACE_MASK = 1023;
+  float errors[TRACE_MASK + 1];
+
+  /**
+   * @brief compute() through a BaseController pointer the compiler cannot see through
+   */
+  void benchVirtual(const char *name, BaseController *const *controllers, volatile int index) {
+    BaseController *c = controllers[index];
+    float sum = 0.0f;
+    bench::report(name, bench::nsPerCall(
+                            [&](uint32_t i) {
+                              sum += c->compute(errors[i & TRACE_MASK]);
+                            },
+                            CALLS));
+    bench::keep(sum);
+  }
+
+  /**
+   * @brief compute() on the Pid<Traits> core, fully inlined
+   */
+  template <typename Traits>
+  void benchTemplate(const char *name, Pid<Traits> &core) {
+    float sum = 0.0f;
+    bench::report(name, bench::nsPerCall(
+                            [&](uint32_t i) {
+                              sum += core.compute(errors[i & TRACE_MASK]);
+                            },
+                            CALLS));
+    bench::keep(sum);
+  }
+
+} // namespace
+
+int main() {
+  srand(1);
+  for (uint32_t i = 0; i <= TRACE_MASK; i++) {
+    errors[i] = (float)rand() / RAND_MAX * 2.0f - 1.0f;
+  }
+
+  PController p(250.0f);
+  PIController pi(250.0f, 20.0f);
+  PDController pd(250.0f, 2.0f);
+  PIDController pid(250.0f, 20.0f, 2.0f);
+  BaseController *controllers[] = {&p, &pi, &pd, &pid};
+
+  Pid<PTraits> p_core(250.0f);
+  Pid<PITraits> pi_core(250.0f, 20.0f);
+  Pid<PDTraits> pd_core(250.0f, 0.0f, 2.0f);
+  Pid<PIDTraits> pid_core(250.0f, 20.0f, 2.0f);
+
+  printf("Controller dispatch: virtual BaseController::compute vs Pid<Traits>::compute\n");
+  benchVirtual("P   virtual (PController)", controllers, 0);
+  benchTemplate("P   Pid<PTraits>", p_core);
+  benchVirtual("PI  virtual (PIController)", controllers, 1);
+  benchTemplate("PI  Pid<PITraits>", pi_core);
+  benchVirtual("PD  virtual (PDController)", controllers, 2);
+  benchTemplate("PD  Pid<PDTraits>", pd_core);
+  benchVirtual("PID virtual (PIDController)", controllers, 3);
+  benchTemplate("PID Pid<PIDTraits>", pid_core);
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include "BenchHarness.h"
+#include "SensorNormalizer.h"
+#include <stdlib.h>
+
+namespace {
+
+  const uint8_t SENSORS = 8;
+  const uint32_t FRAMES = 5000000;
+  const uint32_t FRAME_MASK = 255;
+  uint16_t raw_frames[FRAME_MASK + 1][SENSORS];
+  uint16_t minimum[SENSORS];
+  uint16_t maximum[SENSORS];
+
+  /**
+   * @brief QTRSensors::readCalibrated() arithmetic after the read, as in the Pololu library
+   */
+  void qtrCalibrate(const uint16_t *raw, uint16_t *normalized) {
+    for (uint8_t i = 0; i < SENSORS; i++) {
+      uint16_t denominator = maximum[i] - minimum[i];
+      int16_t value = 0;
+      if (denominator != 0) {
+        value = (((int32_t)raw[i]) - minimum[i]) * 1000 / denominator;
+      }
+      normalized[i] = value < 0 ? 0 : (value > 1000 ? 1000 : (uint16_t)value);
+    }
+  }
+
+  /**
+   * @brief Largest difference to the QTR result over every raw value of every sensor
+   */
+  int maxDeviation(const sensing::SensorNormalizer<SENSORS> &normalizer) {
+    int worst = 0;
+    uint16_t raw[SENSORS];
+    uint16_t expected[SENSORS];
+    uint16_t actual[SENSORS];
+    for (uint16_t value = 0; value < 4096; value++) {
+      for (uint8_t i = 0; i < SENSORS; i++) {
+        raw[i] = value;
+      }
+      qtrCalibrate(raw, expected);
+      normalizer.normalize(raw, actual);
+      for (uint8_t i = 0; i < SENSORS; i++) {
+        int deviation = abs((int)actual[i] - (int)expected[i]);
+        worst = deviation > worst ? deviation : worst;
+      }
+    }
+    return worst;
+  }
+
+  template <typename Normalize>
+  void benchFrames(const char *name, Normalize normalize) {
+    uint16_t normalized[SENSORS];
+    bench::report(name, bench::nsPerCall(
+                            [&](uint32_t i) {
+                              normalize(raw_frames[i & FRAME_MASK], normalized);
+                              bench::keep(normalized);
+                            },
+                            FRAMES));
+  }
+
+} // namespace
+
+int main() {
+  srand(1);
+  for (uint8_t i = 0; i < SENSORS; i++) {
+    minimum[i] = (uint16_t)(150 + rand() % 200);
+    maximum[i] = (uint16_t)(2800 + rand() % 1200);
+  }
+  for (uint32_t f = 0; f <= FRAME_MASK; f++) {
+    for (uint8_t i = 0; i < SENSORS; i++) {
+      raw_frames[f][i] = (uint16_t)(rand() % 4096);
+    }
+  }
+
+  sensing::SensorNormalizer<SENSORS> scaled;
+  scaled.rebuild(minimum, maximum);
+  sensing::SensorNormalizer<SENSORS> tabled;
+  tabled.enableTable();
+  tabled.rebuild(minimum, maximum);
+
+  printf("Sensor normalization, %u sensors per frame (ns/call is per frame)\n", (unsigned)SENSORS);
+  printf("  max deviation from QTR: scale mode %d, table mode %d\n", maxDeviation(scaled), maxDeviation(tabled));
+  benchFrames("QTR readCalibrated arithmetic (divide)", qtrCalibrate);
+  benchFrames("SensorNormalizer scale mode", [&](const uint16_t *raw, uint16_t *out) { scaled.normalize(raw, out); });
+  benchFrames("SensorNormalizer table mode", [&](const uint16_t *raw, uint16_t *out) { tabled.normalize(raw, out); });
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include "BenchHarness.h"
+#include "SpscRingBuffer.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using rt::SpscRingBuffer;
+
+namespace {
+
+  /**
+   * @brief Same size as the sketch's TelemetrySample with 8 sensors
+   */
+  struct Sample {
+    uint32_t timestamp_us;
+    int32_t position;
+    float steering;
+    uint8_t conversions;
+    uint16_t sensors[8];
+  };
+
+  /**
+   * @brief Stream samples through the ring with a producer and a consumer thread
+   *
+   * @param lossless: The producer retries a full push instead of dropping it
+   */
+  template <size_t CAPACITY>
+  void stress(const char *name, bool lossless) {
+    static SpscRingBuffer<Sample, CAPACITY> ring;
+    const uint32_t total = 5000000;
+    std::atomic<bool> done(false);
+    uint32_t received = 0;
+    uint32_t dropped_before = ring.getDropped();
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread consumer([&]() {
+      Sample sample;
+      while (!done.load(std::memory_order_relaxed) || !ring.empty()) {
+        if (ring.pop(sample)) {
+          received++;
+          bench::keep(sample.position);
+        } else {
+          std::this_thread::yield(); // A one-core host would otherwise spin a whole time slice
+        }
+      }
+    });
+
+    Sample sample = {};
+    for (uint32_t i = 0; i < total; i++) {
+      sample.timestamp_us = i;
+      if (lossless) {
+        while (!ring.push(sample)) {
+          std::this_thread::yield();
+        }
+      } else {
+        ring.push(sample);
+      }
+    }
+    done = true;
+    consumer.join();
+    auto stop = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    printf("  %-40s %8.2f Mitems/s  received %u  full pushes %u\n", name, total / seconds / 1e6, received,
+           ring.getDropped() - dropped_before);
+  }
+
+} // namespace
+
+int main() {
+  printf("SpscRingBuffer, %zu-byte samples\n", sizeof(Sample));
+
+  SpscRingBuffer<Sample, 16> ring;
+  Sample sample = {};
+  bench::report("push + pop, one thread", bench::nsPerCall(
+                                             [&](uint32_t i) {
+                                               sample.timestamp_us = i;
+                                               ring.push(sample);
+                                               ring.pop(sample);
+                                               bench::keep(sample);
+                                             },
+                                             10000000));
+
+  stress<16>("2 threads, capacity 16, lossless", true);
+  stress<1024>("2 threads, capacity 1024, lossless", true);
+  stress<16>("2 threads, capacity 16, dropping", false);
+  return 0;
+}
@@ -0,0 +1,51 @@
+#include "BenchHarness.h"
+#include "LQRController.h"
+#include "MPCController.h"
+#include <math.h>
+
+using namespace controller;
+
+namespace {
+
+  const uint32_t CALLS = 200000;
+  const uint32_t TRACE_MASK = 1023;
+  float errors[TRACE_MASK + 1];
+
+  /**
+   * @brief compute() on a recorded error trace, saturating part of the time
+   */
+  template <typename Controller>
+  void benchCompute(const char *name, Controller &controller) {
+    float sum = 0.0f;
+    bench::report(name, bench::nsPerCall([&](uint32_t i) { sum += controller.compute(errors[i & TRACE_MASK]); },
+                                         CALLS));
+    bench::keep(sum);
+  }
+
+} // namespace
+
+int main() {
+  // A line swinging ±2.5 pitches: the ±300 limit is active near the peaks
+  for (uint32_t i = 0; i <= TRACE_MASK; i++) {
+    errors[i] = 2.5f * sinf(6.2831853f * i / (TRACE_MASK + 1));
+  }
+
+  printf("State-space line controllers, one compute() per call\n");
+  printf("  (host timings; the ESP32 budget of 200 us per step is not measured here,\n");
+  printf("   use LoopProfiler's control stage on the target)\n");
+
+  LQRController lqr(1, -300.0f, 300.0f);
+  lqr.init();
+  benchCompute("LQRController", lqr);
+
+  const uint8_t ITERATIONS[] = {5, control_tables::MPC_ITERATIONS, 40};
+  for (uint8_t iterations : ITERATIONS) {
+    MPCController mpc(1, -300.0f, 300.0f);
+    mpc.init();
+    mpc.setIterations(iterations);
+    char name[48];
+    snprintf(name, sizeof(name), "MPCController (%u iterations)", (unsigned)iterations);
+    benchCompute(name, mpc);
+  }
+  return 0;
+}
@@ -0,0 +1,4 @@
+// The Arduino build includes Arduino.h ahead of a sketch implicitly
+#include <Arduino.h>
+
+#include "main.ino"
@@ -0,0 +1,154 @@
+#pragma once
+
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the Arduino-ESP32 core, for the tests in tests/
+ *
+ * Declares the subset of the Arduino API the sketch uses. The clock is
+ * simulated: micros() and millis() only move when a test calls
+ * host::setMicros() or host::advanceMicros(), so timing logic can be
+ * stepped through deterministically. analogRead() returns values set with
+ * host::setAnalog(), digitalWrite() is recorded for host::digitalLevel(),
+ * and Serial discards its output but counts the lines.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#include "freertos/task.h"
+
+#define IRAM_ATTR
+#define ARDUINO_ISR_ATTR
+#define HEX 16
+#define DEC 10
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define FALLING 2
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+class String {
+public:
+  String() {}
+  String(const char *text) : text(text) {}
+  String(const __FlashStringHelper *text) : text(reinterpret_cast<const char *>(text)) {}
+  const char *c_str() const { return text.c_str(); }
+
+private:
+  std::string text;
+};
+
+class Print {
+public:
+  template <typename T> size_t print(T) { return 0; }
+  template <typename T> size_t print(T, int) { return 0; }
+  template <typename T> size_t println(T) { return println(); }
+  template <typename T> size_t println(T, int) { return println(); }
+  size_t println() {
+    lines++;
+    return 0;
+  }
+
+  void begin(unsigned long) {}
+  int available() { return 0; }
+  int read() { return -1; }
+
+  /**
+   * @var lines: println() calls since construction, see host::serialLines()
+   */
+  uint32_t lines = 0;
+};
+
+extern Print Serial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+int digitalPinToInterrupt(int pin);
+void attachInterrupt(int interrupt, void (*handler)(), int mode);
+
+struct EspClass {
+  uint32_t getCycleCount();
+  uint32_t getCpuFreqMHz();
+};
+extern EspClass ESP;
+
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+typedef struct {
+  uint8_t pin;
+  uint8_t channel;
+  int avg_read_raw;
+  int avg_read_mvolts;
+} adc_continuous_result_t;
+bool analogContinuous(const uint8_t pins[], size_t pins_count, uint32_t conversions_per_pin,
+                      uint32_t sampling_freq_hz, void (*userFunc)(void));
+bool analogContinuousRead(adc_continuous_result_t **buffer, uint32_t timeout_ms);
+bool analogContinuousStart();
+bool analogContinuousStop();
+bool analogContinuousDeinit();
+#endif
+
+namespace host {
+
+  /**
+   * @brief Simulated clock; delay() and delayMicroseconds() advance it too
+   */
+  void setMicros(uint64_t now_us);
+  void advanceMicros(uint64_t delta_us);
+  uint64_t nowMicros();
+
+  /**
+   * @brief Let time pass inside the code under test (both 0 by default)
+   *
+   * @param micros_tick_us: Clock advance per micros() call, so busy-waits end
+   * @param analog_read_us: Clock advance per analogRead(), the conversion time
+   */
+  void setClockTicks(uint32_t micros_tick_us, uint32_t analog_read_us);
+
+  /**
+   * @brief Simulated pins
+   */
+  void setAnalog(uint8_t pin, uint16_t value);
+  uint8_t digitalLevel(uint8_t pin);
+
+  /**
+   * @brief Pin activity log: digitalWrite() and analogRead() calls in order
+   *
+   * @var write: digitalWrite (true) or analogRead (false)
+   * @var pin: Pin accessed
+   * @var level: Level written (0 for a read)
+   * @var time_us: Simulated clock at the access
+   */
+  struct PinEvent {
+    bool write;
+    uint8_t pin;
+    uint8_t level;
+    uint64_t time_us;
+  };
+  static const size_t PIN_LOG_SIZE = 1024;
+
+  /**
+   * @brief Empty the log; events past PIN_LOG_SIZE are dropped
+   */
+  void clearPinLog();
+  size_t pinEventCount();
+  const PinEvent &pinEvent(size_t index);
+
+  /**
+   * @brief Lines printed to Serial since the start of the program
+   */
+  uint32_t serialLines();
+
+} // namespace host
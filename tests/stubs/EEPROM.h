@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Host EEPROM emulation: a zero-initialised 4 KB array
+ */
+class EEPROMClass {
+public:
+  static const size_t CAPACITY = 4096;
+
+  bool begin(size_t size);
+  uint8_t read(int address);
+  void write(int address, uint8_t value);
+  bool commit();
+
+  /**
+   * @brief Erase the emulated EEPROM to 0xFF, as a fresh chip reads
+   */
+  void clear();
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,215 @@
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "QTRSensors.h"
+#include "esp_timer.h"
+#include <string.h>
+
+Print Serial;
+EspClass ESP;
+EEPROMClass EEPROM;
+
+namespace {
+  uint64_t clock_us = 0;
+  uint32_t micros_tick_us = 0;
+  uint32_t analog_read_us = 0;
+  uint16_t analog_values[64];
+  uint8_t digital_levels[64];
+  uint8_t eeprom_data[EEPROMClass::CAPACITY];
+  host::PinEvent pin_log[host::PIN_LOG_SIZE];
+  size_t pin_events = 0;
+
+  void logPin(bool write, uint8_t pin, uint8_t level) {
+    if (pin_events < host::PIN_LOG_SIZE) {
+      pin_log[pin_events++] = {write, pin, level, clock_us};
+    }
+  }
+} // namespace
+
+namespace host {
+
+  void setMicros(uint64_t now_us) {
+    clock_us = now_us;
+  }
+
+  void advanceMicros(uint64_t delta_us) {
+    clock_us += delta_us;
+  }
+
+  uint64_t nowMicros() {
+    return clock_us;
+  }
+
+  void setClockTicks(uint32_t micros_tick, uint32_t analog_read) {
+    micros_tick_us = micros_tick;
+    analog_read_us = analog_read;
+  }
+
+  void setAnalog(uint8_t pin, uint16_t value) {
+    analog_values[pin & 63] = value;
+  }
+
+  uint8_t digitalLevel(uint8_t pin) {
+    return digital_levels[pin & 63];
+  }
+
+  void clearPinLog() {
+    pin_events = 0;
+  }
+
+  size_t pinEventCount() {
+    return pin_events;
+  }
+
+  const PinEvent &pinEvent(size_t index) {
+    return pin_log[index];
+  }
+
+  uint32_t serialLines() {
+    return Serial.lines;
+  }
+
+} // namespace host
+
+unsigned long millis() {
+  return (unsigned long)(uint32_t)(clock_us / 1000);
+}
+
+unsigned long micros() {
+  uint32_t now = (uint32_t)clock_us;
+  clock_us += micros_tick_us;
+  return now;
+}
+
+void delay(unsigned long ms) {
+  clock_us += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us) {
+  clock_us += us;
+}
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+  digital_levels[pin & 63] = level;
+  logPin(true, pin, level);
+}
+
+int digitalRead(uint8_t pin) {
+  return digital_levels[pin & 63];
+}
+
+uint16_t analogRead(uint8_t pin) {
+  logPin(false, pin, 0);
+  clock_us += analog_read_us;
+  return analog_values[pin & 63];
+}
+
+int digitalPinToInterrupt(int pin) {
+  return pin;
+}
+
+void attachInterrupt(int, void (*)(), int) {}
+
+uint32_t EspClass::getCycleCount() {
+  return (uint32_t)(clock_us * 240);
+}
+
+uint32_t EspClass::getCpuFreqMHz() {
+  return 240;
+}
+
+bool EEPROMClass::begin(size_t size) {
+  return size <= CAPACITY;
+}
+
+uint8_t EEPROMClass::read(int address) {
+  return (address >= 0 && (size_t)address < CAPACITY) ? eeprom_data[address] : 0xFF;
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+  if (address >= 0 && (size_t)address < CAPACITY) {
+    eeprom_data[address] = value;
+  }
+}
+
+bool EEPROMClass::commit() {
+  return true;
+}
+
+void EEPROMClass::clear() {
+  memset(eeprom_data, 0xFF, sizeof(eeprom_data));
+}
+
+void QTRSensors::setTypeAnalog() {}
+void QTRSensors::setSensorPins(const uint8_t *, uint8_t) {}
+void QTRSensors::calibrate() {}
+void QTRSensors::read(uint16_t *) {}
+uint16_t QTRSensors::readLineBlack(uint16_t *) {
+  return 0;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *, esp_timer_handle_t *) {
+  return ESP_FAIL;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t, uint64_t) {
+  return ESP_FAIL;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t) {
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t) {
+  return ESP_OK;
+}
+
+int64_t esp_timer_get_time() {
+  return (int64_t)clock_us;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char *, uint32_t, void *, UBaseType_t, TaskHandle_t *,
+                                   BaseType_t) {
+  return pdFAIL;
+}
+
+void vTaskDelete(TaskHandle_t) {}
+
+uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) {
+  return 0;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t) {
+  return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t, BaseType_t *) {}
+
+void vTaskDelay(TickType_t ticks) {
+  clock_us += (uint64_t)ticks * 1000;
+}
+
+BaseType_t xPortGetCoreID() {
+  return 0;
+}
+
+bool analogContinuous(const uint8_t *, size_t, uint32_t, uint32_t, void (*)(void)) {
+  return false;
+}
+
+bool analogContinuousRead(adc_continuous_result_t **, uint32_t) {
+  return false;
+}
+
+bool analogContinuousStart() {
+  return false;
+}
+
+bool analogContinuousStop() {
+  return true;
+}
+
+bool analogContinuousDeinit() {
+  return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Host stand-in for the Pololu QTRSensors library (declarations only)
+ */
+class QTRSensors {
+public:
+  struct CalibrationData {
+    bool initialized;
+    uint16_t *minimum;
+    uint16_t *maximum;
+  };
+
+  CalibrationData calibrationOn;
+
+  void setTypeAnalog();
+  void setSensorPins(const uint8_t *pins, uint8_t count);
+  void calibrate();
+  void read(uint16_t *values);
+  uint16_t readLineBlack(uint16_t *values);
+};
@@ -0,0 +1,261 @@
+#include "IncrementalPIDController.h"
+#include "PController.h"
+#include "PDController.h"
+#include "PIController.h"
+#include "PIDController.h"
+#include "TestHarness.h"
+
+using controller::IncrementalPIDController;
+using controller::PController;
+using controller::PDController;
+using controller::PIController;
+using controller::PIDController;
+
+namespace {
+
+  const float DT = 0.001f;
+  const float ERROR = 0.8f;
+
+  /**
+   * @brief First-order plant y' = (gain * u - y) / tau, one Euler step per control step
+   */
+  struct Plant {
+    float gain;
+    float tau;
+    float y;
+
+    Plant(float gain, float tau) : gain(gain), tau(tau), y(0.0f) {}
+
+    float step(float u) {
+      y += DT * (gain * u - y) / tau;
+      return y;
+    }
+  };
+
+  /**
+   * @brief Run a controller at a constant error and return its last output
+   */
+  template <typename Controller>
+  float run(Controller &controller, int steps) {
+    float output = 0.0f;
+    for (int k = 0; k < steps; k++) {
+      output = controller.compute(ERROR);
+    }
+    return output;
+  }
+
+  void pidRetuneHasNoStep() {
+    PIDController pid(2.0f, 5.0f, 0.01f);
+    CHECK(pid.init());
+    float output = run(pid, 50);
+
+    // At a constant error only the integral moves: Ki * dt * error per step
+    pid.setKp(6.0f);
+    CHECK_NEAR(pid.compute(ERROR), output + 5.0f * DT * ERROR, 1e-4f);
+    output = pid.getOutput();
+
+    pid.setKi(20.0f);
+    CHECK_NEAR(pid.compute(ERROR), output + 20.0f * DT * ERROR, 1e-4f);
+    output = pid.getOutput();
+
+    pid.setKd(0.05f);
+    CHECK_NEAR(pid.compute(ERROR), output + 20.0f * DT * ERROR, 1e-4f);
+    output = pid.getOutput();
+
+    pid.setGains(0.5f, 2.0f, 0.0f);
+    CHECK_NEAR(pid.compute(ERROR), output + 2.0f * DT * ERROR, 1e-4f);
+  }
+
+  void piRetuneHasNoStep() {
+    PIController pi(2.0f, 5.0f);
+    CHECK(pi.init());
+    float output = run(pi, 50);
+
+    pi.setKp(0.5f);
+    CHECK_NEAR(pi.compute(ERROR), output + 5.0f * DT * ERROR, 1e-4f);
+    output = pi.getOutput();
+
+    pi.setGains(4.0f, 1.0f);
+    CHECK_NEAR(pi.compute(ERROR), output + 1.0f * DT * ERROR, 1e-4f);
+  }
+
+  void incrementalRetuneHasNoStep() {
+    IncrementalPIDController pid(2.0f, 5.0f, 0.01f);
+    CHECK(pid.init());
+    float output = run(pid, 50);
+
+    pid.setKp(6.0f);
+    CHECK_NEAR(pid.compute(ERROR), output + 5.0f * DT * ERROR, 1e-4f);
+    output = pid.getOutput();
+
+    pid.setKi(20.0f);
+    CHECK_NEAR(pid.compute(ERROR), output + 20.0f * DT * ERROR, 1e-4f);
+    output = pid.getOutput();
+
+    pid.setKd(0.05f);
+    CHECK_NEAR(pid.compute(ERROR), output + 20.0f * DT * ERROR, 1e-4f);
+    output = pid.getOutput();
+
+    pid.setGains(0.5f, 2.0f, 0.0f);
+    CHECK_NEAR(pid.compute(ERROR), output + 2.0f * DT * ERROR, 1e-4f);
+  }
+
+  void retuneWithChangingError() {
+    // A ramping error: the retuned PID continues on the curve of a PID that
+    // had the new gains and the same output all along
+    PIDController pid(2.0f, 5.0f, 0.0f);
+    CHECK(pid.init());
+    float error = 0.0f;
+    for (int k = 0; k < 50; k++) {
+      error = 0.01f * k;
+      pid.compute(error);
+    }
+    float output = pid.getOutput();
+    pid.setKp(6.0f);
+    float next = 0.01f * 50;
+    CHECK_NEAR(pid.compute(next), output + 6.0f * (next - error) + 5.0f * DT * next, 1e-4f);
+  }
+
+  void takeOverChainHasNoStep() {
+    // P -> PD -> PID -> incremental PID at a constant error, sharing Kp
+    PController p(3.0f);
+    PDController pd(3.0f, 0.02f);
+    PIDController pid(3.0f, 10.0f, 0.02f);
+    IncrementalPIDController incremental(3.0f, 10.0f, 0.02f);
+    CHECK(p.init());
+    CHECK(pd.init());
+    CHECK(pid.init());
+    CHECK(incremental.init());
+
+    float output = run(p, 20);
+
+    // PD: the derivative history starts at the current error, so no kick
+    pd.takeOverFrom(p, ERROR);
+    CHECK_NEAR(pd.compute(ERROR), output, 1e-5f);
+    output = run(pd, 20);
+
+    pid.takeOverFrom(pd, ERROR);
+    CHECK_NEAR(pid.compute(ERROR), output + 10.0f * DT * ERROR, 1e-4f);
+    output = run(pid, 20);
+
+    incremental.takeOverFrom(pid, ERROR);
+    CHECK_NEAR(incremental.compute(ERROR), output + 10.0f * DT * ERROR, 1e-4f);
+  }
+
+  void takeOverAnyOutput() {
+    // Controllers with an integral or incremental state match any output
+    PController p(1.0f);
+    PIDController pid(3.0f, 10.0f, 0.02f);
+    IncrementalPIDController incremental(3.0f, 10.0f, 0.02f);
+    CHECK(p.init());
+    CHECK(pid.init());
+    CHECK(incremental.init());
+
+    float output = run(p, 5); // 0.8, far from 3.0 * 0.8
+    pid.takeOverFrom(p, ERROR);
+    CHECK_NEAR(pid.compute(ERROR), output + 10.0f * DT * ERROR, 1e-4f);
+    incremental.takeOverFrom(p, ERROR);
+    CHECK_NEAR(incremental.compute(ERROR), output + 10.0f * DT * ERROR, 1e-4f);
+  }
+
+  void incrementalMatchesPositionalUnsaturated() {
+    PIDController positional(4.0f, 30.0f, 0.02f);
+    IncrementalPIDController incremental(4.0f, 30.0f, 0.02f);
+    CHECK(positional.init());
+    CHECK(incremental.init());
+    Plant positional_plant(1.0f, 0.05f);
+    Plant incremental_plant(1.0f, 0.05f);
+
+    float worst = 0.0f;
+    for (int k = 0; k < 2000; k++) {
+      float setpoint = k < 1000 ? 1.0f : 0.0f; // Up, then back down
+      float u_positional = positional.compute(setpoint - positional_plant.y);
+      float u_incremental = incremental.compute(setpoint - incremental_plant.y);
+      positional_plant.step(u_positional);
+      incremental_plant.step(u_incremental);
+
+      float difference = u_positional - u_incremental;
+      difference = difference < 0.0f ? -difference : difference;
+      worst = difference > worst ? difference : worst;
+    }
+    CHECK(worst < 1e-3f);
+    CHECK_NEAR(positional_plant.y, 0.0f, 1e-3f);
+    CHECK_NEAR(incremental_plant.y, 0.0f, 1e-3f);
+  }
+
+  void incrementalDoesNotWindUp() {
+    // The setpoint needs u = 2 from a plant of gain 0.5 but the limit is 1.5,
+    // so both forms sit at the limit while the error persists. Kd is 0: a
+    // clipped derivative kick is lost to the velocity form's accumulator and
+    // would make the two differ for reasons other than the integrator
+    const float limit = 1.5f;
+    PIDController positional(1.0f, 30.0f, 0.0f, 1, -limit, limit);
+    IncrementalPIDController incremental(1.0f, 30.0f, 0.0f, 1, -limit, limit);
+    CHECK(positional.init());
+    CHECK(incremental.init());
+    Plant positional_plant(0.5f, 0.05f);
+    Plant incremental_plant(0.5f, 0.05f);
+
+    int incremental_release = -1;
+    int positional_release = -1;
+    for (int k = 0; k < 3000; k++) {
+      float setpoint = k < 1000 ? 1.0f : 0.2f;
+      float u_positional = positional.compute(setpoint - positional_plant.y);
+      float u_incremental = incremental.compute(setpoint - incremental_plant.y);
+      positional_plant.step(u_positional);
+      incremental_plant.step(u_incremental);
+
+      if (k >= 500 && k < 1000) {
+        CHECK_EQ(u_positional, limit);
+        CHECK_EQ(u_incremental, limit);
+      }
+      if (k >= 1000 && incremental_release < 0 && u_incremental < limit) {
+        incremental_release = k;
+      }
+      if (k >= 1000 && positional_release < 0 && u_positional < limit) {
+        positional_release = k;
+      }
+    }
+
+    // The clamped accumulator leaves the limit on the first reversed error;
+    // the positional integral is clamped at the limit too, so it is not later
+    CHECK_EQ(incremental_release, 1000);
+    CHECK(positional_release >= incremental_release);
+
+    // Same steady state once out of saturation (u = 0.4)
+    CHECK_NEAR(positional_plant.y, 0.2f, 1e-3f);
+    CHECK_NEAR(incremental_plant.y, 0.2f, 1e-3f);
+    CHECK_NEAR(incremental.getOutput(), positional.getOutput(), 1e-3f);
+  }
+
+  void saturatedOutputsAgreeBeforeTheLimit() {
+    // Until the first step that hits the limit the two forms are the same
+    // controller; at the limit both hold it
+    PIDController positional(4.0f, 30.0f, 0.0f, 1, -2.0f, 2.0f);
+    IncrementalPIDController incremental(4.0f, 30.0f, 0.0f, 1, -2.0f, 2.0f);
+    CHECK(positional.init());
+    CHECK(incremental.init());
+    for (int k = 0; k < 100; k++) {
+      float error = 0.004f * k; // Reaches the limit after a few dozen steps
+      float u_positional = positional.compute(error);
+      float u_incremental = incremental.compute(error);
+      CHECK_NEAR(u_incremental, u_positional, 1e-4f);
+    }
+    CHECK_EQ(positional.getOutput(), 2.0f);
+    CHECK_EQ(incremental.getOutput(), 2.0f);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(pidRetuneHasNoStep);
+  RUN_TEST(piRetuneHasNoStep);
+  RUN_TEST(incrementalRetuneHasNoStep);
+  RUN_TEST(retuneWithChangingError);
+  RUN_TEST(takeOverChainHasNoStep);
+  RUN_TEST(takeOverAnyOutput);
+  RUN_TEST(incrementalMatchesPositionalUnsaturated);
+  RUN_TEST(incrementalDoesNotWindUp);
+  RUN_TEST(saturatedOutputsAgreeBeforeTheLimit);
+  return test::finish("BumplessTransfer");
+}
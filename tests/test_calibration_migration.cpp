@@ -0,0 +1,235 @@
+#include "EEPROM.h"
+#include "EEPROMCalibrationManager.h"
+#include "GainSchedule.h"
+#include "QTRSensors.h"
+#include "TestHarness.h"
+
+using controller::GainSchedule;
+
+namespace {
+
+  const size_t EEPROM_BYTES = 512;
+  const size_t LEGACY_BYTES = 40; // Packed version 2 record: 4 + 2 × 8 × 2 + 4
+  const uint8_t VERSION_2 = EEPROMCalibrationManager::LEGACY_CALIBRATION_VERSION;
+  const uint8_t VERSION_3 = EEPROMCalibrationManager::CALIBRATION_VERSION;
+
+  const float SPEEDS[GainSchedule::SPEED_POINTS] = {100.0f, 300.0f, 600.0f, 1000.0f};
+  const float CURVATURES[GainSchedule::CURVATURE_POINTS] = {0.0f, 0.5f, 1.5f, 4.0f};
+
+  uint32_t rotl1(uint32_t value) {
+    return (value << 1) | (value >> 31);
+  }
+
+  /**
+   * @brief Write a version 2 record as the old firmware did, little-endian
+   *
+   * The checksum covers all 8 slots; slots past the sensor count stay 0.
+   *
+   * @param count: Sensors in the record
+   * @param corrupt: Store a checksum one off the right value
+   */
+  void writeLegacyRecord(uint8_t count, bool corrupt = false) {
+    uint16_t minimum[EEPROMCalibrationManager::LEGACY_MAX_SENSORS] = {};
+    uint16_t maximum[EEPROMCalibrationManager::LEGACY_MAX_SENSORS] = {};
+    for (uint8_t i = 0; i < count; i++) {
+      minimum[i] = (uint16_t)(100 + 10 * i);
+      maximum[i] = (uint16_t)(3000 + 20 * i);
+    }
+
+    uint32_t checksum = 0;
+    checksum = rotl1(checksum + EEPROMCalibrationManager::CALIBRATION_MAGIC);
+    checksum = rotl1(checksum + EEPROMCalibrationManager::LEGACY_CALIBRATION_VERSION);
+    checksum = rotl1(checksum + count);
+    for (uint8_t i = 0; i < EEPROMCalibrationManager::LEGACY_MAX_SENSORS; i++) {
+      checksum = rotl1(checksum + minimum[i]);
+      checksum = rotl1(checksum + maximum[i]);
+    }
+    if (corrupt) {
+      checksum++;
+    }
+
+    uint8_t bytes[LEGACY_BYTES];
+    size_t at = 0;
+    bytes[at++] = EEPROMCalibrationManager::CALIBRATION_MAGIC & 0xFF;
+    bytes[at++] = EEPROMCalibrationManager::CALIBRATION_MAGIC >> 8;
+    bytes[at++] = EEPROMCalibrationManager::LEGACY_CALIBRATION_VERSION;
+    bytes[at++] = count;
+    for (uint8_t i = 0; i < EEPROMCalibrationManager::LEGACY_MAX_SENSORS; i++) {
+      bytes[at++] = minimum[i] & 0xFF;
+      bytes[at++] = minimum[i] >> 8;
+    }
+    for (uint8_t i = 0; i < EEPROMCalibrationManager::LEGACY_MAX_SENSORS; i++) {
+      bytes[at++] = maximum[i] & 0xFF;
+      bytes[at++] = maximum[i] >> 8;
+    }
+    for (uint8_t b = 0; b < 4; b++) {
+      bytes[at++] = (uint8_t)(checksum >> (8 * b));
+    }
+
+    for (size_t i = 0; i < LEGACY_BYTES; i++) {
+      EEPROM.write((int)i, bytes[i]);
+    }
+    EEPROM.commit();
+  }
+
+  /**
+   * @brief Fresh EEPROM with a gain schedule behind the fixed 40-byte record
+   *
+   * An 8-sensor version 3 record is also 40 bytes, so its manager places
+   * the schedule where the old firmware kept it.
+   */
+  void writeLegacySchedule(GainSchedule &schedule) {
+    CHECK(schedule.setSpeedAxis(SPEEDS));
+    CHECK(schedule.setCurvatureAxis(CURVATURES));
+    for (uint8_t s = 0; s < GainSchedule::SPEED_POINTS; s++) {
+      for (uint8_t c = 0; c < GainSchedule::CURVATURE_POINTS; c++) {
+        CHECK(schedule.setEntry(s, c, 1.0f + s + 0.5f * c, 0.1f * s, 0.01f * c));
+      }
+    }
+    EEPROMCalibrationManager placer(8, false, EEPROM_BYTES, 0);
+    CHECK(placer.saveGainSchedule(schedule));
+  }
+
+  void snapshotImage(uint8_t *image) {
+    for (size_t i = 0; i < EEPROM_BYTES; i++) {
+      image[i] = EEPROM.read((int)i);
+    }
+  }
+
+  bool imageUnchanged(const uint8_t *image) {
+    for (size_t i = 0; i < EEPROM_BYTES; i++) {
+      if (EEPROM.read((int)i) != image[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void checkLoadedRecord(EEPROMCalibrationManager &manager, uint8_t count) {
+    uint16_t minimum[EEPROMCalibrationManager::MAX_SENSORS] = {};
+    uint16_t maximum[EEPROMCalibrationManager::MAX_SENSORS] = {};
+    QTRSensors qtr;
+    qtr.calibrationOn.minimum = minimum;
+    qtr.calibrationOn.maximum = maximum;
+    CHECK(manager.loadCalibration(qtr));
+    for (uint8_t i = 0; i < count; i++) {
+      CHECK_EQ(minimum[i], (uint16_t)(100 + 10 * i));
+      CHECK_EQ(maximum[i], (uint16_t)(3000 + 20 * i));
+    }
+  }
+
+  void validRecordMigratesAndKeepsSchedule() {
+    EEPROM.clear();
+    CHECK(EEPROM.begin(EEPROM_BYTES));
+    GainSchedule saved;
+    writeLegacySchedule(saved);
+    writeLegacyRecord(4);
+
+    EEPROMCalibrationManager manager(4, false, EEPROM_BYTES, 0);
+    CHECK(manager.isInitialized());
+    CHECK_EQ(EEPROM.read(2), VERSION_3);
+    CHECK(manager.hasValidCalibration());
+    checkLoadedRecord(manager, 4);
+
+    // 4 sensors take 8 + 4 × 4 = 24 bytes: the schedule moved up from 40 to
+    // the address the manager looks at, so finding it there proves the move
+    CHECK(manager.hasValidGainSchedule());
+    GainSchedule loaded;
+    CHECK(manager.loadGainSchedule(loaded));
+    CHECK(loaded.lookup(450.0f, 1.0f).Kp == saved.lookup(450.0f, 1.0f).Kp);
+    CHECK(loaded.lookup(777.0f, 2.2f).Ki == saved.lookup(777.0f, 2.2f).Ki);
+    CHECK(loaded.lookup(150.0f, 3.0f).Kd == saved.lookup(150.0f, 3.0f).Kd);
+
+    // A second construction finds version 3 and changes nothing
+    uint8_t migrated[EEPROM_BYTES];
+    snapshotImage(migrated);
+    EEPROMCalibrationManager again(4, false, EEPROM_BYTES, 0);
+    CHECK(imageUnchanged(migrated));
+    checkLoadedRecord(again, 4);
+  }
+
+  void fullRecordMigratesInPlace() {
+    // 8 sensors: same 40 bytes, the schedule stays where it is
+    EEPROM.clear();
+    CHECK(EEPROM.begin(EEPROM_BYTES));
+    GainSchedule saved;
+    writeLegacySchedule(saved);
+    writeLegacyRecord(8);
+
+    uint8_t before[EEPROM_BYTES];
+    snapshotImage(before);
+
+    EEPROMCalibrationManager manager(8, false, EEPROM_BYTES, 0);
+    CHECK_EQ(EEPROM.read(2), VERSION_3);
+    checkLoadedRecord(manager, 8);
+    for (size_t i = 4; i < LEGACY_BYTES - 4; i++) {
+      CHECK_EQ(EEPROM.read((int)i), before[i]); // Only the version and checksum change
+    }
+    for (size_t i = LEGACY_BYTES; i < EEPROM_BYTES; i++) {
+      CHECK_EQ(EEPROM.read((int)i), before[i]);
+    }
+    CHECK(manager.hasValidGainSchedule());
+  }
+
+  void corruptRecordIsNotRewritten() {
+    EEPROM.clear();
+    CHECK(EEPROM.begin(EEPROM_BYTES));
+    GainSchedule saved;
+    writeLegacySchedule(saved);
+    writeLegacyRecord(4, true);
+
+    uint8_t before[EEPROM_BYTES];
+    snapshotImage(before);
+
+    EEPROMCalibrationManager manager(4, false, EEPROM_BYTES, 0);
+    CHECK(manager.isInitialized());
+    CHECK(imageUnchanged(before));
+    CHECK_EQ(EEPROM.read(2), VERSION_2);
+    CHECK(!manager.hasValidCalibration());
+  }
+
+  void sensorCountMismatchIsNotRewritten() {
+    EEPROM.clear();
+    CHECK(EEPROM.begin(EEPROM_BYTES));
+    writeLegacyRecord(6);
+
+    uint8_t before[EEPROM_BYTES];
+    snapshotImage(before);
+
+    EEPROMCalibrationManager manager(4, false, EEPROM_BYTES, 0);
+    CHECK(imageUnchanged(before));
+    CHECK(!manager.hasValidCalibration());
+  }
+
+  void currentRecordIsLeftAlone() {
+    EEPROM.clear();
+    CHECK(EEPROM.begin(EEPROM_BYTES));
+    uint16_t minimum[4] = {100, 110, 120, 130};
+    uint16_t maximum[4] = {3000, 3020, 3040, 3060};
+    QTRSensors qtr;
+    qtr.calibrationOn.minimum = minimum;
+    qtr.calibrationOn.maximum = maximum;
+    {
+      EEPROMCalibrationManager writer(4, false, EEPROM_BYTES, 0);
+      CHECK(writer.saveCalibration(qtr));
+    }
+    CHECK_EQ(EEPROM.read(2), VERSION_3);
+
+    uint8_t before[EEPROM_BYTES];
+    snapshotImage(before);
+
+    EEPROMCalibrationManager manager(4, false, EEPROM_BYTES, 0);
+    CHECK(imageUnchanged(before));
+    checkLoadedRecord(manager, 4);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(validRecordMigratesAndKeepsSchedule);
+  RUN_TEST(fullRecordMigratesInPlace);
+  RUN_TEST(corruptRecordIsNotRewritten);
+  RUN_TEST(sensorCountMismatchIsNotRewritten);
+  RUN_TEST(currentRecordIsLeftAlone);
+  return test::finish("CalibrationMigration");
+}
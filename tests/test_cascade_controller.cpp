@@ -0,0 +1,167 @@
+#include "CascadeController.h"
+#include "DiffDrivePlant.h"
+#include "PIController.h"
+#include "PIDController.h"
+#include "TestHarness.h"
+#include <math.h>
+#include <stdio.h>
+
+using controller::CascadeController;
+using controller::PIController;
+using controller::PIDController;
+
+namespace {
+
+  const uint32_t INNER_RATE_HZ = 1000;
+  const float BASE_SPEED = 400.0f; // mm/s
+
+  /**
+   * @brief Outer line PID and inner wheel PIs as a cascade
+   */
+  struct Rig {
+    PIDController outer;
+    PIController left;
+    PIController right;
+    CascadeController cascade;
+
+    explicit Rig(uint8_t divider)
+        : outer(25.0f, 60.0f, 1.0f, 1, -300.0f, 300.0f), left(2.0f, 40.0f, 1), right(2.0f, 40.0f, 1),
+          cascade(outer, left, right, INNER_RATE_HZ, divider) {}
+  };
+
+  /**
+   * @brief Result of one closed-loop run
+   *
+   * @var settle_s: Last time |error| was above 1 mm on the straight
+   * @var curve_rms, curve_max: Line error on the curve (mm)
+   * @var final_error: Line error at the end (mm)
+   */
+  struct Run {
+    double settle_s;
+    double curve_rms;
+    double curve_max;
+    double final_error;
+  };
+
+  /**
+   * @brief 3 s on a straight line from a 20 mm offset, then 3 s on a 400 mm radius curve
+   */
+  Run runClosedLoop(uint8_t divider) {
+    Rig rig(divider);
+    CHECK(rig.cascade.init());
+    rig.cascade.setBaseSpeed(BASE_SPEED);
+
+    test::DiffDrivePlant plant;
+    plant.offset = 20.0;
+    const uint32_t STRAIGHT = 3 * INNER_RATE_HZ;
+    const double dt = 1.0 / INNER_RATE_HZ;
+
+    Run run = {0.0, 0.0, 0.0, 0.0};
+    double sum_squares = 0.0;
+    for (uint32_t k = 0; k < 2 * STRAIGHT; k++) {
+      if (k == STRAIGHT) {
+        plant.curvature = 1.0 / 400.0;
+      }
+      CascadeController::WheelCommand command = rig.cascade.step(
+          (float)plant.lineError(), (float)plant.left_speed, (float)plant.right_speed);
+      plant.step(command.left, command.right, dt);
+
+      double error = plant.lineError();
+      if (k < STRAIGHT && fabs(error) > 1.0) {
+        run.settle_s = (k + 1) * dt;
+      }
+      if (k >= STRAIGHT) {
+        sum_squares += error * error;
+        run.curve_max = fabs(error) > run.curve_max ? fabs(error) : run.curve_max;
+      }
+    }
+    run.curve_rms = sqrt(sum_squares / STRAIGHT);
+    run.final_error = plant.lineError();
+    return run;
+  }
+
+  void plantFollowsSignConvention() {
+    test::DiffDrivePlant plant;
+    plant.offset = -10.0; // Line 10 mm to the right: turn right
+    CHECK(plant.lineError() > 0.0);
+
+    double before = plant.lineError();
+    for (int k = 0; k < 200; k++) {
+      plant.step(300.0, 200.0, 0.001); // Left faster turns right
+    }
+    CHECK(plant.heading > 0.0);
+    CHECK(plant.lineError() < before);
+
+    test::DiffDrivePlant straight;
+    for (int k = 0; k < 1000; k++) {
+      straight.step(200.0, 200.0, 0.001);
+    }
+    CHECK_NEAR(straight.left_speed, 300.0, 1e-6);
+    CHECK_EQ(straight.lineError(), 0.0);
+  }
+
+  void sampleTimesFollowRateAndDivider() {
+    Rig rig(4);
+    CHECK(rig.cascade.init());
+    CHECK_EQ(rig.left.getSampleTime(), 0.001f);
+    CHECK_EQ(rig.right.getSampleTime(), 0.001f);
+    CHECK_EQ(rig.outer.getSampleTime(), 0.004f);
+
+    CHECK(rig.cascade.setRates(500, 5));
+    CHECK_EQ(rig.left.getSampleTime(), 0.002f);
+    CHECK_EQ(rig.outer.getSampleTime(), 0.01f);
+    CHECK(!rig.cascade.setRates(500, 0));
+    CHECK_EQ(rig.cascade.getOuterDivider(), 5u);
+  }
+
+  void outerRunsOncePerDivider() {
+    Rig rig(4);
+    CHECK(rig.cascade.init());
+    rig.cascade.setBaseSpeed(BASE_SPEED);
+
+    uint32_t outer_ticks = 0;
+    float held = 0.0f;
+    for (uint32_t k = 0; k < 40; k++) {
+      bool due = rig.cascade.isOuterDue();
+      rig.cascade.step(5.0f + k, 0.0f, 0.0f);
+      if (due) {
+        outer_ticks++;
+        held = rig.cascade.getDifferential();
+      }
+      CHECK_EQ(rig.cascade.getDifferential(), held); // Zero-order hold in between
+      CHECK_EQ(rig.cascade.getLeftTarget(), BASE_SPEED + held);
+      CHECK_EQ(rig.cascade.getRightTarget(), BASE_SPEED - held);
+    }
+    CHECK_EQ(outer_ticks, 10u);
+  }
+
+  void dividerSweep() {
+    // Outer rate from 1 kHz down to 15.6 Hz with the inner loops at 1 kHz
+    const uint8_t dividers[] = {1, 2, 4, 8, 16, 32, 64};
+    Run runs[sizeof(dividers)];
+    printf("  divider  outer Hz  settle s  curve rms mm  curve max mm  final mm\n");
+    for (size_t i = 0; i < sizeof(dividers); i++) {
+      runs[i] = runClosedLoop(dividers[i]);
+      printf("  %7u  %8.1f  %8.3f  %12.3f  %12.3f  %8.3f\n", dividers[i], (double)INNER_RATE_HZ / dividers[i],
+             runs[i].settle_s, runs[i].curve_rms, runs[i].curve_max, runs[i].final_error);
+    }
+
+    // Up to 1/32 of the inner rate the outer loop keeps its performance ...
+    for (size_t i = 0; i < 6; i++) {
+      CHECK(runs[i].settle_s < 0.6);
+      CHECK(runs[i].curve_rms < 1.0);
+      CHECK(fabs(runs[i].final_error) < 0.1);
+    }
+    // ... at 1/64 the same gains no longer hold the line on the curve
+    CHECK(runs[6].curve_rms > 5.0 * runs[2].curve_rms);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(plantFollowsSignConvention);
+  RUN_TEST(sampleTimesFollowRateAndDivider);
+  RUN_TEST(outerRunsOncePerDivider);
+  RUN_TEST(dividerSweep);
+  return test::finish("CascadeController");
+}
@@ -0,0 +1,94 @@
+#include "ContinuousAdcSource.h"
+#include "MockFrameSource.h"
+#include "TestHarness.h"
+#include <Arduino.h>
+
+using sensing::ContinuousAdcSource;
+using sensing::SensorFrame;
+
+namespace {
+
+  void constructorDoesNotPrint() {
+    // 20 pins: more than a frame holds, which begin() reports
+    static const uint8_t pins[20] = {32, 33, 34, 35, 36, 39, 32, 33, 34, 35, 36, 39, 32, 33, 34, 35, 36, 39, 32, 33};
+    uint32_t lines = host::serialLines();
+    ContinuousAdcSource source(pins, 20);
+    CHECK_EQ(host::serialLines(), lines);
+    CHECK_EQ(source.getAdc1Count(), 0u);
+
+    // The stub task creation fails, after the pin checks have run
+    CHECK(!source.begin());
+    CHECK(host::serialLines() > lines);
+    CHECK_EQ(source.getAdc1Count(), SensorFrame::MAX_SENSORS);
+  }
+
+  void adc2PinsStayOutOfTheScan() {
+    static const uint8_t pins[8] = {36, 39, 34, 35, 32, 33, 25, 26};
+    ContinuousAdcSource source(pins, 8);
+    source.begin();
+    CHECK_EQ(source.getAdc1Count(), 6u);
+    CHECK(!source.start(1000)); // No task, no scan
+    CHECK(!source.isRunning());
+    CHECK(!source.hasFrame());
+  }
+
+  void mockHandoffSingleThreaded() {
+    test::MockFrameSource source(8);
+    CHECK(!source.fetch());
+    CHECK(!source.hasFrame());
+
+    source.start(3);
+    source.wait();
+    CHECK(source.fetch()); // Only the newest of the three frames
+    CHECK_EQ(source.frame().sequence, 3u);
+    CHECK(source.isIntact(source.frame()));
+    CHECK(!source.fetch());
+    CHECK_EQ(source.frame().sequence, 3u); // Front stays put until the next fetch
+  }
+
+  void mockHandoffIsNeverTornOrOutOfOrder() {
+    const uint32_t FRAMES = 200000;
+    test::MockFrameSource source;
+    source.start(FRAMES);
+
+    uint32_t fetched = 0;
+    uint32_t torn = 0;
+    uint32_t reordered = 0;
+    uint32_t last_sequence = 0;
+    for (;;) {
+      bool producing = source.isRunning(); // Read first: a fetch after the last publish must succeed
+      if (!source.fetch()) {
+        if (!producing) {
+          break;
+        }
+        std::this_thread::yield();
+        continue;
+      }
+      const SensorFrame &frame = source.frame();
+      fetched++;
+      if (!source.isIntact(frame)) {
+        torn++;
+      }
+      if (frame.sequence <= last_sequence) {
+        reordered++;
+      }
+      last_sequence = frame.sequence;
+    }
+    source.wait();
+
+    printf("  fetched %u of %u frames\n", (unsigned)fetched, (unsigned)FRAMES);
+    CHECK(fetched > 0);
+    CHECK_EQ(torn, 0u);
+    CHECK_EQ(reordered, 0u);
+    CHECK_EQ(last_sequence, FRAMES); // The final publish is never lost
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(constructorDoesNotPrint);
+  RUN_TEST(adc2PinsStayOutOfTheScan);
+  RUN_TEST(mockHandoffSingleThreaded);
+  RUN_TEST(mockHandoffIsNeverTornOrOutOfOrder);
+  return test::finish("ContinuousAdcSource");
+}
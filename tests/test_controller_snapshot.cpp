@@ -0,0 +1,250 @@
+#include "FlightRecorder.h"
+#include "IncrementalPIDController.h"
+#include "LQRController.h"
+#include "MPCController.h"
+#include "PController.h"
+#include "PDController.h"
+#include "PIController.h"
+#include "PIDController.h"
+#include "RelayAutotuner.h"
+#include "TestHarness.h"
+#include <math.h>
+
+using namespace controller;
+
+namespace {
+
+  const int RUN_STEPS = 37;
+  const int RESUME_STEPS = 50;
+
+  float errorAt(int k) {
+    return 1.5f * sinf(0.13f * k) + 0.4f * cosf(0.71f * k);
+  }
+
+  /**
+   * @brief Run, snapshot, restore into a fresh instance and compare the continuation
+   *
+   * @param original: Initialized controller that runs first
+   * @param fresh: Initialized controller of the same configuration
+   * @param tolerance: Allowed output difference (0 = identical)
+   */
+  template <typename Controller>
+  void checkResume(Controller &original, Controller &fresh, float tolerance = 0.0f) {
+    original.setFeedForward(12.5f);
+    for (int k = 0; k < RUN_STEPS; k++) {
+      original.compute(errorAt(k));
+    }
+
+    ControllerState state = original.snapshot();
+    CHECK(state.kind == original.getKind());
+    CHECK(fresh.restore(state));
+    CHECK_EQ(fresh.getOutput(), original.getOutput());
+    CHECK_EQ(fresh.getFeedForward(), original.getFeedForward());
+
+    for (int k = RUN_STEPS; k < RUN_STEPS + RESUME_STEPS; k++) {
+      float expected = original.compute(errorAt(k));
+      float resumed = fresh.compute(errorAt(k));
+      if (tolerance == 0.0f) {
+        CHECK_EQ(resumed, expected);
+      } else {
+        CHECK_NEAR(resumed, expected, tolerance);
+      }
+    }
+  }
+
+  void pResumes() {
+    PController a(40.0f), b(40.0f);
+    CHECK(a.init() && b.init());
+    checkResume(a, b);
+  }
+
+  void piResumes() {
+    PIController a(40.0f, 300.0f), b(40.0f, 300.0f);
+    CHECK(a.init() && b.init());
+    checkResume(a, b);
+  }
+
+  void pdResumes() {
+    PDController a(40.0f, 0.5f), b(40.0f, 0.5f);
+    CHECK(a.init() && b.init());
+    a.setDerivativeFilter(80.0f);
+    b.setDerivativeFilter(80.0f);
+    checkResume(a, b);
+  }
+
+  void pidResumes() {
+    PIDController a(40.0f, 300.0f, 0.5f), b(40.0f, 300.0f, 0.5f);
+    CHECK(a.init() && b.init());
+    a.setDerivativeFilter(80.0f);
+    b.setDerivativeFilter(80.0f);
+    checkResume(a, b);
+  }
+
+  void pidResumesWithSetpoint() {
+    // Derivative on measurement: the restored setpoint is part of the state
+    PIDController a(40.0f, 300.0f, 0.5f), b(40.0f, 300.0f, 0.5f);
+    CHECK(a.init() && b.init());
+    a.setDerivativeOnMeasurement(true);
+    b.setDerivativeOnMeasurement(true);
+    a.setSetpoint(0.75f);
+    for (int k = 0; k < RUN_STEPS; k++) {
+      a.computeWithSetpoint(errorAt(k));
+    }
+    CHECK(b.restore(a.snapshot()));
+    for (int k = RUN_STEPS; k < RUN_STEPS + RESUME_STEPS; k++) {
+      CHECK_EQ(b.computeWithSetpoint(errorAt(k)), a.computeWithSetpoint(errorAt(k)));
+    }
+  }
+
+  void incrementalPidResumes() {
+    IncrementalPIDController a(40.0f, 300.0f, 0.5f), b(40.0f, 300.0f, 0.5f);
+    CHECK(a.init() && b.init());
+    checkResume(a, b);
+  }
+
+  void lqrResumes() {
+    LQRController a, b;
+    CHECK(a.init() && b.init());
+    checkResume(a, b);
+  }
+
+  void mpcResumesNearly() {
+    // The plan is not in the snapshot: the restored controller warm-starts
+    // from the restored output and converges to the same plan within a few
+    // steps, so the outputs agree closely but not bit for bit
+    MPCController a(1, -300.0f, 300.0f), b(1, -300.0f, 300.0f);
+    CHECK(a.init() && b.init());
+    checkResume(a, b, 1.0f);
+
+    MPCController c(1, -300.0f, 300.0f), d(1, -300.0f, 300.0f);
+    CHECK(c.init() && d.init());
+    c.setIterations(200);
+    d.setIterations(200);
+    checkResume(c, d, 1e-2f);
+  }
+
+  void autotunerRestartsOnRestore() {
+    RelayAutotuner a(300.0f, 0.05f), b(300.0f, 0.05f);
+    CHECK(a.init() && b.init());
+    for (int k = 0; k < 2000; k++) {
+      a.compute(errorAt(k));
+    }
+    CHECK(a.getCycleCount() > 0);
+    CHECK(b.restore(a.snapshot()));
+    CHECK_EQ(b.getCycleCount(), 0);
+    CHECK(b.getState() == RelayAutotuner::State::RUNNING);
+  }
+
+  void kindMismatchIsRejected() {
+    PIDController pid(40.0f, 300.0f, 0.5f);
+    PDController pd(40.0f, 0.5f), reference(40.0f, 0.5f);
+    CHECK(pid.init() && pd.init() && reference.init());
+    for (int k = 0; k < RUN_STEPS; k++) {
+      pid.compute(errorAt(k));
+      pd.compute(errorAt(k));
+      reference.compute(errorAt(k));
+    }
+
+    // A PID snapshot leaves the PD untouched
+    ControllerState state = pid.snapshot();
+    CHECK(!pd.restore(state));
+    CHECK_EQ(pd.getOutput(), reference.getOutput());
+    for (int k = RUN_STEPS; k < RUN_STEPS + 10; k++) {
+      CHECK_EQ(pd.compute(errorAt(k)), reference.compute(errorAt(k)));
+    }
+
+    // Neighbouring kinds with compatible layouts are still different kinds
+    IncrementalPIDController incremental(40.0f, 300.0f, 0.5f);
+    MPCController mpc;
+    LQRController lqr;
+    CHECK(incremental.init() && mpc.init() && lqr.init());
+    CHECK(!incremental.restore(state));
+    CHECK(!mpc.restore(lqr.snapshot()));
+  }
+
+  controller::ControllerState stamped(uint32_t t) {
+    ControllerState state = {};
+    state.timestamp_us = t;
+    state.output = (float)t;
+    state.kind = ControllerKind::PID;
+    return state;
+  }
+
+  void recorderKeepsNewest() {
+    rt::FlightRecorder<4> recorder;
+    CHECK_EQ(recorder.size(), (size_t)0);
+    CHECK_EQ(recorder.capacity(), (size_t)4);
+
+    // Filling: oldest first, no wrap yet
+    recorder.record(stamped(0));
+    recorder.record(stamped(1));
+    CHECK_EQ(recorder.size(), (size_t)2);
+    CHECK_EQ(recorder.get(0).timestamp_us, 0u);
+    CHECK_EQ(recorder.get(recorder.size() - 1).timestamp_us, 1u);
+
+    // Past capacity: the last four remain, in order
+    for (uint32_t t = 2; t < 11; t++) {
+      recorder.record(stamped(t));
+    }
+    CHECK_EQ(recorder.size(), (size_t)4);
+    for (size_t i = 0; i < recorder.size(); i++) {
+      CHECK_EQ(recorder.get(i).timestamp_us, (uint32_t)(7 + i));
+    }
+    CHECK_EQ(recorder.get(0).timestamp_us, 7u);
+    CHECK_EQ(recorder.get(recorder.size() - 1).timestamp_us, 10u);
+
+    // Exactly at a wrap boundary
+    recorder.record(stamped(11));
+    CHECK_EQ(recorder.get(0).timestamp_us, 8u);
+    CHECK_EQ(recorder.get(3).output, 11.0f);
+
+    recorder.clear();
+    CHECK_EQ(recorder.size(), (size_t)0);
+    recorder.record(stamped(20));
+    CHECK_EQ(recorder.get(0).timestamp_us, 20u);
+  }
+
+  void singleSlotRecorder() {
+    rt::FlightRecorder<1> recorder;
+    for (uint32_t t = 0; t < 5; t++) {
+      recorder.record(stamped(t));
+      CHECK_EQ(recorder.size(), (size_t)1);
+      CHECK_EQ(recorder.get(0).timestamp_us, t);
+    }
+  }
+
+  void recorderHoldsControllerSnapshots() {
+    // Snapshots read back from the ring restore like fresh ones
+    PIDController a(40.0f, 300.0f, 0.5f), b(40.0f, 300.0f, 0.5f);
+    CHECK(a.init() && b.init());
+    rt::FlightRecorder<8> recorder;
+    for (int k = 0; k < RUN_STEPS; k++) {
+      a.compute(errorAt(k));
+      recorder.record(a.snapshot());
+    }
+    CHECK(b.restore(recorder.get(recorder.size() - 1)));
+    CHECK_EQ(b.compute(errorAt(RUN_STEPS)), a.compute(errorAt(RUN_STEPS)));
+
+    Print out;
+    recorder.dump(out);
+    CHECK_EQ(out.lines, (uint32_t)(recorder.size() + 1)); // Header and one row each
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(pResumes);
+  RUN_TEST(piResumes);
+  RUN_TEST(pdResumes);
+  RUN_TEST(pidResumes);
+  RUN_TEST(pidResumesWithSetpoint);
+  RUN_TEST(incrementalPidResumes);
+  RUN_TEST(lqrResumes);
+  RUN_TEST(mpcResumesNearly);
+  RUN_TEST(autotunerRestartsOnRestore);
+  RUN_TEST(kindMismatchIsRejected);
+  RUN_TEST(recorderKeepsNewest);
+  RUN_TEST(singleSlotRecorder);
+  RUN_TEST(recorderHoldsControllerSnapshots);
+  return test::finish("ControllerSnapshot");
+}
@@ -0,0 +1,107 @@
+#include "BaseController.h"
+#include "PIDController.h"
+#include "TestHarness.h"
+
+namespace {
+
+  /**
+   * @brief Exposes the time step chosen by updateTimestep()
+   */
+  class TimestepProbe : public controller::BaseController {
+  public:
+    TimestepProbe() : BaseController(1) {}
+
+    float compute(float error) override {
+      (void)error;
+      return 0.0f;
+    }
+    using BaseController::compute;
+
+    void reset() override {
+      resetTimestamp();
+    }
+
+    float getDt() const { return dt; }
+    float getInvDt() const { return inv_dt; }
+  };
+
+  void everyPeriodIsMeasuredByDefault() {
+    TimestepProbe probe;
+    uint32_t now = 5000;
+    probe.compute(0.0f, now);
+
+    // Windowed acquisition: periods alternate around 1 ms
+    const uint32_t periods[] = {960, 1040, 1000, 1100, 900, 1003};
+    for (uint32_t period : periods) {
+      now += period;
+      probe.compute(0.0f, now);
+      CHECK_NEAR(probe.getDt(), period * 1e-6f, 1e-9);
+      CHECK_NEAR(probe.getInvDt(), 1e6f / period, 1e-2);
+    }
+  }
+
+  void realRateChangeIsMeasured() {
+    TimestepProbe probe;
+    uint32_t now = 0;
+    probe.compute(0.0f, now);
+
+    now += 2000; // Missed period
+    probe.compute(0.0f, now);
+    CHECK_NEAR(probe.getDt(), 0.002f, 1e-9);
+    CHECK_NEAR(probe.getInvDt(), 500.0f, 1e-3);
+
+    now += 1000; // Back on the grid
+    probe.compute(0.0f, now);
+    CHECK_EQ(probe.getDt(), 0.001f);
+
+    now = 0xFFFFFFFFu - 700; // Last call before the micros() wrap
+    probe.compute(0.0f, now);
+    now += 1500;
+    probe.compute(0.0f, now);
+    CHECK_NEAR(probe.getDt(), 0.0015f, 1e-9);
+  }
+
+  void toleranceIsOptIn() {
+    TimestepProbe probe;
+    probe.setJitterTolerance(50);
+    uint32_t now = 0;
+    probe.compute(0.0f, now);
+    now += 1040;
+    probe.compute(0.0f, now);
+    CHECK_EQ(probe.getDt(), 0.001f);
+    now += 1060; // Outside the tolerance
+    probe.compute(0.0f, now);
+    CHECK_NEAR(probe.getDt(), 0.00106f, 1e-9);
+
+    probe.setJitterTolerance(0);
+    now += 1010;
+    probe.compute(0.0f, now);
+    CHECK_NEAR(probe.getDt(), 0.00101f, 1e-9);
+  }
+
+  void steadyOffNominalPeriodIntegratesElapsedTime() {
+    // Pure integrator: the output grows by Ki × error × dt per step
+    controller::PIDController timed(0.0f, 1.0f, 0.0f, 1);
+    timed.init();
+
+    uint32_t now = 0;
+    timed.compute(1.0f, now); // First call has no interval yet
+    float previous = timed.getOutput();
+    for (int k = 0; k < 100; k++) {
+      now += 1090; // 9% slow, steadily
+      float output = timed.compute(1.0f, now);
+      CHECK_NEAR(output - previous, 0.00109f, 1e-7);
+      previous = output;
+    }
+    CHECK_NEAR(previous - 0.001f, 100 * 0.00109f, 1e-5);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(everyPeriodIsMeasuredByDefault);
+  RUN_TEST(realRateChangeIsMeasured);
+  RUN_TEST(toleranceIsOptIn);
+  RUN_TEST(steadyOffNominalPeriodIntegratesElapsedTime);
+  return test::finish("Controller timestep");
+}
@@ -0,0 +1,129 @@
+#include "PidCore.h"
+#include "TestHarness.h"
+#include <math.h>
+#include <stdio.h>
+
+using controller::PDTraits;
+using controller::Pid;
+
+namespace {
+
+  const float DT = 0.001f; // 1 kHz, the line loop rate
+  const double PI = 3.14159265358979;
+
+  /**
+   * @brief Amplitude of the D term for a unit sine error at freq_hz
+   *
+   * Kp = 0 and Kd = 1, so the output is the (filtered) backward difference
+   * of the error. The amplitude is the DFT bin at freq_hz over whole
+   * periods, after the filter transient has died out.
+   */
+  double dAmplitude(float cutoff_hz, double freq_hz) {
+    Pid<PDTraits> core(0.0f, 0.0f, 1.0f, DT, -1e9f, 1e9f);
+    core.setDerivativeFilter(cutoff_hz);
+
+    uint32_t period = (uint32_t)lround(1.0 / (freq_hz * DT));
+    uint32_t settle = 20 * period + 2000;
+    uint32_t measure = 20 * period;
+    double re = 0.0;
+    double im = 0.0;
+    for (uint32_t k = 0; k < settle + measure; k++) {
+      double phase = 2.0 * PI * freq_hz * k * DT;
+      float output = core.compute((float)sin(phase));
+      if (k >= settle) {
+        re += output * cos(phase);
+        im += output * sin(phase);
+      }
+    }
+    return 2.0 * sqrt(re * re + im * im) / measure;
+  }
+
+  /**
+   * @brief Gain of the filter alone: filtered over raw D amplitude
+   */
+  double filterGain(float cutoff_hz, double freq_hz) {
+    return dAmplitude(cutoff_hz, freq_hz) / dAmplitude(0.0f, freq_hz);
+  }
+
+  /**
+   * @brief |H| of D[k] = D[k-1] + alpha * (x[k] - D[k-1]) at freq_hz
+   */
+  double expectedGain(float cutoff_hz, double freq_hz) {
+    double w = 2.0 * PI * cutoff_hz * DT;
+    double alpha = w / (1.0 + w);
+    double theta = 2.0 * PI * freq_hz * DT;
+    double re = 1.0 - (1.0 - alpha) * cos(theta);
+    double im = (1.0 - alpha) * sin(theta);
+    return alpha / sqrt(re * re + im * im);
+  }
+
+  void unfilteredIsTheBackwardDifference() {
+    // |1 - exp(-j w T)| / T = 2 sin(w T / 2) / T
+    const double frequencies[] = {2.0, 10.0, 50.0, 125.0};
+    for (double f : frequencies) {
+      double expected = 2.0 * sin(PI * f * DT) / DT;
+      CHECK_NEAR(dAmplitude(0.0f, f), expected, expected * 1e-3);
+    }
+  }
+
+  void responseMatchesFirstOrderIir() {
+    const float cutoff = 20.0f;
+    const double frequencies[] = {1.0, 5.0, 10.0, 20.0, 40.0, 100.0, 200.0, 250.0};
+    printf("  fc = %.0f Hz at %.0f Hz:\n", cutoff, 1.0 / DT);
+    for (double f : frequencies) {
+      double measured = filterGain(cutoff, f);
+      double expected = expectedGain(cutoff, f);
+      printf("    %6.1f Hz  %6.3f (%6.2f dB)\n", f, measured, 20.0 * log10(measured));
+      CHECK_NEAR(measured, expected, expected * 0.01);
+    }
+  }
+
+  void cutoffIsMinus3dB() {
+    // Backward Euler puts -3 dB at fc while fc << fs; it drifts as fc nears fs
+    const float cutoffs[] = {5.0f, 10.0f, 20.0f};
+    for (float fc : cutoffs) {
+      double gain = filterGain(fc, fc);
+      printf("  gain at fc = %4.0f Hz: %.3f\n", fc, gain);
+      CHECK_NEAR(gain, 1.0 / sqrt(2.0), 0.025);
+    }
+
+    // At fs / 20 the filter already cuts harder than -3 dB at fc
+    double gain = filterGain(50.0f, 50.0);
+    printf("  gain at fc = %4.0f Hz: %.3f\n", 50.0, gain);
+    CHECK(gain < 1.0 / sqrt(2.0) - 0.025);
+    CHECK(gain > 0.6);
+  }
+
+  void passbandAndRolloff() {
+    const float cutoff = 20.0f;
+    CHECK(filterGain(cutoff, 1.0) > 0.99);            // fc / 20: untouched
+    CHECK(filterGain(cutoff, 10.0 * cutoff) < 0.15);  // First order: ~ -20 dB a decade
+    CHECK(filterGain(cutoff, 10.0 * cutoff) > 0.05);  // ... and not more
+  }
+
+  void disablingRestoresRawDerivative() {
+    Pid<PDTraits> raw(0.0f, 0.0f, 1.0f, DT, -1e9f, 1e9f);
+    Pid<PDTraits> toggled(0.0f, 0.0f, 1.0f, DT, -1e9f, 1e9f);
+    toggled.setDerivativeFilter(20.0f);
+    toggled.setDerivativeFilter(0.0f);
+    toggled.setDerivativeFilter(-5.0f); // Negative cutoffs also disable
+    uint32_t mismatches = 0;
+    for (uint32_t k = 0; k < 1000; k++) {
+      float error = sinf(k * 0.05f);
+      if (raw.compute(error) != toggled.compute(error)) {
+        mismatches++;
+      }
+    }
+    CHECK_EQ(mismatches, 0u);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(unfilteredIsTheBackwardDifference);
+  RUN_TEST(responseMatchesFirstOrderIir);
+  RUN_TEST(cutoffIsMinus3dB);
+  RUN_TEST(passbandAndRolloff);
+  RUN_TEST(disablingRestoresRawDerivative);
+  return test::finish("Derivative filter");
+}
@@ -0,0 +1,137 @@
+#include "BaseController.h"
+#include "FixedPoint.h"
+#include "PidCore.h"
+#include "TestHarness.h"
+#include <random>
+
+using numeric::Q16_16;
+using numeric::Q17_15;
+
+namespace {
+
+  const double LSB16 = 1.0 / 65536.0;
+
+  std::mt19937 rng(12345);
+
+  double uniform(double low, double high) {
+    return std::uniform_real_distribution<double>(low, high)(rng);
+  }
+
+  /**
+   * @brief Exact value of a fixed-point number
+   */
+  template <typename T>
+  double exact(T value) {
+    return (double)value.raw / T::ONE;
+  }
+
+  void conversionRoundsToNearest() {
+    double worst = 0.0;
+    for (int i = 0; i < 100000; i++) {
+      float x = (float)uniform(-30000.0, 30000.0);
+      if (i & 1) {
+        x *= 0.005f; // Also the range where x * 2^16 crosses 2^23
+      }
+      worst = fmax(worst, fabs(exact(Q16_16(x)) - x));
+    }
+    CHECK(worst <= 0.5 * LSB16);
+
+    CHECK_EQ(Q16_16(1.5f).raw, 3 * 32768);
+    CHECK_EQ(Q16_16(-1.5f).raw, -3 * 32768);
+    CHECK_EQ(Q17_15(1.0f).raw, 32768);
+    CHECK_EQ(Q16_16(2.75f).toInt(), 3);
+    CHECK_EQ(Q16_16(-2.25f).toInt(), -2);
+  }
+
+  void arithmeticErrorIsBounded() {
+    double add_worst = 0.0;
+    double mul_worst = 0.0;
+    double div_worst = 0.0;
+    for (int i = 0; i < 100000; i++) {
+      Q16_16 a(uniform(-150.0, 150.0));
+      Q16_16 b(uniform(-150.0, 150.0));
+      double ea = exact(a);
+      double eb = exact(b);
+
+      add_worst = fmax(add_worst, fabs(exact(a + b) - (ea + eb)));
+      add_worst = fmax(add_worst, fabs(exact(a - b) - (ea - eb)));
+      mul_worst = fmax(mul_worst, fabs(exact(a * b) - ea * eb));
+      if (fabs(eb) > 0.01) {
+        double quotient = ea / eb;
+        if (fabs(quotient) < 30000.0) {
+          div_worst = fmax(div_worst, fabs(exact(a / b) - quotient));
+        }
+      }
+    }
+    printf("  worst error in LSB: add %.3f, mul %.3f, div %.3f\n", add_worst / LSB16, mul_worst / LSB16,
+           div_worst / LSB16);
+    CHECK_EQ(add_worst, 0.0);          // Exact inside the range
+    CHECK(mul_worst <= 0.5 * LSB16);   // Rounded to nearest
+    CHECK(div_worst <= 0.5 * LSB16);
+  }
+
+  void arithmeticSaturatesInsteadOfWrapping() {
+    Q16_16 big(30000.0f);
+    CHECK_EQ((big + big).raw, Q16_16::RAW_MAX);
+    CHECK_EQ((-big - big).raw, Q16_16::RAW_MIN);
+    CHECK_EQ((big * Q16_16(2.0f)).raw, Q16_16::RAW_MAX);
+    CHECK_EQ((big * Q16_16(-2.0f)).raw, Q16_16::RAW_MIN);
+    CHECK_EQ((big / Q16_16(0.5f)).raw, Q16_16::RAW_MAX);
+    CHECK_EQ((Q16_16(1.0f) / Q16_16()).raw, Q16_16::RAW_MAX);
+    CHECK_EQ((Q16_16(-1.0f) / Q16_16()).raw, Q16_16::RAW_MIN);
+    CHECK_EQ((-Q16_16::fromRaw(Q16_16::RAW_MIN)).raw, Q16_16::RAW_MAX);
+    CHECK_EQ(Q16_16(1.0e9f).raw, Q16_16::RAW_MAX);
+    CHECK_EQ(Q16_16(-1.0e9f).raw, Q16_16::RAW_MIN);
+    CHECK_EQ(Q16_16::fromInt(70000).raw, Q16_16::RAW_MAX);
+  }
+
+  /**
+   * @brief BaseController::applyLimits, reachable for the comparison
+   */
+  struct LimitProbe : public controller::BaseController {
+    float compute(float error) override { return error; }
+    void reset() override {}
+    float limit(float value, float min, float max) const { return applyLimits(value, min, max); }
+  };
+
+  void clampMatchesApplyLimits() {
+    LimitProbe probe;
+    const float values[] = {-2000.0f, -1023.0f, -5.5f, 0.0f, 5.5f, 1023.0f, 2000.0f};
+    for (float value : values) {
+      float reference = probe.limit(value, -1023.0f, 1023.0f);
+      float fixed =
+          (float)controller::policy::Saturate::apply(Q16_16(value), Q16_16(-1023.0f), Q16_16(1023.0f));
+      float plain = controller::policy::Saturate::apply(value, -1023.0f, 1023.0f);
+      CHECK_EQ(fixed, reference);
+      CHECK_EQ(plain, reference);
+    }
+  }
+
+  void fixedPidTracksFloatPid() {
+    // dt = 1/1024 s is exact in Q16.16, so only the per-step rounding differs
+    const float dt = 1.0f / 1024.0f;
+    controller::Pid<controller::PIDTraits> reference(250.0f, 20.0f, 0.5f, dt);
+    controller::Pid<controller::PIDTraitsQ16> fixed(Q16_16(250.0f), Q16_16(20.0f), Q16_16(0.5f), Q16_16(dt));
+
+    double worst = 0.0;
+    for (int k = 0; k < 20000; k++) {
+      float error = 2.0f * sinf(k * 0.002f) + (float)uniform(-0.05, 0.05);
+      float expected = reference.compute(error);
+      float actual = (float)fixed.compute(Q16_16(error));
+      worst = fmax(worst, fabs(actual - expected));
+    }
+    printf("  worst |Q16.16 - float| over 20000 PID steps: %.4f (output range ±1023)\n", worst);
+    // The D term multiplies the quantized error difference by Kd/dt = 512
+    CHECK(worst <= 512.0 * LSB16 * 2.0 + 0.05);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(conversionRoundsToNearest);
+  RUN_TEST(arithmeticErrorIsBounded);
+  RUN_TEST(arithmeticSaturatesInsteadOfWrapping);
+  RUN_TEST(clampMatchesApplyLimits);
+  RUN_TEST(fixedPidTracksFloatPid);
+  return test::finish("FixedPoint");
+}
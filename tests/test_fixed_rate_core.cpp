@@ -0,0 +1,167 @@
+#include "FixedRateCore.h"
+#include "TestHarness.h"
+#include <Arduino.h>
+
+using rt::FixedRateCore;
+
+namespace {
+
+  /**
+   * @brief Run one iteration at the current simulated time that takes exec_us
+   *
+   * @return bool true if the iteration overran
+   */
+  bool runCycle(FixedRateCore &core, uint32_t exec_us) {
+    core.beginCycle(micros());
+    host::advanceMicros(exec_us);
+    return core.endCycle(micros());
+  }
+
+  void rateIsClampedToSupportedBand() {
+    FixedRateCore core(500);
+    CHECK_EQ(core.getRateHz(), FixedRateCore::MIN_RATE_HZ);
+    CHECK(!core.setRate(8000));
+    CHECK_EQ(core.getRateHz(), FixedRateCore::MAX_RATE_HZ);
+    CHECK_EQ(core.getPeriodUs(), 200u);
+    CHECK(core.setRate(3000));
+    CHECK_EQ(core.getPeriodUs(), 333u);
+  }
+
+  void firstReleaseIsOnePeriodAfterStart() {
+    host::setMicros(10000);
+    FixedRateCore core(1000);
+    core.start(micros());
+
+    host::advanceMicros(999);
+    CHECK(!core.isDue(micros()));
+    host::advanceMicros(1);
+    CHECK(core.isDue(micros()));
+  }
+
+  void onTimeCyclesReleaseEveryPeriod() {
+    host::setMicros(0);
+    FixedRateCore core(2000);
+    core.start(micros());
+
+    uint32_t released = 0;
+    while (micros() < 10000) { // 10 ms in 1 µs steps
+      host::advanceMicros(1);
+      if (core.isDue(micros())) {
+        CHECK(!runCycle(core, 120));
+        released++;
+      }
+    }
+    CHECK_EQ(released, 20u);
+    CHECK_EQ(core.getStats().cycles, 20u);
+    CHECK_EQ(core.getStats().missed_periods, 0u);
+    CHECK_EQ(core.getStats().overruns, 0u);
+    CHECK_EQ(core.getStats().last_exec_us, 120u);
+  }
+
+  void lateStartWithinPeriodIsLatencyNotMiss() {
+    host::setMicros(0);
+    FixedRateCore core(1000);
+    core.start(micros());
+
+    host::advanceMicros(1300); // Released at 1000, started 300 µs late
+    CHECK_EQ(core.beginCycle(micros()), 0u);
+    CHECK_EQ(core.getStats().max_latency_us, 300u);
+    host::advanceMicros(100);
+    CHECK(!core.endCycle(micros()));
+  }
+
+  void overrunIsCountedAtDeadline() {
+    host::setMicros(0);
+    FixedRateCore core(1000);
+    core.start(micros());
+
+    host::advanceMicros(1000);
+    CHECK(!runCycle(core, 1000)); // Ends exactly at the deadline
+    host::setMicros(2000);
+    CHECK(runCycle(core, 1001));
+    CHECK_EQ(core.getStats().overruns, 1u);
+    CHECK_EQ(core.getStats().max_exec_us, 1001u);
+  }
+
+  void missedPeriodsAreSkippedNotBurst() {
+    host::setMicros(0);
+    FixedRateCore core(1000);
+    core.start(micros());
+
+    host::advanceMicros(1000);
+    runCycle(core, 3500); // Long iteration: releases at 2000, 3000, 4000 pass
+    CHECK_EQ(micros(), 4500u);
+    CHECK(core.isDue(micros()));
+    CHECK_EQ(core.beginCycle(micros()), 2u); // 2000 and 3000 skipped, 4000 runs
+    CHECK_EQ(core.getStats().missed_periods, 2u);
+    CHECK_EQ(core.getStats().max_latency_us, 500u);
+    core.endCycle(micros());
+
+    // The schedule continues on the original grid, no catch-up burst
+    CHECK(!core.isDue(micros()));
+    host::setMicros(4999);
+    CHECK(!core.isDue(micros()));
+    host::setMicros(5000);
+    CHECK(core.isDue(micros()));
+  }
+
+  void scheduleSurvivesMicrosWraparound() {
+    // Start 2.5 periods before the 32-bit counter wraps
+    host::setMicros(0xFFFFFFFFull - 2500 + 1);
+    FixedRateCore core(1000);
+    core.start(micros());
+
+    uint32_t released = 0;
+    while (micros() >= 0x80000000u || micros() < 7500) { // Until 10 ms after start
+      host::advanceMicros(1);
+      if (core.isDue(micros())) {
+        runCycle(core, 50);
+        released++;
+      }
+    }
+    CHECK(micros() < 10000u); // The counter did wrap
+    CHECK_EQ(released, 10u);
+    CHECK_EQ(core.getStats().missed_periods, 0u);
+    CHECK_EQ(core.getStats().overruns, 0u);
+    CHECK(core.getStats().max_latency_us <= 1u);
+  }
+
+  void overrunAcrossWraparound() {
+    host::setMicros(0xFFFFFFFFull - 1500 + 1);
+    FixedRateCore core(1000);
+    core.start(micros());
+
+    host::advanceMicros(1000);
+    CHECK(runCycle(core, 1200)); // Crosses the wrap and the deadline
+    CHECK_EQ(core.getStats().overruns, 1u);
+    CHECK_EQ(core.getStats().last_exec_us, 1200u);
+  }
+
+  void startClearsStatistics() {
+    host::setMicros(0);
+    FixedRateCore core(1000);
+    core.start(micros());
+    host::advanceMicros(5000);
+    runCycle(core, 2000);
+    CHECK(core.getStats().missed_periods > 0);
+
+    core.start(micros());
+    CHECK_EQ(core.getStats().cycles, 0u);
+    CHECK_EQ(core.getStats().missed_periods, 0u);
+    CHECK_EQ(core.getStats().overruns, 0u);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(rateIsClampedToSupportedBand);
+  RUN_TEST(firstReleaseIsOnePeriodAfterStart);
+  RUN_TEST(onTimeCyclesReleaseEveryPeriod);
+  RUN_TEST(lateStartWithinPeriodIsLatencyNotMiss);
+  RUN_TEST(overrunIsCountedAtDeadline);
+  RUN_TEST(missedPeriodsAreSkippedNotBurst);
+  RUN_TEST(scheduleSurvivesMicrosWraparound);
+  RUN_TEST(overrunAcrossWraparound);
+  RUN_TEST(startClearsStatistics);
+  return test::finish("FixedRateCore");
+}
@@ -0,0 +1,263 @@
+#include "EEPROM.h"
+#include "EEPROMCalibrationManager.h"
+#include "GainSchedule.h"
+#include "TestHarness.h"
+
+using controller::GainSchedule;
+
+namespace {
+
+  const float SPEEDS[GainSchedule::SPEED_POINTS] = {100.0f, 300.0f, 600.0f, 1000.0f};
+  const float CURVATURES[GainSchedule::CURVATURE_POINTS] = {0.0f, 0.5f, 1.5f, 4.0f};
+
+  // One Q16.16 LSB per blend, three blends per lookup
+  const float TOLERANCE = 4.0f / 65536.0f;
+
+  /**
+   * @brief Gains bilinear in the breakpoint indices, so interpolation reproduces them
+   */
+  float kp(float s, float c) { return 1.0f + 0.5f * s + 0.25f * c; }
+  float ki(float s, float c) { return 0.1f * s + 0.05f * c * s; }
+  float kd(float s, float c) { return 0.02f + 0.001f * s + 0.01f * c; }
+
+  /**
+   * @brief Fractional breakpoint index of a value on an axis, clamped to its ends
+   */
+  float axisIndex(const float *axis, uint8_t count, float value) {
+    if (value <= axis[0]) {
+      return 0.0f;
+    }
+    for (uint8_t i = 0; i + 1 < count; i++) {
+      if (value < axis[i + 1]) {
+        return i + (value - axis[i]) / (axis[i + 1] - axis[i]);
+      }
+    }
+    return (float)(count - 1);
+  }
+
+  void fillSchedule(GainSchedule &schedule) {
+    CHECK(schedule.setSpeedAxis(SPEEDS));
+    CHECK(schedule.setCurvatureAxis(CURVATURES));
+    for (uint8_t s = 0; s < GainSchedule::SPEED_POINTS; s++) {
+      for (uint8_t c = 0; c < GainSchedule::CURVATURE_POINTS; c++) {
+        CHECK(schedule.setEntry(s, c, kp(s, c), ki(s, c), kd(s, c)));
+      }
+    }
+  }
+
+  void checkLookup(const GainSchedule &schedule, float speed, float curvature) {
+    float s = axisIndex(SPEEDS, GainSchedule::SPEED_POINTS, speed);
+    float c = axisIndex(CURVATURES, GainSchedule::CURVATURE_POINTS, curvature);
+    GainSchedule::Gains gains = schedule.lookup(speed, curvature);
+    CHECK_NEAR(gains.Kp.toFloat(), kp(s, c), TOLERANCE);
+    CHECK_NEAR(gains.Ki.toFloat(), ki(s, c), TOLERANCE);
+    CHECK_NEAR(gains.Kd.toFloat(), kd(s, c), TOLERANCE);
+  }
+
+  void breakpointsAreExact() {
+    GainSchedule schedule;
+    fillSchedule(schedule);
+    for (uint8_t s = 0; s < GainSchedule::SPEED_POINTS; s++) {
+      for (uint8_t c = 0; c < GainSchedule::CURVATURE_POINTS; c++) {
+        GainSchedule::Gains gains = schedule.lookup(SPEEDS[s], CURVATURES[c]);
+        CHECK(gains.Kp == schedule.getEntry(s, c).Kp);
+        CHECK(gains.Ki == schedule.getEntry(s, c).Ki);
+        CHECK(gains.Kd == schedule.getEntry(s, c).Kd);
+      }
+    }
+  }
+
+  void interiorIsBilinear() {
+    GainSchedule schedule;
+    fillSchedule(schedule);
+
+    // The ki term is bilinear (s * c), the others linear
+    for (float speed = 100.0f; speed <= 1000.0f; speed += 37.0f) {
+      for (float curvature = 0.0f; curvature <= 4.0f; curvature += 0.13f) {
+        checkLookup(schedule, speed, curvature);
+      }
+    }
+
+    // Segment midpoints of uneven widths
+    checkLookup(schedule, 200.0f, 0.25f);
+    checkLookup(schedule, 450.0f, 1.0f);
+    checkLookup(schedule, 800.0f, 2.75f);
+  }
+
+  void axisEndsClamp() {
+    GainSchedule schedule;
+    fillSchedule(schedule);
+    const uint8_t last_s = GainSchedule::SPEED_POINTS - 1;
+    const uint8_t last_c = GainSchedule::CURVATURE_POINTS - 1;
+
+    CHECK(schedule.lookup(0.0f, -1.0f).Kp == schedule.getEntry(0, 0).Kp);
+    CHECK(schedule.lookup(-500.0f, 0.0f).Ki == schedule.getEntry(0, 0).Ki);
+    CHECK(schedule.lookup(5000.0f, 100.0f).Kp == schedule.getEntry(last_s, last_c).Kp);
+    CHECK(schedule.lookup(1000.0f, 4.0f).Kd == schedule.getEntry(last_s, last_c).Kd);
+
+    // One axis clamped, the other interpolated
+    checkLookup(schedule, 2000.0f, 1.0f);
+    checkLookup(schedule, 450.0f, -2.0f);
+  }
+
+  void nonIncreasingAxisIsRejected() {
+    GainSchedule schedule;
+    fillSchedule(schedule);
+    const float flat[] = {0.0f, 1.0f, 1.0f, 2.0f};
+    const float falling[] = {400.0f, 300.0f, 200.0f, 100.0f};
+    CHECK(!schedule.setCurvatureAxis(flat));
+    CHECK(!schedule.setSpeedAxis(falling));
+
+    // The previous axes stay in force
+    checkLookup(schedule, 450.0f, 1.0f);
+  }
+
+  void unchangedGainsSkipRetune() {
+    GainSchedule schedule;
+    fillSchedule(schedule);
+    controller::PIDController pid(1.0f, 0.1f, 0.0f);
+    CHECK(pid.init());
+
+    CHECK(schedule.apply(pid, 450.0f, 1.0f));
+    CHECK_NEAR(pid.getKp(), schedule.lookup(450.0f, 1.0f).Kp.toFloat(), 1e-6f);
+    CHECK(!schedule.apply(pid, 450.0f, 1.0f));
+
+    // A step smaller than one Q16.16 LSB on the curvature axis changes nothing
+    CHECK(!schedule.apply(pid, 450.0f, 1.0f + 1e-6f));
+    CHECK(schedule.apply(pid, 450.0f, 1.1f));
+
+    // Clamped operating points past the axis end are all the same gains
+    CHECK(schedule.apply(pid, 2000.0f, 5.0f));
+    CHECK(!schedule.apply(pid, 3000.0f, 9.0f));
+
+    schedule.invalidate();
+    CHECK(schedule.apply(pid, 3000.0f, 9.0f));
+
+    // Editing the table forgets the last gains too
+    CHECK(schedule.setEntry(0, 0, 1.0f, 0.0f, 0.0f));
+    CHECK(schedule.apply(pid, 3000.0f, 9.0f));
+  }
+
+  void pidRetuneIsBumplessPdIsNot() {
+    GainSchedule schedule;
+    fillSchedule(schedule);
+    const float error = 0.8f;
+    const uint32_t period = 1000;
+
+    controller::PIDController pid(1.0f, 0.1f, 0.0f);
+    controller::PDController pd(1.0f, 0.0f);
+    CHECK(pid.init());
+    CHECK(pd.init());
+    CHECK(schedule.apply(pid, 300.0f, 0.0f));
+    schedule.invalidate();
+    CHECK(schedule.apply(pd, 300.0f, 0.0f));
+
+    uint32_t now = 1000;
+    float pid_output = 0.0f;
+    float pd_output = 0.0f;
+    for (int k = 0; k < 20; k++) {
+      now += period;
+      pid_output = pid.compute(error, now);
+      pd_output = pd.compute(error, now);
+    }
+
+    schedule.invalidate();
+    CHECK(schedule.apply(pid, 600.0f, 1.5f));
+    schedule.invalidate();
+    CHECK(schedule.apply(pd, 600.0f, 1.5f));
+    float kp_step = kp(2, 2) - kp(1, 0);
+    now += period;
+
+    // The integral absorbs the Kp change; only its own growth shows
+    CHECK_NEAR(pid.compute(error, now), pid_output + pid.getKi() * error * period * 1e-6f, 1e-4f);
+
+    // The PD output steps by ΔKp·error, as the PD overload documents
+    CHECK_NEAR(pd.compute(error, now) - pd_output, kp_step * error, 1e-4f);
+  }
+
+  void eepromRoundTrip() {
+    EEPROM.clear();
+    CHECK(EEPROM.begin(512));
+    EEPROMCalibrationManager manager(8, false, 512, 0);
+    CHECK(manager.isInitialized());
+    CHECK(!manager.hasValidGainSchedule());
+
+    GainSchedule saved;
+    fillSchedule(saved);
+    CHECK(manager.saveGainSchedule(saved));
+    CHECK(manager.hasValidGainSchedule());
+
+    GainSchedule loaded;
+    CHECK(manager.loadGainSchedule(loaded));
+    for (uint8_t s = 0; s < GainSchedule::SPEED_POINTS; s++) {
+      CHECK(loaded.getSpeedAxis()[s] == saved.getSpeedAxis()[s]);
+    }
+    for (uint8_t c = 0; c < GainSchedule::CURVATURE_POINTS; c++) {
+      CHECK(loaded.getCurvatureAxis()[c] == saved.getCurvatureAxis()[c]);
+    }
+    for (uint8_t s = 0; s < GainSchedule::SPEED_POINTS; s++) {
+      for (uint8_t c = 0; c < GainSchedule::CURVATURE_POINTS; c++) {
+        CHECK(loaded.getEntry(s, c).Kp == saved.getEntry(s, c).Kp);
+        CHECK(loaded.getEntry(s, c).Ki == saved.getEntry(s, c).Ki);
+        CHECK(loaded.getEntry(s, c).Kd == saved.getEntry(s, c).Kd);
+      }
+    }
+
+    // The restored reciprocals interpolate the same way
+    CHECK(loaded.lookup(450.0f, 1.0f).Kp == saved.lookup(450.0f, 1.0f).Kp);
+    CHECK(loaded.lookup(777.0f, 2.2f).Ki == saved.lookup(777.0f, 2.2f).Ki);
+  }
+
+  void corruptBlockIsNotLoaded() {
+    EEPROM.clear();
+    CHECK(EEPROM.begin(512));
+    EEPROMCalibrationManager manager(8, false, 512, 0);
+    CHECK(manager.isInitialized());
+
+    GainSchedule saved;
+    fillSchedule(saved);
+    CHECK(manager.saveGainSchedule(saved));
+
+    // Flip one bit in the last byte of the stored block
+    int address = -1;
+    for (int i = 511; i >= 0 && address < 0; i--) {
+      if (EEPROM.read(i) != 0xFF) {
+        address = i;
+      }
+    }
+    CHECK(address > 0);
+    EEPROM.write(address, EEPROM.read(address) ^ 0x01);
+
+    GainSchedule loaded;
+    const GainSchedule::Value before = loaded.getEntry(1, 1).Kp;
+    CHECK(!manager.hasValidGainSchedule());
+    CHECK(!manager.loadGainSchedule(loaded));
+    CHECK(loaded.getEntry(1, 1).Kp == before);
+  }
+
+  void tooSmallEepromIsRejected() {
+    EEPROM.clear();
+    CHECK(EEPROM.begin(64));
+    EEPROMCalibrationManager manager(8, false, 64, 0);
+    CHECK(manager.isInitialized());
+
+    GainSchedule schedule;
+    fillSchedule(schedule);
+    CHECK(!manager.saveGainSchedule(schedule));
+    CHECK(manager.getLastError() == EEPROMCalibrationManager::ErrorCode::INSUFFICIENT_SPACE);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(breakpointsAreExact);
+  RUN_TEST(interiorIsBilinear);
+  RUN_TEST(axisEndsClamp);
+  RUN_TEST(nonIncreasingAxisIsRejected);
+  RUN_TEST(unchangedGainsSkipRetune);
+  RUN_TEST(pidRetuneIsBumplessPdIsNot);
+  RUN_TEST(eepromRoundTrip);
+  RUN_TEST(corruptBlockIsNotLoaded);
+  RUN_TEST(tooSmallEepromIsRejected);
+  return test::finish("GainSchedule");
+}
@@ -0,0 +1,205 @@
+#include "LineKalmanFilter.h"
+#include "TestHarness.h"
+#include <math.h>
+#include <stdlib.h>
+
+using sensing::LineKalmanFilter;
+
+namespace {
+
+  /**
+   * @brief Model parameters: dt in s, accel_noise in pitches/s², position_noise in pitches
+   */
+  struct Model {
+    double dt;
+    double accel_noise;
+    double position_noise;
+  };
+
+  const Model MODELS[] = {
+      {0.001, 500.0, 0.02}, // The sketch defaults
+      {0.001, 50.0, 0.05},
+      {0.001, 5000.0, 0.01},
+      {0.002, 500.0, 0.02},
+  };
+
+  /**
+   * @brief Reference filter: full covariance and Riccati update in double every step
+   */
+  struct ReferenceFilter {
+    double dt, q, r;
+    double position, velocity;
+    double p00, p01, p11;
+    double k0, k1;
+
+    explicit ReferenceFilter(const Model &model)
+        : dt(model.dt), q(model.accel_noise), r(model.position_noise), position(0.0), velocity(0.0), p00(1e3),
+          p01(0.0), p11(1e6), k0(0.0), k1(0.0) {}
+
+    void update(double measured) {
+      // Predict with the discrete white-acceleration process noise
+      double q00 = q * q * dt * dt * dt * dt / 4.0;
+      double q01 = q * q * dt * dt * dt / 2.0;
+      double q11 = q * q * dt * dt;
+      double predicted = position + dt * velocity;
+      double m00 = p00 + 2.0 * dt * p01 + dt * dt * p11 + q00;
+      double m01 = p01 + dt * p11 + q01;
+      double m11 = p11 + q11;
+
+      // Correct
+      double s = m00 + r * r;
+      k0 = m00 / s;
+      k1 = m01 / s;
+      double residual = measured - predicted;
+      position = predicted + k0 * residual;
+      velocity += k1 * residual;
+      p00 = (1.0 - k0) * m00;
+      p01 = (1.0 - k0) * m01;
+      p11 = m11 - k1 * m01;
+    }
+  };
+
+  double gaussian() {
+    // Box-Muller on rand(), so the sequence is the same on every run
+    double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+  }
+
+  void steadyStateGainMatchesRiccati() {
+    for (const Model &model : MODELS) {
+      ReferenceFilter reference(model);
+      for (int k = 0; k < 20000; k++) {
+        reference.update(0.0); // The gain does not depend on the measurements
+      }
+
+      LineKalmanFilter filter((float)model.dt, (float)model.accel_noise, (float)model.position_noise);
+      CHECK_NEAR(filter.getPositionGain(), reference.k0, 1e-5 * reference.k0);
+      CHECK_NEAR(filter.getVelocityGain(), reference.k1, 1e-5 * reference.k1);
+    }
+  }
+
+  void trackMatchesReferenceFilter() {
+    srand(24);
+    for (const Model &model : MODELS) {
+      ReferenceFilter reference(model);
+      LineKalmanFilter filter((float)model.dt, (float)model.accel_noise, (float)model.position_noise);
+
+      // A line wandering with white acceleration, reflected at the array ends
+      double position = 0.0;
+      double velocity = 0.0;
+      double worst_position = 0.0;
+      double worst_velocity = 0.0;
+      for (int k = 0; k < 20000; k++) {
+        double accel = model.accel_noise * gaussian();
+        position += velocity * model.dt + accel * model.dt * model.dt / 2.0;
+        velocity += accel * model.dt;
+        if (fabs(position) > 3.0) {
+          position = position > 0.0 ? 3.0 : -3.0;
+          velocity = -velocity;
+        }
+
+        double measured = position + model.position_noise * gaussian();
+        reference.update(measured);
+        filter.update((float)measured);
+
+        // After the reference gain has converged the two filters must agree
+        if (k >= 2000) {
+          double dp = fabs(filter.getPosition() - reference.position);
+          double dv = fabs(filter.getVelocity() - reference.velocity);
+          worst_position = dp > worst_position ? dp : worst_position;
+          worst_velocity = dv > worst_velocity ? dv : worst_velocity;
+        }
+      }
+      CHECK(worst_position < 1e-5);
+      CHECK(worst_velocity < 1e-3 * (1.0 + model.accel_noise * model.dt));
+    }
+  }
+
+  void velocityIsCleanerThanDifference() {
+    srand(25);
+    const Model &model = MODELS[0];
+    LineKalmanFilter filter((float)model.dt, (float)model.accel_noise, (float)model.position_noise);
+
+    double position = 0.0;
+    double velocity = 0.0;
+    double previous = 0.0;
+    double filtered_error = 0.0;
+    double difference_error = 0.0;
+    for (int k = 0; k < 20000; k++) {
+      double accel = model.accel_noise * gaussian();
+      position += velocity * model.dt + accel * model.dt * model.dt / 2.0;
+      velocity += accel * model.dt;
+      if (fabs(position) > 3.0) {
+        position = position > 0.0 ? 3.0 : -3.0;
+        velocity = -velocity;
+      }
+      double measured = position + model.position_noise * gaussian();
+      filter.update((float)measured);
+
+      if (k >= 2000) {
+        double difference = (measured - previous) / model.dt;
+        filtered_error += (filter.getVelocity() - velocity) * (filter.getVelocity() - velocity);
+        difference_error += (difference - velocity) * (difference - velocity);
+      }
+      previous = measured;
+    }
+    CHECK(sqrt(filtered_error) < 0.5 * sqrt(difference_error));
+  }
+
+  void predictBridgesGapThenDropsTrack() {
+    LineKalmanFilter filter(0.001f, 500.0f, 0.02f, 30, 3.5f);
+    for (int k = 0; k < 200; k++) {
+      filter.update(k * 0.01f); // 10 pitches/s
+    }
+    CHECK_NEAR(filter.getVelocity(), 10.0f, 0.05f);
+
+    float position = filter.getPosition();
+    CHECK(filter.predict());
+    CHECK_NEAR(filter.getPosition(), position + 0.001f * filter.getVelocity(), 1e-5f);
+
+    uint16_t bridged = 1;
+    while (filter.predict()) {
+      bridged++;
+    }
+    CHECK_EQ(bridged, 30);
+    CHECK(!filter.isTracking());
+  }
+
+  void predictStopsAtPositionLimit() {
+    LineKalmanFilter filter(0.001f, 500.0f, 0.02f, 200, 3.5f);
+    for (int k = 0; k < 400; k++) {
+      filter.update(-1.0f - k * 0.005f); // Leaving towards the negative edge at 5 pitches/s
+    }
+    for (int k = 0; k < 150; k++) { // 0.5 pitch to the limit takes about 100 cycles
+      CHECK(filter.predict());
+    }
+    CHECK_EQ(filter.getPosition(), -3.5f);
+    CHECK_EQ(filter.getVelocity(), 0.0f);
+    CHECK(filter.isTracking());
+  }
+
+  void invalidModelIsRejected() {
+    LineKalmanFilter filter(0.001f, 500.0f, 0.02f);
+    float alpha = filter.getPositionGain();
+    CHECK(!filter.configure(0.0f, 500.0f, 0.02f));
+    CHECK(!filter.configure(0.001f, -1.0f, 0.02f));
+    CHECK(!filter.configure(0.001f, 500.0f, 0.0f));
+    CHECK_EQ(filter.getPositionGain(), alpha);
+
+    // An invalid constructor argument falls back to the defaults
+    LineKalmanFilter fallback(-1.0f, 500.0f, 0.02f);
+    CHECK_EQ(fallback.getPositionGain(), alpha);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(steadyStateGainMatchesRiccati);
+  RUN_TEST(trackMatchesReferenceFilter);
+  RUN_TEST(velocityIsCleanerThanDifference);
+  RUN_TEST(predictBridgesGapThenDropsTrack);
+  RUN_TEST(predictStopsAtPositionLimit);
+  RUN_TEST(invalidModelIsRejected);
+  return test::finish("LineKalmanFilter");
+}
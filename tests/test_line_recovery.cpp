@@ -0,0 +1,149 @@
+#include "LineRecovery.h"
+#include "TestHarness.h"
+
+using controller::LineRecovery;
+
+namespace {
+
+  const float STEERING = 400.0f;
+  const uint32_t TIMEOUT_US = 500000;
+
+  void sideFollowsLastPosition() {
+    LineRecovery recovery(STEERING, TIMEOUT_US);
+    CHECK_EQ(recovery.getSide(), 0);
+
+    // Running off to the positive edge: positive side, negative steering
+    for (int k = 0; k < 10; k++) {
+      recovery.track(0.3f * k, 50.0f);
+    }
+    CHECK_EQ(recovery.getSide(), 1);
+    CHECK_EQ(recovery.search(1000), -STEERING);
+    CHECK(recovery.isSearching());
+    CHECK_EQ(recovery.getSpeedScale(), 0.5f);
+
+    // Outside the centre band the position wins over a velocity pointing back
+    recovery.track(-2.0f, 30.0f);
+    CHECK_EQ(recovery.getSide(), -1);
+    CHECK_EQ(recovery.search(2000), STEERING);
+  }
+
+  void centreBandUsesVelocity() {
+    LineRecovery recovery(STEERING, TIMEOUT_US, 0.5f, 0.5f);
+
+    recovery.track(0.1f, -20.0f);
+    CHECK_EQ(recovery.getSide(), -1);
+    CHECK_EQ(recovery.search(1000), STEERING);
+
+    recovery.track(-0.4f, 20.0f);
+    CHECK_EQ(recovery.getSide(), 1);
+    CHECK_EQ(recovery.search(2000), -STEERING);
+
+    // Standing still in the centre, e.g. the end of the tape: straight ahead
+    recovery.track(0.2f, 0.0f);
+    CHECK_EQ(recovery.getSide(), 0);
+    CHECK_EQ(recovery.search(3000), 0.0f);
+    CHECK(recovery.isSearching());
+
+    // The band edge belongs to the velocity side of the test
+    recovery.track(0.5f, -1.0f);
+    CHECK_EQ(recovery.getSide(), -1);
+  }
+
+  void timeoutAcrossMicrosWrap() {
+    LineRecovery recovery(STEERING, TIMEOUT_US);
+    recovery.track(2.0f, 0.0f);
+
+    const uint32_t start = 0xFFFFF000u; // 4096 µs before micros() wraps
+    CHECK_EQ(recovery.search(start), -STEERING);
+    CHECK_EQ(recovery.getSearchTime(start + 4096), 4096u);
+    CHECK_EQ(recovery.search(start + 4096), -STEERING); // Now 0
+    CHECK_EQ(recovery.search(start + TIMEOUT_US - 1), -STEERING);
+    CHECK(recovery.isSearching());
+    CHECK_EQ(recovery.getSearchTime(start + TIMEOUT_US - 1), TIMEOUT_US - 1);
+
+    CHECK_EQ(recovery.search(start + TIMEOUT_US), 0.0f);
+    CHECK(recovery.isStopped());
+    CHECK_EQ(recovery.getSpeedScale(), 0.0f);
+    CHECK_EQ(recovery.getSearchTime(start + TIMEOUT_US), 0u);
+  }
+
+  void searchBudgetStartsAtFirstLostCycle() {
+    LineRecovery recovery(STEERING, TIMEOUT_US);
+    recovery.track(2.0f, 0.0f);
+    CHECK_EQ(recovery.search(100000), -STEERING);
+
+    // Found again and lost later: a new budget from the new loss
+    recovery.track(2.0f, 0.0f);
+    CHECK_EQ(recovery.search(550000), -STEERING);
+    CHECK_EQ(recovery.search(100000 + TIMEOUT_US), -STEERING);
+    CHECK(recovery.isSearching());
+    CHECK_EQ(recovery.search(550000 + TIMEOUT_US), 0.0f);
+    CHECK(recovery.isStopped());
+  }
+
+  void stoppedStaysStopped() {
+    LineRecovery recovery(STEERING, TIMEOUT_US);
+    recovery.track(2.0f, 0.0f);
+    recovery.search(0);
+    recovery.search(TIMEOUT_US);
+    CHECK(recovery.isStopped());
+
+    // The line reappearing does not restart the run
+    recovery.track(1.0f, 0.0f);
+    CHECK(recovery.isStopped());
+    CHECK_EQ(recovery.getRecoveries(), 0);
+    CHECK_EQ(recovery.search(TIMEOUT_US + 1000), 0.0f);
+    CHECK(recovery.isStopped());
+    CHECK_EQ(recovery.getSpeedScale(), 0.0f);
+
+    recovery.reset();
+    CHECK(recovery.getState() == LineRecovery::State::TRACKING);
+    CHECK_EQ(recovery.getSide(), 0);
+    CHECK_EQ(recovery.getSpeedScale(), 1.0f);
+  }
+
+  void recoveriesAreCounted() {
+    LineRecovery recovery(STEERING, TIMEOUT_US);
+    recovery.track(2.0f, 0.0f);
+
+    // Tracking without losing the line is not a recovery
+    recovery.track(2.0f, 0.0f);
+    CHECK_EQ(recovery.getRecoveries(), 0);
+
+    uint32_t now = 0;
+    for (int i = 0; i < 3; i++) {
+      recovery.search(now);
+      recovery.search(now + 1000); // Several lost cycles are one search
+      recovery.track(-2.0f, 0.0f);
+      now += 10000;
+    }
+    CHECK_EQ(recovery.getRecoveries(), 3);
+
+    recovery.reset();
+    CHECK_EQ(recovery.getRecoveries(), 0);
+  }
+
+  void configurationIsSanitised() {
+    LineRecovery recovery(-STEERING, TIMEOUT_US, 2.0f, -0.5f);
+    recovery.track(0.3f, -5.0f); // Inside the band of magnitude 0.5
+    CHECK_EQ(recovery.search(0), STEERING);
+    CHECK_EQ(recovery.getSpeedScale(), 1.0f);
+
+    recovery.setSearch(-100.0f, 1000);
+    CHECK_EQ(recovery.search(10), 100.0f);
+    CHECK_EQ(recovery.search(1000), 0.0f);
+    CHECK(recovery.isStopped());
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(sideFollowsLastPosition);
+  RUN_TEST(centreBandUsesVelocity);
+  RUN_TEST(timeoutAcrossMicrosWrap);
+  RUN_TEST(searchBudgetStartsAtFirstLostCycle);
+  RUN_TEST(stoppedStaysStopped);
+  RUN_TEST(recoveriesAreCounted);
+  RUN_TEST(configurationIsSanitised);
+  return test::finish("LineRecovery");
+}
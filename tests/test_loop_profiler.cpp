@@ -0,0 +1,135 @@
+#include "LoopProfiler.h"
+#include "TestHarness.h"
+
+using rt::LoopProfiler;
+using rt::Stage;
+using rt::StageStats;
+
+namespace {
+
+  uint32_t populatedBuckets(const StageStats &stats) {
+    uint32_t populated = 0;
+    for (uint8_t b = 0; b < StageStats::HISTOGRAM_BUCKETS; b++) {
+      populated += stats.histogram[b] != 0 ? 1 : 0;
+    }
+    return populated;
+  }
+
+  void recordTracksMinMaxMean() {
+    LoopProfiler::reset();
+    LoopProfiler::record(Stage::CONTROL, 500);
+    LoopProfiler::record(Stage::CONTROL, 200); // Below the first sample
+    LoopProfiler::record(Stage::CONTROL, 900);
+
+    const StageStats &stats = LoopProfiler::getStats(Stage::CONTROL);
+    CHECK_EQ(stats.count, 3u);
+    CHECK_EQ(stats.min_ticks, 200u);
+    CHECK_EQ(stats.max_ticks, 900u);
+    CHECK_EQ(stats.total_ticks, (uint64_t)1600);
+    CHECK_EQ(stats.total_ticks / stats.count, (uint64_t)533);
+
+    // Stages are independent
+    CHECK_EQ(LoopProfiler::getStats(Stage::ACQUIRE).count, 0u);
+    CHECK_EQ(LoopProfiler::getStats(Stage::TELEMETRY).count, 0u);
+  }
+
+  void totalDoesNotWrap() {
+    LoopProfiler::reset();
+    for (int k = 0; k < 4; k++) {
+      LoopProfiler::record(Stage::ACQUIRE, 0xFFFFFFFFu);
+    }
+    CHECK_EQ(LoopProfiler::getStats(Stage::ACQUIRE).total_ticks, (uint64_t)0xFFFFFFFFu * 4);
+  }
+
+  void bucketsAreFloorLog2() {
+    LoopProfiler::reset();
+    struct Case {
+      uint32_t ticks;
+      uint8_t bucket;
+    };
+    const Case cases[] = {{0, 0}, {1, 0}, {2, 1}, {3, 1}, {4, 2}, {1023, 9}, {1024, 10}, {1025, 10},
+                          {0x80000000u, 31}, {0xFFFFFFFFu, 31}};
+    for (const Case &c : cases) {
+      LoopProfiler::reset();
+      LoopProfiler::record(Stage::ESTIMATE, c.ticks);
+      const StageStats &stats = LoopProfiler::getStats(Stage::ESTIMATE);
+      CHECK_EQ(stats.histogram[c.bucket], 1u);
+      CHECK_EQ(populatedBuckets(stats), 1u);
+    }
+
+    // Counts accumulate per bucket
+    LoopProfiler::reset();
+    const uint32_t ticks[] = {256, 300, 511, 512, 7};
+    for (uint32_t t : ticks) {
+      LoopProfiler::record(Stage::ESTIMATE, t);
+    }
+    const StageStats &stats = LoopProfiler::getStats(Stage::ESTIMATE);
+    CHECK_EQ(stats.histogram[8], 3u);
+    CHECK_EQ(stats.histogram[9], 1u);
+    CHECK_EQ(stats.histogram[2], 1u);
+  }
+
+  void resetClearsEverything() {
+    LoopProfiler::reset();
+    LoopProfiler::record(Stage::CONTROL, 40);
+    LoopProfiler::record(Stage::TELEMETRY, 70000);
+    LoopProfiler::reset();
+
+    for (uint8_t s = 0; s < (uint8_t)Stage::COUNT; s++) {
+      const StageStats &stats = LoopProfiler::getStats((Stage)s);
+      CHECK_EQ(stats.count, 0u);
+      CHECK_EQ(stats.min_ticks, 0u);
+      CHECK_EQ(stats.max_ticks, 0u);
+      CHECK_EQ(stats.total_ticks, (uint64_t)0);
+      CHECK_EQ(populatedBuckets(stats), 0u);
+    }
+
+    // The first sample after a reset sets the minimum, whatever its size
+    LoopProfiler::record(Stage::CONTROL, 5000);
+    CHECK_EQ(LoopProfiler::getStats(Stage::CONTROL).min_ticks, 5000u);
+  }
+
+  void scopeTimesWithTheHostClock() {
+    // The Arduino stubs freeze micros(), but the profiler clock still runs
+    LoopProfiler::reset();
+    uint32_t before = LoopProfiler::now();
+    volatile uint32_t sink = 0;
+    {
+      rt::ProfileScope scope(Stage::ACQUIRE);
+      for (uint32_t k = 0; k < 100000; k++) {
+        sink = sink + k;
+      }
+    }
+    uint32_t elapsed = LoopProfiler::now() - before;
+
+    const StageStats &stats = LoopProfiler::getStats(Stage::ACQUIRE);
+    CHECK_EQ(stats.count, 1u);
+    CHECK(stats.max_ticks > 0);
+    CHECK(stats.max_ticks <= elapsed);
+    CHECK(elapsed < 1000000000u); // Well under a second of nanoseconds
+    CHECK_EQ(LoopProfiler::ticksPerMicrosecond(), 1000.0f);
+  }
+
+  void dumpPrintsPopulatedBuckets() {
+    LoopProfiler::reset();
+    LoopProfiler::record(Stage::CONTROL, 100); // Bucket 6
+    LoopProfiler::record(Stage::CONTROL, 120); // Bucket 6
+    LoopProfiler::record(Stage::CONTROL, 300); // Bucket 8
+
+    Print out;
+    LoopProfiler::dump(out);
+    // Header, one line per stage and one per populated bucket
+    CHECK_EQ(out.lines, (uint32_t)(1 + (uint8_t)Stage::COUNT + 2));
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(recordTracksMinMaxMean);
+  RUN_TEST(totalDoesNotWrap);
+  RUN_TEST(bucketsAreFloorLog2);
+  RUN_TEST(resetClearsEverything);
+  RUN_TEST(scopeTimesWithTheHostClock);
+  RUN_TEST(dumpPrintsPopulatedBuckets);
+  return test::finish("LoopProfiler");
+}
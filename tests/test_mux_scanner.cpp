@@ -0,0 +1,210 @@
+#include "MuxScanner.h"
+#include "TestHarness.h"
+
+using sensing::MuxScanner;
+
+namespace {
+
+  const MuxScanner::MuxPins PINS[MuxScanner::MAX_MUXES] = {
+      {34, {12, 13, 14, 15}},
+      {35, {16, 17, 18, 19}},
+  };
+  const uint16_t SIGNAL_LEVEL[MuxScanner::MAX_MUXES] = {1000, 2000};
+
+  /**
+   * @brief Mux state rebuilt from the pin log, one event at a time
+   *
+   * @var channel: Channel the select lines encode
+   * @var changed_at: Time of the last select line write
+   */
+  struct Replay {
+    uint8_t levels[MuxScanner::MAX_MUXES][MuxScanner::SELECT_LINES];
+    uint8_t channel[MuxScanner::MAX_MUXES];
+    uint64_t changed_at[MuxScanner::MAX_MUXES];
+
+    Replay() : levels(), channel(), changed_at() {}
+
+    void apply(const host::PinEvent &event) {
+      for (uint8_t m = 0; m < MuxScanner::MAX_MUXES; m++) {
+        for (uint8_t line = 0; line < MuxScanner::SELECT_LINES; line++) {
+          if (event.pin == PINS[m].select[line]) {
+            levels[m][line] = event.level;
+            channel[m] = (uint8_t)(levels[m][0] | levels[m][1] << 1 | levels[m][2] << 2 | levels[m][3] << 3);
+            changed_at[m] = event.time_us;
+          }
+        }
+      }
+    }
+  };
+
+  int muxOfPin(uint8_t signal) {
+    for (uint8_t m = 0; m < MuxScanner::MAX_MUXES; m++) {
+      if (PINS[m].signal == signal) {
+        return m;
+      }
+    }
+    return -1;
+  }
+
+  /**
+   * @brief Scanner after begin(), the clock moved on by the rest of a cycle
+   *
+   * @param micros_tick_us: Clock advance per micros() call
+   * @param analog_read_us: Conversion time
+   */
+  void start(MuxScanner &scanner, uint32_t micros_tick_us, uint32_t analog_read_us) {
+    host::setClockTicks(micros_tick_us, analog_read_us);
+    host::setAnalog(PINS[0].signal, SIGNAL_LEVEL[0]);
+    host::setAnalog(PINS[1].signal, SIGNAL_LEVEL[1]);
+    host::clearPinLog();
+    scanner.begin();
+    host::advanceMicros(1000);
+  }
+
+  /**
+   * @brief Replay a scan and check every conversion against the pipeline
+   *
+   * Each sensor's samples must read its own mux and channel, after the
+   * channel had settle_us to settle; with two muxes the other mux must
+   * already hold the next sensor when the conversion starts.
+   */
+  void checkScan(const MuxScanner &scanner, uint8_t first, uint8_t end, uint8_t samples, Replay &replay,
+                 size_t from_event) {
+    uint8_t sensor = first;
+    uint8_t sample = 0;
+    for (size_t e = from_event; e < host::pinEventCount(); e++) {
+      const host::PinEvent &event = host::pinEvent(e);
+      if (event.write) {
+        replay.apply(event);
+        continue;
+      }
+
+      CHECK(sensor < end);
+      uint8_t mux = scanner.muxOf(sensor);
+      CHECK_EQ(muxOfPin(event.pin), mux);
+      CHECK_EQ(replay.channel[mux], scanner.channelOf(sensor));
+      CHECK(event.time_us - replay.changed_at[mux] >= scanner.getSettleTime());
+      if (scanner.getMuxCount() == 2) {
+        uint8_t next = sensor + 1 < end ? sensor + 1 : first;
+        CHECK_EQ(replay.channel[scanner.muxOf(next)], scanner.channelOf(next));
+      }
+
+      if (++sample == samples) {
+        sample = 0;
+        sensor++;
+      }
+    }
+    CHECK_EQ(sensor, end);
+    CHECK_EQ(sample, 0);
+  }
+
+  void beginSelectsChannelZero() {
+    MuxScanner scanner(PINS, 2, 32);
+    start(scanner, 0, 0);
+
+    // All four lines of both muxes are driven: their levels are unknown
+    CHECK_EQ(host::pinEventCount(), (size_t)8);
+    Replay replay;
+    for (size_t e = 0; e < host::pinEventCount(); e++) {
+      CHECK(host::pinEvent(e).write);
+      CHECK_EQ(host::pinEvent(e).level, LOW);
+      replay.apply(host::pinEvent(e));
+    }
+    for (uint8_t m = 0; m < 2; m++) {
+      for (uint8_t line = 0; line < MuxScanner::SELECT_LINES; line++) {
+        CHECK_EQ(host::digitalLevel(PINS[m].select[line]), LOW);
+      }
+    }
+  }
+
+  void twoMuxesHideSettling() {
+    // 10 µs conversions against 5 µs settling: the pipeline never waits
+    const uint8_t samples = 2;
+    MuxScanner scanner(PINS, 2, 8, samples, 5);
+    start(scanner, 1, 10);
+    Replay replay;
+    for (size_t e = 0; e < host::pinEventCount(); e++) {
+      replay.apply(host::pinEvent(e));
+    }
+    size_t from_event = host::pinEventCount();
+
+    uint16_t raw[8] = {};
+    scanner.read(raw, 0, 8);
+    checkScan(scanner, 0, 8, samples, replay, from_event);
+    CHECK_EQ(scanner.getSettleWaits(), 0u);
+    for (uint8_t i = 0; i < 8; i++) {
+      CHECK_EQ(raw[i], SIGNAL_LEVEL[i % 2]);
+    }
+
+    // Only changed lines are written: mux 0 steps 0-1-2-3-0 (1 + 2 + 1 + 2
+    // lines), mux 1 steps 0-1-2-3 (1 + 2 + 1 lines)
+    size_t writes = 0;
+    for (size_t e = from_event; e < host::pinEventCount(); e++) {
+      writes += host::pinEvent(e).write ? 1 : 0;
+    }
+    CHECK_EQ(writes, (size_t)10);
+
+    // The start of the next scan is selected and settling
+    CHECK_EQ(replay.channel[0], 0);
+    CHECK_EQ(replay.channel[1], 3);
+  }
+
+  void oneMuxWaitsPerSensor() {
+    // One mux cannot overlap: every channel change is waited out in full
+    const uint8_t samples = 4;
+    MuxScanner scanner(PINS, 1, 4, samples, 20);
+    start(scanner, 1, 3);
+    Replay replay;
+    for (size_t e = 0; e < host::pinEventCount(); e++) {
+      replay.apply(host::pinEvent(e));
+    }
+    size_t from_event = host::pinEventCount();
+
+    uint16_t raw[4] = {};
+    scanner.read(raw, 0, 4);
+    checkScan(scanner, 0, 4, samples, replay, from_event);
+    CHECK_EQ(scanner.getSettleWaits(), 3u); // Sensor 0 settled during the rest of the cycle
+    CHECK_EQ(replay.channel[0], 0);
+    for (uint8_t i = 0; i < 4; i++) {
+      CHECK_EQ(raw[i], SIGNAL_LEVEL[0]);
+    }
+  }
+
+  void windowLeavesOtherSensorsAlone() {
+    const uint8_t samples = 1;
+    MuxScanner scanner(PINS, 2, 16, samples, 5);
+    start(scanner, 1, 10);
+    Replay replay;
+    for (size_t e = 0; e < host::pinEventCount(); e++) {
+      replay.apply(host::pinEvent(e));
+    }
+    size_t from_event = host::pinEventCount();
+
+    uint16_t raw[16];
+    for (uint8_t i = 0; i < 16; i++) {
+      raw[i] = 0xBEEF;
+    }
+    scanner.read(raw, 5, 4);
+    checkScan(scanner, 5, 9, samples, replay, from_event);
+    for (uint8_t i = 0; i < 16; i++) {
+      CHECK_EQ(raw[i], i >= 5 && i < 9 ? SIGNAL_LEVEL[i % 2] : 0xBEEF);
+    }
+
+    // Sensor 5 (mux 1, channel 2) is selected again for the next cycle
+    CHECK_EQ(replay.channel[1], 2);
+
+    // A run past the end is cut at the last sensor
+    from_event = host::pinEventCount();
+    scanner.read(raw, 14, 8);
+    checkScan(scanner, 14, 16, samples, replay, from_event);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(beginSelectsChannelZero);
+  RUN_TEST(twoMuxesHideSettling);
+  RUN_TEST(oneMuxWaitsPerSensor);
+  RUN_TEST(windowLeavesOtherSensorsAlone);
+  return test::finish("MuxScanner");
+}
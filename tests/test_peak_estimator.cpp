@@ -0,0 +1,148 @@
+#include "LineEstimator.h"
+#include "PeakEstimator.h"
+#include "TestHarness.h"
+#include <math.h>
+#include <stdlib.h>
+
+using sensing::LineEstimator;
+using sensing::PeakEstimator;
+
+namespace {
+
+  const uint8_t SENSORS = 8;
+  const double EDGE = -3.5; // Outermost sensor, in pitches from the centre
+  const double SIGMAS[] = {0.55, 0.7}; // Profile widths where about three sensors see the line
+
+  /**
+   * @brief Normalized readings of a Gaussian line profile over a white floor
+   *
+   * @param x: Line position in sensor pitches (0 = centre)
+   * @param sigma: Profile width in pitches (0.55-0.7: about three sensors see the line)
+   * @param amplitude: Peak above the floor (above 1000 saturates)
+   */
+  void profile(uint16_t *values, double x, double sigma, double amplitude = 950.0) {
+    for (uint8_t i = 0; i < SENSORS; i++) {
+      double d = (i - 3.5) - x;
+      double v = 25.0 + amplitude * exp(-d * d / (2.0 * sigma * sigma));
+      values[i] = (uint16_t)(v > 1000.0 ? 1000.0 : v);
+    }
+  }
+
+  /**
+   * @brief Error in weight units; positions past the edge sensor read as the edge
+   */
+  int32_t error(int32_t estimate, double x) {
+    double truth = (x < EDGE ? EDGE : (x > -EDGE ? -EDGE : x)) * 1000.0;
+    return estimate - (int32_t)lround(truth);
+  }
+
+  void noLineBelowNoiseFloor() {
+    PeakEstimator<SENSORS> estimator;
+    uint16_t values[SENSORS];
+    for (uint8_t i = 0; i < SENSORS; i++) {
+      values[i] = estimator.getNoiseFloor();
+    }
+    CHECK_EQ(estimator.estimate(values), PeakEstimator<SENSORS>::NO_LINE);
+    CHECK_EQ(estimator.getSignal(), 0);
+  }
+
+  void centredProfileIsExact() {
+    PeakEstimator<SENSORS> estimator;
+    uint16_t values[SENSORS];
+    for (uint8_t i = 1; i < SENSORS - 1; i++) {
+      profile(values, i - 3.5, 0.6);
+      CHECK_EQ(estimator.estimate(values), 1000 * i - 3500);
+    }
+
+    // A plateau of saturated sensors is centred on the run
+    profile(values, 0.0, 0.6, 2000.0);
+    CHECK_EQ(estimator.estimate(values), 0);
+  }
+
+  void mirroredFrameNegates() {
+    PeakEstimator<SENSORS> estimator;
+    uint16_t values[SENSORS];
+    uint16_t mirrored[SENSORS];
+    for (double x = -4.0; x <= 4.0; x += 0.01) {
+      profile(values, x, 0.6);
+      for (uint8_t i = 0; i < SENSORS; i++) {
+        mirrored[i] = values[SENSORS - 1 - i];
+      }
+      CHECK_EQ(estimator.estimate(mirrored), -estimator.estimate(values));
+    }
+  }
+
+  void interiorAccuracy() {
+    PeakEstimator<SENSORS> estimator;
+    uint16_t values[SENSORS];
+    for (double sigma : SIGMAS) {
+      int32_t worst = 0;
+      for (double x = -2.5; x <= 2.5; x += 0.005) {
+        profile(values, x, sigma);
+        int32_t e = labs(error(estimator.estimate(values), x));
+        worst = e > worst ? e : worst;
+      }
+      CHECK(worst <= 160);
+    }
+  }
+
+  void edgeIsNotPulledInward() {
+    PeakEstimator<SENSORS> peak;
+    LineEstimator<SENSORS> centroid;
+    uint16_t values[SENSORS];
+    for (double sigma : SIGMAS) {
+      // Line centred on the edge sensor and past it: both read as the edge.
+      // Taking the missing neighbour as zero gave up to 100 here at sigma 0.7
+      for (double x = EDGE; x >= EDGE - 0.5; x -= 0.05) {
+        profile(values, x, sigma);
+        CHECK(labs(error(peak.estimate(values), x)) <= 70);
+        CHECK(labs(error(peak.estimate(values), x)) <= labs(error(centroid.estimate(values), x)));
+      }
+    }
+  }
+
+  void edgeIsContinuous() {
+    PeakEstimator<SENSORS> estimator;
+    uint16_t values[SENSORS];
+    for (double sigma : SIGMAS) {
+      // 5-unit steps across the hand-over from the second sensor to the edge sensor
+      profile(values, -2.5, sigma);
+      int32_t previous = estimator.estimate(values);
+      int32_t largest_step = 0;
+      for (double x = -2.505; x >= -4.0; x -= 0.005) {
+        profile(values, x, sigma);
+        int32_t position = estimator.estimate(values);
+        int32_t step = labs(position - previous);
+        largest_step = step > largest_step ? step : largest_step;
+        previous = position;
+      }
+      CHECK(largest_step <= 60);
+    }
+  }
+
+  void edgeZoneAccuracy() {
+    PeakEstimator<SENSORS> estimator;
+    uint16_t values[SENSORS];
+    for (double sigma : SIGMAS) {
+      int32_t worst = 0;
+      for (double x = -3.0; x >= EDGE; x -= 0.005) {
+        profile(values, x, sigma);
+        int32_t e = labs(error(estimator.estimate(values), x));
+        worst = e > worst ? e : worst;
+      }
+      CHECK(worst <= 170);
+    }
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(noLineBelowNoiseFloor);
+  RUN_TEST(centredProfileIsExact);
+  RUN_TEST(mirroredFrameNegates);
+  RUN_TEST(interiorAccuracy);
+  RUN_TEST(edgeIsNotPulledInward);
+  RUN_TEST(edgeIsContinuous);
+  RUN_TEST(edgeZoneAccuracy);
+  return test::finish("PeakEstimator");
+}
@@ -0,0 +1,177 @@
+#include "PIDController.h"
+#include "PidBank.h"
+#include "PidCore.h"
+#include "TestHarness.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using controller::PIDController;
+using controller::PidBank;
+
+namespace {
+
+  const size_t LANES = 8;
+  const uint32_t STEPS = 5000;
+
+  /**
+   * @brief Candidate gains, including lanes with a term disabled
+   */
+  const float GAINS[LANES][3] = {
+      {180.0f, 60.0f, 0.9f}, {250.0f, 0.0f, 1.2f}, {120.0f, 200.0f, 0.0f}, {300.0f, 20.0f, 3.0f},
+      {90.0f, 5.0f, 0.2f},   {0.0f, 400.0f, 0.0f}, {500.0f, 80.0f, 2.0f},  {60.0f, 30.0f, 0.05f},
+  };
+
+  float randomError() {
+    return 6.0f * (float)rand() / RAND_MAX - 3.0f; // Wide enough to saturate most lanes
+  }
+
+  /**
+   * @brief One PIDController per lane, with the bank's gains, sample time and limits
+   */
+  struct Reference {
+    PIDController *lanes[LANES];
+
+    Reference() {
+      for (size_t i = 0; i < LANES; i++) {
+        lanes[i] = new PIDController(GAINS[i][0], GAINS[i][1], GAINS[i][2], 1);
+        lanes[i]->init();
+      }
+    }
+
+    ~Reference() {
+      for (size_t i = 0; i < LANES; i++) {
+        delete lanes[i];
+      }
+    }
+  };
+
+  void configure(PidBank<LANES> &bank) {
+    for (size_t i = 0; i < LANES; i++) {
+      bank.setGains(i, GAINS[i][0], GAINS[i][1], GAINS[i][2]);
+    }
+  }
+
+  void stepAllMatchesPidController() {
+    PidBank<LANES> bank(0.001f);
+    configure(bank);
+    Reference reference;
+
+    srand(3);
+    uint32_t mismatches = 0;
+    for (uint32_t k = 0; k < STEPS; k++) {
+      float error = randomError();
+      bank.stepAll(error);
+      for (size_t i = 0; i < LANES; i++) {
+        if (bank.getOutput(i) != reference.lanes[i]->compute(error)) {
+          mismatches++;
+        }
+      }
+    }
+    CHECK_EQ(mismatches, 0u); // Same arithmetic in the same order: bit for bit
+  }
+
+  void stepMatchesPidControllerPerLane() {
+    PidBank<LANES> bank(0.001f);
+    configure(bank);
+    bank.setAntiWindupLimit(3, 150.0f);
+    Reference reference;
+    reference.lanes[3]->setAntiWindupLimit(150.0f);
+
+    srand(4);
+    float errors[LANES];
+    float outputs[LANES];
+    uint32_t mismatches = 0;
+    for (uint32_t k = 0; k < STEPS; k++) {
+      for (size_t i = 0; i < LANES; i++) {
+        errors[i] = randomError();
+      }
+      bank.step(errors, outputs);
+      for (size_t i = 0; i < LANES; i++) {
+        float expected = reference.lanes[i]->compute(errors[i]);
+        if (outputs[i] != expected || bank.getOutputs()[i] != expected) {
+          mismatches++;
+        }
+      }
+    }
+    CHECK_EQ(mismatches, 0u);
+    CHECK_EQ(bank.getIntegral(3), reference.lanes[3]->getIntegral());
+  }
+
+  void resetClearsEveryLane() {
+    PidBank<LANES> bank(0.001f);
+    configure(bank);
+    for (uint32_t k = 0; k < 100; k++) {
+      bank.stepAll(1.0f);
+    }
+    bank.reset();
+    for (size_t i = 0; i < LANES; i++) {
+      CHECK_EQ(bank.getOutput(i), 0.0f);
+      CHECK_EQ(bank.getIntegral(i), 0.0f);
+    }
+
+    // No derivative kick from the history before reset()
+    Reference reference;
+    bank.stepAll(0.5f);
+    for (size_t i = 0; i < LANES; i++) {
+      CHECK_EQ(bank.getOutput(i), reference.lanes[i]->compute(0.5f));
+    }
+  }
+
+  /**
+   * @brief computeTrace() of a core against PIDController::compute() sample by sample
+   *
+   * Both sum (P + I) + D with the same filter arithmetic, so the outputs
+   * agree bit for bit, filtered or not.
+   */
+  float traceDeviation(float cutoff_hz, size_t chunk) {
+    const size_t COUNT = 4000;
+    static float errors[COUNT];
+    static float outputs[COUNT];
+    srand(5);
+    for (size_t k = 0; k < COUNT; k++) {
+      errors[k] = 0.8f * sinf(k * 0.01f) + 0.1f * randomError();
+    }
+
+    controller::Pid<controller::PIDTraits> core(180.0f, 60.0f, 0.9f, 0.001f);
+    PIDController reference(180.0f, 60.0f, 0.9f, 1);
+    reference.init();
+    if (cutoff_hz > 0.0f) {
+      core.setDerivativeFilter(cutoff_hz);
+      reference.setDerivativeFilter(cutoff_hz);
+    }
+
+    // Chunks continue from the state the previous chunk left behind
+    for (size_t start = 0; start < COUNT; start += chunk) {
+      core.computeTrace(errors + start, outputs + start, chunk);
+    }
+
+    float worst = 0.0f;
+    for (size_t k = 0; k < COUNT; k++) {
+      float expected = reference.compute(errors[k]);
+      float deviation = fabsf(outputs[k] - expected) / (1.0f + fabsf(expected));
+      worst = deviation > worst ? deviation : worst;
+    }
+    CHECK_EQ(core.getOutput(), outputs[COUNT - 1]);
+    return worst;
+  }
+
+  void computeTraceMatchesPidController() {
+    float whole = traceDeviation(0.0f, 4000);
+    float chunked = traceDeviation(0.0f, 100);
+    float filtered = traceDeviation(80.0f, 400);
+    printf("  worst relative deviation: whole %.2e, chunked %.2e, filtered %.2e\n", whole, chunked, filtered);
+    CHECK_EQ(whole, 0.0f);
+    CHECK_EQ(chunked, 0.0f);
+    CHECK_EQ(filtered, 0.0f);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(stepAllMatchesPidController);
+  RUN_TEST(stepMatchesPidControllerPerLane);
+  RUN_TEST(resetClearsEveryLane);
+  RUN_TEST(computeTraceMatchesPidController);
+  return test::finish("PidBank");
+}
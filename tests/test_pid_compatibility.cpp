@@ -0,0 +1,112 @@
+#include "BaselinePid.h"
+#include "PController.h"
+#include "PDController.h"
+#include "PIController.h"
+#include "PIDController.h"
+#include "TestHarness.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace {
+
+  const uint32_t STEPS = 20000;
+  const float MIN_OUTPUT = -1023.0f;
+  const float MAX_OUTPUT = 1023.0f;
+
+  // Precomputing Ki * dt and Kd / dt regroups the float products; the
+  // integral accumulates that rounding, so the bound is absolute plus a
+  // relative part for large outputs
+  const float ABS_TOLERANCE = 1e-3f;
+  const float REL_TOLERANCE = 1e-4f;
+
+  /**
+   * @brief Line-position-like error: a slow sweep, sharp steps and sensor noise
+   */
+  float traceError(uint32_t k) {
+    float sweep = 1.5f * sinf(k * 0.0021f) + 0.4f * sinf(k * 0.013f);
+    float step = ((k / 2500) % 2 == 0) ? 0.0f : 0.8f;
+    float noise = ((float)rand() / RAND_MAX - 0.5f) * 0.05f;
+    return sweep + step + noise;
+  }
+
+  /**
+   * @brief Worst deviation of a current controller from its frozen baseline
+   */
+  template <typename Current, typename Baseline>
+  void compare(const char *name, Current &current, Baseline &baseline) {
+    CHECK(current.init());
+    srand(7);
+    float worst_abs = 0.0f;
+    float worst_rel = 0.0f;
+    uint32_t outside = 0;
+    for (uint32_t k = 0; k < STEPS; k++) {
+      float error = traceError(k);
+      float expected = baseline.compute(error);
+      float actual = current.compute(error);
+      float deviation = fabsf(actual - expected);
+      float magnitude = fabsf(expected);
+      if (deviation > worst_abs) {
+        worst_abs = deviation;
+      }
+      if (magnitude > 1.0f && deviation / magnitude > worst_rel) {
+        worst_rel = deviation / magnitude;
+      }
+      if (deviation > ABS_TOLERANCE + REL_TOLERANCE * magnitude) {
+        outside++;
+      }
+    }
+    printf("  %-4s worst deviation %.2e absolute, %.2e relative\n", name, worst_abs, worst_rel);
+    CHECK_EQ(outside, 0u);
+  }
+
+  void proportionalIsBitExact() {
+    controller::PController current(180.0f, 1, MIN_OUTPUT, MAX_OUTPUT);
+    baseline::PController reference(180.0f, 0.001f, MIN_OUTPUT, MAX_OUTPUT);
+    CHECK(current.init());
+    srand(7);
+    uint32_t mismatches = 0;
+    for (uint32_t k = 0; k < STEPS; k++) {
+      float error = traceError(k);
+      if (current.compute(error) != reference.compute(error)) {
+        mismatches++;
+      }
+    }
+    CHECK_EQ(mismatches, 0u);
+  }
+
+  void piMatchesBaseline() {
+    controller::PIController current(180.0f, 60.0f, 1, MIN_OUTPUT, MAX_OUTPUT);
+    baseline::PIController reference(180.0f, 60.0f, 0.001f, MIN_OUTPUT, MAX_OUTPUT);
+    compare("PI", current, reference);
+  }
+
+  void pdMatchesBaseline() {
+    controller::PDController current(180.0f, 0.9f, 1, MIN_OUTPUT, MAX_OUTPUT);
+    baseline::PDController reference(180.0f, 0.9f, 0.001f, MIN_OUTPUT, MAX_OUTPUT);
+    compare("PD", current, reference);
+  }
+
+  void pidMatchesBaseline() {
+    controller::PIDController current(180.0f, 60.0f, 0.9f, 1, MIN_OUTPUT, MAX_OUTPUT);
+    baseline::PIDController reference(180.0f, 60.0f, 0.9f, 0.001f, MIN_OUTPUT, MAX_OUTPUT);
+    compare("PID", current, reference);
+  }
+
+  void pidMatchesBaselineAtSlowRate() {
+    // 5 ms: dt is not a power of two either way, and Kd / dt is smaller
+    controller::PIDController current(120.0f, 300.0f, 2.5f, 5, MIN_OUTPUT, MAX_OUTPUT);
+    baseline::PIDController reference(120.0f, 300.0f, 2.5f, 0.005f, MIN_OUTPUT, MAX_OUTPUT);
+    compare("PID", current, reference);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(proportionalIsBitExact);
+  RUN_TEST(piMatchesBaseline);
+  RUN_TEST(pdMatchesBaseline);
+  RUN_TEST(pidMatchesBaseline);
+  RUN_TEST(pidMatchesBaselineAtSlowRate);
+  return test::finish("PID compatibility");
+}
@@ -0,0 +1,124 @@
+#include "RelayAutotuner.h"
+#include "TestHarness.h"
+#include <Arduino.h>
+#include <math.h>
+
+using controller::RelayAutotuner;
+
+namespace {
+
+  /**
+   * @brief Integrator with dead time: y' = gain × u(t - delay)
+   *
+   * Under relay feedback it oscillates with period 4 × delay and a
+   * triangular error of amplitude a = ε + gain × d × delay, so the
+   * describing function gives Ku = 4d / (π × sqrt(a² - ε²)). That is 19%
+   * below the exact π / (2 × gain × delay) because the wave is not a sine,
+   * the usual relay-test bias for integrating plants.
+   */
+  struct DelayedIntegrator {
+    static const uint32_t MAX_DELAY = 64;
+    float gain;
+    uint32_t delay;
+    float history[MAX_DELAY];
+    uint32_t head;
+    float y;
+
+    DelayedIntegrator(float gain, uint32_t delay) : gain(gain), delay(delay), head(0), y(0.0f) {
+      for (uint32_t i = 0; i < MAX_DELAY; i++) {
+        history[i] = 0.0f;
+      }
+    }
+
+    float step(float u, float dt) {
+      float delayed = history[head];
+      history[head] = u;
+      head = (head + 1) % delay;
+      y += gain * delayed * dt;
+      return y;
+    }
+  };
+
+  void convergesOnDelayedIntegrator() {
+    host::setMicros(0);
+    RelayAutotuner tuner(100.0f, 0.002f, 1);
+    CHECK(tuner.init());
+
+    DelayedIntegrator plant(0.05f, 20); // 20 ms dead time
+    float y = 0.01f;
+    for (uint32_t k = 0; k < 20000 && !tuner.isDone(); k++) {
+      host::advanceMicros(1000);
+      float u = tuner.computeWithSetpoint(y, micros());
+      y = plant.step(u, 0.001f);
+    }
+    CHECK(tuner.getState() == RelayAutotuner::State::CONVERGED);
+    CHECK_NEAR(tuner.getUltimatePeriod(), 0.080f, 0.080f * 0.05f);
+    const float a = 0.002f + 0.05f * 100.0f * 0.020f;
+    const float expected_ku = 4.0f * 100.0f / (3.14159265f * sqrtf(a * a - 0.002f * 0.002f));
+    CHECK_NEAR(tuner.getUltimateGain(), expected_ku, expected_ku * 0.05f);
+    CHECK_NEAR(tuner.getOscillationAmplitude(), a, a * 0.05f);
+  }
+
+  void timeoutRunsOnTimestampsNotCalls() {
+    host::setMicros(123456);
+    RelayAutotuner tuner(100.0f, 0.01f, 1);
+    CHECK(tuner.init());
+    tuner.setTimeout(2.0f);
+
+    // One call every 100 ms: summing the 1 ms nominal dt would take 2000 calls
+    uint32_t calls = 0;
+    while (!tuner.isDone() && calls < 1000) {
+      tuner.compute(0.0f, micros());
+      host::advanceMicros(100000);
+      calls++;
+    }
+    CHECK(tuner.getState() == RelayAutotuner::State::FAILED);
+    CHECK(calls >= 20u && calls <= 22u);
+    CHECK_EQ(tuner.getOutput(), 0.0f);
+  }
+
+  void timeoutRunsWithoutCompute() {
+    host::setMicros(0xFFFFFFFFull - 500000); // Also crosses the micros() wrap
+    RelayAutotuner tuner(100.0f, 0.01f, 1);
+    CHECK(tuner.init());
+    tuner.setTimeout(1.0f);
+
+    tuner.compute(0.5f, micros());
+    CHECK(!tuner.isDone());
+    host::advanceMicros(900000);
+    CHECK(!tuner.checkTimeout(micros()));
+    host::advanceMicros(200000);
+    CHECK(tuner.checkTimeout(micros())); // No compute() since the start
+    CHECK(tuner.getState() == RelayAutotuner::State::FAILED);
+  }
+
+  void abortEndsTheExperiment() {
+    host::setMicros(0);
+    RelayAutotuner tuner(100.0f, 0.01f, 1);
+    CHECK(tuner.init());
+    host::advanceMicros(1000);
+    CHECK_EQ(tuner.compute(0.5f, micros()), 100.0f);
+
+    tuner.abort();
+    CHECK(tuner.isDone());
+    CHECK(tuner.getState() == RelayAutotuner::State::ABORTED);
+    CHECK_EQ(tuner.getOutput(), 0.0f);
+    host::advanceMicros(1000);
+    CHECK_EQ(tuner.compute(-0.5f, micros()), 0.0f);
+
+    float Kp, Ki, Kd;
+    CHECK(!tuner.computeGains(RelayAutotuner::TuningRule::TYREUS_LUYBEN, false, true, Kp, Ki, Kd));
+
+    tuner.reset(); // A new experiment starts clean
+    CHECK(tuner.getState() == RelayAutotuner::State::RUNNING);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(convergesOnDelayedIntegrator);
+  RUN_TEST(timeoutRunsOnTimestampsNotCalls);
+  RUN_TEST(timeoutRunsWithoutCompute);
+  RUN_TEST(abortEndsTheExperiment);
+  return test::finish("RelayAutotuner");
+}
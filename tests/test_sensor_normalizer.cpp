@@ -0,0 +1,132 @@
+#include "SensorNormalizer.h"
+#include "TestHarness.h"
+#include <stdlib.h>
+
+namespace {
+
+  const uint8_t SENSORS = 8;
+
+  /**
+   * @brief QTRSensors::readCalibrated() arithmetic after the read, as in the Pololu library
+   *
+   * The library keeps the quotient in an int16_t, which overflows once
+   * raw - min exceeds 32 ranges (a range of a few counts); the reference
+   * keeps 32 bits there, so it clamps the way the normalizer does.
+   */
+  void qtrCalibrate(const uint16_t *minimum, const uint16_t *maximum, const uint16_t *raw,
+                    uint16_t *normalized) {
+    for (uint8_t i = 0; i < SENSORS; i++) {
+      uint16_t denominator = maximum[i] - minimum[i];
+      int32_t value = 0;
+      if (denominator != 0) {
+        value = (((int32_t)raw[i]) - minimum[i]) * 1000 / denominator;
+      }
+      normalized[i] = value < 0 ? 0 : (value > 1000 ? 1000 : (uint16_t)value);
+    }
+  }
+
+  /**
+   * @brief Largest difference to the QTR result over every raw value of every sensor
+   */
+  int maxDeviation(const sensing::SensorNormalizer<SENSORS> &normalizer, const uint16_t *minimum,
+                   const uint16_t *maximum) {
+    int worst = 0;
+    uint16_t raw[SENSORS];
+    uint16_t expected[SENSORS];
+    uint16_t actual[SENSORS];
+    for (uint16_t value = 0; value < 4096; value++) {
+      for (uint8_t i = 0; i < SENSORS; i++) {
+        raw[i] = value;
+      }
+      qtrCalibrate(minimum, maximum, raw, expected);
+      normalizer.normalize(raw, actual);
+      for (uint8_t i = 0; i < SENSORS; i++) {
+        int deviation = abs((int)actual[i] - (int)expected[i]);
+        worst = deviation > worst ? deviation : worst;
+      }
+    }
+    return worst;
+  }
+
+  /**
+   * @brief Both modes against QTR for one calibration
+   */
+  void checkCalibration(const uint16_t *minimum, const uint16_t *maximum) {
+    sensing::SensorNormalizer<SENSORS> scaled;
+    scaled.rebuild(minimum, maximum);
+    sensing::SensorNormalizer<SENSORS> tabled;
+    CHECK(tabled.enableTable());
+    tabled.rebuild(minimum, maximum);
+    CHECK(!scaled.usesTable());
+    CHECK(tabled.usesTable());
+
+    CHECK(maxDeviation(scaled, minimum, maximum) <= 1);
+    CHECK_EQ(maxDeviation(tabled, minimum, maximum), 0);
+  }
+
+  void randomCalibrations() {
+    srand(1);
+    for (int trial = 0; trial < 20; trial++) {
+      uint16_t minimum[SENSORS];
+      uint16_t maximum[SENSORS];
+      for (uint8_t i = 0; i < SENSORS; i++) {
+        minimum[i] = (uint16_t)(150 + rand() % 200);
+        maximum[i] = (uint16_t)(2800 + rand() % 1200);
+      }
+      checkCalibration(minimum, maximum);
+    }
+  }
+
+  void narrowAndFullRanges() {
+    // Ranges of 1 and 3 counts, odd ranges and the full 12-bit span
+    const uint16_t minimum[SENSORS] = {0, 2000, 100, 0, 1, 4094, 333, 1000};
+    const uint16_t maximum[SENSORS] = {4095, 2001, 103, 7, 1001, 4095, 3999, 2000};
+    checkCalibration(minimum, maximum);
+  }
+
+  void degenerateCalibrations() {
+    // max == min reads 0; max < min wraps QTR's 16-bit range to a large one
+    const uint16_t minimum[SENSORS] = {500, 0, 4095, 3000, 4095, 1, 2000, 100};
+    const uint16_t maximum[SENSORS] = {500, 0, 4095, 2000, 0, 0, 3000, 3900};
+    checkCalibration(minimum, maximum);
+
+    sensing::SensorNormalizer<SENSORS> scaled;
+    scaled.rebuild(minimum, maximum);
+    const uint16_t raw[SENSORS] = {4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095};
+    uint16_t normalized[SENSORS];
+    scaled.normalize(raw, normalized);
+    CHECK_EQ(normalized[0], 0);
+    CHECK_EQ(normalized[1], 0);
+    CHECK_EQ(normalized[2], 0);
+    CHECK(normalized[5] > 0 && normalized[5] < 100); // 4094 × 1000 / 65535
+    CHECK_EQ(normalized[6], 1000);                   // Healthy sensors beside them are unaffected
+  }
+
+  void rebuildReplacesCalibration() {
+    uint16_t minimum[SENSORS];
+    uint16_t maximum[SENSORS];
+    for (uint8_t i = 0; i < SENSORS; i++) {
+      minimum[i] = 200;
+      maximum[i] = 200; // Uncalibrated
+    }
+    sensing::SensorNormalizer<SENSORS> tabled;
+    CHECK(tabled.enableTable());
+    tabled.rebuild(minimum, maximum);
+    CHECK_EQ(maxDeviation(tabled, minimum, maximum), 0);
+
+    for (uint8_t i = 0; i < SENSORS; i++) {
+      maximum[i] = (uint16_t)(3000 + 100 * i);
+    }
+    tabled.rebuild(minimum, maximum);
+    CHECK_EQ(maxDeviation(tabled, minimum, maximum), 0);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(randomCalibrations);
+  RUN_TEST(narrowAndFullRanges);
+  RUN_TEST(degenerateCalibrations);
+  RUN_TEST(rebuildReplacesCalibration);
+  return test::finish("SensorNormalizer");
+}
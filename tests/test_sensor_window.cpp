@@ -0,0 +1,202 @@
+#include "LineEstimator.h"
+#include "SensorWindow.h"
+#include "TestHarness.h"
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using sensing::LineEstimator;
+
+namespace {
+
+  const uint8_t SENSORS = 8;
+  const uint8_t WINDOW_SIZE = 4;
+  const uint16_t FULL_SWEEP_PERIOD = 8;
+
+  // Off-centre error of a windowed estimate that drops only the floor readings
+  const int32_t TOLERANCE = 20;
+
+  typedef std::array<uint16_t, SENSORS> Frame;
+
+  /**
+   * @brief Load the recorded frames ("Sensors: v0 ... v7" lines, # comments)
+   */
+  std::vector<Frame> loadFrames(const char *path) {
+    std::vector<Frame> frames;
+    FILE *file = fopen(path, "r");
+    if (!file) {
+      return frames;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+      const char *field = strstr(line, "Sensors:");
+      if (line[0] == '#' || !field) {
+        continue;
+      }
+      Frame frame;
+      char *cursor = (char *)field + strlen("Sensors:");
+      uint8_t count = 0;
+      for (; count < SENSORS; count++) {
+        char *end;
+        long value = strtol(cursor, &end, 10);
+        if (end == cursor || value < 0 || value > 0xFFFF) {
+          break;
+        }
+        frame[count] = (uint16_t)value;
+        cursor = end;
+      }
+      if (count == SENSORS) {
+        frames.push_back(frame);
+      }
+    }
+    fclose(file);
+    return frames;
+  }
+
+  /**
+   * @brief One replayed cycle: the window, its estimate and the full-frame reference
+   */
+  struct Cycle {
+    sensing::SensorWindow<SENSORS>::Window window;
+    int32_t windowed;
+    int32_t reference;
+    bool masked;
+  };
+
+  /**
+   * @brief Replay the frames through plan()/complete() as the control loop does
+   */
+  std::vector<Cycle> replay(const std::vector<Frame> &frames, sensing::SensorWindow<SENSORS> &window) {
+    LineEstimator<SENSORS> estimator;
+    std::vector<Cycle> cycles;
+    int32_t last_position = LineEstimator<SENSORS>::NO_LINE;
+
+    for (const Frame &frame : frames) {
+      Cycle cycle;
+      cycle.window = window.plan(last_position);
+
+      // Readings outside the window hold stale data, as the sketch's buffer would
+      uint16_t values[SENSORS];
+      for (uint8_t i = 0; i < SENSORS; i++) {
+        bool read = i >= cycle.window.first && i < cycle.window.first + cycle.window.count;
+        values[i] = read ? frame[i] : 999;
+      }
+      window.complete(values, estimator.getNoiseFloor());
+
+      cycle.masked = true;
+      for (uint8_t i = 0; i < SENSORS; i++) {
+        bool read = i >= cycle.window.first && i < cycle.window.first + cycle.window.count;
+        if (!read && values[i] != 0) {
+          cycle.masked = false;
+        }
+      }
+
+      cycle.windowed = estimator.estimate(values);
+      cycle.reference = estimator.estimate(frame.data());
+      last_position = cycle.windowed;
+      cycles.push_back(cycle);
+    }
+    return cycles;
+  }
+
+  bool agrees(const Cycle &cycle) {
+    bool windowed_line = LineEstimator<SENSORS>::hasLine(cycle.windowed);
+    if (windowed_line != LineEstimator<SENSORS>::hasLine(cycle.reference)) {
+      return false;
+    }
+    return !windowed_line || labs((long)(cycle.windowed - cycle.reference)) <= TOLERANCE;
+  }
+
+  const std::vector<Frame> &fixture() {
+    static std::vector<Frame> frames = loadFrames(FIXTURE_DIR "/sensor_window_frames.txt");
+    return frames;
+  }
+
+  void fixtureLoads() {
+    const std::vector<Frame> &frames = fixture();
+    CHECK(frames.size() >= 100);
+  }
+
+  void unreadSensorsAreMasked() {
+    sensing::SensorWindow<SENSORS> window(WINDOW_SIZE, FULL_SWEEP_PERIOD);
+    std::vector<Cycle> cycles = replay(fixture(), window);
+    for (const Cycle &cycle : cycles) {
+      CHECK(cycle.masked);
+    }
+  }
+
+  void windowedEstimateTracksFullSweep() {
+    sensing::SensorWindow<SENSORS> window(WINDOW_SIZE, FULL_SWEEP_PERIOD);
+    std::vector<Cycle> cycles = replay(fixture(), window);
+
+    size_t windowed = 0;
+    size_t disagreements = 0;
+    for (size_t k = 0; k < cycles.size(); k++) {
+      const Cycle &cycle = cycles[k];
+      if (cycle.window.full) {
+        CHECK_EQ(cycle.windowed, cycle.reference);
+        continue;
+      }
+      windowed++;
+      if (!agrees(cycle)) {
+        // A crossing or a jump out of the window is caught by an inner edge,
+        // and the next cycle sweeps
+        disagreements++;
+        CHECK(k + 1 == cycles.size() || cycles[k + 1].window.full);
+      }
+    }
+    CHECK(windowed > cycles.size() / 2);
+    CHECK(disagreements <= cycles.size() / 20);
+  }
+
+  void lineLossForcesFullSweep() {
+    sensing::SensorWindow<SENSORS> window(WINDOW_SIZE, FULL_SWEEP_PERIOD);
+    std::vector<Cycle> cycles = replay(fixture(), window);
+
+    size_t losses = 0;
+    for (size_t k = 0; k + 1 < cycles.size(); k++) {
+      if (!LineEstimator<SENSORS>::hasLine(cycles[k].windowed)) {
+        losses++;
+        CHECK(cycles[k + 1].window.full);
+      }
+    }
+    CHECK(losses >= 2); // The fixture leaves the array and crosses a gap
+  }
+
+  void fullSweepsKeepTheirPeriod() {
+    sensing::SensorWindow<SENSORS> window(WINDOW_SIZE, FULL_SWEEP_PERIOD);
+    std::vector<Cycle> cycles = replay(fixture(), window);
+
+    uint16_t since_full = 0;
+    for (const Cycle &cycle : cycles) {
+      since_full = cycle.window.full ? 0 : since_full + 1;
+      CHECK(since_full < FULL_SWEEP_PERIOD);
+    }
+  }
+
+  void windowSavesConversions() {
+    sensing::SensorWindow<SENSORS> window(WINDOW_SIZE, FULL_SWEEP_PERIOD);
+    std::vector<Cycle> cycles = replay(fixture(), window);
+    CHECK_EQ(window.getCycleCount(), (uint32_t)cycles.size());
+    CHECK(window.getMeanConversions() < 6.0f);
+
+    // The full-sweep baseline converts every sensor each cycle
+    sensing::SensorWindow<SENSORS> full(SENSORS, FULL_SWEEP_PERIOD);
+    replay(fixture(), full);
+    CHECK_NEAR(full.getMeanConversions(), (float)SENSORS, 1e-6f);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(fixtureLoads);
+  RUN_TEST(unreadSensorsAreMasked);
+  RUN_TEST(windowedEstimateTracksFullSweep);
+  RUN_TEST(lineLossForcesFullSweep);
+  RUN_TEST(fullSweepsKeepTheirPeriod);
+  RUN_TEST(windowSavesConversions);
+  return test::finish("SensorWindow");
+}
@@ -0,0 +1,157 @@
+#include "SpscRingBuffer.h"
+#include "TestHarness.h"
+#include <atomic>
+#include <thread>
+
+using rt::SpscRingBuffer;
+
+namespace {
+
+  /**
+   * @brief Sample with a payload that shows a torn copy
+   */
+  struct Sample {
+    uint32_t sequence;
+    uint32_t payload[11];
+    uint32_t check;
+  };
+
+  Sample makeSample(uint32_t sequence) {
+    Sample sample;
+    sample.sequence = sequence;
+    uint32_t check = sequence;
+    for (uint32_t i = 0; i < 11; i++) {
+      sample.payload[i] = sequence * 2654435761u + i;
+      check ^= sample.payload[i];
+    }
+    sample.check = check;
+    return sample;
+  }
+
+  bool isIntact(const Sample &sample) {
+    uint32_t check = sample.sequence;
+    for (uint32_t i = 0; i < 11; i++) {
+      if (sample.payload[i] != sample.sequence * 2654435761u + i) {
+        return false;
+      }
+      check ^= sample.payload[i];
+    }
+    return check == sample.check;
+  }
+
+  void fifoOrderAndFullBuffer() {
+    SpscRingBuffer<uint32_t, 4> ring;
+    uint32_t value = 0;
+    CHECK(ring.empty());
+    CHECK(!ring.pop(value));
+
+    for (uint32_t i = 0; i < 4; i++) {
+      CHECK(ring.push(i));
+    }
+    CHECK_EQ(ring.size(), 4u);
+    CHECK(!ring.push(99)); // Full: dropped, not overwritten
+    CHECK_EQ(ring.getDropped(), 1u);
+
+    for (uint32_t i = 0; i < 4; i++) {
+      CHECK(ring.pop(value));
+      CHECK_EQ(value, i);
+    }
+    CHECK(ring.empty());
+  }
+
+  void slotIndicesWrapAround() {
+    SpscRingBuffer<uint32_t, 8> ring;
+    uint32_t next_in = 0;
+    uint32_t next_out = 0;
+    for (uint32_t round = 0; round < 1000; round++) {
+      for (uint32_t i = 0; i < 5; i++) {
+        CHECK(ring.push(next_in++));
+      }
+      for (uint32_t i = 0; i < 5; i++) {
+        uint32_t value = 0;
+        CHECK(ring.pop(value));
+        CHECK_EQ(value, next_out++);
+      }
+    }
+    CHECK(ring.empty());
+    CHECK_EQ(ring.getDropped(), 0u);
+  }
+
+  void threadedLosslessTransfer() {
+    static SpscRingBuffer<Sample, 16> ring;
+    const uint32_t total = 1000000;
+    std::atomic<bool> intact(true);
+
+    std::thread consumer([&]() {
+      Sample sample;
+      uint32_t expected = 0;
+      while (expected < total) {
+        if (!ring.pop(sample)) {
+          std::this_thread::yield();
+          continue;
+        }
+        if (sample.sequence != expected || !isIntact(sample)) {
+          intact = false;
+        }
+        expected++;
+      }
+    });
+
+    // The producer retries when full, so every sample must arrive in order
+    for (uint32_t i = 0; i < total; i++) {
+      Sample sample = makeSample(i);
+      while (!ring.push(sample)) {
+        std::this_thread::yield();
+      }
+    }
+    consumer.join();
+
+    CHECK(intact.load());
+    CHECK(ring.empty());
+  }
+
+  void threadedDroppingProducer() {
+    // The control task never waits: full pushes are dropped and counted
+    static SpscRingBuffer<Sample, 16> ring;
+    const uint32_t total = 500000;
+    std::atomic<bool> done(false);
+    std::atomic<bool> intact(true);
+    uint32_t received = 0;
+
+    std::thread consumer([&]() {
+      Sample sample;
+      int64_t last = -1;
+      for (;;) {
+        if (ring.pop(sample)) {
+          if ((int64_t)sample.sequence <= last || !isIntact(sample)) {
+            intact = false;
+          }
+          last = sample.sequence;
+          received++;
+        } else if (done.load()) {
+          if (ring.empty()) {
+            break;
+          }
+        }
+      }
+    });
+
+    for (uint32_t i = 0; i < total; i++) {
+      ring.push(makeSample(i));
+    }
+    done = true;
+    consumer.join();
+
+    CHECK(intact.load());
+    CHECK_EQ(received + ring.getDropped(), total);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(fifoOrderAndFullBuffer);
+  RUN_TEST(slotIndicesWrapAround);
+  RUN_TEST(threadedLosslessTransfer);
+  RUN_TEST(threadedDroppingProducer);
+  return test::finish("SpscRingBuffer");
+}
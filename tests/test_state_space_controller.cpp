@@ -0,0 +1,262 @@
+#include "DiffDrivePlant.h"
+#include "LQRController.h"
+#include "MPCController.h"
+#include "TestHarness.h"
+#include <math.h>
+
+using controller::LQRController;
+using controller::MPCController;
+namespace tables = controller::control_tables;
+
+namespace {
+
+  const uint8_t N = tables::MPC_HORIZON;
+
+  /**
+   * @brief Lateral model of ControlTables.h: x = [e, e'], x[k+1] = A x[k] + B u[k]
+   */
+  struct ModelPlant {
+    double e;
+    double rate;
+
+    void step(double u) {
+      e += tables::DT * rate + tables::MODEL_B[0] * u;
+      rate += tables::MODEL_B[1] * u;
+    }
+  };
+
+  /**
+   * @brief Box-constrained QP of the MPC solved to convergence in double
+   *
+   * Plain projected gradient from zero with step 1 / lambda_max(H): slow but
+   * monotone, so enough iterations give the optimum to double precision.
+   */
+  void referencePlan(double e, double rate, double low, double high, double *plan) {
+    double linear[N];
+    for (uint8_t i = 0; i < N; i++) {
+      linear[i] = (double)tables::MPC_F[i][0] * e + (double)tables::MPC_F[i][1] * rate;
+      plan[i] = 0.0;
+    }
+    for (int k = 0; k < 20000; k++) {
+      double next[N];
+      for (uint8_t i = 0; i < N; i++) {
+        double gradient = linear[i];
+        for (uint8_t j = 0; j < N; j++) {
+          gradient += (double)tables::MPC_H[i][j] * plan[j];
+        }
+        double value = plan[i] - (double)tables::MPC_STEP * gradient;
+        next[i] = value < low ? low : (value > high ? high : value);
+      }
+      for (uint8_t i = 0; i < N; i++) {
+        plan[i] = next[i];
+      }
+    }
+  }
+
+  void sampleTimeMustMatchTables() {
+    LQRController lqr_ok(1);
+    MPCController mpc_ok(1);
+    CHECK(lqr_ok.init());
+    CHECK(mpc_ok.init());
+
+    LQRController lqr_slow(2);
+    MPCController mpc_slow(2);
+    CHECK(!lqr_slow.init());
+    CHECK(!mpc_slow.init());
+  }
+
+  void observerStartsWithoutKick() {
+    LQRController lqr;
+    CHECK(lqr.init());
+    lqr.compute(2.0f);
+    CHECK_EQ(lqr.getErrorEstimate(), 2.0f);
+    CHECK_EQ(lqr.getErrorRateEstimate(), 0.0f);
+    CHECK_NEAR(lqr.getOutput(), tables::LQR_K[0] * 2.0f, 1e-3f);
+  }
+
+  void observerConvergesOnModel() {
+    // Open loop, coasting at a constant rate
+    LQRController lqr(1, -1e6f, 1e6f);
+    CHECK(lqr.init());
+    lqr.setGains(0.0f, 0.0f); // Output 0, so the model input matches the coasting plant
+
+    ModelPlant plant = {0.5, 3.0};
+    for (int k = 0; k < 500; k++) {
+      plant.step(0.0);
+      lqr.compute((float)plant.e);
+    }
+    CHECK_NEAR(lqr.getErrorEstimate(), plant.e, 1e-4f);
+    CHECK_NEAR(lqr.getErrorRateEstimate(), plant.rate, 1e-2f);
+  }
+
+  void observerUsesTheSteering() {
+    // Closed loop on the exact model: the rate estimate follows the steering
+    // with no lag, so after the start-up transient it tracks the true rate
+    LQRController lqr;
+    CHECK(lqr.init());
+    ModelPlant plant = {1.0, 0.0};
+    double worst = 0.0;
+    for (int k = 0; k < 1000; k++) {
+      float u = lqr.compute((float)plant.e);
+      if (k >= 200) {
+        double difference = fabs(lqr.getErrorRateEstimate() - plant.rate);
+        worst = difference > worst ? difference : worst;
+      }
+      plant.step(u);
+    }
+    CHECK(worst < 1e-3);
+  }
+
+  void mpcMatchesConvergedQp() {
+    // Limits tight enough that the first moves sit on the bound
+    const float limit = 200.0f;
+    const float errors[] = {0.3f, 1.5f, -3.0f};
+    for (float error : errors) {
+      MPCController mpc(1, -limit, limit);
+      CHECK(mpc.init());
+      mpc.setIterations(200);
+      mpc.compute(error);
+
+      double reference[N];
+      referencePlan(mpc.getErrorEstimate(), mpc.getErrorRateEstimate(), -limit, limit, reference);
+      for (uint8_t i = 0; i < N; i++) {
+        CHECK_NEAR(mpc.getPlannedMove(i), reference[i], 1e-3 * limit);
+      }
+    }
+
+    // The constraints are active in the large-error cases
+    MPCController mpc(1, -limit, limit);
+    CHECK(mpc.init());
+    mpc.compute(3.0f);
+    CHECK_EQ(mpc.getPlannedMove(0), limit);
+    CHECK_EQ(mpc.getOutput(), limit);
+  }
+
+  void mpcDefaultIterationsAreCloseAfterWarmStart() {
+    // Twenty warm-started iterations per step stay near the optimum
+    const float limit = 200.0f;
+    MPCController mpc(1, -limit, limit);
+    CHECK(mpc.init());
+    ModelPlant plant = {2.0, 0.0};
+    double worst = 0.0;
+    for (int k = 0; k < 300; k++) {
+      float u = mpc.compute((float)plant.e);
+      double reference[N];
+      referencePlan(mpc.getErrorEstimate(), mpc.getErrorRateEstimate(), -limit, limit, reference);
+      double difference = fabs(u - reference[0]);
+      worst = k >= 5 && difference > worst ? difference : worst;
+      plant.step(u);
+    }
+    CHECK(worst < 0.02 * limit);
+  }
+
+  void mpcUnconstrainedIsNearLqr() {
+    // With room to spare the first move is close to the LQR law (the header
+    // records 236 e + 21.3 e' against 247 e + 21.8 e')
+    MPCController mpc;
+    LQRController lqr;
+    CHECK(mpc.init());
+    CHECK(lqr.init());
+    mpc.setIterations(200);
+    float u_mpc = mpc.compute(0.5f);
+    float u_lqr = lqr.compute(0.5f);
+    CHECK_NEAR(u_mpc, u_lqr, 0.06f * u_lqr);
+  }
+
+  /**
+   * @brief Closed loop on the model plant, returning the overshoot past the line
+   */
+  template <typename Controller>
+  double runModel(Controller &controller, double start, double &final_error) {
+    ModelPlant plant = {start, 0.0};
+    double overshoot = 0.0;
+    for (int k = 0; k < 3000; k++) {
+      plant.step(controller.compute((float)plant.e));
+      overshoot = -plant.e > overshoot ? -plant.e : overshoot;
+    }
+    final_error = plant.e;
+    return overshoot;
+  }
+
+  void modelClosedLoop() {
+    double final_error;
+    LQRController lqr;
+    CHECK(lqr.init());
+    double lqr_overshoot = runModel(lqr, 2.0, final_error);
+    CHECK(fabs(final_error) < 1e-3);
+    CHECK(lqr_overshoot < 0.1);
+
+    MPCController mpc;
+    CHECK(mpc.init());
+    runModel(mpc, 2.0, final_error);
+    CHECK(fabs(final_error) < 1e-3);
+
+    // Saturated: clamping the LQR overshoots more than planning with the bound
+    LQRController clamped(1, -100.0f, 100.0f);
+    MPCController planned(1, -100.0f, 100.0f);
+    CHECK(clamped.init());
+    CHECK(planned.init());
+    double clamped_overshoot = runModel(clamped, 3.0, final_error);
+    CHECK(fabs(final_error) < 1e-3);
+    double planned_overshoot = runModel(planned, 3.0, final_error);
+    CHECK(fabs(final_error) < 1e-3);
+    CHECK(planned_overshoot < clamped_overshoot);
+  }
+
+  /**
+   * @brief Closed loop on the differential-drive plant, steering split onto the wheels
+   *
+   * The base speed and the steering split give the 1 m/s and 0.01 rad/s per
+   * count the tables were generated for; motor lag and the sensor lookahead
+   * are left unmodelled.
+   */
+  template <typename Controller>
+  double runDiffDrive(Controller &controller, double &worst_late) {
+    const double PITCH_MM = 9.5;
+    const double BASE_PWM = 1000.0 / 1.5; // 1 m/s
+    const double SPLIT = 0.4;             // 2 x 1.5 x 0.4 / 120 = 0.01 rad/s per count
+
+    test::DiffDrivePlant plant;
+    plant.motor_tau = 0.01;
+    plant.left_speed = plant.right_speed = 1000.0;
+    plant.offset = 20.0;
+    worst_late = 0.0;
+    for (int k = 0; k < 3000; k++) {
+      float error = (float)(plant.lineError() / PITCH_MM);
+      double steering = controller.compute(error);
+      plant.step(BASE_PWM + SPLIT * steering, BASE_PWM - SPLIT * steering, tables::DT);
+      if (k >= 1500) {
+        double e = fabs(plant.lineError());
+        worst_late = e > worst_late ? e : worst_late;
+      }
+    }
+    return plant.lineError();
+  }
+
+  void diffDriveClosedLoop() {
+    double worst_late;
+    LQRController lqr;
+    CHECK(lqr.init());
+    runDiffDrive(lqr, worst_late);
+    CHECK(worst_late < 0.5); // mm
+
+    MPCController mpc;
+    CHECK(mpc.init());
+    runDiffDrive(mpc, worst_late);
+    CHECK(worst_late < 0.5);
+  }
+
+} // namespace
+
+int main() {
+  RUN_TEST(sampleTimeMustMatchTables);
+  RUN_TEST(observerStartsWithoutKick);
+  RUN_TEST(observerConvergesOnModel);
+  RUN_TEST(observerUsesTheSteering);
+  RUN_TEST(mpcMatchesConvergedQp);
+  RUN_TEST(mpcDefaultIterationsAreCloseAfterWarmStart);
+  RUN_TEST(mpcUnconstrainedIsNearLqr);
+  RUN_TEST(modelClosedLoop);
+  RUN_TEST(diffDriveClosedLoop);
+  return test::finish("StateSpaceController");
+}
@@ -0,0 +1,313 @@
+#!/usr/bin/env python3
+"""Generate main/ControlTables.h for the LQR and MPC line controllers.
+
+The lateral dynamics of the robot are modelled kinematically. At forward
+speed v the line position y (in sensor pitches) accelerates with the yaw
+rate the steering command u produces:
+
+    y'' = b * u,    b = v * yaw_per_count / sensor_pitch
+
+The controllers work on the error e = -y (setpoint 0), so the state is
+x = [e, e'] and the discrete model at the control period dt is
+
+    x[k+1] = A x[k] + B u[k],  A = [[1, dt], [0, 1]],  B = -b * [dt^2/2, dt]
+
+From this model the script computes
+  - the infinite-horizon LQR gain for u = K x
+  - the steady-state Kalman gain of the observer that estimates e'
+  - the condensed MPC matrices H and F of
+        min_U  1/2 U^T H U + U^T F x   s.t.  u_min <= U <= u_max
+    with move blocking (each of the N moves is held for `block` periods),
+    a terminal cost from the block model's Riccati equation, and the step
+    and momentum of the fast projected gradient solver.
+
+Only the Python standard library is used, so the script runs on any host:
+
+    python3 tools/gen_control_tables.py > main/ControlTables.h
+
+With --check FILE the tables are compared with FILE instead of printed, and
+the exit status is 1 if they differ (the host tests run this against the
+committed header).
+"""
+
+import argparse
+import difflib
+import io
+import math
+import sys
+
+
+def matmul(a, b):
+    return [[sum(a[i][k] * b[k][j] for k in range(len(b))) for j in range(len(b[0]))] for i in range(len(a))]
+
+
+def transpose(a):
+    return [list(row) for row in zip(*a)]
+
+
+def add(a, b):
+    return [[a[i][j] + b[i][j] for j in range(len(a[0]))] for i in range(len(a))]
+
+
+def sub(a, b):
+    return [[a[i][j] - b[i][j] for j in range(len(a[0]))] for i in range(len(a))]
+
+
+def scale(a, s):
+    return [[a[i][j] * s for j in range(len(a[0]))] for i in range(len(a))]
+
+
+def identity(n):
+    return [[1.0 if i == j else 0.0 for j in range(n)] for i in range(n)]
+
+
+def max_abs_diff(a, b):
+    return max(abs(a[i][j] - b[i][j]) for i in range(len(a)) for j in range(len(a[0])))
+
+
+def dare(a, b, q, r, iterations=200000, tol=1e-12):
+    """Solve the discrete algebraic Riccati equation for a single input.
+
+    Returns (P, K) with the optimal feedback u = -K x.
+    """
+    p = [row[:] for row in q]
+    at = transpose(a)
+    bt = transpose(b)
+    for _ in range(iterations):
+        pa = matmul(p, a)
+        pb = matmul(p, b)
+        s = r + matmul(bt, pb)[0][0]
+        k = scale(matmul(bt, pa), 1.0 / s)
+        p_next = add(q, sub(matmul(at, pa), matmul(matmul(at, pb), k)))
+        if max_abs_diff(p_next, p) <= tol * max(1.0, max(abs(v) for row in p for v in row)):
+            p = p_next
+            break
+        p = p_next
+    s = r + matmul(bt, matmul(p, b))[0][0]
+    k = scale(matmul(bt, matmul(p, a)), 1.0 / s)
+    return p, k
+
+
+def kalman_gain(a, g, accel_noise, meas_noise, iterations=200000, tol=1e-14):
+    """Steady-state gain of the predict/correct observer with y = x[0]."""
+    n = len(a)
+    qn = scale(matmul(g, transpose(g)), accel_noise * accel_noise)
+    rn = meas_noise * meas_noise
+    p = identity(n)
+    gain = [0.0] * n
+    for _ in range(iterations):
+        pp = add(matmul(matmul(a, p), transpose(a)), qn)
+        s = pp[0][0] + rn
+        next_gain = [pp[i][0] / s for i in range(n)]
+        p = [[pp[i][j] - next_gain[i] * pp[0][j] for j in range(n)] for i in range(n)]
+        if max(abs(next_gain[i] - gain[i]) for i in range(n)) <= tol:
+            gain = next_gain
+            break
+        gain = next_gain
+    return gain
+
+
+def power_iteration(m, shift=0.0, iterations=10000):
+    """Largest eigenvalue of the symmetric matrix (m - shift I)."""
+    n = len(m)
+    v = [1.0 / math.sqrt(n)] * n
+    value = 0.0
+    for _ in range(iterations):
+        w = [sum(m[i][j] * v[j] for j in range(n)) - shift * v[i] for i in range(n)]
+        norm = math.sqrt(sum(x * x for x in w))
+        if norm == 0.0:
+            return 0.0
+        v = [x / norm for x in w]
+        next_value = sum(v[i] * (sum(m[i][j] * v[j] for j in range(n)) - shift * v[i]) for i in range(n))
+        if abs(next_value - value) <= 1e-15 * max(1.0, abs(next_value)):
+            return next_value
+        value = next_value
+    return value
+
+
+def condensed_mpc(a, b, q, r, p_terminal, horizon):
+    """H = Gamma^T Qbar Gamma + Rbar and F = Gamma^T Qbar Phi."""
+    n = len(a)
+    powers = [identity(n)]
+    for _ in range(horizon):
+        powers.append(matmul(a, powers[-1]))
+
+    # Gamma rows: x_i = Phi_i x0 + sum_j A^(i-1-j) B u_j,  i = 1..N
+    gamma = [[[0.0] for _ in range(horizon)] for _ in range(horizon)]
+    for i in range(1, horizon + 1):
+        for j in range(i):
+            gamma[i - 1][j] = matmul(powers[i - 1 - j], b)
+
+    h = [[0.0] * horizon for _ in range(horizon)]
+    f = [[0.0] * n for _ in range(horizon)]
+    for i in range(1, horizon + 1):
+        weight = p_terminal if i == horizon else q
+        phi = powers[i]
+        for j in range(i):
+            gj_t = transpose(gamma[i - 1][j])
+            wg = matmul(gj_t, weight)
+            row = matmul(wg, phi)[0]
+            for c in range(n):
+                f[j][c] += row[c]
+            for l in range(i):
+                h[j][l] += matmul(wg, gamma[i - 1][l])[0][0]
+    for j in range(horizon):
+        h[j][j] += r
+    return h, f
+
+
+def solve(m, rhs):
+    """Gaussian elimination for the unconstrained check."""
+    n = len(m)
+    a = [m[i][:] + [rhs[i]] for i in range(n)]
+    for c in range(n):
+        pivot = max(range(c, n), key=lambda i: abs(a[i][c]))
+        a[c], a[pivot] = a[pivot], a[c]
+        for i in range(c + 1, n):
+            factor = a[i][c] / a[c][c]
+            for j in range(c, n + 1):
+                a[i][j] -= factor * a[c][j]
+    x = [0.0] * n
+    for i in reversed(range(n)):
+        x[i] = (a[i][n] - sum(a[i][j] * x[j] for j in range(i + 1, n))) / a[i][i]
+    return x
+
+
+def fmt(value):
+    text = "%.9g" % value
+    if "e" not in text and "." not in text:
+        text += ".0"
+    return text + "f"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--rate", type=float, default=1000.0, help="control rate in Hz (CONTROL_RATE_HZ)")
+    parser.add_argument("--speed", type=float, default=1.0, help="forward speed in m/s the tables are tuned for")
+    parser.add_argument("--yaw-per-count", type=float, default=0.01,
+                        help="yaw rate in rad/s per unit of steering command")
+    parser.add_argument("--sensor-pitch", type=float, default=0.0095, help="sensor spacing in m")
+    parser.add_argument("--q-position", type=float, default=1.0, help="LQR weight on the position error")
+    parser.add_argument("--q-rate", type=float, default=1e-4, help="LQR weight on the error rate")
+    parser.add_argument("--r", type=float, default=1.6e-5, help="LQR weight on the steering command")
+    parser.add_argument("--accel-noise", type=float, default=50.0,
+                        help="observer process noise, pitches/s^2 (unmodelled curvature)")
+    parser.add_argument("--meas-noise", type=float, default=0.02, help="position noise in pitches")
+    parser.add_argument("--horizon", type=int, default=10, help="MPC moves N")
+    parser.add_argument("--block", type=int, default=5, help="control periods each MPC move is held")
+    parser.add_argument("--iterations", type=int, default=20, help="default solver iterations per step")
+    parser.add_argument("--check", metavar="FILE", help="compare with FILE instead of printing")
+    args = parser.parse_args()
+
+    if args.rate <= 0 or args.speed <= 0 or args.horizon < 1 or args.horizon > 32 or args.block < 1:
+        parser.error("rate and speed must be positive, horizon 1-32, block >= 1")
+
+    dt = 1.0 / args.rate
+    b_gain = args.speed * args.yaw_per_count / args.sensor_pitch
+    q = [[args.q_position, 0.0], [0.0, args.q_rate]]
+
+    a = [[1.0, dt], [0.0, 1.0]]
+    b = [[-b_gain * dt * dt / 2.0], [-b_gain * dt]]
+    _, k = dare(a, b, q, args.r)
+    lqr = [-k[0][0], -k[0][1]]
+
+    g = [[dt * dt / 2.0], [dt]]
+    observer = kalman_gain(a, g, args.accel_noise, args.meas_noise)
+
+    # Block model: weights scale with the time each step covers
+    tb = dt * args.block
+    ab = [[1.0, tb], [0.0, 1.0]]
+    bb = [[-b_gain * tb * tb / 2.0], [-b_gain * tb]]
+    qb = scale(q, args.block)
+    rb = args.r * args.block
+    pb, _ = dare(ab, bb, qb, rb)
+    h, f = condensed_mpc(ab, bb, qb, rb, pb, args.horizon)
+
+    l_max = power_iteration(h)
+    l_min = l_max + power_iteration(h, shift=l_max)
+    kappa = l_max / l_min
+    momentum = (math.sqrt(kappa) - 1.0) / (math.sqrt(kappa) + 1.0)
+
+    # Unconstrained first move, reported for comparison with the LQR gain
+    first = [-solve(h, [f[i][c] for i in range(args.horizon)])[0] for c in range(2)]
+
+    # The recorded command line regenerates the file, so --check is left out
+    command = ["python3 tools/gen_control_tables.py"]
+    skip = False
+    for arg in sys.argv[1:]:
+        if skip:
+            skip = False
+        elif arg == "--check":
+            skip = True
+        elif not arg.startswith("--check="):
+            command.append(arg)
+
+    out = io.StringIO() if args.check else sys.stdout
+    out.write("#pragma once\n\n")
+    out.write("#include <stdint.h>\n\n")
+    out.write("// Generated by tools/gen_control_tables.py - do not edit by hand\n")
+    out.write("// %s\n" % " ".join(command))
+    out.write("//\n")
+    out.write("// Model: y'' = b u, b = %.6g pitches/s^2 per count (v = %.3g m/s, yaw %.3g rad/s/count,\n"
+              % (b_gain, args.speed, args.yaw_per_count))
+    out.write("// pitch %.4g m); Q = diag(%.3g, %.3g), R = %.3g\n" % (args.sensor_pitch, args.q_position,
+                                                                   args.q_rate, args.r))
+    out.write("// MPC: N = %d moves of %d periods, condition number %.1f, unconstrained first move\n"
+              % (args.horizon, args.block, kappa))
+    out.write("// u = %.6g e + %.6g e' (LQR: %.6g e + %.6g e')\n\n" % (first[0], first[1], lqr[0], lqr[1]))
+
+    out.write("namespace controller {\n")
+    out.write("  namespace control_tables {\n\n")
+    out.write("    /**\n")
+    out.write("     * @brief Model, observer and LQR constants\n")
+    out.write("     *\n")
+    out.write("     * @var DT: Control period the tables are computed for (seconds)\n")
+    out.write("     * @var MODEL_B: Input column of the discrete model, x[k+1] = A x[k] + B u[k]\n")
+    out.write("     * @var OBSERVER_L: Steady-state observer gain on the position residual\n")
+    out.write("     * @var LQR_K: State feedback u = K[0] e + K[1] e'\n")
+    out.write("     */\n")
+    out.write("    static constexpr float DT = %s;\n" % fmt(dt))
+    out.write("    static constexpr float MODEL_B[2] = {%s, %s};\n" % (fmt(b[0][0]), fmt(b[1][0])))
+    out.write("    static constexpr float OBSERVER_L[2] = {%s, %s};\n" % (fmt(observer[0]), fmt(observer[1])))
+    out.write("    static constexpr float LQR_K[2] = {%s, %s};\n\n" % (fmt(lqr[0]), fmt(lqr[1])))
+
+    out.write("    /**\n")
+    out.write("     * @brief Condensed MPC problem and solver constants\n")
+    out.write("     *\n")
+    out.write("     * @var MPC_HORIZON: Moves in the plan\n")
+    out.write("     * @var MPC_BLOCK: Control periods each move is held\n")
+    out.write("     * @var MPC_ITERATIONS: Default fast gradient iterations per step\n")
+    out.write("     * @var MPC_STEP: Gradient step 1 / lambda_max(H)\n")
+    out.write("     * @var MPC_MOMENTUM: (sqrt(kappa) - 1) / (sqrt(kappa) + 1)\n")
+    out.write("     * @var MPC_H: Hessian of the plan cost\n")
+    out.write("     * @var MPC_F: Linear term per state, gradient = H U + F x\n")
+    out.write("     */\n")
+    out.write("    static constexpr uint8_t MPC_HORIZON = %d;\n" % args.horizon)
+    out.write("    static constexpr uint8_t MPC_BLOCK = %d;\n" % args.block)
+    out.write("    static constexpr uint8_t MPC_ITERATIONS = %d;\n" % args.iterations)
+    out.write("    static constexpr float MPC_STEP = %s;\n" % fmt(1.0 / l_max))
+    out.write("    static constexpr float MPC_MOMENTUM = %s;\n" % fmt(momentum))
+    out.write("    static constexpr float MPC_H[MPC_HORIZON][MPC_HORIZON] = {\n")
+    for row in h:
+        out.write("        {%s},\n" % ", ".join(fmt(v) for v in row))
+    out.write("    };\n")
+    out.write("    static constexpr float MPC_F[MPC_HORIZON][2] = {\n")
+    for row in f:
+        out.write("        {%s},\n" % ", ".join(fmt(v) for v in row))
+    out.write("    };\n\n")
+    out.write("  } // namespace control_tables\n")
+    out.write("} // namespace controller\n")
+
+    if args.check:
+        with open(args.check) as committed:
+            expected = committed.read()
+        generated = out.getvalue()
+        if generated != expected:
+            sys.stdout.writelines(difflib.unified_diff(expected.splitlines(True), generated.splitlines(True),
+                                                       args.check, "generated"))
+            return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())